@@ -0,0 +1,77 @@
+//AccumulationPass with and without per-tile pre-aggregation (EngineSettings::tileAggregation) for a range of tile sizes.
+//Reports how many increments reach the shared accumulation table and how fast they are merged. Coarser levels cover more
+//pixels per seed, so they are run as well.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    int AggregationBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        uint32_t const tileSizes[] = { 8, 16, 32, 64, 128 };
+        uint32_t const levelOffsets[] = { 4, 2, 0 }; //Below maxLevels
+        double const pixelsPerFrame = double(frames[0].width) * double(frames[0].height);
+        std::printf("aggregation: %u frames, connectivity %u\n", options.frames, options.voxelConnectivity);
+        std::printf("%8s %6s %6s %10s %12s %12s %14s %12s %12s\n", "threads", "level", "tile", "aggregate", "accum ms", "Mpixels/s", "updates/frame",
+            "updates/px", "Mmerges/s");
+
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            for (uint32_t levelOffset : levelOffsets)
+            {
+                for (uint32_t tileSize : tileSizes)
+                {
+                    for (uint32_t aggregate = 0; aggregate < 2; ++aggregate)
+                    {
+                        EngineSettings settings;
+                        settings.threadCount = threadCount;
+                        settings.screenWidth = frames[0].width;
+                        settings.screenHeight = frames[0].height;
+                        settings.voxelConnectivity = options.voxelConnectivity;
+                        settings.lodMode = options.lodMode;
+                        settings.level = settings.maxLevels - levelOffset;
+                        settings.tileSize = tileSize;
+                        settings.tileAggregation = aggregate != 0;
+                        Engine engine(settings);
+
+                        //Only the accumulation is timed, the samples are generated once per frame
+                        double accumulationMilliseconds = 0.0;
+                        uint64_t updateCount = 0;
+                        for (uint32_t f = 0; f < options.frames; ++f)
+                        {
+                            FrameData const& frame = frames[f % uniqueFrames];
+                            engine.SampleGenerationPass(frame);
+                            engine.AccumulationPass(frame);
+                            accumulationMilliseconds += engine.GetTimings().accumulation;
+                            updateCount += engine.GetAccumulationUpdateCount();
+                            engine.ClearBuffersPass();
+                        }
+
+                        double const frameCount = double(options.frames);
+                        double const updatesPerFrame = double(updateCount) / frameCount;
+                        double const seconds = accumulationMilliseconds * 1e-3;
+                        std::printf("%8u %6u %6u %10s %12.2f %12.2f %14.0f %12.3f %12.2f\n", engine.GetThreadCount(), settings.level, tileSize,
+                            aggregate ? "tile" : "off", accumulationMilliseconds / frameCount, ((pixelsPerFrame * frameCount) / seconds) * 1e-6,
+                            updatesPerFrame, updatesPerFrame / pixelsPerFrame, (double(updateCount) / seconds) * 1e-6);
+                    }
+                }
+            }
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,184 @@
+//Two level acceleration structure (AccelerationStructure) of --model or the synthetic model: the BLAS of all meshes built in
+//parallel per thread count against one BVH over the merged triangle list, the rebuild of a single mesh (its BLAS and the TLAS)
+//and the AO rays/s of both structures for the same frames, --frames = repetitions of the builds and frames traced. First
+//checks that meshes without triangles and scenes without meshes are traced as empty.
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const CheckRayCount = 16;
+
+        //Rays along +z through one triangle at z = 1 and rays along -z away from it, alternating, against a scene whose
+        //first mesh has no triangles (hits: the triangle, instance 1) and a scene without meshes (no hits)
+        bool TracesEmptyMeshes()
+        {
+            TriangleMesh mesh;
+            mesh.positions = { float3{ -1.f, -1.f, 1.f }, float3{ 1.f, -1.f, 1.f }, float3{ 0.f, 1.f, 1.f } };
+            mesh.normals.assign(3, float3{ 0.f, 0.f, -1.f });
+            mesh.indices = { 0, 1, 2 };
+            mesh.meshFirstTriangle = { 0, 0, 1 };
+            TriangleMesh noMeshes;
+            noMeshes.meshFirstTriangle = { 0 };
+
+            ThreadPool threadPool(1);
+            AccelerationStructure scene;
+            scene.Build(mesh, threadPool);
+            AccelerationStructure emptyScene;
+            emptyScene.Build(noMeshes, threadPool);
+
+            float originX[CheckRayCount], originY[CheckRayCount], originZ[CheckRayCount];
+            float directionX[CheckRayCount], directionY[CheckRayCount], directionZ[CheckRayCount];
+            for (uint32_t i = 0; i < CheckRayCount; ++i)
+            {
+                originX[i] = 0.f;
+                originY[i] = -0.5f + float(i) / float(CheckRayCount);
+                originZ[i] = 0.f;
+                directionX[i] = 0.f;
+                directionY[i] = 0.f;
+                directionZ[i] = (i % 2) == 0 ? 1.f : -1.f;
+            }
+            RayBatch const rays = { originX, originY, originZ, directionX, directionY, directionZ, 0.f, 10.f };
+
+            bool valid = scene.GetMeshBVH(0).GetNodes().empty() && scene.GetTLASInstances().size() == 1 && emptyScene.GetTLASNodes().empty();
+            for (uint32_t i = 0; i < CheckRayCount; ++i)
+            {
+                float3 const origin = { originX[i], originY[i], originZ[i] };
+                float3 const direction = { directionX[i], directionY[i], directionZ[i] };
+                bool const expectHit = (i % 2) == 0;
+                RayHit hit;
+                bool const found = scene.Intersect(origin, direction, rays.tMin, rays.tMax, hit);
+                valid = valid && found == expectHit && (!found || (hit.triangle == 0 && hit.instance == 1 && hit.t == 1.f));
+                valid = valid && (scene.IntersectAny(origin, direction, rays.tMin, rays.tMax) < rays.tMax) == expectHit;
+                valid = valid && !emptyScene.Intersect(origin, direction, rays.tMin, rays.tMax, hit)
+                    && emptyScene.IntersectAny(origin, direction, rays.tMin, rays.tMax) == rays.tMax;
+            }
+            for (SimdWidth width : { SimdWidth::Scalar, SimdWidth::AVX2, SimdWidth::AVX512 })
+            {
+                float hitT[CheckRayCount];
+                float emptyHitT[CheckRayCount];
+                IntersectAnyBatch(scene, rays, CheckRayCount, hitT, width);
+                IntersectAnyBatch(emptyScene, rays, CheckRayCount, emptyHitT, width);
+                for (uint32_t i = 0; i < CheckRayCount; ++i)
+                    valid = valid && (hitT[i] < rays.tMax) == ((i % 2) == 0) && emptyHitT[i] == rays.tMax;
+            }
+            return valid;
+        }
+    }
+
+    int BLASBuildBenchmark(BenchmarkOptions const& options)
+    {
+        bool const emptyMeshesTraced = TracesEmptyMeshes();
+        std::printf("blasbuild: empty mesh and empty scene %s\n", emptyMeshesTraced ? "traced as empty" : "FAILED");
+        if (!emptyMeshesTraced)
+            return 1;
+
+        H3DModel model;
+        if (!GetBenchmarkModel(options, model))
+        {
+            std::printf("Failed to load model %s\n", options.modelFile.c_str());
+            return 1;
+        }
+
+        TriangleMesh mesh;
+        if (!GetTriangleMesh(model, mesh))
+        {
+            std::printf("Model %s has indices past the vertices of their mesh\n", options.modelFile.c_str());
+            return 1;
+        }
+        uint32_t const triangleCount = uint32_t(mesh.indices.size() / 3);
+        uint32_t const meshCount = uint32_t(mesh.meshFirstTriangle.size()) - 1;
+        uint32_t largestMesh = 0;
+        for (uint32_t m = 0; m < meshCount; ++m)
+        {
+            if (mesh.meshFirstTriangle[m + 1] - mesh.meshFirstTriangle[m] > mesh.meshFirstTriangle[largestMesh + 1] - mesh.meshFirstTriangle[largestMesh])
+                largestMesh = m;
+        }
+
+        //The merged triangle list as a single mesh: one BLAS under one instance, the structure of the single BVH
+        TriangleMesh mergedMesh = mesh;
+        mergedMesh.meshFirstTriangle = { 0, triangleCount };
+
+        std::printf("blasbuild: %s, %u meshes, %u triangles (largest mesh %u), %u repetitions, %ux%u\n",
+            options.modelFile.empty() ? "synthetic model" : options.modelFile.c_str(), meshCount, triangleCount,
+            mesh.meshFirstTriangle[largestMesh + 1] - mesh.meshFirstTriangle[largestMesh], options.frames, options.screenWidth, options.screenHeight);
+        std::printf("%8s %14s %14s %10s %12s %14s %14s %14s %10s\n", "threads", "merged ms", "per mesh ms", "speedup", "TLAS ms",
+            "rebuild 1 ms", "merged Mrays/s", "scene Mrays/s", "same hits");
+
+        double singleThreadMilliseconds = 0.0;
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            ThreadPool threadPool(threadCount);
+            AccelerationStructure merged;
+            AccelerationStructure scene;
+            double mergedMilliseconds = 0.0;
+            double sceneMilliseconds = 0.0;
+            double tlasMilliseconds = 0.0;
+            double rebuildMilliseconds = 0.0;
+            for (uint32_t r = 0; r < options.frames; ++r)
+            {
+                Clock::time_point start = Clock::now();
+                merged.Build(mergedMesh, threadPool);
+                mergedMilliseconds += MillisecondsSince(start);
+
+                start = Clock::now();
+                scene.Build(mesh, threadPool);
+                sceneMilliseconds += MillisecondsSince(start);
+
+                start = Clock::now();
+                scene.BuildTLAS();
+                tlasMilliseconds += MillisecondsSince(start);
+
+                start = Clock::now();
+                scene.RebuildMesh(largestMesh);
+                scene.BuildTLAS();
+                rebuildMilliseconds += MillisecondsSince(start);
+            }
+            if (singleThreadMilliseconds == 0.0)
+                singleThreadMilliseconds = sceneMilliseconds;
+
+            //AO rays of the same frames through both structures
+            AmbientOcclusionTracer mergedTracer(merged);
+            AmbientOcclusionTracer sceneTracer(scene);
+            FrameData frame;
+            std::vector<float> mergedAO;
+            double mergedRayMilliseconds = 0.0;
+            double sceneRayMilliseconds = 0.0;
+            uint64_t rays = 0;
+            uint64_t sameHits = 0;
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                AOCamera const camera = GetBenchmarkCamera(options, model, f);
+                mergedTracer.TraceGBuffer(camera, options.screenWidth, options.screenHeight, threadPool, frame);
+                Clock::time_point start = Clock::now();
+                mergedTracer.TraceAmbientOcclusion(f, GetMaxSimdWidth(), threadPool, frame);
+                mergedRayMilliseconds += MillisecondsSince(start);
+                mergedAO = frame.ambientOcclusion;
+
+                sceneTracer.TraceGBuffer(camera, options.screenWidth, options.screenHeight, threadPool, frame);
+                start = Clock::now();
+                sceneTracer.TraceAmbientOcclusion(f, GetMaxSimdWidth(), threadPool, frame);
+                sceneRayMilliseconds += MillisecondsSince(start);
+                rays += sceneTracer.GetAORayCount();
+
+                for (size_t i = 0; i < frame.depth.size(); ++i)
+                {
+                    if (asint(frame.depth[i]) != 0)
+                        sameHits += ((frame.ambientOcclusion[i] < 1.f) == (mergedAO[i] < 1.f)) ? 1 : 0;
+                }
+            }
+
+            double const repetitions = double(std::max(options.frames, 1u));
+            std::printf("%8u %14.2f %14.2f %9.2fx %12.3f %14.3f %14.2f %14.2f %9.4f%%\n", threadPool.GetThreadCount(), mergedMilliseconds / repetitions,
+                sceneMilliseconds / repetitions, singleThreadMilliseconds / sceneMilliseconds, tlasMilliseconds / repetitions,
+                rebuildMilliseconds / repetitions, double(rays) / (mergedRayMilliseconds * 1000.0), double(rays) / (sceneRayMilliseconds * 1000.0),
+                (100.0 * double(sameHits)) / double(std::max<uint64_t>(rays, 1)));
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,68 @@
+//Shared options and helpers of the ImplicitPointBench benchmarks. Every benchmark is a function registered in Main.cpp.
+#pragma once
+#include "FrameData.h"
+#include "LODFunctions.h"
+#include "AmbientOcclusionTracer.h"
+#include "H3DModel.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace ImplicitPointBench
+{
+    struct BenchmarkOptions
+    {
+        uint32_t frames = 8;
+        std::vector<uint32_t> threadCounts;  //Empty = 1, 2, 4, ... up to the hardware concurrency
+        std::string frameFile;               //Captured .ipf frame, synthetic frames are used when empty
+        std::string modelFile;               //H3D model (.h3d): frames are ray traced from it, and the ray tracing benchmarks trace it
+        uint32_t screenWidth = 1920;         //Resolution of the synthetic frames, a captured frame keeps its own
+        uint32_t screenHeight = 1080;
+        uint32_t voxelConnectivity = 26;
+        ImplicitPointCPU::LODMode lodMode = ImplicitPointCPU::LODMode::FixedLOD;
+        std::vector<std::string> snapshotFiles; //World hash table snapshots (.iph) for the tools that read them
+    };
+
+    typedef int (*BenchmarkFunction)(BenchmarkOptions const& options);
+
+    //Frame frameIndex of the benchmark input: the captured frame, a frame ray traced from the model or a synthetic one
+    bool GetBenchmarkFrame(BenchmarkOptions const& options, uint32_t frameIndex, ImplicitPointCPU::FrameData& frame);
+    //Model of the ray tracing benchmarks, the synthetic model when there is no model file
+    bool GetBenchmarkModel(BenchmarkOptions const& options, ImplicitPointCPU::H3DModel& model);
+    //Camera of frame frameIndex for that model: the demo's camera for the demo's scenes, slowly turning like the synthetic frames
+    ImplicitPointCPU::AOCamera GetBenchmarkCamera(BenchmarkOptions const& options, ImplicitPointCPU::H3DModel const& model, uint32_t frameIndex);
+    std::vector<uint32_t> GetThreadCounts(BenchmarkOptions const& options);
+
+    typedef std::chrono::high_resolution_clock Clock;
+
+    inline double MillisecondsSince(Clock::time_point const& start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    //---- BENCHMARKS ----
+    int PipelineBenchmark(BenchmarkOptions const& options);
+    int SampleGenerationBenchmark(BenchmarkOptions const& options);
+    int HashTableBenchmark(BenchmarkOptions const& options);
+    int ResizeBenchmark(BenchmarkOptions const& options);
+    int EvictionBenchmark(BenchmarkOptions const& options);
+    int SnapshotBenchmark(BenchmarkOptions const& options);
+    int CompactSlotBenchmark(BenchmarkOptions const& options);
+    int AggregationBenchmark(BenchmarkOptions const& options);
+    int SortAccumulationBenchmark(BenchmarkOptions const& options);
+    int DeterminismBenchmark(BenchmarkOptions const& options);
+    int CompareSnapshotsTool(BenchmarkOptions const& options);
+    int ReconstructionBenchmark(BenchmarkOptions const& options);
+    int ShepardBudgetBenchmark(BenchmarkOptions const& options);
+    int OctreeBenchmark(BenchmarkOptions const& options);
+    int SpatialKeysBenchmark(BenchmarkOptions const& options);
+    int HashFunctionsBenchmark(BenchmarkOptions const& options);
+    int SamplePatternBenchmark(BenchmarkOptions const& options);
+    int TemporalReuseBenchmark(BenchmarkOptions const& options);
+    int MinMaxLODBenchmark(BenchmarkOptions const& options);
+    int RayTracingBenchmark(BenchmarkOptions const& options);
+    int BLASBuildBenchmark(BenchmarkOptions const& options);
+    int RefitBenchmark(BenchmarkOptions const& options);
+    int WideBVHBenchmark(BenchmarkOptions const& options);
+    int H3DLoadBenchmark(BenchmarkOptions const& options);
+} //namespace ImplicitPointBench
@@ -0,0 +1,156 @@
+//Reconstruction error of the compact world hash table layout (CompactKeyDataSlot) relative to KeyDataSlot. Both tables
+//are fed with the same accumulated samples of the engine every frame, so the error includes the drift of re-quantizing
+//the running average each frame, not only the rounding of a single store.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        typedef ResizableHashTable<KeyDataSlot> FullWorldHashTable;
+        typedef ResizableHashTable<CompactKeyDataSlot> CompactWorldHashTable;
+
+        struct ErrorSum
+        {
+            uint64_t samples = 0;
+            double valueAbsoluteSum = 0.0;
+            double valueSquaredSum = 0.0;
+            double valueAbsoluteMax = 0.0;
+            double countRelativeSum = 0.0;
+            double countRelativeMax = 0.0;
+
+            void Add(KeyData const& reference, KeyData const& compact, HashTableConstants const& constants)
+            {
+                double const valueError = std::fabs(double(FromFixedPoint(compact.value, constants.worldHashTableValueFractionalBits))
+                    - double(FromFixedPoint(reference.value, constants.worldHashTableValueFractionalBits)));
+                double const referenceCount = double(reference.count);
+                double const countError = referenceCount > 0.0 ? std::fabs(double(compact.count) - referenceCount) / referenceCount : 0.0;
+
+                ++samples;
+                valueAbsoluteSum += valueError;
+                valueSquaredSum += valueError * valueError;
+                valueAbsoluteMax = std::max(valueAbsoluteMax, valueError);
+                countRelativeSum += countError;
+                countRelativeMax = std::max(countRelativeMax, countError);
+            }
+
+            void Add(ErrorSum const& other)
+            {
+                samples += other.samples;
+                valueAbsoluteSum += other.valueAbsoluteSum;
+                valueSquaredSum += other.valueSquaredSum;
+                valueAbsoluteMax = std::max(valueAbsoluteMax, other.valueAbsoluteMax);
+                countRelativeSum += other.countRelativeSum;
+                countRelativeMax = std::max(countRelativeMax, other.countRelativeMax);
+            }
+
+            void Print(char const* label) const
+            {
+                double const n = samples > 0 ? double(samples) : 1.0;
+                std::printf("%-10s %10llu %14.3e %14.3e %14.3e %14.3e %14.3e\n", label, static_cast<unsigned long long>(samples),
+                    valueAbsoluteSum / n, std::sqrt(valueSquaredSum / n), valueAbsoluteMax, countRelativeSum / n, countRelativeMax);
+            }
+        };
+
+        //The WorldHashTablePass of the engine, on a table of any slot layout
+        template<typename WorldTable>
+        void MergeAccumulation(HashTable const& accumulationHashTable, WorldTable& worldHashTable, HashTableConstants const& constants, ThreadPool& threadPool)
+        {
+            uint32_t const slotsPerJob = 4096;
+            uint32_t const slotCount = accumulationHashTable.GetCapacity();
+            threadPool.ParallelFor((slotCount + slotsPerJob - 1) / slotsPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+            {
+                uint32_t const end = std::min((job + 1) * slotsPerJob, slotCount);
+                for (uint32_t slotID = job * slotsPerJob; slotID < end; ++slotID)
+                {
+                    KeyData const accumulatedData = accumulationHashTable.LookupBySlotID(slotID);
+                    if (accumulatedData.key == 0)
+                        continue;
+                    KeyData const mergedData = MergeAccumulatedData(accumulatedData, worldHashTable.Lookup(accumulatedData.key), constants);
+                    worldHashTable.Insert(mergedData.key, mergedData.value, mergedData.count);
+                }
+            });
+            worldHashTable.Maintain(threadPool);
+        }
+    }
+
+    int CompactSlotBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        EngineSettings settings;
+        settings.threadCount = GetThreadCounts(options).back();
+        settings.screenWidth = frames[0].width;
+        settings.screenHeight = frames[0].height;
+        settings.voxelConnectivity = options.voxelConnectivity;
+        settings.lodMode = options.lodMode;
+        Engine engine(settings);
+        ThreadPool threadPool(engine.GetThreadCount());
+
+        //No eviction, the compact table can't age, so both tables keep the same keys
+        HashTableConstants const& constants = settings.hashTableConstants;
+        EvictionPolicy noEviction;
+        noEviction.maxAge = 0;
+        FullWorldHashTable fullTable(settings.worldHashTablePolicy, noEviction, constants.worldHashTableElementCount);
+        CompactWorldHashTable compactTable(settings.worldHashTablePolicy, noEviction, constants.worldHashTableElementCount);
+
+        std::printf("compactslot: %u frames, connectivity %u, %u bytes per slot vs %u\n", options.frames, options.voxelConnectivity,
+            uint32_t(sizeof(CompactKeyDataSlot)), uint32_t(sizeof(KeyDataSlot)));
+        std::printf("%-10s %10s %14s %14s %14s %14s %14s\n", "frame", "entries", "value mean", "value rms", "value max", "count mean", "count max");
+
+        ErrorSum total;
+        ErrorSum storeOnly;
+        for (uint32_t f = 0; f < options.frames; ++f)
+        {
+            engine.SampleGenerationPass(frames[f % uniqueFrames]);
+            engine.AccumulationPass(frames[f % uniqueFrames]);
+            HashTable const& accumulationHashTable = engine.GetAccumulationHashTable();
+            MergeAccumulation(accumulationHashTable, fullTable, constants, threadPool);
+            MergeAccumulation(accumulationHashTable, compactTable, constants, threadPool);
+
+            //Compare the entries written this frame. Store only: a single store of the reference entry into a compact slot.
+            ErrorSum frameError;
+            for (uint32_t slotID = 0; slotID < accumulationHashTable.GetCapacity(); ++slotID)
+            {
+                uint32_t const key = accumulationHashTable.LookupBySlotID(slotID).key;
+                if (key == 0)
+                    continue;
+                KeyData const reference = fullTable.Lookup(key);
+                frameError.Add(reference, compactTable.Lookup(key), constants);
+
+                CompactKeyDataSlot rounded;
+                rounded.key.store(key, std::memory_order_relaxed);
+                rounded.Store(reference.value, reference.count);
+                storeOnly.Add(reference, rounded.Load(), constants);
+            }
+
+            char label[16];
+            std::snprintf(label, sizeof(label), "%u", f);
+            frameError.Print(label);
+            total.Add(frameError);
+
+            engine.ClearBuffersPass();
+        }
+        total.Print("all");
+        storeOnly.Print("store");
+
+        std::printf("world hash table: %u entries, %.1f MB in KeyDataSlots, %.1f MB in CompactKeyDataSlots\n", fullTable.GetSize(),
+            double(fullTable.GetMemoryUsage()) / (1024.0 * 1024.0), double(compactTable.GetMemoryUsage()) / (1024.0 * 1024.0));
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,127 @@
+//Reproducibility of the world hash table: the same frames are rendered with every thread count, the table is saved as a
+//snapshot and compared against the one of the first thread count. Also the "comparesnapshots" tool for two .iph files.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        void PrintComparison(SnapshotComparison const& comparison)
+        {
+            std::printf("%s, %s entries, %llu differing keys\n", comparison.identical ? "identical" : "not identical",
+                comparison.sameEntries ? "same" : "different", static_cast<unsigned long long>(comparison.differingKeyCount));
+            if (comparison.differingKeyCount == 0)
+                return;
+
+            std::printf("first differing key 0x%08x: a = { value %u, count %u, frame %u }, b = { value %u, count %u, frame %u }%s\n",
+                comparison.firstDifferingKey, comparison.firstA.value, comparison.firstA.count, comparison.firstLastTouchedA,
+                comparison.firstB.value, comparison.firstB.count, comparison.firstLastTouchedB,
+                comparison.firstA.key == 0 ? ", missing in a" : (comparison.firstB.key == 0 ? ", missing in b" : ""));
+        }
+    }
+
+    int DeterminismBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        //Nothing to compare with a single thread count
+        std::vector<uint32_t> threadCounts = GetThreadCounts(options);
+        if (threadCounts.size() < 2)
+            threadCounts.push_back(threadCounts.front() * 4);
+
+        AccumulationMode const modes[] = { AccumulationMode::HashTable, AccumulationMode::Deterministic };
+        char const* const modeNames[] = { "hash", "deterministic" };
+        std::printf("determinism: %u frames, connectivity %u\n", options.frames, options.voxelConnectivity);
+
+        int result = 0;
+        for (uint32_t m = 0; m < 2; ++m)
+        {
+            std::unique_ptr<HashTableSnapshot> pReference;
+            for (uint32_t t = 0; t < threadCounts.size(); ++t)
+            {
+                EngineSettings settings;
+                settings.threadCount = threadCounts[t];
+                settings.screenWidth = frames[0].width;
+                settings.screenHeight = frames[0].height;
+                settings.voxelConnectivity = options.voxelConnectivity;
+                settings.lodMode = options.lodMode;
+                settings.accumulationMode = modes[m];
+                settings.visualizeFinalPass = false;
+                Engine engine(settings);
+
+                std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+                for (uint32_t f = 0; f < options.frames; ++f)
+                    engine.RenderFrame(frames[f % uniqueFrames]);
+                double const milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+                char filename[64];
+                std::snprintf(filename, sizeof(filename), "ImplicitPointBench_determinism_%u.iph", t);
+                std::unique_ptr<HashTableSnapshot> pSnapshot(new HashTableSnapshot());
+                if (!engine.SaveWorldHashTableAsync(filename).get() || !pSnapshot->Open(filename))
+                {
+                    std::printf("Failed to save %s\n", filename);
+                    return 1;
+                }
+
+                std::printf("%-14s %3u threads, %9u entries, %10.2f ms/frame: ", modeNames[m], engine.GetThreadCount(),
+                    engine.GetWorldHashTable().GetSize(), milliseconds / double(options.frames));
+                if (t == 0)
+                {
+                    std::printf("reference\n");
+                    pReference = std::move(pSnapshot);
+                    continue;
+                }
+                SnapshotComparison const comparison = CompareSnapshots(*pReference, *pSnapshot);
+                PrintComparison(comparison);
+                if (modes[m] == AccumulationMode::Deterministic && !comparison.identical)
+                    result = 1;
+
+                //A mapped file can't be removed on Windows
+                pSnapshot.reset();
+                std::remove(filename);
+            }
+            pReference.reset();
+            std::remove("ImplicitPointBench_determinism_0.iph");
+        }
+        return result;
+    }
+
+    int CompareSnapshotsTool(BenchmarkOptions const& options)
+    {
+        if (options.snapshotFiles.size() != 2)
+        {
+            std::printf("comparesnapshots needs two --snapshot files\n");
+            return 1;
+        }
+
+        HashTableSnapshot a;
+        HashTableSnapshot b;
+        if (!a.Open(options.snapshotFiles[0].c_str()) || !b.Open(options.snapshotFiles[1].c_str()))
+        {
+            std::printf("Failed to open %s or %s\n", options.snapshotFiles[0].c_str(), options.snapshotFiles[1].c_str());
+            return 1;
+        }
+
+        std::printf("a: %s, %u entries, frame %u\nb: %s, %u entries, frame %u\n", options.snapshotFiles[0].c_str(), a.GetTable().GetSize(),
+            a.GetFrame(), options.snapshotFiles[1].c_str(), b.GetTable().GetSize(), b.GetFrame());
+        SnapshotComparison const comparison = CompareSnapshots(a, b);
+        PrintComparison(comparison);
+        return comparison.sameEntries ? 0 : 1;
+    }
+} //namespace ImplicitPointBench
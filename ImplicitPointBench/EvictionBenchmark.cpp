@@ -0,0 +1,87 @@
+//Simulated long walkthrough for the aging of the world hash table: every frame sees a window of the points of the last
+//frames plus a batch of new ones, older points are never seen again. Reports occupancy and eviction counters per frame and
+//verifies that every point touched within maxAge frames survives the backward shift deletions.
+#include "Benchmark.h"
+#include "ResizableHashTable.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    int EvictionBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const NewKeysPerFrame = 131072;
+        uint32_t const VisibleFrames = 4;   //Points stay visible for this many frames after they are discovered
+        uint32_t const KeysPerJob = 4096;
+
+        EvictionPolicy eviction;
+        eviction.maxAge = 8;
+        uint32_t const frameCount = std::max(options.frames, 4 * eviction.maxAge);
+
+        std::vector<uint32_t> const threadCounts = GetThreadCounts(options);
+        ThreadPool threadPool(threadCounts.back());
+        WorldHashTable table(ResizePolicy(), eviction, 8388608);
+
+        std::printf("eviction: %u new keys per frame, visible for %u frames, maxAge %u, %u frames, %u threads\n", NewKeysPerFrame,
+            VisibleFrames, eviction.maxAge, frameCount, threadPool.GetThreadCount());
+        std::printf("%6s %10s %10s %10s %10s %10s %12s %10s\n", "frame", "merge ms", "maint ms", "size", "capacity", "occupancy",
+            "evicted", "missing");
+
+        std::mt19937 generator(7);
+        std::vector<uint32_t> history;  //New keys of every frame, NewKeysPerFrame per frame
+        uint32_t missingTotal = 0;
+        uint32_t maxSize = 0;
+        for (uint32_t f = 0; f < frameCount; ++f)
+        {
+            for (uint32_t i = 0; i < NewKeysPerFrame; ++i)
+            {
+                uint32_t key = 0;
+                do { key = generator(); } while (key == 0);
+                history.push_back(key);
+            }
+
+            //Everything discovered in the last VisibleFrames frames is merged again
+            uint32_t const firstVisible = (f + 1 > VisibleFrames ? f + 1 - VisibleFrames : 0) * NewKeysPerFrame;
+            uint32_t const visibleCount = uint32_t(history.size()) - firstVisible;
+            std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+            threadPool.ParallelFor((visibleCount + KeysPerJob - 1) / KeysPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+            {
+                uint32_t const end = std::min((job + 1) * KeysPerJob, visibleCount);
+                for (uint32_t i = job * KeysPerJob; i < end; ++i)
+                {
+                    uint32_t const key = history[firstVisible + i];
+                    KeyData const cachedData = table.Lookup(key);
+                    table.Insert(key, cachedData.value + 1, cachedData.count + 1);
+                }
+            });
+            double const mergeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+            std::chrono::high_resolution_clock::time_point const maintenanceStart = std::chrono::high_resolution_clock::now();
+            table.Maintain(threadPool);
+            double const maintenanceMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - maintenanceStart).count();
+
+            //Points that were written within maxAge frames must still be there
+            uint32_t const firstRecent = (f + 1 > eviction.maxAge ? f + 1 - eviction.maxAge : 0) * NewKeysPerFrame;
+            uint32_t missing = 0;
+            for (uint32_t i = firstRecent; i < uint32_t(history.size()); ++i)
+            {
+                if (table.Lookup(history[i]).key == 0)
+                    ++missing;
+            }
+            missingTotal += missing;
+            maxSize = std::max(maxSize, table.GetSize());
+
+            std::printf("%6u %10.2f %10.2f %10u %10u %10.3f %12llu %10u\n", f, mergeMs, maintenanceMs, table.GetSize(), table.GetCapacity(),
+                table.GetOccupancy(), static_cast<unsigned long long>(table.GetEvictedCount()), missing);
+        }
+
+        //Without eviction the table would hold every key ever seen
+        std::printf("max size %u of %u keys seen, %llu evicted, %u missing\n", maxSize, uint32_t(history.size()),
+            static_cast<unsigned long long>(table.GetEvictedCount()), missingTotal);
+        return missingTotal == 0 ? 0 : 1;
+    }
+} //namespace ImplicitPointBench
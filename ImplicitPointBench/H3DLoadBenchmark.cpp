@@ -0,0 +1,202 @@
+//Load time of an H3D model, --model or the synthetic model written to a file: LoadH3D reading every table and stream into
+//vectors vs MappedH3DModel validating the tables in the mapping, the time until the first vertex and the triangle mesh a
+//BVH build starts from are available, and a pass over all streams through the mapping. --frames is the number of
+//repetitions. The file was just read or written, so loads are served from the OS page cache; run with a cold cache for
+//disk numbers. Last, a file with an index past the vertices of its mesh has to open and then fail GetTriangleMesh.
+#include "Benchmark.h"
+#include "MappedH3DModel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        char const* const ModelFilename = "ImplicitPointBench_model.h3d";
+        char const* const BadIndexFilename = "ImplicitPointBench_bad_index.h3d";
+
+        double SecondsSince(Clock::time_point const& start)
+        {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        double GigabytesPerSecond(uint64_t bytes, double seconds)
+        {
+            return (double(bytes) / seconds) * 1e-9;
+        }
+
+        //Reads every 8 bytes of a stream, what a consumer going over all of the geometry pays for the page faults
+        uint64_t Checksum(H3DSpan<uint8_t> const& stream)
+        {
+            uint64_t checksum = 0;
+            size_t i = 0;
+            for (; i + sizeof(uint64_t) <= stream.size; i += sizeof(uint64_t))
+            {
+                uint64_t value;
+                std::memcpy(&value, stream.data + i, sizeof(value));
+                checksum += value;
+            }
+            for (; i < stream.size; ++i)
+                checksum += stream[i];
+            return checksum;
+        }
+
+        bool SameBytes(void const* a, void const* b, size_t size)
+        {
+            return size == 0 || std::memcmp(a, b, size) == 0;
+        }
+
+        bool SameStream(H3DSpan<uint8_t> const& a, H3DSpan<uint8_t> const& b)
+        {
+            return a.size == b.size && SameBytes(a.data, b.data, a.size);
+        }
+
+        //One triangle whose last index points far past the 3 vertices of its mesh. The tables are valid, so the file opens,
+        //and GetTriangleMesh has to reject it before a BVH build reads past the positions.
+        bool RejectsBadIndices()
+        {
+            float3 const positions[3] = { { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f } };
+            uint16_t const indices[3] = { 0, 1, 60000 };
+            H3DMesh mesh = {};
+            mesh.attribsEnabled = 1u << H3DAttribPosition;
+            mesh.vertexStride = sizeof(float3);
+            mesh.attrib[H3DAttribPosition] = H3DAttribDesc{ 0, 0, 3, H3DAttribFormatFloat };
+            mesh.vertexCount = 3;
+            mesh.indexCount = 3;
+
+            H3DModel model;
+            model.header.meshCount = 1;
+            model.header.materialCount = 1;
+            model.header.vertexDataByteSize = sizeof(positions);
+            model.header.indexDataByteSize = sizeof(indices);
+            model.meshes.push_back(mesh);
+            model.materials.push_back(H3DMaterial());
+            model.vertexData.assign(reinterpret_cast<uint8_t const*>(positions), reinterpret_cast<uint8_t const*>(positions) + sizeof(positions));
+            model.indexData.assign(reinterpret_cast<uint8_t const*>(indices), reinterpret_cast<uint8_t const*>(indices) + sizeof(indices));
+            model.indexDataDepth = model.indexData;
+            if (!SaveH3D(BadIndexFilename, model))
+                return false;
+
+            H3DModel loadedModel;
+            MappedH3DModel mappedModel;
+            TriangleMesh triangleMesh;
+            bool const rejected = LoadH3D(BadIndexFilename, loadedModel) && !GetTriangleMesh(loadedModel, triangleMesh)
+                && mappedModel.Open(BadIndexFilename) && !GetTriangleMesh(mappedModel.GetView(), triangleMesh) && triangleMesh.indices.empty();
+            mappedModel.Close();
+            std::remove(BadIndexFilename);
+            return rejected;
+        }
+
+        bool SameTriangleMesh(TriangleMesh const& a, TriangleMesh const& b)
+        {
+            return a.positions.size() == b.positions.size() && a.indices.size() == b.indices.size() && a.meshFirstTriangle == b.meshFirstTriangle
+                && a.indices == b.indices && SameBytes(a.positions.data(), b.positions.data(), a.positions.size() * sizeof(float3))
+                && SameBytes(a.normals.data(), b.normals.data(), a.normals.size() * sizeof(float3));
+        }
+    }
+
+    int H3DLoadBenchmark(BenchmarkOptions const& options)
+    {
+        char const* filename = options.modelFile.c_str();
+        if (options.modelFile.empty())
+        {
+            H3DModel syntheticModel;
+            GetBenchmarkModel(options, syntheticModel);
+            if (!SaveH3D(ModelFilename, syntheticModel))
+            {
+                std::printf("Failed to save %s\n", ModelFilename);
+                return 1;
+            }
+            filename = ModelFilename;
+        }
+
+        double readSeconds = 0.0;
+        double readMeshSeconds = 0.0;
+        double openSeconds = 0.0;
+        double firstVertexSeconds = 0.0;
+        double mappedMeshSeconds = 0.0;
+        double scanSeconds = 0.0;
+        uint64_t fileSize = 0;
+        uint64_t streamBytes = 0;
+        uint32_t triangleCount = 0;
+        bool valid = true;
+        for (uint32_t repetition = 0; repetition < options.frames && valid; ++repetition)
+        {
+            //Read: every table and stream is copied into the vectors before anything can use them
+            H3DModel model;
+            Clock::time_point start = Clock::now();
+            valid = LoadH3D(filename, model);
+            readSeconds += SecondsSince(start);
+            TriangleMesh readMesh;
+            start = Clock::now();
+            valid = valid && GetTriangleMesh(model, readMesh);
+            readMeshSeconds += SecondsSince(start);
+
+            //Mapped: the first vertex can be read as soon as the tables are validated
+            MappedH3DModel mappedModel;
+            start = Clock::now();
+            valid = valid && mappedModel.Open(filename);
+            openSeconds += SecondsSince(start);
+            if (!valid)
+                break;
+            H3DModelView const& view = mappedModel.GetView();
+            float3 const firstVertex = view.meshes.size > 0 && view.meshes[0].vertexCount > 0
+                ? view.GetVertexFloat3(view.meshes[0], H3DAttribPosition, 0) : float3{ 0.f, 0.f, 0.f };
+            firstVertexSeconds += SecondsSince(start);
+            TriangleMesh mappedMesh;
+            start = Clock::now();
+            valid = GetTriangleMesh(view, mappedMesh);
+            mappedMeshSeconds += SecondsSince(start);
+
+            //A second mapping, so the pass over the streams takes its own page faults
+            MappedH3DModel scanModel;
+            valid = valid && scanModel.Open(filename);
+            if (!valid)
+                break;
+            H3DModelView const& scanView = scanModel.GetView();
+            start = Clock::now();
+            uint64_t const checksum = Checksum(scanView.vertexData) + Checksum(scanView.indexData) + Checksum(scanView.vertexDataDepth)
+                + Checksum(scanView.indexDataDepth);
+            scanSeconds += SecondsSince(start);
+
+            //The mapped views have to hold exactly what LoadH3D read
+            H3DModelView const readView = model.GetView();
+            valid = SameBytes(view.header, readView.header, sizeof(H3DHeader)) && view.meshes.size == readView.meshes.size
+                && view.materials.size == readView.materials.size && SameBytes(view.meshes.data, readView.meshes.data, view.meshes.size * sizeof(H3DMesh))
+                && SameBytes(view.materials.data, readView.materials.data, view.materials.size * sizeof(H3DMaterial))
+                && SameStream(view.vertexData, readView.vertexData) && SameStream(view.indexData, readView.indexData)
+                && SameStream(view.vertexDataDepth, readView.vertexDataDepth) && SameStream(view.indexDataDepth, readView.indexDataDepth)
+                && SameTriangleMesh(mappedMesh, readMesh) && asuint(firstVertex.x) == asuint(readMesh.positions.empty() ? 0.f : readMesh.positions[0].x)
+                && checksum == Checksum(readView.vertexData) + Checksum(readView.indexData) + Checksum(readView.vertexDataDepth) + Checksum(readView.indexDataDepth);
+
+            fileSize = mappedModel.GetFileSize();
+            streamBytes = view.vertexData.size + view.indexData.size + view.vertexDataDepth.size + view.indexDataDepth.size;
+            triangleCount = view.GetTriangleCount();
+        }
+        if (filename == ModelFilename)
+            std::remove(ModelFilename);
+        if (fileSize == 0)
+        {
+            std::printf("Failed to load %s\n", filename);
+            return 1;
+        }
+
+        double const repetitions = double(options.frames);
+        std::printf("h3dload: %s, %.2f MB, %u triangles, %u repetitions\n", options.modelFile.empty() ? "synthetic model" : filename,
+            double(fileSize) / (1024.0 * 1024.0), triangleCount, options.frames);
+        std::printf("%-30s %12s %10s\n", "operation", "ms", "GB/s");
+        std::printf("%-30s %12.3f %10.2f\n", "read (LoadH3D)", readSeconds * 1e3 / repetitions, GigabytesPerSecond(fileSize, readSeconds / repetitions));
+        std::printf("%-30s %12.3f %10s\n", "read + GetTriangleMesh", (readSeconds + readMeshSeconds) * 1e3 / repetitions, "");
+        std::printf("%-30s %12.3f %10s\n", "mmap open", openSeconds * 1e3 / repetitions, "");
+        std::printf("%-30s %12.3f %10s\n", "mmap first vertex", firstVertexSeconds * 1e3 / repetitions, "");
+        std::printf("%-30s %12.3f %10s\n", "mmap open + GetTriangleMesh", (openSeconds + mappedMeshSeconds) * 1e3 / repetitions, "");
+        std::printf("%-30s %12.3f %10.2f\n", "mmap scan all streams", scanSeconds * 1e3 / repetitions, GigabytesPerSecond(streamBytes, scanSeconds / repetitions));
+        std::printf("mapped model %s\n", valid ? "identical" : "DIFFERENT");
+        bool const badIndicesRejected = RejectsBadIndices();
+        std::printf("indices past the vertices of their mesh %s\n", badIndicesRejected ? "rejected" : "NOT REJECTED");
+        return valid && badIndicesRejected ? 0 : 1;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,295 @@
+//Seed hash policies (see SeedHash in HashFunctions.h) compared on speed and quality, single threaded. The inputs are the fixed
+//point voxel centers (ToSignedFixedPoint) the pixels of the benchmark frame seed on every level, deduplicated.
+//- throughput: hashes/ns of the scalar policy and of the AVX2/AVX-512 batches, which are verified bit-exact with it
+//- avalanche: probability that an output bit flips when one input bit flips, ideal 0.5, and the worst bias of the 96 x 32 pairs
+//- collisions: inputs that share their seed with an earlier input (they alias in every table) and inputs whose slot in an
+//  8M slot table (seed % 8M) is taken already, next to what a uniform random hash would give
+//- probe lengths: the seeds inserted in an 8M slot HashTable, average, maximum and share of the keys per probe length in groups
+//Then hash3 and the 8 implicit points per voxel (GenerateVoxelSamplesBatch) of the build's seeds, scalar against SIMD.
+#include "Benchmark.h"
+#include "Engine.h"
+#include "HashBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const TableSlots = 8388608;
+        uint32_t const AvalancheInputs = 65536;
+        uint32_t const BlockSize = 1024;
+
+        struct PolicyResult
+        {
+            char const* name = nullptr;
+            double hashesPerNanosecond[3] = {}; //Scalar, AVX2, AVX-512, 0 when not supported
+            uint32_t mismatches = 0;
+            double avalanche = 0.0;
+            double worstBias = 0.0;
+            uint64_t seedCollisions = 0;
+            uint64_t slotCollisions = 0;
+            HashTableStatistics statistics;
+        };
+
+        struct Inputs
+        {
+            std::vector<uint32_t> x, y, z;
+            uint32_t GetCount() const { return uint32_t(x.size()); }
+        };
+
+        //Inputs that collide when n uniform random values are put in m buckets
+        double ExpectedCollisions(double n, double m)
+        {
+            return n - m * (1.0 - std::exp(n * std::log1p(-1.0 / m)));
+        }
+
+        double NanosecondsSince(std::chrono::high_resolution_clock::time_point const& start)
+        {
+            return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        template<typename Hash>
+        PolicyResult RunPolicy(Inputs const& inputs, std::vector<SimdWidth> const& widths, uint32_t repetitions)
+        {
+            PolicyResult result;
+            result.name = Hash::GetName();
+            uint32_t const count = inputs.GetCount();
+
+            //Throughput, every width against the scalar seeds
+            std::vector<uint32_t> reference(count);
+            std::vector<uint32_t> seeds(count);
+            for (SimdWidth width : widths)
+            {
+                std::vector<uint32_t>& output = width == SimdWidth::Scalar ? reference : seeds;
+                std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+                for (uint32_t r = 0; r < repetitions; ++r)
+                    HashSeedBatch<Hash>(inputs.x.data(), inputs.y.data(), inputs.z.data(), count, output.data(), width);
+                double const nanoseconds = NanosecondsSince(start);
+
+                uint32_t const column = width == SimdWidth::Scalar ? 0 : (width == SimdWidth::AVX2 ? 1 : 2);
+                result.hashesPerNanosecond[column] = double(count) * repetitions / nanoseconds;
+                if (width != SimdWidth::Scalar)
+                {
+                    for (uint32_t i = 0; i < count; ++i)
+                        result.mismatches += seeds[i] != reference[i] ? 1 : 0;
+                }
+            }
+
+            //Avalanche over the 96 input bits
+            std::vector<uint32_t> flips(96 * 32, 0);
+            uint32_t const avalancheInputs = std::min(count, AvalancheInputs);
+            for (uint32_t i = 0; i < avalancheInputs; ++i)
+            {
+                uint3 const input = { inputs.x[i], inputs.y[i], inputs.z[i] };
+                uint32_t const seed = reference[i];
+                for (uint32_t bit = 0; bit < 96; ++bit)
+                {
+                    uint3 flipped = input;
+                    uint32_t& component = bit < 32 ? flipped.x : (bit < 64 ? flipped.y : flipped.z);
+                    component ^= 1u << (bit % 32);
+                    uint32_t const difference = seed ^ Hash::Hash(flipped);
+                    for (uint32_t outputBit = 0; outputBit < 32; ++outputBit)
+                        flips[bit * 32 + outputBit] += (difference >> outputBit) & 1u;
+                }
+            }
+            uint64_t flipSum = 0;
+            for (uint32_t flipCount : flips)
+            {
+                flipSum += flipCount;
+                result.worstBias = std::max(result.worstBias, std::fabs(double(flipCount) / avalancheInputs - 0.5));
+            }
+            result.avalanche = double(flipSum) / (double(avalancheInputs) * flips.size());
+
+            //Collisions of the whole seed and of the slot in a table of TableSlots
+            std::vector<uint8_t> slotTaken(TableSlots, 0);
+            for (uint32_t seed : reference)
+            {
+                result.slotCollisions += slotTaken[seed % TableSlots];
+                slotTaken[seed % TableSlots] = 1;
+            }
+            std::vector<uint32_t> sortedSeeds = reference;
+            std::sort(sortedSeeds.begin(), sortedSeeds.end());
+            for (uint32_t i = 1; i < count; ++i)
+                result.seedCollisions += sortedSeeds[i] == sortedSeeds[i - 1] ? 1 : 0;
+
+            //Probe lengths, seed 0 is the empty key
+            HashTable table(TableSlots);
+            for (uint32_t seed : reference)
+            {
+                if (seed != 0)
+                    table.Insert(seed, 1, 1);
+            }
+            result.statistics = table.ComputeStatistics();
+            return result;
+        }
+
+        bool SameBits(float a, float b)
+        {
+            return asuint(a) == asuint(b);
+        }
+
+        //hash3 of the seeds and the implicit points of the voxels, per width in values/ns and mismatches against the scalar results.
+        //Timed in blocks of BlockSize inputs that stay in the cache, the 96 bytes of points per voxel would measure the memory bandwidth.
+        int RunVoxelSamples(Inputs const& inputs, std::vector<SimdWidth> const& widths, uint32_t repetitions)
+        {
+            uint32_t const count = inputs.GetCount();
+            EngineSettings const settings;
+            std::vector<uint32_t> seeds(count);
+            HashSeedBatch<SeedHash>(inputs.x.data(), inputs.y.data(), inputs.z.data(), count, seeds.data(), SimdWidth::Scalar);
+            std::vector<float3> positions(count);
+            for (uint32_t i = 0; i < count; ++i)
+                positions[i] = float3{ float(int32_t(inputs.x[i])), float(int32_t(inputs.y[i])), float(int32_t(inputs.z[i])) } / float(IntPow2(settings.maxLevels));
+            float const cellSize = float(settings.cellSize) / float(IntPow2(settings.maxLevels));
+
+            std::vector<float> referenceX(count), referenceY(count), referenceZ(count), x(count), y(count), z(count);
+            std::vector<float3> referenceSamples(size_t(count) * 8), samples(size_t(count) * 8);
+            std::printf("%18s %12s %12s %12s %12s\n", "width", "hash3 h/ns", "mismatches", "voxels/ns", "mismatches");
+            int result = 0;
+            for (SimdWidth width : widths)
+            {
+                std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+                for (uint32_t r = 0; r < repetitions; ++r)
+                {
+                    for (uint32_t block = 0; block < count; block += BlockSize)
+                        Hash3Batch(seeds.data() + block, std::min(BlockSize, count - block), x.data(), y.data(), z.data(), width);
+                }
+                double const hashNanoseconds = NanosecondsSince(start);
+
+                start = std::chrono::high_resolution_clock::now();
+                for (uint32_t r = 0; r < repetitions; ++r)
+                {
+                    for (uint32_t block = 0; block < count; block += BlockSize)
+                        GenerateVoxelSamplesBatch(seeds.data() + block, positions.data() + block, std::min(BlockSize, count - block), cellSize, samples.data(), width);
+                }
+                double const voxelNanoseconds = NanosecondsSince(start);
+
+                uint32_t hashMismatches = 0;
+                uint32_t sampleMismatches = 0;
+                bool const scalar = width == SimdWidth::Scalar;
+                Hash3Batch(seeds.data(), count, scalar ? referenceX.data() : x.data(), scalar ? referenceY.data() : y.data(), scalar ? referenceZ.data() : z.data(), width);
+                GenerateVoxelSamplesBatch(seeds.data(), positions.data(), count, cellSize, scalar ? referenceSamples.data() : samples.data(), width);
+                if (!scalar)
+                {
+                    for (uint32_t i = 0; i < count; ++i)
+                        hashMismatches += (SameBits(x[i], referenceX[i]) && SameBits(y[i], referenceY[i]) && SameBits(z[i], referenceZ[i])) ? 0 : 1;
+                    for (size_t i = 0; i < samples.size(); ++i)
+                    {
+                        sampleMismatches += (SameBits(samples[i].x, referenceSamples[i].x) && SameBits(samples[i].y, referenceSamples[i].y)
+                            && SameBits(samples[i].z, referenceSamples[i].z)) ? 0 : 1;
+                    }
+                }
+                std::printf("%18s %12.3f %12u %12.3f %12u\n", GetSimdWidthName(width), double(count) * repetitions / hashNanoseconds, hashMismatches,
+                    double(count) * repetitions / voxelNanoseconds, sampleMismatches);
+                result = (hashMismatches == 0 && sampleMismatches == 0) ? result : 1;
+            }
+            return result;
+        }
+    }
+
+    int HashFunctionsBenchmark(BenchmarkOptions const& options)
+    {
+        FrameData frame;
+        if (!GetBenchmarkFrame(options, 0, frame))
+        {
+            std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+            return 1;
+        }
+
+        //The voxel center of every pixel with geometry on every level, the way GetNeighbourVoxelSeed fixes it
+        EngineSettings const settings;
+        std::vector<uint3> voxelCenters;
+        uint2 const screenDimensions = { frame.width, frame.height };
+        uint32_t pixels = 0;
+        for (uint32_t index = 0; index < frame.width * frame.height; ++index)
+        {
+            if (asint(frame.depth[index]) == 0)
+                continue;
+            uint2 const index2D = { index % frame.width, index / frame.width };
+            float3 const position = DepthToWorldPosition(frame.depth[index], index2D, screenDimensions, frame.viewProjectionInverse).xyz();
+            for (uint32_t level = 0; level <= settings.maxLevels; ++level)
+            {
+                float const deltaOnLevel = 1.f / float(IntPow2(level));
+                float3 const discretePosition = Discretize(position, float(settings.cellSize) * deltaOnLevel);
+                float3 const acp = GetNeighbourVoxelCenter(discretePosition, deltaOnLevel, settings.cellSize);
+                voxelCenters.push_back(ToSignedFixedPoint(acp, settings.maxLevels));
+            }
+            ++pixels;
+        }
+        std::sort(voxelCenters.begin(), voxelCenters.end(), [](uint3 const& a, uint3 const& b)
+        {
+            return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+        });
+        voxelCenters.erase(std::unique(voxelCenters.begin(), voxelCenters.end(), [](uint3 const& a, uint3 const& b)
+        {
+            return a.x == b.x && a.y == b.y && a.z == b.z;
+        }), voxelCenters.end());
+
+        //Sorted inputs differ in the low bits of z only, the avalanche inputs are taken from a random order
+        std::mt19937 generator(5);
+        std::shuffle(voxelCenters.begin(), voxelCenters.end(), generator);
+        Inputs inputs;
+        for (uint3 const& center : voxelCenters)
+        {
+            inputs.x.push_back(center.x);
+            inputs.y.push_back(center.y);
+            inputs.z.push_back(center.z);
+        }
+        uint32_t const count = inputs.GetCount();
+        if (count == 0)
+        {
+            std::printf("hashfunctions: no geometry in the frame\n");
+            return 1;
+        }
+
+        std::vector<SimdWidth> widths = { SimdWidth::Scalar };
+        if (SupportsAVX2())
+            widths.push_back(SimdWidth::AVX2);
+        if (SupportsAVX512())
+            widths.push_back(SimdWidth::AVX512);
+
+        std::vector<PolicyResult> results;
+        results.push_back(RunPolicy<PcgNestedHash>(inputs, widths, options.frames));
+        results.push_back(RunPolicy<WangNestedHash>(inputs, widths, options.frames));
+        results.push_back(RunPolicy<WangLinearHash>(inputs, widths, options.frames));
+        results.push_back(RunPolicy<XxHash32Hash>(inputs, widths, options.frames));
+        results.push_back(RunPolicy<XorShiftLinearHash>(inputs, widths, options.frames));
+
+        std::printf("hashfunctions: %u unique voxel centers of %u pixels on levels 0-%u, %u repetitions, single thread, build seed hash %s\n",
+            count, pixels, settings.maxLevels, options.frames, SeedHash::GetName());
+        std::printf("%18s %12s %12s %12s %11s %10s %11s\n", "hash", "scalar h/ns", "AVX2 h/ns", "AVX-512 h/ns", "mismatches", "avalanche",
+            "worst bias");
+        int result = 0;
+        for (PolicyResult const& r : results)
+        {
+            std::printf("%18s %12.3f %12.3f %12.3f %11u %10.4f %11.4f\n", r.name, r.hashesPerNanosecond[0], r.hashesPerNanosecond[1],
+                r.hashesPerNanosecond[2], r.mismatches, r.avalanche, r.worstBias);
+            result = r.mismatches == 0 ? result : 1;
+        }
+
+        std::printf("%18s %12s %12s %12s %12s %10s %10s %8s %8s %8s %8s %8s\n", "hash", "seed coll.", "expected", "slot coll.", "expected",
+            "avg probe", "max probe", "0", "1", "2", "3", "4+");
+        for (PolicyResult const& r : results)
+        {
+            std::vector<uint32_t> const& histogram = r.statistics.probeLengthHistogram;
+            double const occupied = std::max(double(r.statistics.occupied), 1.0);
+            uint64_t longProbes = 0;
+            for (size_t length = 4; length < histogram.size(); ++length)
+                longProbes += histogram[length];
+            std::printf("%18s %12llu %12.1f %12llu %12.1f %10.4f %10u %7.3f%% %7.3f%% %7.3f%% %7.3f%% %7.3f%%\n", r.name,
+                static_cast<unsigned long long>(r.seedCollisions), ExpectedCollisions(count, 4294967296.0),
+                static_cast<unsigned long long>(r.slotCollisions), ExpectedCollisions(count, TableSlots), r.statistics.averageProbeLength,
+                r.statistics.maxProbeLength, histogram[0] * 100.0 / occupied, histogram[1] * 100.0 / occupied, histogram[2] * 100.0 / occupied,
+                histogram[3] * 100.0 / occupied, longProbes * 100.0 / occupied);
+            result = r.statistics.failedInserts == 0 ? result : 1;
+        }
+
+        result = RunVoxelSamples(inputs, widths, options.frames) == 0 ? result : 1;
+        return result;
+    }
+} //namespace ImplicitPointBench
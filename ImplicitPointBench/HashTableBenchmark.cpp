@@ -0,0 +1,132 @@
+//Contention benchmark of the concurrent hash table: every thread count increments the same key stream into a cleared
+//accumulation sized table. Key streams: the seeds of a real frame (many pixels share a seed), uniform random keys and a
+//small hot set where all threads fight over the same cache lines.
+#include "Benchmark.h"
+#include "Engine.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        struct KeyStream
+        {
+            char const* name;
+            std::vector<uint32_t> keys;
+        };
+
+        //Seed and previous LOD seed of every pixel, in the order the AccumulationPass increments them
+        std::vector<uint32_t> GetFrameKeys(FrameData const& frame, BenchmarkOptions const& options)
+        {
+            EngineSettings settings;
+            settings.screenWidth = frame.width;
+            settings.screenHeight = frame.height;
+            settings.voxelConnectivity = options.voxelConnectivity;
+            settings.lodMode = options.lodMode;
+            Engine engine(settings);
+            engine.SampleGenerationPass(frame);
+
+            std::vector<uint32_t> keys;
+            for (SampleData const& data : engine.GetPointSampleBuffer())
+            {
+                if (data.seed == 0)
+                    continue;
+                keys.push_back(data.seed);
+                if (data.prevSeed != 0 && data.prevSeed != data.seed)
+                    keys.push_back(data.prevSeed);
+            }
+            return keys;
+        }
+
+        std::vector<uint32_t> GetRandomKeys(uint32_t count, uint32_t distinctKeys)
+        {
+            std::mt19937 generator(1337);
+            std::vector<uint32_t> distinct(distinctKeys);
+            for (uint32_t& key : distinct)
+            {
+                do { key = generator(); } while (key == 0);
+            }
+
+            std::uniform_int_distribution<uint32_t> pick(0, distinctKeys - 1);
+            std::vector<uint32_t> keys(count);
+            for (uint32_t& key : keys)
+                key = distinct[pick(generator)];
+            return keys;
+        }
+    }
+
+    int HashTableBenchmark(BenchmarkOptions const& options)
+    {
+        FrameData frame;
+        if (!GetBenchmarkFrame(options, 0, frame))
+        {
+            std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+            return 1;
+        }
+
+        //One slot per pixel, like the accumulation hash table of the engine
+        uint32_t const capacity = frame.width * frame.height;
+
+        std::vector<KeyStream> streams(3);
+        streams[0].name = "frame";
+        streams[0].keys = GetFrameKeys(frame, options);
+        uint32_t const keyCount = uint32_t(streams[0].keys.size());
+        streams[1].name = "uniform";
+        streams[1].keys = GetRandomKeys(keyCount, capacity / 2);
+        streams[2].name = "hot";
+        streams[2].keys = GetRandomKeys(keyCount, 64);
+
+        std::printf("hashtable: %u slots, %u increments per repetition, %u repetitions\n", capacity, keyCount, options.frames);
+        std::printf("%8s %8s %12s %14s %8s %10s %10s %10s\n", "keys", "threads", "Mops/s", "Mops/s/core", "load", "avg probe", "max probe", "failed");
+
+        uint32_t const keysPerJob = 4096;
+        int result = 0;
+        for (KeyStream const& stream : streams)
+        {
+            for (uint32_t threadCount : GetThreadCounts(options))
+            {
+                ThreadPool threadPool(threadCount);
+                uint32_t const jobCount = (keyCount + keysPerJob - 1) / keysPerJob;
+
+                double seconds = 0.0;
+                HashTableStatistics statistics;
+                for (uint32_t r = 0; r < options.frames; ++r)
+                {
+                    std::unique_ptr<HashTable> pTable(new HashTable(capacity));
+                    HashTable& table = *pTable;
+
+                    std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+                    threadPool.ParallelFor(jobCount, [&](uint32_t job, uint32_t /*threadIndex*/)
+                    {
+                        uint32_t const end = std::min((job + 1) * keysPerJob, keyCount);
+                        for (uint32_t i = job * keysPerJob; i < end; ++i)
+                            table.Increment(stream.keys[i], 1);
+                    });
+                    seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+                    //Every increment has to be accounted for, either in a slot or as dropped at the probe bound
+                    statistics = table.ComputeStatistics();
+                    uint64_t countSum = 0;
+                    for (uint32_t slotID = 0; slotID < table.GetCapacity(); ++slotID)
+                        countSum += table.LookupBySlotID(slotID).count;
+                    if (countSum + statistics.failedInserts != keyCount)
+                        result = 1;
+                }
+
+                double const operationsPerSecond = (double(keyCount) * options.frames) / seconds;
+                std::printf("%8s %8u %12.2f %14.2f %8.3f %10.3f %10u %10llu\n", stream.name, threadPool.GetThreadCount(),
+                    operationsPerSecond * 1e-6, (operationsPerSecond / threadPool.GetThreadCount()) * 1e-6,
+                    statistics.loadFactor, statistics.averageProbeLength, statistics.maxProbeLength,
+                    static_cast<unsigned long long>(statistics.failedInserts));
+            }
+        }
+        return result;
+    }
+} //namespace ImplicitPointBench
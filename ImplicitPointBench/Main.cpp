@@ -0,0 +1,179 @@
+//Headless benchmarks for the CPU implementation of the implicit point pipeline (ImplicitPointCPU).
+//Usage: ImplicitPointBench <benchmark> [--frames N] [--threads 1,2,4] [--frame capture.ipf] [--resolution 1920x1080]
+//                          [--connectivity 0|6|18|26] [--lod 0|1|2] [--snapshot table.iph]... [--model scene.h3d]
+#include "Benchmark.h"
+#include "Engine.h"
+#include "ModelScene.h"
+#include "SyntheticScene.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    bool GetBenchmarkFrame(BenchmarkOptions const& options, uint32_t frameIndex, FrameData& frame)
+    {
+        if (!options.frameFile.empty())
+            return LoadFrame(options.frameFile.c_str(), frame);
+        if (!options.modelFile.empty())
+            return TraceBenchmarkFrame(options, frameIndex, frame);
+
+        CreateSyntheticFrame(frameIndex, options.screenWidth, options.screenHeight, frame);
+        return true;
+    }
+
+    std::vector<uint32_t> GetThreadCounts(BenchmarkOptions const& options)
+    {
+        if (!options.threadCounts.empty())
+            return options.threadCounts;
+
+        std::vector<uint32_t> threadCounts;
+        uint32_t const hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        for (uint32_t threads = 1; threads < hardwareThreads; threads *= 2)
+            threadCounts.push_back(threads);
+        threadCounts.push_back(hardwareThreads);
+        return threadCounts;
+    }
+} //namespace ImplicitPointBench
+
+namespace
+{
+    struct BenchmarkEntry
+    {
+        char const* name;
+        ImplicitPointBench::BenchmarkFunction function;
+        char const* description;
+    };
+
+    BenchmarkEntry const Benchmarks[] =
+    {
+        { "pipeline", &ImplicitPointBench::PipelineBenchmark, "Full frame (all passes), pixels/s per thread count" },
+        { "samplegen", &ImplicitPointBench::SampleGenerationBenchmark, "GetGeneratedSample scalar vs SIMD per voxel connectivity, --frames = repetitions" },
+        { "hashtable", &ImplicitPointBench::HashTableBenchmark, "Concurrent hash table increments/s per thread count, load factor and probe lengths" },
+        { "resize", &ImplicitPointBench::ResizeBenchmark, "World hash table frame latency while growing, incremental vs stop-the-world migration" },
+        { "eviction", &ImplicitPointBench::EvictionBenchmark, "World hash table aging during a simulated walkthrough, occupancy and eviction counters" },
+        { "snapshot", &ImplicitPointBench::SnapshotBenchmark, "World hash table snapshot save/load GB/s and time to first lookup (mmap vs read)" },
+        { "compactslot", &ImplicitPointBench::CompactSlotBenchmark, "Value/count error of the compact 8 byte world hash table slot vs KeyDataSlot on recorded frames" },
+        { "aggregation", &ImplicitPointBench::AggregationBenchmark, "Accumulation pass merges/s into the shared table per tile size, with and without per-tile pre-aggregation" },
+        { "sortaccumulation", &ImplicitPointBench::SortAccumulationBenchmark, "Radix sort + segmented reduce accumulation vs the hash table path, per thread count" },
+        { "determinism", &ImplicitPointBench::DeterminismBenchmark, "World hash table snapshots per thread count compared, hash vs deterministic accumulation" },
+        { "comparesnapshots", &ImplicitPointBench::CompareSnapshotsTool, "Compares two --snapshot files entry by entry, reports the first differing key" },
+        { "reconstruction", &ImplicitPointBench::ReconstructionBenchmark, "Final visualization pass Mpixels/s and world hash table lookups per pixel per neighbour voxel cache size" },
+        { "shepardbudget", &ImplicitPointBench::ShepardBudgetBenchmark, "MinMaxLOD reconstruction points/lookups per pixel, ms and error per early-out weight and point budget" },
+        { "octree", &ImplicitPointBench::OctreeBenchmark, "Hashed sparse octree over the generated points: fill cost, reconstruction with it, finest level and radius queries" },
+        { "spatialkeys", &ImplicitPointBench::SpatialKeysBenchmark, "World hash table keyed by pcg seeds vs spatial seeds: lookups/s, cache lines and simulated misses per pixel" },
+        { "hashfunctions", &ImplicitPointBench::HashFunctionsBenchmark, "Seed hash policies: hashes/ns scalar and SIMD, avalanche, collisions and probe lengths on the frame's voxel centers, hash3 and voxel points" },
+        { "samplepattern", &ImplicitPointBench::SamplePatternBenchmark, "Quarter/checkerboard sample generation vs every pixel: pass times and reconstruction error per frame with 1 spp AO" },
+        { "temporalreuse", &ImplicitPointBench::TemporalReuseBenchmark, "Reprojected closest samples per reuse distance, orbiting and static camera: sample generation ms, hit rate, other seeds and error" },
+        { "minmaxlod", &ImplicitPointBench::MinMaxLODBenchmark, "MinMaxLOD ns/pixel per max level on the frame's AO and constant AO, ring by ring kernel vs min/max pyramid, --frames = repetitions" },
+        { "raytracing", &ImplicitPointBench::RayTracingBenchmark, "CPU BVH build and AO ray tracing of --model (synthetic model without): primary and AO rays/s, scalar vs packets" },
+        { "blasbuild", &ImplicitPointBench::BLASBuildBenchmark, "Per mesh BLAS + TLAS build ms per thread count vs one merged BVH, single mesh rebuild and AO rays/s of both" },
+        { "refit", &ImplicitPointBench::RefitBenchmark, "Animated meshes and instances: refit vs refit with SAH triggered rebuilds vs rebuild vs full build ms per frame, SAH cost and AO rays/s" },
+        { "widebvh", &ImplicitPointBench::WideBVHBenchmark, "Compressed 8-wide BVH vs binary float BVH: bytes per triangle, primary and AO rays/s per thread count, scalar vs SIMD" },
+        { "h3dload", &ImplicitPointBench::H3DLoadBenchmark, "H3D model load ms: LoadH3D vs mmap (MappedH3DModel) open, first vertex, triangle mesh and stream scan, --frames = repetitions" }
+    };
+
+    void PrintUsage()
+    {
+        std::printf("Usage: ImplicitPointBench <benchmark> [--frames N] [--threads 1,2,4] [--frame capture.ipf] [--resolution 1920x1080]\n");
+        std::printf("                          [--connectivity 0|6|18|26] [--lod 0|1|2] [--snapshot table.iph]... [--model scene.h3d]\n");
+        std::printf("Benchmarks:\n");
+        for (BenchmarkEntry const& entry : Benchmarks)
+            std::printf("  %-24s %s\n", entry.name, entry.description);
+    }
+
+    std::vector<uint32_t> ParseList(char const* text)
+    {
+        std::vector<uint32_t> values;
+        while (*text != '\0')
+        {
+            char* end = nullptr;
+            values.push_back(uint32_t(std::strtoul(text, &end, 10)));
+            if (end == text)
+                break;
+            text = (*end == ',') ? end + 1 : end;
+        }
+        return values;
+    }
+
+    bool ParseOptions(int argc, char** argv, ImplicitPointBench::BenchmarkOptions& options)
+    {
+        for (int i = 2; i < argc; ++i)
+        {
+            bool const hasValue = (i + 1) < argc;
+            if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+                options.frames = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+                options.threadCounts = ParseList(argv[++i]);
+            else if (std::strcmp(argv[i], "--frame") == 0 && hasValue)
+                options.frameFile = argv[++i];
+            else if (std::strcmp(argv[i], "--resolution") == 0 && hasValue)
+            {
+                char* end = nullptr;
+                options.screenWidth = uint32_t(std::strtoul(argv[++i], &end, 10));
+                options.screenHeight = (*end == 'x') ? uint32_t(std::strtoul(end + 1, nullptr, 10)) : 0;
+            }
+            else if (std::strcmp(argv[i], "--connectivity") == 0 && hasValue)
+                options.voxelConnectivity = uint32_t(std::strtoul(argv[++i], nullptr, 10));
+            else if (std::strcmp(argv[i], "--lod") == 0 && hasValue)
+                options.lodMode = LODMode(std::strtoul(argv[++i], nullptr, 10));
+            else if (std::strcmp(argv[i], "--snapshot") == 0 && hasValue)
+                options.snapshotFiles.push_back(argv[++i]);
+            else if (std::strcmp(argv[i], "--model") == 0 && hasValue)
+                options.modelFile = argv[++i];
+            else
+            {
+                std::printf("Unknown or incomplete option: %s\n", argv[i]);
+                return false;
+            }
+        }
+
+        if (options.frames == 0 || options.screenWidth == 0 || options.screenHeight == 0 || options.voxelConnectivity > 26 || uint32_t(options.lodMode) > uint32_t(LODMode::MinMaxLOD))
+        {
+            std::printf("Invalid option value\n");
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    ImplicitPointBench::BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    for (BenchmarkEntry const& entry : Benchmarks)
+    {
+        if (std::strcmp(entry.name, argv[1]) != 0)
+            continue;
+
+        try
+        {
+            return entry.function(options);
+        }
+        catch (std::exception const& e)
+        {
+            std::printf("Benchmark %s failed: %s\n", entry.name, e.what());
+            return 1;
+        }
+    }
+
+    std::printf("Unknown benchmark: %s\n", argv[1]);
+    PrintUsage();
+    return 1;
+}
@@ -0,0 +1,108 @@
+//MinMaxLOD per maximum level (the kernel grows to 3 + maxLevels texels around the pixel): ScreenMinMaxLOD reading the
+//kernel ring by ring against the min/max pyramid (MinMaxPyramid) built once per frame. Reports the time per pixel with
+//depth, the pyramid build and lookups separately, and the pixels that get the same levels from both. Two AO inputs: the
+//frame's, where most pixels find AO variation within a ring or two, and constant AO on the pixels with depth, the worst
+//case where the ring loop never finds any and reads the whole kernel up to maxLevels.
+#include "Benchmark.h"
+#include "MinMaxPyramid.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const MaxLevels[] = { 2, 4, 8, 12, 16, 24, 32 };
+
+        struct AOInput
+        {
+            char const* name;
+            TextureView aoBuffer;
+        };
+    }
+
+    int MinMaxLODBenchmark(BenchmarkOptions const& options)
+    {
+        FrameData frame;
+        if (!GetBenchmarkFrame(options, 0, frame))
+        {
+            std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+            return 1;
+        }
+
+        uint2 const screenDimensions = { frame.width, frame.height };
+        TextureView const depthBuffer = frame.GetDepthView();
+        TextureView const frameAOBuffer = frame.GetBlurredAmbientOcclusionView();
+        std::vector<float> constantAO(frame.depth.size());
+        for (size_t i = 0; i < frame.depth.size(); ++i)
+            constantAO[i] = asint(frame.depth[i]) != 0 ? 0.5f : frameAOBuffer.pData[i];
+        AOInput const inputs[] = { { "frame", frameAOBuffer }, { "constant", TextureView{ constantAO.data(), frame.width, frame.height } } };
+        uint64_t const validPixels = uint64_t(std::count_if(frame.depth.begin(), frame.depth.end(), [](float depth) { return asint(depth) != 0; }));
+        std::vector<uint2> ringLods(frame.depth.size());
+        std::vector<uint2> pyramidLods(frame.depth.size());
+
+        std::printf("minmaxlod: %u repetitions, %ux%u, %llu pixels with depth\n", options.frames, frame.width, frame.height,
+            static_cast<unsigned long long>(validPixels));
+        std::printf("%8s %10s %10s %12s %12s %12s %12s %10s %12s %10s\n", "threads", "ao", "maxLevels", "ring ns/px", "build ns/px", "lookup ns/px",
+            "pyramid ns/px", "speedup", "pyramid MB", "same lod");
+
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            ThreadPool threadPool(threadCount);
+            MinMaxPyramid pyramid;
+            for (AOInput const& input : inputs)
+            {
+                TextureView const& aoBuffer = input.aoBuffer;
+                for (uint32_t maxLevels : MaxLevels)
+                {
+                    double ringMilliseconds = 0.0;
+                    double buildMilliseconds = 0.0;
+                    double lookupMilliseconds = 0.0;
+                    for (uint32_t r = 0; r < options.frames; ++r)
+                    {
+                        Clock::time_point start = Clock::now();
+                        threadPool.ParallelFor(frame.height, [&](uint32_t y, uint32_t /*threadIndex*/)
+                        {
+                            for (uint32_t x = 0; x < frame.width; ++x)
+                            {
+                                uint32_t const index = x + y * frame.width;
+                                if (asint(frame.depth[index]) != 0)
+                                    ScreenMinMaxLOD(uint2{ x, y }, screenDimensions, maxLevels, depthBuffer, aoBuffer, ringLods[index].x, ringLods[index].y);
+                            }
+                        });
+                        ringMilliseconds += MillisecondsSince(start);
+
+                        start = Clock::now();
+                        pyramid.Build(depthBuffer, aoBuffer, 4, 3 + maxLevels, threadPool);
+                        buildMilliseconds += MillisecondsSince(start);
+
+                        start = Clock::now();
+                        threadPool.ParallelFor(frame.height, [&](uint32_t y, uint32_t /*threadIndex*/)
+                        {
+                            for (uint32_t x = 0; x < frame.width; ++x)
+                            {
+                                uint32_t const index = x + y * frame.width;
+                                if (asint(frame.depth[index]) != 0)
+                                    PyramidMinMaxLOD(uint2{ x, y }, maxLevels, pyramid, pyramidLods[index].x, pyramidLods[index].y);
+                            }
+                        });
+                        lookupMilliseconds += MillisecondsSince(start);
+                    }
+
+                    uint64_t sameLods = 0;
+                    for (size_t i = 0; i < frame.depth.size(); ++i)
+                        sameLods += (asint(frame.depth[i]) != 0 && ringLods[i].x == pyramidLods[i].x && ringLods[i].y == pyramidLods[i].y) ? 1 : 0;
+
+                    double const pixels = double(validPixels) * double(options.frames) * 1e-6; //ms -> ns per pixel
+                    std::printf("%8u %10s %10u %12.2f %12.2f %12.2f %12.2f %9.2fx %12.1f %9.2f%%\n", threadPool.GetThreadCount(), input.name, maxLevels,
+                        ringMilliseconds / pixels, buildMilliseconds / pixels, lookupMilliseconds / pixels,
+                        (buildMilliseconds + lookupMilliseconds) / pixels, ringMilliseconds / (buildMilliseconds + lookupMilliseconds),
+                        double(pyramid.GetMemorySize()) / (1024.0 * 1024.0), (100.0 * double(sameLods)) / double(std::max<uint64_t>(validPixels, 1)));
+                }
+            }
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
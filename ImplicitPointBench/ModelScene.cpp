@@ -0,0 +1,106 @@
+#include "ModelScene.h"
+#include "SyntheticScene.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        //Startup cameras of ImplicitPointDemo per scene
+        struct DemoCamera
+        {
+            char const* modelName;
+            float3 position;
+            float3 lookDirection;
+            float3 up;
+        };
+
+        DemoCamera const DemoCameras[] =
+        {
+            { "bistro-interior", float3{ -11.805f, 298.791f, -115.986f }, float3{ 0.937597f, -0.186109f, -0.293727f }, float3{ 0.177598f, 0.982529f, -0.0556372f } },
+            { "dragon", float3{ -141.809f, 282.313f, 256.845f }, float3{ 0.37324f, -0.593874f, -0.712745f }, float3{ 0.275502f, 0.804558f, -0.526104f } },
+            { "hairball", float3{ -8.37427f, 150.595f, 133.763f }, float3{ 0.0445527f, -0.633293f, -0.772629f }, float3{ 0.0364575f, 0.773913f, -0.632242f } },
+            { "bistro-exterior", float3{ -680.566f, 110.841f, 106.817f }, float3{ 0.974446f, -0.103681f, -0.199261f }, float3{ 0.101579f, 0.994611f, -0.0207715f } }
+        };
+
+        struct TracedModel
+        {
+            std::string filename;
+            H3DModel model;
+            TriangleMesh mesh;
+            AccelerationStructure scene;
+        };
+
+        //Rotates around the world up axis, like the orbit of the synthetic frames
+        float3 RotateY(float3 const& v, float angle)
+        {
+            float const c = std::cos(angle);
+            float const s = std::sin(angle);
+            return float3{ c * v.x + s * v.z, v.y, -s * v.x + c * v.z };
+        }
+    }
+
+    bool GetBenchmarkModel(BenchmarkOptions const& options, H3DModel& model)
+    {
+        if (!options.modelFile.empty())
+            return LoadH3D(options.modelFile.c_str(), model);
+
+        CreateSyntheticModel(model);
+        return true;
+    }
+
+    AOCamera GetBenchmarkCamera(BenchmarkOptions const& options, H3DModel const& model, uint32_t frameIndex)
+    {
+        if (options.modelFile.empty())
+            return GetSyntheticCamera(frameIndex);
+
+        float const angle = float(frameIndex) * 0.002f;
+        AOCamera camera;
+        for (DemoCamera const& demoCamera : DemoCameras)
+        {
+            if (options.modelFile.find(demoCamera.modelName) == std::string::npos)
+                continue;
+            camera.position = demoCamera.position;
+            camera.lookDirection = RotateY(demoCamera.lookDirection, angle);
+            camera.up = RotateY(demoCamera.up, angle);
+            return camera;
+        }
+
+        //Other models: looking at the center of the bounding box from above one of its corners, orbiting the center
+        H3DBoundingBox const& bounds = model.header.boundingBox;
+        float3 const boundsMin = { bounds.min.x, bounds.min.y, bounds.min.z };
+        float3 const boundsMax = { bounds.max.x, bounds.max.y, bounds.max.z };
+        float3 const center = (boundsMin + boundsMax) * 0.5f;
+        camera.position = center + RotateY((boundsMax - center) * float3{ 1.2f, 0.8f, 1.2f }, angle);
+        camera.lookDirection = normalize(center - camera.position);
+        camera.up = float3{ 0.f, 1.f, 0.f };
+        camera.farPlane = std::max(10000.f, 4.f * length(boundsMax - boundsMin));
+        return camera;
+    }
+
+    bool TraceBenchmarkFrame(BenchmarkOptions const& options, uint32_t frameIndex, FrameData& frame)
+    {
+        ThreadPool threadPool;
+        static std::unique_ptr<TracedModel> s_pModel;
+        if (!s_pModel || s_pModel->filename != options.modelFile)
+        {
+            s_pModel.reset(new TracedModel());
+            s_pModel->filename = options.modelFile;
+            if (!GetBenchmarkModel(options, s_pModel->model) || !GetTriangleMesh(s_pModel->model, s_pModel->mesh))
+            {
+                s_pModel.reset();
+                return false;
+            }
+            s_pModel->scene.Build(s_pModel->mesh, threadPool);
+        }
+
+        AmbientOcclusionTracer tracer(s_pModel->scene);
+        tracer.RenderFrame(GetBenchmarkCamera(options, s_pModel->model, frameIndex), options.screenWidth, options.screenHeight, frameIndex,
+            GetMaxSimdWidth(), threadPool, frame);
+        return true;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,11 @@
+//H3D models as benchmark input: frames ray traced on the CPU (AmbientOcclusionTracer) from --model, so every benchmark can
+//run on the demo's scenes without a DXR capable GPU.
+#pragma once
+#include "Benchmark.h"
+
+namespace ImplicitPointBench
+{
+    //Depth and 1 spp AO of frame frameIndex at the benchmark resolution. The model and its BVH are loaded and built on the
+    //first call and kept for the next ones.
+    bool TraceBenchmarkFrame(BenchmarkOptions const& options, uint32_t frameIndex, ImplicitPointCPU::FrameData& frame);
+} //namespace ImplicitPointBench
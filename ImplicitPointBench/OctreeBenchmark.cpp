@@ -0,0 +1,257 @@
+//Hashed sparse octree over the generated implicit points (EngineSettings::octreeCapacity). Renders the frames with and
+//without the octree, with and without the neighbour voxel cache, and reports the cost of filling it during sample generation,
+//the final pass time and how far the reconstruction moves (the octree drops seeds that only collide with a cached key).
+//Then times the queries on the generated points of the last frame: finest populated level, and the cached points within one
+//cell of a point against probing all 27 x 8 seeds of the neighbourhood. Last, a walkthrough with eviction checks that the
+//octree is pruned along with the world hash table and is complete at its end.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        struct OctreeVariant
+        {
+            char const* name;
+            bool octree;
+            uint32_t neighbourVoxelCacheSize;
+        };
+
+        OctreeVariant const Variants[] =
+        {
+            { "probe", false, 0 },
+            { "octree", true, 0 },
+            { "cache", false, 4096 },
+            { "cache+octree", true, 4096 }
+        };
+        uint32_t const VariantCount = sizeof(Variants) / sizeof(Variants[0]);
+        uint32_t const OctreeCapacity = 1u << 23;
+        uint32_t const QueryCount = 65536;
+        uint32_t const EvictionMaxAge = 2;
+        uint32_t const WalkthroughFrameStep = 64; //Frames of the slowly turning camera between two frames of the walkthrough
+
+        struct QueryResult
+        {
+            uint64_t points = 0;
+            uint64_t seedSum = 0;
+        };
+
+        //Cached points within one cell of position on level, the way the reconstruction searches them
+        QueryResult ProbeNeighbourhood(float3 const& position, uint32_t level, EngineSettings const& settings, WorldHashTable const& worldHashTable)
+        {
+            float const deltaOnLevel = 1.f / float(IntPow2(level));
+            float const cellSizeBasedOnLevel = float(settings.cellSize) * deltaOnLevel;
+            float3 const discretePosition = Discretize(position, cellSizeBasedOnLevel);
+
+            QueryResult result;
+            for (uint32_t v = 0; v < 27; ++v)
+            {
+                NeighbourVoxel const neighbour = GetNeighbourVoxel(discretePosition, v, cellSizeBasedOnLevel, deltaOnLevel, settings.cellSize, settings.maxLevels);
+                for (uint32_t i = 0; i < 8; ++i)
+                {
+                    float3 const sample = neighbour.position + (GenerateSampleInVoxelQuadrant(neighbour.seed, level, i) * cellSizeBasedOnLevel);
+                    if (distance(position, sample) <= cellSizeBasedOnLevel && worldHashTable.Lookup(neighbour.seed + i).key != 0)
+                    {
+                        ++result.points;
+                        result.seedSum += neighbour.seed + i;
+                    }
+                }
+            }
+            return result;
+        }
+
+        QueryResult QueryOctree(float3 const& position, uint32_t level, EngineSettings const& settings, ImplicitPointOctree const& octree,
+            WorldHashTable const& worldHashTable)
+        {
+            float const cellSizeBasedOnLevel = float(settings.cellSize) * (1.f / float(IntPow2(level)));
+            QueryResult result;
+            octree.ForEachPointInRadius(position, cellSizeBasedOnLevel, level, level, [&](uint32_t seed, float3 const& /*sample*/, uint32_t /*level*/)
+            {
+                if (worldHashTable.Lookup(seed).key != 0)
+                {
+                    ++result.points;
+                    result.seedSum += seed;
+                }
+            });
+            return result;
+        }
+
+        double NanosecondsSince(std::chrono::high_resolution_clock::time_point const& start, uint32_t count)
+        {
+            return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / double(count);
+        }
+
+        //Walkthrough with a short maxAge, so the world hash table evicts the points of the frames that are out of view. The
+        //octree has to drop them as well, a full octree fails inserts and the reconstruction stops using it.
+        bool StaysCompleteUnderEviction(BenchmarkOptions const& options, FrameData const& firstFrame)
+        {
+            EngineSettings settings;
+            settings.threadCount = GetThreadCounts(options).back();
+            settings.screenWidth = firstFrame.width;
+            settings.screenHeight = firstFrame.height;
+            settings.voxelConnectivity = options.voxelConnectivity;
+            settings.lodMode = options.lodMode;
+            settings.worldHashTableEviction.maxAge = EvictionMaxAge;
+            settings.octreeCapacity = OctreeCapacity;
+            Engine engine(settings);
+
+            uint32_t const frameCount = std::max(options.frames, 32u);
+            uint32_t completeFrames = 0;
+            FrameData frame;
+            for (uint32_t f = 0; f < frameCount; ++f)
+            {
+                GetBenchmarkFrame(options, f * WalkthroughFrameStep, frame);
+                engine.RenderFrame(frame);
+                completeFrames += engine.GetOctree()->IsComplete() ? 1 : 0;
+            }
+
+            ImplicitPointOctree const& octree = *engine.GetOctree();
+            std::printf("%8s maxAge %u: %llu evicted, %u nodes of %u, %llu failed inserts, complete in %u of %u frames, %s\n", "",
+                EvictionMaxAge, static_cast<unsigned long long>(engine.GetWorldHashTable().GetEvictedCount()), octree.GetSize(),
+                octree.GetCapacity(), static_cast<unsigned long long>(octree.GetFailedInsertCount()), completeFrames, frameCount,
+                octree.IsComplete() ? "complete" : "incomplete");
+            return engine.GetWorldHashTable().GetEvictedCount() > 0 && octree.IsComplete();
+        }
+    }
+
+    int OctreeBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        std::printf("octree: %u frames, connectivity %u, lod mode %u\n", options.frames, options.voxelConnectivity, uint32_t(options.lodMode));
+        int result = 0;
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            std::vector<std::unique_ptr<Engine>> engines;
+            for (OctreeVariant const& variant : Variants)
+            {
+                EngineSettings settings;
+                settings.threadCount = threadCount;
+                settings.screenWidth = frames[0].width;
+                settings.screenHeight = frames[0].height;
+                settings.voxelConnectivity = options.voxelConnectivity;
+                settings.lodMode = options.lodMode;
+                settings.accumulationMode = AccumulationMode::Deterministic;
+                settings.neighbourVoxelCacheSize = variant.neighbourVoxelCacheSize;
+                settings.octreeCapacity = variant.octree ? OctreeCapacity : 0;
+                engines.emplace_back(new Engine(settings));
+            }
+
+            double sampleGenerationMilliseconds[VariantCount] = {};
+            double finalMilliseconds[VariantCount] = {};
+            uint64_t differingPixels[VariantCount] = {};
+            double maxErrors[VariantCount] = {};
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                FrameData const& frame = frames[f % uniqueFrames];
+                for (uint32_t v = 0; v < VariantCount; ++v)
+                {
+                    Engine& engine = *engines[v];
+                    engine.RenderFrame(frame);
+                    sampleGenerationMilliseconds[v] += engine.GetTimings().sampleGeneration;
+                    finalMilliseconds[v] += engine.GetTimings().finalVisualization;
+
+                    std::vector<float> const& reference = engines[0]->GetVisualizationBuffer();
+                    std::vector<float> const& visualization = engine.GetVisualizationBuffer();
+                    for (size_t i = 0; i < visualization.size(); ++i)
+                    {
+                        double const error = std::fabs(double(visualization[i]) - double(reference[i]));
+                        differingPixels[v] += error != 0.0 ? 1 : 0;
+                        maxErrors[v] = std::max(maxErrors[v], error);
+                    }
+                }
+            }
+
+            double const frameCount = double(options.frames);
+            std::printf("%8s %14s %12s %12s %10s %14s %12s\n", "threads", "reconstruct", "samplegen ms", "final ms", "speedup", "differing px",
+                "max error");
+            for (uint32_t v = 0; v < VariantCount; ++v)
+            {
+                std::printf("%8u %14s %12.2f %12.2f %9.2fx %14llu %12.6f\n", engines[v]->GetThreadCount(), Variants[v].name,
+                    sampleGenerationMilliseconds[v] / frameCount, finalMilliseconds[v] / frameCount, finalMilliseconds[0] / finalMilliseconds[v],
+                    static_cast<unsigned long long>(differingPixels[v]), maxErrors[v]);
+            }
+
+            //The clear pass reset the LOD buffer, generate the samples of the last frame again
+            Engine& engine = *engines[1];
+            engine.SampleGenerationPass(frames[(options.frames - 1) % uniqueFrames]);
+            ImplicitPointOctree const& octree = *engine.GetOctree();
+            std::printf("%8s %u nodes of %u (%.1f MB), %llu failed inserts, %s\n", "", octree.GetSize(), octree.GetCapacity(),
+                double(octree.GetCapacity()) * sizeof(OctreeNode) / (1024.0 * 1024.0),
+                static_cast<unsigned long long>(octree.GetFailedInsertCount()), octree.IsComplete() ? "complete" : "incomplete");
+
+            //Generated points of the last frame, at the LOD they were generated on
+            std::vector<float3> positions;
+            std::vector<uint32_t> levels;
+            std::mt19937 generator(11);
+            std::uniform_int_distribution<uint32_t> pixel(0, engine.GetPixelCount() - 1);
+            for (uint32_t attempt = 0; attempt < QueryCount * 16 && positions.size() < QueryCount; ++attempt)
+            {
+                uint32_t const index = pixel(generator);
+                if (engine.GetPointSampleBuffer()[index].seed == 0)
+                    continue;
+                positions.push_back(engine.GetPointSampleBuffer()[index].sample);
+                levels.push_back(engine.GetLODBuffer()[index].x);
+            }
+            uint32_t const queries = uint32_t(positions.size());
+            if (queries == 0)
+                continue;
+
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            uint64_t levelSum = 0;
+            for (uint32_t q = 0; q < queries; ++q)
+                levelSum += octree.FindFinestLevel(positions[q], engine.GetSettings().maxLevels);
+            double const finestNanoseconds = NanosecondsSince(start, queries);
+
+            std::vector<QueryResult> probed(queries);
+            start = std::chrono::high_resolution_clock::now();
+            for (uint32_t q = 0; q < queries; ++q)
+                probed[q] = ProbeNeighbourhood(positions[q], levels[q], engine.GetSettings(), engine.GetWorldHashTable());
+            double const probeNanoseconds = NanosecondsSince(start, queries);
+
+            std::vector<QueryResult> found(queries);
+            start = std::chrono::high_resolution_clock::now();
+            for (uint32_t q = 0; q < queries; ++q)
+                found[q] = QueryOctree(positions[q], levels[q], engine.GetSettings(), octree, engine.GetWorldHashTable());
+            double const octreeNanoseconds = NanosecondsSince(start, queries);
+
+            uint64_t probedPoints = 0;
+            uint64_t foundPoints = 0;
+            uint32_t differingQueries = 0;
+            for (uint32_t q = 0; q < queries; ++q)
+            {
+                probedPoints += probed[q].points;
+                foundPoints += found[q].points;
+                differingQueries += (probed[q].points != found[q].points || probed[q].seedSum != found[q].seedSum) ? 1 : 0;
+            }
+            std::printf("%8s %u queries: finest level %.0f ns (average %.2f), radius probe %.0f ns, radius octree %.0f ns (%.2fx)\n", "", queries,
+                finestNanoseconds, double(levelSum) / double(queries), probeNanoseconds, octreeNanoseconds, probeNanoseconds / octreeNanoseconds);
+            std::printf("%8s points found: probe %llu, octree %llu, %u queries differ (seed collisions)\n", "",
+                static_cast<unsigned long long>(probedPoints), static_cast<unsigned long long>(foundPoints), differingQueries);
+            result = octree.IsComplete() ? result : 1;
+        }
+
+        //A captured frame is the only frame there is, nothing would be evicted
+        if (options.frameFile.empty())
+            result = StaysCompleteUnderEviction(options, frames[0]) ? result : 1;
+        return result;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,72 @@
+//Runs the full CPU pipeline over a sequence of frames for every thread count and reports throughput and per pass timings.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    int PipelineBenchmark(BenchmarkOptions const& options)
+    {
+        //A few distinct frames is enough for the camera to move, the rest of the sequence cycles through them
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        double const pixelsPerFrame = double(frames[0].width) * double(frames[0].height);
+        std::printf("pipeline: %ux%u, %u frames, connectivity %u, LOD mode %u\n", frames[0].width, frames[0].height,
+            options.frames, options.voxelConnectivity, uint32_t(options.lodMode));
+        std::printf("%8s %12s %14s %10s %10s %10s %10s %10s %10s\n", "threads", "Mpixels/s", "Mpixels/s/core", "gen ms", "accum ms", "merge ms", "maint ms", "final ms", "clear ms");
+
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            EngineSettings settings;
+            settings.threadCount = threadCount;
+            settings.screenWidth = frames[0].width;
+            settings.screenHeight = frames[0].height;
+            settings.voxelConnectivity = options.voxelConnectivity;
+            settings.lodMode = options.lodMode;
+            Engine engine(settings);
+
+            //Warm up: fills the world hash table, so the timed frames see a table in steady state
+            engine.RenderFrame(frames[0]);
+
+            PassTimings sum;
+            std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                engine.RenderFrame(frames[f % uniqueFrames]);
+                PassTimings const& timings = engine.GetTimings();
+                sum.sampleGeneration += timings.sampleGeneration;
+                sum.accumulation += timings.accumulation;
+                sum.worldHashTable += timings.worldHashTable;
+                sum.maintenance += timings.maintenance;
+                sum.finalVisualization += timings.finalVisualization;
+                sum.clearBuffers += timings.clearBuffers;
+            }
+            double const seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+            double const pixelsPerSecond = (pixelsPerFrame * options.frames) / seconds;
+            double const frameCount = double(options.frames);
+            std::printf("%8u %12.2f %14.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", engine.GetThreadCount(),
+                pixelsPerSecond * 1e-6, (pixelsPerSecond / engine.GetThreadCount()) * 1e-6,
+                sum.sampleGeneration / frameCount, sum.accumulation / frameCount, sum.worldHashTable / frameCount, sum.maintenance / frameCount,
+                sum.finalVisualization / frameCount, sum.clearBuffers / frameCount);
+
+            WorldHashTable const& worldHashTable = engine.GetWorldHashTable();
+            std::printf("%8s world hash table: %u entries, %u slots, occupancy %.3f, %llu evicted\n", "", worldHashTable.GetSize(),
+                worldHashTable.GetCapacity(), worldHashTable.GetOccupancy(), static_cast<unsigned long long>(worldHashTable.GetEvictedCount()));
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,106 @@
+//CPU ray tracing of the AO input (AmbientOcclusionTracer) on --model or the synthetic model: the BLAS/TLAS build, the primary
+//rays of the depth/normal buffers and the AO rays per SIMD width. The AO of the packets is compared against the scalar
+//traversal: whether a pixel is occluded has to agree, the occlusion value may differ because any hit stops at the first
+//hit found, which depends on the visiting order.
+#include "Benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    int RayTracingBenchmark(BenchmarkOptions const& options)
+    {
+        H3DModel model;
+        Clock::time_point start = Clock::now();
+        if (!GetBenchmarkModel(options, model))
+        {
+            std::printf("Failed to load model %s\n", options.modelFile.c_str());
+            return 1;
+        }
+        double const loadMilliseconds = MillisecondsSince(start);
+
+        TriangleMesh mesh;
+        if (!GetTriangleMesh(model, mesh))
+        {
+            std::printf("Model %s has indices past the vertices of their mesh\n", options.modelFile.c_str());
+            return 1;
+        }
+        uint32_t const triangleCount = uint32_t(mesh.indices.size() / 3);
+        AccelerationStructure scene;
+        start = Clock::now();
+        {
+            ThreadPool threadPool;
+            scene.Build(mesh, threadPool);
+        }
+        double const buildMilliseconds = MillisecondsSince(start);
+
+        std::printf("raytracing: %s, %u meshes, %u triangles, %u frames, %ux%u\n", options.modelFile.empty() ? "synthetic model" : options.modelFile.c_str(),
+            model.header.meshCount, triangleCount, options.frames, options.screenWidth, options.screenHeight);
+        std::printf("load %.2f ms, BLAS/TLAS build %.2f ms (all threads), %u BLAS, %zu TLAS nodes, %.2f MB\n", loadMilliseconds, buildMilliseconds,
+            scene.GetMeshCount(), scene.GetTLASNodes().size(), double(scene.GetMemorySize()) / (1024.0 * 1024.0));
+        std::printf("%8s %8s %16s %14s %10s %10s %12s %10s\n", "threads", "simd", "primary Mrays/s", "AO Mrays/s", "speedup", "mean AO",
+            "same hits", "AO diff");
+
+        std::vector<SimdWidth> widths = { SimdWidth::Scalar };
+        if (GetMaxSimdWidth() >= SimdWidth::AVX2)
+            widths.push_back(SimdWidth::AVX2);
+        if (GetMaxSimdWidth() >= SimdWidth::AVX512)
+            widths.push_back(SimdWidth::AVX512);
+
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            ThreadPool threadPool(threadCount);
+            AmbientOcclusionTracer tracer(scene);
+            std::vector<double> aoMilliseconds(widths.size(), 0.0);
+            std::vector<double> aoSums(widths.size(), 0.0);
+            std::vector<uint64_t> sameHits(widths.size(), 0);
+            std::vector<double> aoDifferences(widths.size(), 0.0);
+            double primaryMilliseconds = 0.0;
+            uint64_t primaryRays = 0;
+            uint64_t aoRays = 0;
+
+            FrameData frame;
+            std::vector<float> scalarAO;
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                start = Clock::now();
+                tracer.TraceGBuffer(GetBenchmarkCamera(options, model, f), options.screenWidth, options.screenHeight, threadPool, frame);
+                primaryMilliseconds += MillisecondsSince(start);
+                primaryRays += tracer.GetPrimaryRayCount();
+
+                for (size_t w = 0; w < widths.size(); ++w)
+                {
+                    start = Clock::now();
+                    tracer.TraceAmbientOcclusion(f, widths[w], threadPool, frame);
+                    aoMilliseconds[w] += MillisecondsSince(start);
+                    if (w == 0)
+                    {
+                        scalarAO = frame.ambientOcclusion;
+                        aoRays += tracer.GetAORayCount();
+                    }
+
+                    for (size_t i = 0; i < frame.depth.size(); ++i)
+                    {
+                        if (asint(frame.depth[i]) == 0)
+                            continue;
+                        aoSums[w] += frame.ambientOcclusion[i];
+                        sameHits[w] += ((frame.ambientOcclusion[i] < 1.f) == (scalarAO[i] < 1.f)) ? 1 : 0;
+                        aoDifferences[w] += std::fabs(double(frame.ambientOcclusion[i]) - double(scalarAO[i]));
+                    }
+                }
+            }
+
+            double const rays = double(std::max<uint64_t>(aoRays, 1));
+            for (size_t w = 0; w < widths.size(); ++w)
+            {
+                std::printf("%8u %8s %16.2f %14.2f %9.2fx %10.4f %11.4f%% %10.6f\n", threadPool.GetThreadCount(), GetSimdWidthName(widths[w]),
+                    double(primaryRays) / (primaryMilliseconds * 1000.0), double(aoRays) / (aoMilliseconds[w] * 1000.0),
+                    aoMilliseconds[0] / aoMilliseconds[w], aoSums[w] / rays, (100.0 * double(sameHits[w])) / rays, aoDifferences[w] / rays);
+            }
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
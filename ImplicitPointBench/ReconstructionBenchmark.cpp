@@ -0,0 +1,90 @@
+//FinalVisualizationPass at the frame resolution with and without the per thread neighbour voxel cache (EngineSettings::neighbourVoxelCacheSize)
+//for a range of cache sizes. Reports Mpixels/s, the world hash table lookups per pixel and checks that the visualization
+//buffer is bit-identical to the uncached reconstruction. Deterministic accumulation, so every engine has the same table.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    int ReconstructionBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        uint32_t const cacheSizes[] = { 0, 256, 1024, 4096, 16384 }; //0 = reference
+        uint32_t const cacheSizeCount = sizeof(cacheSizes) / sizeof(cacheSizes[0]);
+        double const pixelsPerFrame = double(frames[0].width) * double(frames[0].height);
+        std::printf("reconstruction: %u frames, connectivity %u, lod mode %u, %ux%u\n", options.frames, options.voxelConnectivity,
+            uint32_t(options.lodMode), frames[0].width, frames[0].height);
+        std::printf("%8s %8s %12s %12s %10s %12s %12s %12s\n", "threads", "cache", "final ms", "Mpixels/s", "speedup", "hit rate", "lookups/px",
+            "mismatches");
+
+        int result = 0;
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            std::vector<std::unique_ptr<Engine>> engines;
+            for (uint32_t cacheSize : cacheSizes)
+            {
+                EngineSettings settings;
+                settings.threadCount = threadCount;
+                settings.screenWidth = frames[0].width;
+                settings.screenHeight = frames[0].height;
+                settings.voxelConnectivity = options.voxelConnectivity;
+                settings.lodMode = options.lodMode;
+                settings.accumulationMode = AccumulationMode::Deterministic;
+                settings.neighbourVoxelCacheSize = cacheSize;
+                engines.emplace_back(new Engine(settings));
+            }
+
+            double milliseconds[cacheSizeCount] = {};
+            uint64_t hits[cacheSizeCount] = {};
+            uint64_t misses[cacheSizeCount] = {};
+            uint64_t mismatches[cacheSizeCount] = {};
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                FrameData const& frame = frames[f % uniqueFrames];
+                for (uint32_t c = 0; c < cacheSizeCount; ++c)
+                {
+                    Engine& engine = *engines[c];
+                    engine.RenderFrame(frame);
+                    milliseconds[c] += engine.GetTimings().finalVisualization;
+                    hits[c] += engine.GetNeighbourVoxelCacheHitCount();
+                    misses[c] += engine.GetNeighbourVoxelCacheMissCount();
+
+                    std::vector<float> const& reference = engines[0]->GetVisualizationBuffer();
+                    std::vector<float> const& visualization = engine.GetVisualizationBuffer();
+                    for (size_t i = 0; i < visualization.size(); ++i)
+                        mismatches[c] += std::memcmp(&visualization[i], &reference[i], sizeof(float)) != 0 ? 1 : 0;
+                }
+            }
+
+            //Every cached engine gathers the same voxels, the reference looks up all 8 points of each of them
+            double const frameCount = double(options.frames);
+            double const gathersPerPixel = double(hits[1] + misses[1]) / (pixelsPerFrame * frameCount);
+            for (uint32_t c = 0; c < cacheSizeCount; ++c)
+            {
+                double const lookupsPerPixel = c == 0 ? gathersPerPixel * 8.0 : (double(misses[c]) * 8.0) / (pixelsPerFrame * frameCount);
+                double const hitRate = c == 0 ? 0.0 : double(hits[c]) / double(std::max<uint64_t>(hits[c] + misses[c], 1));
+                std::printf("%8u %8u %12.2f %12.2f %9.2fx %11.1f%% %12.2f %12llu\n", engines[c]->GetThreadCount(), cacheSizes[c],
+                    milliseconds[c] / frameCount, ((pixelsPerFrame * frameCount) / (milliseconds[c] * 1e-3)) * 1e-6, milliseconds[0] / milliseconds[c],
+                    hitRate * 100.0, lookupsPerPixel, static_cast<unsigned long long>(mismatches[c]));
+                result = mismatches[c] == 0 ? result : 1;
+            }
+        }
+        return result;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,228 @@
+//Moving geometry in the two level acceleration structure of --model or the synthetic model: every mesh but the largest one (the
+//static environment) turns and bobs as an instance, and its vertices drift apart in chunks a little further every frame. Per
+//frame the structure is updated three ways, for the same animation: refit only (instances: the TLAS part of it), refit with
+//a rebuild once the SAH cost grew past DefaultMaxCostIncrease (UpdateMesh/UpdateTLAS), and a rebuild of the animated BLAS
+//and the TLAS. A full Build is timed as reference. The AO rays of the last frame show what the refit trees cost in tracing.
+#include "Benchmark.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const VerticesPerChunk = 64;
+
+        struct AnimatedMesh
+        {
+            uint32_t mesh;
+            uint32_t firstVertex;
+            uint32_t vertexCount;
+            float3 center;
+            float size; //Diagonal of the bounds
+        };
+
+        //Turning around the mesh center and bobbing up and down
+        float4x4 GetInstanceTransform(AnimatedMesh const& animated, uint32_t frameIndex)
+        {
+            float const angle = 0.02f * float(frameIndex);
+            float const c = std::cos(angle);
+            float const s = std::sin(angle);
+            float3 const offset = { 0.f, std::sin(0.3f * float(frameIndex)) * 0.05f * animated.size, 0.f };
+
+            //T(center + offset) * R * T(-center)
+            float4x4 transform = Identity();
+            transform.m[0][0] = c;  transform.m[0][2] = s;
+            transform.m[2][0] = -s; transform.m[2][2] = c;
+            float3 const rotatedCenter = TransformVector(transform, animated.center);
+            float3 const translation = animated.center + offset - rotatedCenter;
+            transform.m[0][3] = translation.x;
+            transform.m[1][3] = translation.y;
+            transform.m[2][3] = translation.z;
+            return transform;
+        }
+
+        //Chunks of consecutive vertices drift apart in random directions, 0.5% of the mesh size per frame
+        void AnimateVertices(AnimatedMesh const& animated, std::vector<float3> const& restPositions, uint32_t frameIndex, std::vector<float3>& positions)
+        {
+            float const distance = 0.005f * animated.size * float(frameIndex);
+            for (uint32_t v = 0; v < animated.vertexCount; ++v)
+            {
+                uint32_t randSeed = InitRand(v / VerticesPerChunk, animated.mesh);
+                float3 const direction = { 2.f * NextRand(randSeed) - 1.f, 2.f * NextRand(randSeed) - 1.f, 2.f * NextRand(randSeed) - 1.f };
+                uint32_t const vertex = animated.firstVertex + v;
+                positions[vertex] = restPositions[vertex] + direction * distance;
+            }
+        }
+    }
+
+    int RefitBenchmark(BenchmarkOptions const& options)
+    {
+        H3DModel model;
+        if (!GetBenchmarkModel(options, model))
+        {
+            std::printf("Failed to load model %s\n", options.modelFile.c_str());
+            return 1;
+        }
+
+        TriangleMesh mesh;
+        if (!GetTriangleMesh(model, mesh))
+        {
+            std::printf("Model %s has indices past the vertices of their mesh\n", options.modelFile.c_str());
+            return 1;
+        }
+        std::vector<float3> const restPositions = mesh.positions;
+        uint32_t const meshCount = uint32_t(model.meshes.size());
+
+        uint32_t largestMesh = 0;
+        for (uint32_t m = 0; m < meshCount; ++m)
+        {
+            if (model.meshes[m].indexCount > model.meshes[largestMesh].indexCount)
+                largestMesh = m;
+        }
+
+        std::vector<AnimatedMesh> animatedMeshes;
+        uint32_t animatedTriangles = 0;
+        uint32_t firstVertex = 0;
+        for (uint32_t m = 0; m < meshCount; ++m)
+        {
+            H3DMesh const& h3dMesh = model.meshes[m];
+            if (m != largestMesh || meshCount == 1)
+            {
+                float3 const boundsMin = { h3dMesh.boundingBox.min.x, h3dMesh.boundingBox.min.y, h3dMesh.boundingBox.min.z };
+                float3 const boundsMax = { h3dMesh.boundingBox.max.x, h3dMesh.boundingBox.max.y, h3dMesh.boundingBox.max.z };
+                animatedMeshes.push_back(AnimatedMesh{ m, firstVertex, h3dMesh.vertexCount, (boundsMin + boundsMax) * 0.5f, length(boundsMax - boundsMin) });
+                animatedTriangles += mesh.meshFirstTriangle[m + 1] - mesh.meshFirstTriangle[m];
+            }
+            firstVertex += h3dMesh.vertexCount;
+        }
+
+        ThreadPool threadPool(GetThreadCounts(options).back());
+        AccelerationStructure refit;
+        AccelerationStructure updated;
+        AccelerationStructure rebuilt;
+        AccelerationStructure full;
+        //Build gives mesh m instance m
+        refit.Build(mesh, threadPool);
+        updated.Build(mesh, threadPool);
+        rebuilt.Build(mesh, threadPool);
+
+        std::printf("refit: %s, %u meshes, %zu animated (%u triangles), %u frames, %u threads, %ux%u\n",
+            options.modelFile.empty() ? "synthetic model" : options.modelFile.c_str(), meshCount, animatedMeshes.size(), animatedTriangles,
+            options.frames, threadPool.GetThreadCount(), options.screenWidth, options.screenHeight);
+        std::printf("%6s %12s %10s %10s %10s %12s %10s %12s %12s\n", "frame", "instances ms", "refit ms", "update ms", "rebuilds", "rebuild ms",
+            "full ms", "refit SAH", "update SAH");
+
+        double totals[5] = {};
+        double maxUpdateMilliseconds = 0.0;
+        uint32_t totalRebuilds = 0;
+        for (uint32_t f = 1; f <= options.frames; ++f)
+        {
+            for (AnimatedMesh const& animated : animatedMeshes)
+                AnimateVertices(animated, restPositions, f, mesh.positions);
+
+            //Refit only
+            Clock::time_point start = Clock::now();
+            threadPool.ParallelFor(uint32_t(animatedMeshes.size()), [&](uint32_t i, uint32_t /*threadIndex*/)
+            {
+                refit.RefitMesh(animatedMeshes[i].mesh);
+            });
+            Clock::time_point const instancesStart = Clock::now();
+            for (AnimatedMesh const& animated : animatedMeshes)
+                refit.SetInstanceTransform(animated.mesh, GetInstanceTransform(animated, f));
+            refit.RefitTLAS();
+            double const instancesMilliseconds = MillisecondsSince(instancesStart);
+            double const refitMilliseconds = MillisecondsSince(start);
+
+            //Refit, rebuilding what degraded too much
+            std::vector<uint8_t> meshRebuilt(animatedMeshes.size(), 0);
+            start = Clock::now();
+            threadPool.ParallelFor(uint32_t(animatedMeshes.size()), [&](uint32_t i, uint32_t /*threadIndex*/)
+            {
+                meshRebuilt[i] = updated.UpdateMesh(animatedMeshes[i].mesh) ? 1 : 0;
+            });
+            for (AnimatedMesh const& animated : animatedMeshes)
+                updated.SetInstanceTransform(animated.mesh, GetInstanceTransform(animated, f));
+            uint32_t const rebuilds = uint32_t(std::count(meshRebuilt.begin(), meshRebuilt.end(), uint8_t(1))) + (updated.UpdateTLAS() ? 1 : 0);
+            double const updateMilliseconds = MillisecondsSince(start);
+
+            //Rebuild of everything that moved
+            start = Clock::now();
+            threadPool.ParallelFor(uint32_t(animatedMeshes.size()), [&](uint32_t i, uint32_t /*threadIndex*/)
+            {
+                rebuilt.RebuildMesh(animatedMeshes[i].mesh);
+            });
+            for (AnimatedMesh const& animated : animatedMeshes)
+                rebuilt.SetInstanceTransform(animated.mesh, GetInstanceTransform(animated, f));
+            rebuilt.BuildTLAS();
+            double const rebuildMilliseconds = MillisecondsSince(start);
+
+            start = Clock::now();
+            full.Build(mesh, threadPool);
+            for (AnimatedMesh const& animated : animatedMeshes)
+                full.SetInstanceTransform(animated.mesh, GetInstanceTransform(animated, f));
+            full.BuildTLAS();
+            double const fullMilliseconds = MillisecondsSince(start);
+
+            //SAH cost of the animated BLAS relative to freshly built ones, weighted by triangles
+            double refitCost = 0.0;
+            double updatedCost = 0.0;
+            double rebuiltCost = 0.0;
+            for (AnimatedMesh const& animated : animatedMeshes)
+            {
+                double const triangles = double(mesh.meshFirstTriangle[animated.mesh + 1] - mesh.meshFirstTriangle[animated.mesh]);
+                refitCost += triangles * refit.GetMeshBVH(animated.mesh).GetSAHCost();
+                updatedCost += triangles * updated.GetMeshBVH(animated.mesh).GetSAHCost();
+                rebuiltCost += triangles * rebuilt.GetMeshBVH(animated.mesh).GetSAHCost();
+            }
+            rebuiltCost = std::max(rebuiltCost, DBL_MIN);
+
+            std::printf("%6u %12.4f %10.3f %10.3f %10u %12.3f %10.2f %11.3fx %11.3fx\n", f, instancesMilliseconds, refitMilliseconds, updateMilliseconds, rebuilds,
+                rebuildMilliseconds, fullMilliseconds, refitCost / rebuiltCost, updatedCost / rebuiltCost);
+            totals[0] += refitMilliseconds;
+            totals[1] += updateMilliseconds;
+            totals[2] += rebuildMilliseconds;
+            totals[3] += fullMilliseconds;
+            totals[4] += instancesMilliseconds;
+            maxUpdateMilliseconds = std::max(maxUpdateMilliseconds, updateMilliseconds);
+            totalRebuilds += rebuilds;
+        }
+
+        double const frames = double(options.frames);
+        std::printf("mean: instances %.4f ms, refit %.3f ms, update %.3f ms (max %.3f ms, %u rebuilds), rebuild %.3f ms, full build %.2f ms\n", totals[4] / frames, totals[0] / frames,
+            totals[1] / frames, maxUpdateMilliseconds, totalRebuilds, totals[2] / frames, totals[3] / frames);
+
+        //AO rays of the last frame through each structure, the occlusion itself has to agree
+        AccelerationStructure const* const structures[] = { &refit, &updated, &rebuilt };
+        char const* const names[] = { "refit", "update", "rebuild" };
+        AOCamera const camera = GetBenchmarkCamera(options, model, options.frames);
+        FrameData frame;
+        std::vector<double> milliseconds(3, 0.0);
+        std::vector<uint64_t> occluded(3, 0);
+        uint64_t rays = 0;
+        for (uint32_t s = 3; s-- > 0;)
+        {
+            AmbientOcclusionTracer tracer(*structures[s]);
+            tracer.TraceGBuffer(camera, options.screenWidth, options.screenHeight, threadPool, frame);
+            Clock::time_point const start = Clock::now();
+            tracer.TraceAmbientOcclusion(options.frames, GetMaxSimdWidth(), threadPool, frame);
+            milliseconds[s] = MillisecondsSince(start);
+            rays = tracer.GetAORayCount();
+            for (size_t i = 0; i < frame.depth.size(); ++i)
+            {
+                if (asint(frame.depth[i]) != 0 && frame.ambientOcclusion[i] < 1.f)
+                    ++occluded[s];
+            }
+        }
+        for (uint32_t s = 0; s < 3; ++s)
+        {
+            std::printf("%8s: AO %.2f Mrays/s, %.2f%% of the rays occluded\n", names[s], double(rays) / (milliseconds[s] * 1000.0),
+                (100.0 * double(occluded[s])) / double(std::max<uint64_t>(rays, 1)));
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,118 @@
+//Per frame latency of the world hash table while it grows. Every frame mimics the merge pass of a walkthrough: new points
+//are discovered and a larger set of known points is looked up and updated, followed by the maintenance step.
+//Runs once with incremental migration and once with the whole table migrated in the frame of the resize (stop-the-world).
+#include "Benchmark.h"
+#include "ResizableHashTable.h"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <random>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const NewKeysPerFrame = 262144;
+        uint32_t const UpdatesPerFrame = 1048576;
+        uint32_t const KeysPerJob = 4096;
+
+        struct RunResult
+        {
+            double worstFrame = 0.0;
+            double worstMaintenance = 0.0;
+            uint32_t lostKeys = 0;      //Lookups that missed a known key
+            uint32_t failedInserts = 0; //Inserts dropped at the probe bound, the only valid reason for a lost key
+        };
+
+        RunResult RunFrames(char const* name, ResizePolicy const& policy, uint32_t frameCount, ThreadPool& threadPool)
+        {
+            EvictionPolicy noEviction;
+            noEviction.maxAge = 0;
+            WorldHashTable table(policy, noEviction, 8388608);
+            std::mt19937 generator(42);
+            std::vector<uint32_t> knownKeys;
+            std::vector<uint32_t> frameKeys(NewKeysPerFrame + UpdatesPerFrame);
+            std::atomic<uint32_t> lost(0);
+            std::atomic<uint32_t> failed(0);
+
+            RunResult result;
+            double frameSum = 0.0;
+            for (uint32_t f = 0; f < frameCount; ++f)
+            {
+                //New keys first, then updates of random known keys
+                uint32_t const knownCount = uint32_t(knownKeys.size());
+                for (uint32_t i = 0; i < NewKeysPerFrame; ++i)
+                {
+                    do { frameKeys[i] = generator(); } while (frameKeys[i] == 0);
+                }
+                uint32_t const updateCount = knownCount > 0 ? UpdatesPerFrame : 0;
+                for (uint32_t i = 0; i < updateCount; ++i)
+                    frameKeys[NewKeysPerFrame + i] = knownKeys[generator() % knownCount];
+                uint32_t const keyCount = NewKeysPerFrame + updateCount;
+
+                Clock::time_point const start = Clock::now();
+                threadPool.ParallelFor((keyCount + KeysPerJob - 1) / KeysPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+                {
+                    uint32_t const end = std::min((job + 1) * KeysPerJob, keyCount);
+                    for (uint32_t i = job * KeysPerJob; i < end; ++i)
+                    {
+                        KeyData const cachedData = table.Lookup(frameKeys[i]);
+                        if (i >= NewKeysPerFrame && cachedData.key == 0)
+                            lost.fetch_add(1, std::memory_order_relaxed);
+                        if (!table.Insert(frameKeys[i], cachedData.value + 1, cachedData.count + 1))
+                            failed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+                double const mergeMs = MillisecondsSince(start);
+
+                Clock::time_point const maintenanceStart = Clock::now();
+                table.Maintain(threadPool);
+                double const maintenanceMs = MillisecondsSince(maintenanceStart);
+
+                double const frameMs = mergeMs + maintenanceMs;
+                result.worstFrame = std::max(result.worstFrame, frameMs);
+                result.worstMaintenance = std::max(result.worstMaintenance, maintenanceMs);
+                frameSum += frameMs;
+                std::printf("%14s %6u %10.2f %10.2f %10.2f %10u %10u %10.1f %9.0f%%\n", name, f, mergeMs, maintenanceMs, frameMs,
+                    table.GetSize(), table.GetCapacity(), double(table.GetMemoryUsage()) / (1024.0 * 1024.0),
+                    table.IsMigrating() ? table.GetMigrationProgress() * 100.0 : 100.0);
+
+                knownKeys.insert(knownKeys.end(), frameKeys.begin(), frameKeys.begin() + NewKeysPerFrame);
+            }
+
+            result.lostKeys = lost.load();
+            result.failedInserts = failed.load();
+            std::printf("%14s worst frame %.2f ms, worst maintenance %.2f ms, average frame %.2f ms, %u resizes, %u failed inserts\n\n", name,
+                result.worstFrame, result.worstMaintenance, frameSum / std::max(frameCount, 1u), table.GetResizeCount(), result.failedInserts);
+            return result;
+        }
+    }
+
+    int ResizeBenchmark(BenchmarkOptions const& options)
+    {
+        std::vector<uint32_t> const threadCounts = GetThreadCounts(options);
+        ThreadPool threadPool(threadCounts.back());
+
+        std::printf("resize: %u new keys + %u updates per frame, %u frames, %u threads\n", NewKeysPerFrame, UpdatesPerFrame,
+            options.frames, threadPool.GetThreadCount());
+        std::printf("%14s %6s %10s %10s %10s %10s %10s %10s %10s\n", "migration", "frame", "merge ms", "maint ms", "frame ms",
+            "size", "capacity", "MB", "migrated");
+
+        ResizePolicy incremental;
+        ResizePolicy stopTheWorld;
+        stopTheWorld.migrationSlotsPerStep = std::numeric_limits<uint32_t>::max();
+
+        RunResult const incrementalResult = RunFrames("incremental", incremental, options.frames, threadPool);
+        RunResult const stopTheWorldResult = RunFrames("stop-the-world", stopTheWorld, options.frames, threadPool);
+        std::printf("worst frame: incremental %.2f ms, stop-the-world %.2f ms\n", incrementalResult.worstFrame, stopTheWorldResult.worstFrame);
+        std::printf("worst maintenance: incremental %.2f ms, stop-the-world %.2f ms\n", incrementalResult.worstMaintenance, stopTheWorldResult.worstMaintenance);
+
+        //Known keys must stay visible during a migration
+        bool const valid = incrementalResult.lostKeys <= incrementalResult.failedInserts && stopTheWorldResult.lostKeys <= stopTheWorldResult.failedInserts;
+        if (!valid)
+            std::printf("Lost keys: incremental %u, stop-the-world %u\n", incrementalResult.lostKeys, stopTheWorldResult.lostKeys);
+        return valid ? 0 : 1;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,91 @@
+//Microbenchmark of GetGeneratedSample: scalar reference vs the AVX2/AVX-512 batch kernels for every voxel connectivity,
+//single threaded, on world positions reconstructed from the benchmark frame. Also verifies the kernels are bit-exact.
+#include "Benchmark.h"
+#include "Engine.h"
+#include "SampleGenerationBatch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        //Bitwise comparison, so -0/+0 and NaN payload differences count as well
+        uint32_t CountMismatches(std::vector<ClosestPointSample> const& a, std::vector<ClosestPointSample> const& b)
+        {
+            uint32_t mismatches = 0;
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (a[i].seed != b[i].seed || std::memcmp(&a[i].sample, &b[i].sample, sizeof(float3)) != 0)
+                    ++mismatches;
+            }
+            return mismatches;
+        }
+    }
+
+    int SampleGenerationBenchmark(BenchmarkOptions const& options)
+    {
+        FrameData frame;
+        if (!GetBenchmarkFrame(options, 0, frame))
+        {
+            std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+            return 1;
+        }
+
+        //Every 16th pixel with geometry, and levels cycling through all LODs so each lane mix gets exercised
+        EngineSettings const settings;
+        std::vector<float3> positions;
+        std::vector<uint32_t> levels;
+        uint2 const screenDimensions = { frame.width, frame.height };
+        for (uint32_t index = 0; index < frame.width * frame.height; index += 16)
+        {
+            if (asint(frame.depth[index]) == 0)
+                continue;
+            uint2 const index2D = { index % frame.width, index / frame.width };
+            positions.push_back(DepthToWorldPosition(frame.depth[index], index2D, screenDimensions, frame.viewProjectionInverse).xyz());
+            levels.push_back(uint32_t(positions.size()) % (settings.maxLevels + 1));
+        }
+        uint32_t const count = uint32_t(positions.size());
+
+        std::vector<SimdWidth> widths = { SimdWidth::Scalar };
+        if (SupportsAVX2())
+            widths.push_back(SimdWidth::AVX2);
+        if (SupportsAVX512())
+            widths.push_back(SimdWidth::AVX512);
+
+        std::printf("samplegen: %u positions, %u repetitions, single thread\n", count, options.frames);
+        std::printf("%13s %8s %14s %9s %11s\n", "connectivity", "kernel", "Msamples/s", "speedup", "mismatches");
+
+        uint32_t const connectivities[] = { 0, 6, 18, 26 };
+        int result = 0;
+        for (uint32_t voxelConnectivity : connectivities)
+        {
+            std::vector<ClosestPointSample> reference(count);
+            double scalarSeconds = 0.0;
+            for (SimdWidth width : widths)
+            {
+                std::vector<ClosestPointSample> samples(count);
+                std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+                for (uint32_t r = 0; r < options.frames; ++r)
+                    GetGeneratedSampleBatch(positions.data(), levels.data(), count, settings.cellSize, voxelConnectivity, settings.maxLevels, samples.data(), width);
+                double const seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+                if (width == SimdWidth::Scalar)
+                {
+                    reference = samples;
+                    scalarSeconds = seconds;
+                }
+                uint32_t const mismatches = CountMismatches(reference, samples);
+                if (mismatches != 0)
+                    result = 1;
+
+                std::printf("%13u %8s %14.2f %8.2fx %11u\n", voxelConnectivity, GetSimdWidthName(width),
+                    (double(count) * options.frames / seconds) * 1e-6, scalarSeconds / seconds, mismatches);
+            }
+        }
+        return result;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,121 @@
+//Quarter and checkerboard sample generation (EngineSettings::samplePattern) against every pixel every frame: the time of the
+//sample generation and accumulation passes, and the convergence of the full resolution reconstruction over the frames.
+//The ray traced AO of the demo is a single noisy ray per pixel, so every pixel of a frame gets a 0/1 AO with the frame's AO
+//as probability. The error is measured against an engine that accumulates the noise free AO on every pixel.
+#include "Benchmark.h"
+#include "Engine.h"
+#include "HashFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        SamplePattern const Patterns[] = { SamplePattern::Full, SamplePattern::Quarter, SamplePattern::Checkerboard };
+        char const* const PatternNames[] = { "full", "quarter", "checkerboard" };
+        uint32_t const PatternCount = sizeof(Patterns) / sizeof(Patterns[0]);
+
+        //One AO ray per pixel: occluded or not, with the AO of the frame as the chance of not being occluded
+        void CreateNoisyAmbientOcclusion(FrameData const& frame, uint32_t frameIndex, FrameData& noisyFrame)
+        {
+            noisyFrame = frame;
+            uint32_t const frameSeed = pcg(frameIndex);
+            for (uint32_t i = 0; i < uint32_t(frame.ambientOcclusion.size()); ++i)
+            {
+                float const random = float(pcg(i ^ frameSeed) >> 8) * (1.f / 16777216.f);
+                noisyFrame.ambientOcclusion[i] = random < frame.ambientOcclusion[i] ? 1.f : 0.f;
+            }
+        }
+    }
+
+    int SamplePatternBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        //Only the rendered pixels count for the error
+        std::vector<uint32_t> renderedPixels(uniqueFrames, 0);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+            renderedPixels[i] = uint32_t(std::count_if(frames[i].depth.begin(), frames[i].depth.end(), [](float depth) { return asint(depth) != 0; }));
+
+        //Convergence doesn't depend on the thread count, the timings are taken with the largest one
+        EngineSettings settings;
+        settings.threadCount = GetThreadCounts(options).back();
+        settings.screenWidth = frames[0].width;
+        settings.screenHeight = frames[0].height;
+        settings.voxelConnectivity = options.voxelConnectivity;
+        settings.lodMode = options.lodMode;
+        settings.accumulationMode = AccumulationMode::Deterministic;
+        Engine reference(settings);
+
+        std::vector<std::unique_ptr<Engine>> engines;
+        for (SamplePattern pattern : Patterns)
+        {
+            settings.samplePattern = pattern;
+            engines.emplace_back(new Engine(settings));
+        }
+
+        std::printf("samplepattern: %u frames, %u threads, connectivity %u, lod mode %u\n", options.frames, reference.GetThreadCount(),
+            options.voxelConnectivity, uint32_t(options.lodMode));
+        std::printf("%8s", "frame");
+        for (char const* name : PatternNames)
+            std::printf(" %14s", name);
+        std::printf("   (mean error)\n");
+
+        PassTimings timings[PatternCount] = {};
+        FrameData noisyFrame;
+        for (uint32_t f = 0; f < options.frames; ++f)
+        {
+            FrameData const& frame = frames[f % uniqueFrames];
+            reference.RenderFrame(frame);
+            CreateNoisyAmbientOcclusion(frame, f, noisyFrame);
+
+            std::printf("%8u", f);
+            std::vector<float> const& referenceVisualization = reference.GetVisualizationBuffer();
+            for (uint32_t p = 0; p < PatternCount; ++p)
+            {
+                Engine& engine = *engines[p];
+                engine.RenderFrame(noisyFrame);
+
+                PassTimings const& frameTimings = engine.GetTimings();
+                timings[p].sampleGeneration += frameTimings.sampleGeneration;
+                timings[p].accumulation += frameTimings.accumulation;
+                timings[p].worldHashTable += frameTimings.worldHashTable;
+                timings[p].finalVisualization += frameTimings.finalVisualization;
+                timings[p].total += frameTimings.total;
+
+                double errorSum = 0.0;
+                std::vector<float> const& visualization = engine.GetVisualizationBuffer();
+                for (size_t i = 0; i < visualization.size(); ++i)
+                    errorSum += std::fabs(double(visualization[i]) - double(referenceVisualization[i]));
+                std::printf(" %14.6f", errorSum / double(std::max(renderedPixels[f % uniqueFrames], 1u)));
+            }
+            std::printf("\n");
+        }
+
+        double const frameCount = double(options.frames);
+        std::printf("\n%14s %12s %12s %12s %12s %12s %12s\n", "pattern", "samplegen ms", "accum ms", "world ms", "final ms", "total ms", "gen+acc");
+        for (uint32_t p = 0; p < PatternCount; ++p)
+        {
+            double const generationAndAccumulation = timings[p].sampleGeneration + timings[p].accumulation;
+            double const fullGenerationAndAccumulation = timings[0].sampleGeneration + timings[0].accumulation;
+            std::printf("%14s %12.2f %12.2f %12.2f %12.2f %12.2f %11.2fx\n", PatternNames[p], timings[p].sampleGeneration / frameCount,
+                timings[p].accumulation / frameCount, timings[p].worldHashTable / frameCount, timings[p].finalVisualization / frameCount,
+                timings[p].total / frameCount, fullGenerationAndAccumulation / generationAndAccumulation);
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
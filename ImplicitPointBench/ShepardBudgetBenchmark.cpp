@@ -0,0 +1,111 @@
+//MinMaxLOD reconstruction with an early-out weight and a point budget per pixel (EngineSettings::reconstructionBudget) against
+//gathering every level. Reports the implicit points and world hash table lookups per pixel, the final pass time and the error
+//against the unbounded reconstruction. Deterministic accumulation, so every engine has the same table.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        struct BudgetVariant
+        {
+            char const* name;
+            ReconstructionBudget budget;
+        };
+
+        BudgetVariant const Variants[] =
+        {
+            { "all levels", { 0.f, 0 } },
+            { "weight 1", { 1.f, 0 } },
+            { "weight 4", { 4.f, 0 } },
+            { "weight 16", { 16.f, 0 } },
+            { "points 108", { 0.f, 108 } },
+            { "points 216", { 0.f, 216 } },
+            { "points 432", { 0.f, 432 } },
+            { "weight 4+432", { 4.f, 432 } }
+        };
+        uint32_t const VariantCount = sizeof(Variants) / sizeof(Variants[0]);
+    }
+
+    int ShepardBudgetBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        double const pixelsPerFrame = double(frames[0].width) * double(frames[0].height);
+        std::printf("shepardbudget: %u frames, connectivity %u, MinMaxLOD\n", options.frames, options.voxelConnectivity);
+        std::printf("%8s %14s %12s %10s %12s %12s %12s %12s\n", "threads", "budget", "final ms", "speedup", "points/px", "lookups/px",
+            "mean error", "max error");
+
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            std::vector<std::unique_ptr<Engine>> engines;
+            for (BudgetVariant const& variant : Variants)
+            {
+                EngineSettings settings;
+                settings.threadCount = threadCount;
+                settings.screenWidth = frames[0].width;
+                settings.screenHeight = frames[0].height;
+                settings.voxelConnectivity = options.voxelConnectivity;
+                settings.lodMode = LODMode::MinMaxLOD;
+                settings.accumulationMode = AccumulationMode::Deterministic;
+                settings.reconstructionBudget = variant.budget;
+                engines.emplace_back(new Engine(settings));
+            }
+
+            //The voxel cache counts every gathered voxel, hit or miss
+            double milliseconds[VariantCount] = {};
+            uint64_t voxels[VariantCount] = {};
+            uint64_t misses[VariantCount] = {};
+            double errorSums[VariantCount] = {};
+            double maxErrors[VariantCount] = {};
+            uint64_t comparedPixels = 0;
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                FrameData const& frame = frames[f % uniqueFrames];
+                for (uint32_t v = 0; v < VariantCount; ++v)
+                {
+                    Engine& engine = *engines[v];
+                    engine.RenderFrame(frame);
+                    milliseconds[v] += engine.GetTimings().finalVisualization;
+                    voxels[v] += engine.GetNeighbourVoxelCacheHitCount() + engine.GetNeighbourVoxelCacheMissCount();
+                    misses[v] += engine.GetNeighbourVoxelCacheMissCount();
+
+                    std::vector<float> const& reference = engines[0]->GetVisualizationBuffer();
+                    std::vector<float> const& visualization = engine.GetVisualizationBuffer();
+                    for (size_t i = 0; i < visualization.size(); ++i)
+                    {
+                        double const error = std::fabs(double(visualization[i]) - double(reference[i]));
+                        errorSums[v] += error;
+                        maxErrors[v] = std::max(maxErrors[v], error);
+                    }
+                }
+                comparedPixels += engines[0]->GetVisualizationBuffer().size();
+            }
+
+            double const frameCount = double(options.frames);
+            for (uint32_t v = 0; v < VariantCount; ++v)
+            {
+                std::printf("%8u %14s %12.2f %9.2fx %12.2f %12.2f %12.6f %12.6f\n", engines[v]->GetThreadCount(), Variants[v].name,
+                    milliseconds[v] / frameCount, milliseconds[0] / milliseconds[v], (double(voxels[v]) * 8.0) / (pixelsPerFrame * frameCount),
+                    (double(misses[v]) * 8.0) / (pixelsPerFrame * frameCount), errorSums[v] / double(comparedPixels), maxErrors[v]);
+            }
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
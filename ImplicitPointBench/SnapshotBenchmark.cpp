@@ -0,0 +1,139 @@
+//Save and load throughput of world hash table snapshots: synchronous and asynchronous save, mmap warm start vs reading
+//the whole file, with the time until the first lookup can be answered. The file was just written, so loads are served
+//from the OS page cache; run with a cold cache for disk numbers.
+#include "Benchmark.h"
+#include "Engine.h"
+#include "HashTableSnapshot.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        char const* const SnapshotFilename = "ImplicitPointBench_snapshot.iph";
+
+        double SecondsSince(Clock::time_point const& start)
+        {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        double GigabytesPerSecond(uint64_t bytes, double seconds)
+        {
+            return (double(bytes) / seconds) * 1e-9;
+        }
+
+        //What a world table slot hands back for an insert: exact in KeyDataSlot, rounded in CompactKeyDataSlot
+        KeyData GetStoredKeyData(uint32_t key, uint32_t value, uint32_t count)
+        {
+            WorldHashTable::Table::SlotType slot;
+            slot.key.store(key, std::memory_order_relaxed);
+            slot.Store(value, count);
+            return slot.Load();
+        }
+    }
+
+    int SnapshotBenchmark(BenchmarkOptions const& options)
+    {
+        EngineSettings const settings;
+        SnapshotSettings const snapshotSettings = { settings.hashTableConstants, settings.cellSize, settings.maxLevels };
+        uint32_t const entryCount = 3000000;
+
+        //A table the size of the fixed GPU one, filled to the load of a large scene
+        ResizePolicy policy;
+        policy.initialCapacity = settings.hashTableConstants.worldHashTableElementCount;
+        policy.minInsertHeadroom = 0;
+        EvictionPolicy eviction;
+        WorldHashTable table(policy, eviction, settings.hashTableConstants.worldHashTableElementCount);
+
+        //Multiplying by an odd constant is a bijection, so the keys are unique and spread over the table
+        std::vector<uint32_t> keys(entryCount);
+        for (uint32_t i = 0; i < entryCount; ++i)
+        {
+            keys[i] = (i + 1) * 2654435761u;
+            table.Insert(keys[i], keys[i] ^ 0x5bd1e995, i);
+        }
+
+        std::printf("snapshot: %u entries, %u slots\n", table.GetSize(), table.GetCapacity());
+        std::printf("%-26s %12s %10s\n", "operation", "ms", "GB/s");
+
+        //Save: blocking, then asynchronous where only the copy of the slots blocks the caller
+        Clock::time_point start = Clock::now();
+        if (!SaveSnapshot(SnapshotFilename, table, snapshotSettings))
+        {
+            std::printf("Failed to save %s\n", SnapshotFilename);
+            return 1;
+        }
+        double const saveSeconds = SecondsSince(start);
+
+        start = Clock::now();
+        std::future<bool> asyncSave = SaveSnapshotAsync(SnapshotFilename, table, snapshotSettings);
+        double const asyncBlockingSeconds = SecondsSince(start);
+        bool const asyncSaved = asyncSave.get();
+        double const asyncTotalSeconds = SecondsSince(start);
+
+        //Mapped: lookups can start as soon as the header is validated
+        HashTableSnapshot snapshot;
+        start = Clock::now();
+        if (!asyncSaved || !snapshot.Open(SnapshotFilename))
+        {
+            std::printf("Failed to open %s\n", SnapshotFilename);
+            return 1;
+        }
+        KeyData const firstMapped = snapshot.GetTable().Lookup(keys[0]);
+        double const mappedFirstLookupSeconds = SecondsSince(start);
+        uint64_t const fileSize = snapshot.GetFileSize();
+
+        //Touch every slot once, this is what a warm start migration reads over the following frames
+        start = Clock::now();
+        uint64_t checksum = 0;
+        WorldHashTable::Table const& mappedTable = snapshot.GetTable();
+        for (uint32_t slotID = 0; slotID < mappedTable.GetCapacity(); ++slotID)
+            checksum += mappedTable.LookupBySlotID(slotID).value;
+        double const mappedScanSeconds = SecondsSince(start);
+
+        //Read: the whole file has to be in memory before the first lookup
+        start = Clock::now();
+        std::vector<uint8_t> fileData(static_cast<size_t>(fileSize));
+        FILE* file = std::fopen(SnapshotFilename, "rb");
+        size_t const bytesRead = file ? std::fread(fileData.data(), 1, fileData.size(), file) : 0;
+        if (file)
+            std::fclose(file);
+        double const readSeconds = SecondsSince(start);
+
+        std::printf("%-26s %12.2f %10.2f\n", "save", saveSeconds * 1e3, GigabytesPerSecond(fileSize, saveSeconds));
+        std::printf("%-26s %12.2f %10s\n", "async save (blocking)", asyncBlockingSeconds * 1e3, "");
+        std::printf("%-26s %12.2f %10.2f\n", "async save (total)", asyncTotalSeconds * 1e3, GigabytesPerSecond(fileSize, asyncTotalSeconds));
+        std::printf("%-26s %12.3f %10s\n", "mmap first lookup", mappedFirstLookupSeconds * 1e3, "");
+        std::printf("%-26s %12.2f %10.2f\n", "mmap scan all slots", mappedScanSeconds * 1e3, GigabytesPerSecond(fileSize, mappedScanSeconds));
+        std::printf("%-26s %12.2f %10.2f\n", "read whole file", readSeconds * 1e3, GigabytesPerSecond(fileSize, readSeconds));
+
+        //Warm start a fresh table and check every entry made it, before and after the migration out of the mapping
+        WorldHashTable warmTable(ResizePolicy(), eviction, settings.hashTableConstants.worldHashTableElementCount);
+        bool valid = bytesRead == fileSize && firstMapped.key == keys[0] && checksum != 0
+            && WarmStartFromSnapshot(SnapshotFilename, warmTable, snapshotSettings);
+        ThreadPool threadPool(GetThreadCounts(options).back());
+        for (uint32_t pass = 0; pass < 2 && valid; ++pass)
+        {
+            for (uint32_t i = 0; i < entryCount; ++i)
+            {
+                KeyData const data = warmTable.Lookup(keys[i]);
+                KeyData const expected = GetStoredKeyData(keys[i], keys[i] ^ 0x5bd1e995, i);
+                if (data.key != keys[i] || data.value != expected.value || data.count != expected.count)
+                {
+                    valid = false;
+                    break;
+                }
+            }
+            warmTable.FinishMigration(threadPool);
+        }
+        std::printf("warm start %s, %u entries, %s\n", valid ? "valid" : "INVALID", warmTable.GetSize(),
+            warmTable.IsMigrating() ? "migrating" : "migrated");
+
+        std::remove(SnapshotFilename);
+        return valid ? 0 : 1;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,149 @@
+//Sort based accumulation (AccumulationMode::Sort) against the hash table path, with and without per-tile aggregation.
+//Times the accumulation and world hash table passes together, the radix sort on its own, and checks that both modes
+//leave the same entries in the world hash table.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        struct AccumulationVariant
+        {
+            char const* name;
+            AccumulationMode mode;
+            bool tileAggregation;
+        };
+
+        AccumulationVariant const Variants[] =
+        {
+            { "hash", AccumulationMode::HashTable, false },
+            { "hash+tile", AccumulationMode::HashTable, true },
+            { "sort", AccumulationMode::Sort, false }
+        };
+        uint32_t const VariantCount = sizeof(Variants) / sizeof(Variants[0]);
+
+        double RadixSortMillisecondsPerSort(uint32_t elementCount, uint32_t repetitions, ThreadPool& threadPool)
+        {
+            std::mt19937_64 generator(5);
+            std::vector<uint64_t> source(elementCount);
+            for (uint64_t& element : source)
+                element = generator();
+            std::vector<uint64_t> elements(elementCount);
+            std::vector<uint64_t> scratch(elementCount);
+
+            RadixSorter sorter;
+            double milliseconds = 0.0;
+            for (uint32_t r = 0; r < repetitions; ++r)
+            {
+                elements = source;
+                std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+                sorter.Sort(elements.data(), scratch.data(), elementCount, 32, threadPool);
+                milliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            }
+            return milliseconds / double(repetitions);
+        }
+    }
+
+    int SortAccumulationBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        //Two pairs per pixel is the most a frame can emit
+        uint32_t const sortElementCount = frames[0].width * frames[0].height * 2;
+        std::printf("sortaccumulation: %u frames, connectivity %u\n", options.frames, options.voxelConnectivity);
+        std::printf("%8s %12s %12s %12s %12s %14s\n", "threads", "mode", "accum ms", "merge ms", "total ms", "updates/frame");
+
+        int result = 0;
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            std::vector<std::unique_ptr<Engine>> engines;
+            for (AccumulationVariant const& variant : Variants)
+            {
+                EngineSettings settings;
+                settings.threadCount = threadCount;
+                settings.screenWidth = frames[0].width;
+                settings.screenHeight = frames[0].height;
+                settings.voxelConnectivity = options.voxelConnectivity;
+                settings.lodMode = options.lodMode;
+                settings.accumulationMode = variant.mode;
+                settings.tileAggregation = variant.tileAggregation;
+                engines.emplace_back(new Engine(settings));
+            }
+
+            PassTimings sums[VariantCount];
+            uint64_t updateCounts[VariantCount] = {};
+            uint64_t mismatches = 0;
+            uint64_t comparedKeys = 0;
+            for (uint32_t f = 0; f < options.frames; ++f)
+            {
+                FrameData const& frame = frames[f % uniqueFrames];
+                for (uint32_t v = 0; v < VariantCount; ++v)
+                {
+                    Engine& engine = *engines[v];
+                    engine.SampleGenerationPass(frame);
+                    engine.AccumulationPass(frame);
+                    engine.WorldHashTablePass();
+                    sums[v].accumulation += engine.GetTimings().accumulation;
+                    sums[v].worldHashTable += engine.GetTimings().worldHashTable;
+                    updateCounts[v] += engine.GetAccumulationUpdateCount();
+                }
+
+                //Every key accumulated this frame must have the same entry in every mode
+                HashTable const& accumulationHashTable = engines[0]->GetAccumulationHashTable();
+                for (uint32_t slotID = 0; slotID < accumulationHashTable.GetCapacity(); ++slotID)
+                {
+                    uint32_t const key = accumulationHashTable.LookupBySlotID(slotID).key;
+                    if (key == 0)
+                        continue;
+                    KeyData const reference = engines[0]->GetWorldHashTable().Lookup(key);
+                    for (uint32_t v = 1; v < VariantCount; ++v)
+                    {
+                        KeyData const data = engines[v]->GetWorldHashTable().Lookup(key);
+                        mismatches += (data.key != reference.key || data.value != reference.value || data.count != reference.count) ? 1 : 0;
+                    }
+                    ++comparedKeys;
+                }
+
+                for (std::unique_ptr<Engine> const& pEngine : engines)
+                {
+                    pEngine->MaintenancePass();
+                    pEngine->ClearBuffersPass();
+                }
+            }
+
+            double const frameCount = double(options.frames);
+            for (uint32_t v = 0; v < VariantCount; ++v)
+            {
+                std::printf("%8u %12s %12.2f %12.2f %12.2f %14.0f\n", engines[v]->GetThreadCount(), Variants[v].name,
+                    sums[v].accumulation / frameCount, sums[v].worldHashTable / frameCount,
+                    (sums[v].accumulation + sums[v].worldHashTable) / frameCount, double(updateCounts[v]) / frameCount);
+            }
+
+            ThreadPool threadPool(threadCount);
+            double const sortMilliseconds = RadixSortMillisecondsPerSort(sortElementCount, 4, threadPool);
+            std::printf("%8s radix sort of %u elements: %.2f ms, %.1f Melements/s\n", "", sortElementCount, sortMilliseconds,
+                (double(sortElementCount) / (sortMilliseconds * 1e-3)) * 1e-6);
+            std::printf("%8s %llu keys compared, %llu mismatches\n", "", static_cast<unsigned long long>(comparedKeys),
+                static_cast<unsigned long long>(mismatches));
+            result = mismatches == 0 ? result : 1;
+        }
+        return result;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,317 @@
+//World hash table layouts for the lookups of the reconstruction: pcg seeds with key % groupCount (the layout of the engine
+//without IMPLICITPOINT_SPATIAL_SEEDS), the same seeds with a RangeHomeGroup, and spatial seeds (GetSpatialSeedWithSignedBits)
+//with a RangeHomeGroup. Renders the frames, fills one table per layout with the points of the world hash table the last
+//frame reads, keyed by the seeds of the layout, then replays the 27 x 8 lookups of every pixel on its LOD in tile order.
+//Reports the lookups per second and the cache lines, simulated L1/L2 misses and data TLB misses per pixel. The simulation
+//stands in for hardware miss counters, which are not portable, the timing shows what the misses cost.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const NeighbourCount = 27;
+        uint32_t const LookupsPerPixel = NeighbourCount * 8;
+
+        //Set associative, least recently used, counts the misses
+        class SimulatedCache
+        {
+        public:
+            SimulatedCache(uint32_t sets, uint32_t ways, uint32_t lineBits)
+                : m_Tags(size_t(sets) * ways, ~uint64_t(0))
+                , m_Ages(size_t(sets) * ways, 0)
+                , m_Sets(sets)
+                , m_Ways(ways)
+                , m_LineBits(lineBits)
+            {
+            }
+
+            void Access(uint64_t address)
+            {
+                uint64_t const line = address >> m_LineBits;
+                size_t const first = size_t(line % m_Sets) * m_Ways;
+                size_t oldest = first;
+                ++m_Clock;
+                for (size_t way = first; way < first + m_Ways; ++way)
+                {
+                    if (m_Tags[way] == line)
+                    {
+                        m_Ages[way] = m_Clock;
+                        return;
+                    }
+                    oldest = m_Ages[way] < m_Ages[oldest] ? way : oldest;
+                }
+                m_Tags[oldest] = line;
+                m_Ages[oldest] = m_Clock;
+                ++m_Misses;
+            }
+
+            uint64_t GetMissCount() const { return m_Misses; }
+
+        private:
+            std::vector<uint64_t> m_Tags;
+            std::vector<uint64_t> m_Ages;
+            uint32_t m_Sets;
+            uint32_t m_Ways;
+            uint32_t m_LineBits;
+            uint64_t m_Clock = 0;
+            uint64_t m_Misses = 0;
+        };
+
+        struct LayoutResult
+        {
+            double seconds = 0.0;
+            uint64_t found = 0;
+            uint64_t groups = 0;
+            uint64_t l1Misses = 0;
+            uint64_t l2Misses = 0;
+            uint64_t tlbMisses = 0;
+            HashTableStatistics statistics;
+        };
+
+        //One table layout: the home group policy and the seeds its keys are
+        class Layout
+        {
+        public:
+            Layout(char const* name, bool spatialSeeds)
+                : m_Name(name)
+                , m_SpatialSeeds(spatialSeeds)
+            {
+            }
+            virtual ~Layout() {}
+
+            char const* GetName() const { return m_Name; }
+            bool UsesSpatialSeeds() const { return m_SpatialSeeds; }
+
+            virtual void Insert(uint32_t key, KeyData const& data) = 0;
+            //Times the lookups, returns the amount of keys found
+            virtual uint64_t Lookup(std::vector<uint32_t> const& keys) const = 0;
+            //Walks the probe sequences of the keys through the caches, returns the groups visited
+            virtual uint64_t Simulate(std::vector<uint32_t> const& keys, SimulatedCache& l1, SimulatedCache& l2, SimulatedCache& tlb) const = 0;
+            virtual HashTableStatistics ComputeStatistics() const = 0;
+
+        private:
+            char const* m_Name;
+            bool m_SpatialSeeds;
+        };
+
+        template<typename HomeGroup>
+        class TableLayout : public Layout
+        {
+        public:
+            typedef ConcurrentHashTable<KeyDataSlot, 64, HomeGroup> Table;
+
+            TableLayout(char const* name, bool spatialSeeds, uint32_t capacity)
+                : Layout(name, spatialSeeds)
+                , m_Table(capacity)
+            {
+            }
+
+            void Insert(uint32_t key, KeyData const& data) override
+            {
+                m_Table.Insert(key, data.value, data.count);
+            }
+
+            uint64_t Lookup(std::vector<uint32_t> const& keys) const override
+            {
+                uint64_t found = 0;
+                for (uint32_t key : keys)
+                    found += m_Table.Lookup(key).key != 0 ? 1 : 0;
+                return found;
+            }
+
+            uint64_t Simulate(std::vector<uint32_t> const& keys, SimulatedCache& l1, SimulatedCache& l2, SimulatedCache& tlb) const override
+            {
+                uint32_t const groupCount = m_Table.GetCapacity() / Table::SlotsPerGroup;
+                uint64_t groups = 0;
+                for (uint32_t key : keys)
+                {
+                    uint32_t group = m_Table.GetHomeGroup(key);
+                    bool done = false;
+                    for (uint32_t p = 0; p < Table::MaxProbeGroupCount && !done; ++p)
+                    {
+                        uint64_t const address = uint64_t(group) * Table::CacheLineSize;
+                        l1.Access(address);
+                        l2.Access(address);
+                        tlb.Access(address);
+                        ++groups;
+                        for (uint32_t s = 0; s < Table::SlotsPerGroup && !done; ++s)
+                        {
+                            uint32_t const slotKey = m_Table.LookupBySlotID(group * Table::SlotsPerGroup + s).key;
+                            done = slotKey == key || slotKey == 0;
+                        }
+                        group = (group + 1 == groupCount) ? 0 : group + 1;
+                    }
+                }
+                return groups;
+            }
+
+            HashTableStatistics ComputeStatistics() const override { return m_Table.ComputeStatistics(); }
+
+        private:
+            Table m_Table;
+        };
+
+        //Seeds of the 27 x 8 points around every pixel of the tile on its LOD, pcg and spatial. False when the tile has none.
+        bool GetTileSeeds(FrameData const& frame, Engine const& engine, uint2 tileStart, uint2 tileEnd, std::vector<uint32_t>& pcgSeeds,
+            std::vector<uint32_t>& spatialSeeds)
+        {
+            EngineSettings const& settings = engine.GetSettings();
+            uint2 const screenDimensions = { settings.screenWidth, settings.screenHeight };
+            pcgSeeds.clear();
+            spatialSeeds.clear();
+            for (uint32_t y = tileStart.y; y < tileEnd.y; ++y)
+            {
+                for (uint32_t x = tileStart.x; x < tileEnd.x; ++x)
+                {
+                    uint32_t const index = x + (y * settings.screenWidth);
+                    uint32_t const level = engine.GetLODBuffer()[index].x;
+                    if (engine.GetPointSampleBuffer()[index].seed == 0 || level > settings.maxLevels)
+                        continue;
+
+                    float3 const position = DepthToWorldPosition(frame.depth[index], uint2{ x, y }, screenDimensions, frame.viewProjectionInverse).xyz();
+                    float const deltaOnLevel = 1.f / float(IntPow2(level));
+                    float const cellSizeBasedOnLevel = float(settings.cellSize) * deltaOnLevel;
+                    float3 const discretePosition = Discretize(position, cellSizeBasedOnLevel);
+                    for (uint32_t v = 0; v < NeighbourCount; ++v)
+                    {
+                        float3 const neighbourPosition = GetNeighbourPosition(discretePosition, v, cellSizeBasedOnLevel);
+                        float3 const acp = GetNeighbourVoxelCenter(neighbourPosition, deltaOnLevel, settings.cellSize);
+                        uint32_t const pcgSeed = GetSeedWithSignedBits(acp, settings.maxLevels);
+                        uint32_t const spatialSeed = GetSpatialSeedWithSignedBits(acp, deltaOnLevel, settings.cellSize, settings.maxLevels);
+                        for (uint32_t i = 0; i < 8; ++i)
+                        {
+                            pcgSeeds.push_back(pcgSeed + i);
+                            spatialSeeds.push_back(spatialSeed + i);
+                        }
+                    }
+                }
+            }
+            return !pcgSeeds.empty();
+        }
+    }
+
+    int SpatialKeysBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        EngineSettings settings;
+        settings.threadCount = GetThreadCounts(options).back();
+        settings.screenWidth = frames[0].width;
+        settings.screenHeight = frames[0].height;
+        settings.voxelConnectivity = options.voxelConnectivity;
+        settings.lodMode = options.lodMode;
+        Engine engine(settings);
+        for (uint32_t f = 0; f < options.frames; ++f)
+            engine.RenderFrame(frames[f % uniqueFrames]);
+
+        //The clear pass reset the LOD buffer, generate the samples of the last frame again
+        FrameData const& frame = frames[(options.frames - 1) % uniqueFrames];
+        engine.SampleGenerationPass(frame);
+
+        uint32_t const capacity = engine.GetWorldHashTable().GetCapacity();
+        std::vector<std::unique_ptr<Layout>> layouts;
+        layouts.emplace_back(new TableLayout<ModuloHomeGroup>("pcg % groups", false, capacity));
+        layouts.emplace_back(new TableLayout<RangeHomeGroup>("pcg range", false, capacity));
+        layouts.emplace_back(new TableLayout<RangeHomeGroup>("spatial range", true, capacity));
+
+        std::vector<uint2> tiles;
+        uint32_t const tileSize = engine.GetSettings().tileSize;
+        for (uint32_t y = 0; y < settings.screenHeight; y += tileSize)
+        {
+            for (uint32_t x = 0; x < settings.screenWidth; x += tileSize)
+                tiles.push_back(uint2{ x, y });
+        }
+
+        //Every point of the world hash table the pixels read, under the seed of each layout
+        std::vector<uint32_t> pcgSeeds;
+        std::vector<uint32_t> spatialSeeds;
+        uint64_t pixels = 0;
+        for (uint2 const& tileStart : tiles)
+        {
+            uint2 const tileEnd = { std::min(tileStart.x + tileSize, settings.screenWidth), std::min(tileStart.y + tileSize, settings.screenHeight) };
+            if (!GetTileSeeds(frame, engine, tileStart, tileEnd, pcgSeeds, spatialSeeds))
+                continue;
+
+            pixels += pcgSeeds.size() / LookupsPerPixel;
+#if defined(IMPLICITPOINT_SPATIAL_SEEDS)
+            std::vector<uint32_t> const& engineSeeds = spatialSeeds;
+#else
+            std::vector<uint32_t> const& engineSeeds = pcgSeeds;
+#endif
+            for (size_t i = 0; i < engineSeeds.size(); ++i)
+            {
+                KeyData const data = engine.GetWorldHashTable().Lookup(engineSeeds[i]);
+                if (data.key == 0)
+                    continue;
+                for (std::unique_ptr<Layout> const& pLayout : layouts)
+                    pLayout->Insert(pLayout->UsesSpatialSeeds() ? spatialSeeds[i] : pcgSeeds[i], data);
+            }
+        }
+        if (pixels == 0)
+        {
+            std::printf("spatialkeys: no pixels\n");
+            return 1;
+        }
+
+        //L1 32 KB 8 way, L2 1 MB 16 way, 64 entry 4 way data TLB of 4 KB pages
+        std::vector<LayoutResult> results(layouts.size());
+        for (size_t l = 0; l < layouts.size(); ++l)
+        {
+            Layout const& layout = *layouts[l];
+            LayoutResult& result = results[l];
+            SimulatedCache l1(64, 8, 6);
+            SimulatedCache l2(1024, 16, 6);
+            SimulatedCache tlb(16, 4, 12);
+            for (uint2 const& tileStart : tiles)
+            {
+                uint2 const tileEnd = { std::min(tileStart.x + tileSize, settings.screenWidth), std::min(tileStart.y + tileSize, settings.screenHeight) };
+                if (!GetTileSeeds(frame, engine, tileStart, tileEnd, pcgSeeds, spatialSeeds))
+                    continue;
+
+                std::vector<uint32_t> const& keys = layout.UsesSpatialSeeds() ? spatialSeeds : pcgSeeds;
+                std::chrono::high_resolution_clock::time_point const start = std::chrono::high_resolution_clock::now();
+                result.found += layout.Lookup(keys);
+                result.seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                result.groups += layout.Simulate(keys, l1, l2, tlb);
+            }
+            result.l1Misses = l1.GetMissCount();
+            result.l2Misses = l2.GetMissCount();
+            result.tlbMisses = tlb.GetMissCount();
+            result.statistics = layout.ComputeStatistics();
+        }
+
+        std::printf("spatialkeys: %u frames, lod mode %u, %llu pixels, %u slots, %u points\n", options.frames, uint32_t(options.lodMode),
+            static_cast<unsigned long long>(pixels), capacity, results[0].statistics.occupied);
+        std::printf("%16s %12s %10s %10s %10s %10s %10s %10s %10s %10s\n", "layout", "Mlookups/s", "speedup", "found/px", "lines/px",
+            "L1 miss/px", "L2 miss/px", "TLB miss", "avg probe", "failed");
+        int result = 0;
+        double const lookups = double(pixels) * LookupsPerPixel;
+        for (size_t l = 0; l < layouts.size(); ++l)
+        {
+            LayoutResult const& r = results[l];
+            std::printf("%16s %12.1f %9.2fx %10.2f %10.2f %10.2f %10.2f %10.2f %10.3f %10llu\n", layouts[l]->GetName(), lookups / r.seconds * 1e-6,
+                results[0].seconds / r.seconds, double(r.found) / double(pixels), double(r.groups) / double(pixels),
+                double(r.l1Misses) / double(pixels), double(r.l2Misses) / double(pixels), double(r.tlbMisses) / double(pixels),
+                r.statistics.averageProbeLength, static_cast<unsigned long long>(r.statistics.failedInserts));
+            result = r.statistics.failedInserts == 0 ? result : 1;
+        }
+        return result;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,350 @@
+#include "SyntheticScene.h"
+#include "SharedUtilities.h"
+#include <cfloat>
+#include <cstring>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        struct Sphere
+        {
+            float3 center;
+            float radius;
+        };
+
+        Sphere const Spheres[] =
+        {
+            { float3{ 0.f, 400.f, 0.f }, 400.f },
+            { float3{ -900.f, 250.f, -300.f }, 250.f },
+            { float3{ 800.f, 150.f, 200.f }, 150.f },
+            { float3{ 300.f, 600.f, -1200.f }, 600.f },
+            { float3{ -400.f, 80.f, 700.f }, 80.f }
+        };
+
+        float const NearPlane = 1.f;
+        float const FarPlane = 10000.f;
+        float const VerticalFOV = 0.7853981f; //45 degrees
+
+        //Right handed look-at view matrix, camera looks down -z in view space
+        float4x4 CreateView(float3 const& position, float3 const& target, float3& forward)
+        {
+            forward = normalize(target - position);
+            float3 const right = normalize(cross(forward, float3{ 0.f, 1.f, 0.f }));
+            float3 const up = cross(right, forward);
+
+            float4x4 view = Identity();
+            view.m[0][0] = right.x;    view.m[0][1] = right.y;    view.m[0][2] = right.z;    view.m[0][3] = -dot(right, position);
+            view.m[1][0] = up.x;       view.m[1][1] = up.y;       view.m[1][2] = up.z;       view.m[1][3] = -dot(up, position);
+            view.m[2][0] = -forward.x; view.m[2][1] = -forward.y; view.m[2][2] = -forward.z; view.m[2][3] = dot(forward, position);
+            return view;
+        }
+
+        //Reverse-Z perspective: near plane maps to depth 1, far plane to depth 0
+        float4x4 CreateProjection(float aspect)
+        {
+            float const cotangent = 1.f / std::tan(VerticalFOV * 0.5f);
+            float4x4 projection = {};
+            projection.m[0][0] = cotangent / aspect;
+            projection.m[1][1] = cotangent;
+            projection.m[2][2] = NearPlane / (FarPlane - NearPlane);
+            projection.m[2][3] = (FarPlane * NearPlane) / (FarPlane - NearPlane);
+            projection.m[3][2] = -1.f;
+            return projection;
+        }
+
+        float3 const CameraTarget = { 0.f, 250.f, 0.f };
+
+        float3 GetCameraPosition(uint32_t frameIndex)
+        {
+            float const angle = 0.6f + float(frameIndex) * 0.002f;
+            return float3{ std::sin(angle) * 2200.f, 500.f, std::cos(angle) * 2200.f };
+        }
+
+        //Closest hit along the ray, returns false on a miss. Also returns a made up occlusion value for the hit point.
+        bool TraceScene(float3 const& origin, float3 const& direction, float3& hitPosition, float& occlusion)
+        {
+            float closest = FLT_MAX;
+            float3 normal = { 0.f, 1.f, 0.f };
+
+            //Ground plane, y = 0
+            if (direction.y < 0.f)
+            {
+                float const t = -origin.y / direction.y;
+                if (t > NearPlane && t < closest)
+                    closest = t;
+            }
+
+            for (Sphere const& sphere : Spheres)
+            {
+                float3 const oc = origin - sphere.center;
+                float const b = dot(oc, direction);
+                float const c = dot(oc, oc) - sphere.radius * sphere.radius;
+                float const discriminant = b * b - c;
+                if (discriminant < 0.f)
+                    continue;
+                float const t = -b - std::sqrt(discriminant);
+                if (t > NearPlane && t < closest)
+                {
+                    closest = t;
+                    normal = normalize((origin + direction * t) - sphere.center);
+                }
+            }
+
+            if (closest == FLT_MAX || closest > FarPlane)
+                return false;
+
+            //Occlusion: darker when facing down and when close to another surface, plus some high frequency detail
+            hitPosition = origin + direction * closest;
+            float ao = 0.6f + 0.4f * normal.y;
+            for (Sphere const& sphere : Spheres)
+            {
+                float const gap = distance(hitPosition, sphere.center) - sphere.radius;
+                if (gap > 1.f)
+                    ao *= saturate(0.35f + gap / (2.f * sphere.radius));
+            }
+            ao *= 0.9f + 0.1f * std::sin(hitPosition.x * 0.05f) * std::cos(hitPosition.z * 0.05f);
+            occlusion = saturate(ao);
+            return true;
+        }
+
+        //Vertex layout of the demo's H3D meshes: position, texcoord0, normal, tangent, bitangent
+        struct ModelVertex
+        {
+            float3 position;
+            float2 texcoord;
+            float3 normal;
+            float3 tangent;
+            float3 bitangent;
+        };
+
+        struct MeshBuilder
+        {
+            std::vector<ModelVertex> vertices;
+            std::vector<uint16_t> indices;
+
+            uint16_t AddVertex(float3 const& position, float3 const& normal)
+            {
+                float3 const tangent = normalize(GetPerpendicularVector(normal));
+                vertices.push_back(ModelVertex{ position, float2{ 0.f, 0.f }, normal, tangent, cross(normal, tangent) });
+                return uint16_t(vertices.size() - 1);
+            }
+
+            //Wound clockwise seen from the side outward points to, the front face of the demo
+            void AddTriangle(uint16_t a, uint16_t b, uint16_t c, float3 const& outward)
+            {
+                float3 const normal = cross(vertices[b].position - vertices[a].position, vertices[c].position - vertices[a].position);
+                bool const flip = dot(normal, outward) > 0.f;
+                indices.push_back(a);
+                indices.push_back(flip ? c : b);
+                indices.push_back(flip ? b : c);
+            }
+        };
+
+        void GrowBoundingBox(H3DBoundingBox& bounds, float3 const& point)
+        {
+            bounds.min = H3DVector3{ min(bounds.min.x, point.x), min(bounds.min.y, point.y), min(bounds.min.z, point.z), 0.f };
+            bounds.max = H3DVector3{ max(bounds.max.x, point.x), max(bounds.max.y, point.y), max(bounds.max.z, point.z), 0.f };
+        }
+
+        void AppendBytes(std::vector<uint8_t>& data, void const* pSource, size_t size)
+        {
+            size_t const offset = data.size();
+            data.resize(offset + size);
+            std::memcpy(data.data() + offset, pSource, size);
+        }
+
+        void AddMesh(H3DModel& model, MeshBuilder const& builder)
+        {
+            H3DMesh mesh = {};
+            mesh.boundingBox = H3DBoundingBox{ H3DVector3{ FLT_MAX, FLT_MAX, FLT_MAX, 0.f }, H3DVector3{ -FLT_MAX, -FLT_MAX, -FLT_MAX, 0.f } };
+            for (ModelVertex const& vertex : builder.vertices)
+                GrowBoundingBox(mesh.boundingBox, vertex.position);
+            if (model.meshes.empty())
+                model.header.boundingBox = mesh.boundingBox;
+            GrowBoundingBox(model.header.boundingBox, float3{ mesh.boundingBox.min.x, mesh.boundingBox.min.y, mesh.boundingBox.min.z });
+            GrowBoundingBox(model.header.boundingBox, float3{ mesh.boundingBox.max.x, mesh.boundingBox.max.y, mesh.boundingBox.max.z });
+
+            mesh.materialIndex = 0;
+            mesh.attribsEnabled = (1u << H3DAttribPosition) | (1u << H3DAttribTexcoord0) | (1u << H3DAttribNormal) | (1u << H3DAttribTangent) | (1u << H3DAttribBitangent);
+            mesh.attribsEnabledDepth = 1u << H3DAttribPosition;
+            mesh.vertexStride = sizeof(ModelVertex);
+            mesh.vertexStrideDepth = sizeof(float3);
+            mesh.attrib[H3DAttribPosition] = H3DAttribDesc{ 0, 0, 3, H3DAttribFormatFloat };
+            mesh.attrib[H3DAttribTexcoord0] = H3DAttribDesc{ 12, 0, 2, H3DAttribFormatFloat };
+            mesh.attrib[H3DAttribNormal] = H3DAttribDesc{ 20, 0, 3, H3DAttribFormatFloat };
+            mesh.attrib[H3DAttribTangent] = H3DAttribDesc{ 32, 0, 3, H3DAttribFormatFloat };
+            mesh.attrib[H3DAttribBitangent] = H3DAttribDesc{ 44, 0, 3, H3DAttribFormatFloat };
+            mesh.attribDepth[H3DAttribPosition] = H3DAttribDesc{ 0, 0, 3, H3DAttribFormatFloat };
+
+            mesh.vertexDataByteOffset = uint32_t(model.vertexData.size());
+            mesh.vertexCount = uint32_t(builder.vertices.size());
+            mesh.indexDataByteOffset = uint32_t(model.indexData.size());
+            mesh.indexCount = uint32_t(builder.indices.size());
+            mesh.vertexDataByteOffsetDepth = uint32_t(model.vertexDataDepth.size());
+            mesh.vertexCountDepth = mesh.vertexCount;
+
+            AppendBytes(model.vertexData, builder.vertices.data(), builder.vertices.size() * sizeof(ModelVertex));
+            AppendBytes(model.indexData, builder.indices.data(), builder.indices.size() * sizeof(uint16_t));
+            AppendBytes(model.indexDataDepth, builder.indices.data(), builder.indices.size() * sizeof(uint16_t));
+            for (ModelVertex const& vertex : builder.vertices)
+                AppendBytes(model.vertexDataDepth, &vertex.position, sizeof(float3));
+
+            model.meshes.push_back(mesh);
+            model.header.meshCount = uint32_t(model.meshes.size());
+            model.header.vertexDataByteSize = uint32_t(model.vertexData.size());
+            model.header.indexDataByteSize = uint32_t(model.indexData.size());
+            model.header.vertexDataByteSizeDepth = uint32_t(model.vertexDataDepth.size());
+        }
+
+        void AddSphere(MeshBuilder& builder, Sphere const& sphere, uint32_t segments, uint32_t rings)
+        {
+            uint16_t const first = uint16_t(builder.vertices.size());
+            for (uint32_t ring = 0; ring <= rings; ++ring)
+            {
+                float const theta = 3.14159265f * float(ring) / float(rings);
+                for (uint32_t segment = 0; segment <= segments; ++segment)
+                {
+                    float const phi = 2.f * 3.14159265f * float(segment) / float(segments);
+                    float3 const normal = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                    builder.AddVertex(sphere.center + normal * sphere.radius, normal);
+                }
+            }
+            for (uint32_t ring = 0; ring < rings; ++ring)
+            {
+                for (uint32_t segment = 0; segment < segments; ++segment)
+                {
+                    uint16_t const a = uint16_t(first + ring * (segments + 1) + segment);
+                    uint16_t const b = uint16_t(a + segments + 1);
+                    float3 const outward = builder.vertices[a].normal + builder.vertices[b + 1].normal;
+                    if (ring != 0)
+                        builder.AddTriangle(a, b, uint16_t(a + 1), outward);
+                    if (ring != rings - 1)
+                        builder.AddTriangle(uint16_t(a + 1), b, uint16_t(b + 1), outward);
+                }
+            }
+        }
+
+        void AddBox(MeshBuilder& builder, float3 const& center, float3 const& halfSize, float angle)
+        {
+            float3 const axes[3] = { float3{ std::cos(angle), 0.f, std::sin(angle) }, float3{ 0.f, 1.f, 0.f }, float3{ -std::sin(angle), 0.f, std::cos(angle) } };
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                for (float side = -1.f; side <= 1.f; side += 2.f)
+                {
+                    float3 const normal = axes[axis] * side;
+                    float3 const u = axes[(axis + 1) % 3] * halfSize[(axis + 1) % 3];
+                    float3 const v = axes[(axis + 2) % 3] * halfSize[(axis + 2) % 3];
+                    float3 const faceCenter = center + normal * halfSize[axis];
+                    uint16_t const a = builder.AddVertex(faceCenter - u - v, normal);
+                    uint16_t const b = builder.AddVertex(faceCenter + u - v, normal);
+                    uint16_t const c = builder.AddVertex(faceCenter + u + v, normal);
+                    uint16_t const d = builder.AddVertex(faceCenter - u + v, normal);
+                    builder.AddTriangle(a, b, c, normal);
+                    builder.AddTriangle(a, c, d, normal);
+                }
+            }
+        }
+    }
+
+    void CreateSyntheticFrame(uint32_t frameIndex, uint32_t width, uint32_t height, FrameData& frame)
+    {
+        frame.Resize(width, height);
+
+        //Camera
+        float3 const cameraPosition = GetCameraPosition(frameIndex);
+        float3 forward = {};
+        float4x4 const view = CreateView(cameraPosition, CameraTarget, forward);
+        float4x4 const viewProjection = mul(CreateProjection(float(width) / float(height)), view);
+
+        frame.viewProjectionInverse = Invert(viewProjection);
+        frame.viewInverse = Invert(view);
+        frame.viewVector = forward;
+
+        //Trace every pixel, store reverse-Z depth and the occlusion term
+        uint2 const screenDimensions = { width, height };
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                float3 const nearPoint = DepthToWorldPosition(1.f, uint2{ x, y }, screenDimensions, frame.viewProjectionInverse).xyz();
+                float3 const direction = normalize(nearPoint - cameraPosition);
+
+                float3 hitPosition = {};
+                float occlusion = 0.f;
+                if (!TraceScene(cameraPosition, direction, hitPosition, occlusion))
+                    continue;
+
+                float4 const clip = mul(viewProjection, float4{ hitPosition.x, hitPosition.y, hitPosition.z, 1.f });
+                uint32_t const index = x + y * width;
+                frame.depth[index] = clip.z / clip.w;
+                frame.ambientOcclusion[index] = occlusion;
+            }
+        }
+    }
+
+    void CreateSyntheticModel(H3DModel& model)
+    {
+        model = H3DModel();
+        model.materials.resize(1);
+        std::strcpy(model.materials[0].name, "synthetic");
+        model.header.materialCount = 1;
+
+        //Ground: a grid instead of 2 triangles, so the ground isn't one huge leaf of every BVH
+        MeshBuilder ground;
+        uint32_t const groundCells = 32;
+        float const groundExtent = 4000.f;
+        for (uint32_t z = 0; z <= groundCells; ++z)
+        {
+            for (uint32_t x = 0; x <= groundCells; ++x)
+            {
+                float3 const position = { (float(x) / float(groundCells) * 2.f - 1.f) * groundExtent, 0.f, (float(z) / float(groundCells) * 2.f - 1.f) * groundExtent };
+                ground.AddVertex(position, float3{ 0.f, 1.f, 0.f });
+            }
+        }
+        for (uint32_t z = 0; z < groundCells; ++z)
+        {
+            for (uint32_t x = 0; x < groundCells; ++x)
+            {
+                uint16_t const a = uint16_t(x + z * (groundCells + 1));
+                uint16_t const b = uint16_t(a + groundCells + 1);
+                ground.AddTriangle(a, uint16_t(a + 1), b, float3{ 0.f, 1.f, 0.f });
+                ground.AddTriangle(uint16_t(a + 1), uint16_t(b + 1), b, float3{ 0.f, 1.f, 0.f });
+            }
+        }
+        AddMesh(model, ground);
+
+        for (Sphere const& sphere : Spheres)
+        {
+            MeshBuilder builder;
+            AddSphere(builder, sphere, 96, 48);
+            AddMesh(model, builder);
+        }
+
+        //Boxes of 10 to 60 units around the spheres, 1000 per mesh
+        uint32_t random = 12345;
+        for (uint32_t mesh = 0; mesh < 4; ++mesh)
+        {
+            MeshBuilder builder;
+            for (uint32_t box = 0; box < 1000; ++box)
+            {
+                float const radius = 2000.f * std::sqrt(NextRand(random));
+                float const angle = 2.f * 3.14159265f * NextRand(random);
+                float3 const halfSize = { 5.f + 25.f * NextRand(random), 5.f + 25.f * NextRand(random), 5.f + 25.f * NextRand(random) };
+                AddBox(builder, float3{ std::cos(angle) * radius, halfSize.y, std::sin(angle) * radius }, halfSize, 6.2831853f * NextRand(random));
+            }
+            AddMesh(model, builder);
+        }
+    }
+
+    AOCamera GetSyntheticCamera(uint32_t frameIndex)
+    {
+        AOCamera camera;
+        camera.position = GetCameraPosition(frameIndex);
+        camera.lookDirection = normalize(CameraTarget - camera.position);
+        camera.up = float3{ 0.f, 1.f, 0.f };
+        return camera;
+    }
+} //namespace ImplicitPointBench
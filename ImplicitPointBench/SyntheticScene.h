@@ -0,0 +1,19 @@
+//Procedural stand-in for a captured frame: a ground plane with a few spheres, rendered with a reverse-Z camera like the demo uses.
+//Lets the benchmarks run without a DXR capable GPU or a frame dumped from ImplicitPointDemo.
+#pragma once
+#include "FrameData.h"
+#include "AmbientOcclusionTracer.h"
+#include "H3DModel.h"
+
+namespace ImplicitPointBench
+{
+    //frameIndex slowly orbits the camera, so consecutive frames overlap like a moving camera in the demo does
+    void CreateSyntheticFrame(uint32_t frameIndex, uint32_t width, uint32_t height, ImplicitPointCPU::FrameData& frame);
+
+    //The same scene as triangles in the H3D layout of the demo (ground, one mesh per sphere and some meshes of small boxes
+    //on the ground for contact occlusion), for the ray tracing benchmarks when no .h3d file is given
+    void CreateSyntheticModel(ImplicitPointCPU::H3DModel& model);
+
+    //Camera of CreateSyntheticFrame(frameIndex)
+    ImplicitPointCPU::AOCamera GetSyntheticCamera(uint32_t frameIndex);
+} //namespace ImplicitPointBench
@@ -0,0 +1,102 @@
+//Temporal reuse of the closest samples (EngineSettings::temporalReuseDistance) per reuse distance, for the orbiting camera
+//of the input frames and for a static camera. Reports the sample generation time, the hit rate of the reprojection, the
+//pixels that got another seed than searching would give and the final pass error against searching every frame.
+//Deterministic accumulation, so the engines only differ by the reused seeds.
+#include "Benchmark.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        float const ReuseDistances[] = { 0.f, 0.05f, 0.1f, 0.25f, 0.5f, 1.f };
+        uint32_t const ReuseDistanceCount = sizeof(ReuseDistances) / sizeof(ReuseDistances[0]);
+    }
+
+    int TemporalReuseBenchmark(BenchmarkOptions const& options)
+    {
+        uint32_t const uniqueFrames = options.frameFile.empty() ? std::min(options.frames, 8u) : 1u;
+        std::vector<FrameData> frames(uniqueFrames);
+        for (uint32_t i = 0; i < uniqueFrames; ++i)
+        {
+            if (!GetBenchmarkFrame(options, i, frames[i]))
+            {
+                std::printf("Failed to load frame %s\n", options.frameFile.c_str());
+                return 1;
+            }
+        }
+
+        std::printf("temporalreuse: %u frames, connectivity %u, lod mode %u\n", options.frames, options.voxelConnectivity, uint32_t(options.lodMode));
+        std::printf("%8s %8s %10s %14s %10s %12s %14s %12s\n", "threads", "camera", "distance", "samplegen ms", "speedup", "hit rate",
+            "other seeds", "mean error");
+
+        char const* const cameraNames[] = { "orbit", "static" };
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            for (uint32_t camera = 0; camera < 2; ++camera)
+            {
+                std::vector<std::unique_ptr<Engine>> engines;
+                for (float reuseDistance : ReuseDistances)
+                {
+                    EngineSettings settings;
+                    settings.threadCount = threadCount;
+                    settings.screenWidth = frames[0].width;
+                    settings.screenHeight = frames[0].height;
+                    settings.voxelConnectivity = options.voxelConnectivity;
+                    settings.lodMode = options.lodMode;
+                    settings.accumulationMode = AccumulationMode::Deterministic;
+                    settings.temporalReuseDistance = reuseDistance;
+                    engines.emplace_back(new Engine(settings));
+                }
+
+                double milliseconds[ReuseDistanceCount] = {};
+                uint64_t hits[ReuseDistanceCount] = {};
+                uint64_t lookups[ReuseDistanceCount] = {};
+                uint64_t otherSeeds[ReuseDistanceCount] = {};
+                double errorSums[ReuseDistanceCount] = {};
+                uint64_t sampledPixels = 0;
+                for (uint32_t f = 0; f < options.frames; ++f)
+                {
+                    FrameData const& frame = frames[camera == 0 ? f % uniqueFrames : 0];
+                    for (uint32_t d = 0; d < ReuseDistanceCount; ++d)
+                    {
+                        Engine& engine = *engines[d];
+                        engine.RenderFrame(frame);
+                        milliseconds[d] += engine.GetTimings().sampleGeneration;
+                        hits[d] += engine.GetTemporalReuseHitCount();
+                        lookups[d] += engine.GetTemporalReuseHitCount() + engine.GetTemporalReuseMissCount();
+
+                        std::vector<SampleData> const& referenceSamples = engines[0]->GetPointSampleBuffer();
+                        std::vector<SampleData> const& samples = engine.GetPointSampleBuffer();
+                        std::vector<float> const& reference = engines[0]->GetVisualizationBuffer();
+                        std::vector<float> const& visualization = engine.GetVisualizationBuffer();
+                        for (size_t i = 0; i < samples.size(); ++i)
+                        {
+                            otherSeeds[d] += (samples[i].seed != referenceSamples[i].seed || samples[i].prevSeed != referenceSamples[i].prevSeed) ? 1 : 0;
+                            errorSums[d] += std::fabs(double(visualization[i]) - double(reference[i]));
+                        }
+                    }
+                    sampledPixels += uint64_t(std::count_if(engines[0]->GetPointSampleBuffer().begin(), engines[0]->GetPointSampleBuffer().end(),
+                        [](SampleData const& data) { return data.seed != 0; }));
+                }
+
+                double const frameCount = double(options.frames);
+                for (uint32_t d = 0; d < ReuseDistanceCount; ++d)
+                {
+                    std::printf("%8u %8s %10.2f %14.2f %9.2fx %11.2f%% %13.4f%% %12.6f\n", engines[d]->GetThreadCount(), cameraNames[camera],
+                        ReuseDistances[d], milliseconds[d] / frameCount, milliseconds[0] / milliseconds[d],
+                        lookups[d] > 0 ? (100.0 * double(hits[d])) / double(lookups[d]) : 0.0,
+                        (100.0 * double(otherSeeds[d])) / double(std::max<uint64_t>(sampledPixels, 1)),
+                        errorSums[d] / (frameCount * double(engines[d]->GetPixelCount())));
+                }
+            }
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,216 @@
+//Compressed 8-wide BVH (WideBVH) against the binary float BVH it is collapsed from, on one tree over the merged triangles of
+//--model or the synthetic model: build time, nodes and bytes per triangle, then the primary rays (closest hit) and the AO
+//rays (any hit) of the benchmark frames per thread count through both, scalar and SIMD. The AO rays are generated like
+//AmbientOcclusionTracer::TraceAmbientOcclusion does. Hits are compared against the binary tree's scalar traversal.
+#include "Benchmark.h"
+#include "SharedUtilities.h"
+#include "WideBVH.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+
+using namespace ImplicitPointCPU;
+
+namespace ImplicitPointBench
+{
+    namespace
+    {
+        uint32_t const RaysPerJob = 1024;
+
+        //Rays of one frame as structure of arrays
+        struct FrameRays
+        {
+            std::vector<float> origin[3];
+            std::vector<float> direction[3];
+            uint32_t count = 0;
+
+            void Add(float3 const& rayOrigin, float3 const& rayDirection)
+            {
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    origin[axis].push_back(rayOrigin[axis]);
+                    direction[axis].push_back(rayDirection[axis]);
+                }
+                ++count;
+            }
+
+            RayBatch GetBatch(uint32_t first, float tMin, float tMax) const
+            {
+                return RayBatch{ origin[0].data() + first, origin[1].data() + first, origin[2].data() + first,
+                    direction[0].data() + first, direction[1].data() + first, direction[2].data() + first, tMin, tMax };
+            }
+        };
+
+        //Primary rays of every pixel and the AO ray of every pixel with depth, like the tracer shoots them
+        void GetFrameRays(AmbientOcclusionTracer& tracer, AOCamera const& camera, uint32_t frameIndex, BenchmarkOptions const& options,
+            ThreadPool& threadPool, FrameRays& primaryRays, FrameRays& aoRays)
+        {
+            FrameData frame;
+            tracer.TraceGBuffer(camera, options.screenWidth, options.screenHeight, threadPool, frame);
+            uint2 const screenDimensions = { frame.width, frame.height };
+            for (uint32_t y = 0; y < frame.height; ++y)
+            {
+                for (uint32_t x = 0; x < frame.width; ++x)
+                {
+                    float3 const nearPoint = DepthToWorldPosition(1.f, uint2{ x, y }, screenDimensions, frame.viewProjectionInverse).xyz();
+                    primaryRays.Add(camera.position, normalize(nearPoint - camera.position));
+
+                    uint32_t const index = x + y * frame.width;
+                    if (asint(frame.depth[index]) == 0)
+                        continue;
+                    float3 const worldPosition = DepthToWorldPosition(frame.depth[index], uint2{ x, y }, screenDimensions, frame.viewProjectionInverse).xyz();
+                    uint32_t randSeed = InitRand(index, frameIndex, 16);
+                    float3 const worldDirection = GetCosHemisphereSample(randSeed, tracer.GetNormalBuffer()[index]);
+                    aoRays.Add(worldPosition + (worldDirection * 0.01f), worldDirection);
+                }
+            }
+        }
+
+        enum class Tree
+        {
+            Binary,
+            Wide
+        };
+
+        struct Variant
+        {
+            char const* name;
+            Tree tree;
+            SimdWidth width; //Packets of the binary tree, child test of the wide one
+        };
+    }
+
+    int WideBVHBenchmark(BenchmarkOptions const& options)
+    {
+        H3DModel model;
+        if (!GetBenchmarkModel(options, model))
+        {
+            std::printf("Failed to load model %s\n", options.modelFile.c_str());
+            return 1;
+        }
+
+        TriangleMesh mesh;
+        if (!GetTriangleMesh(model, mesh))
+        {
+            std::printf("Model %s has indices past the vertices of their mesh\n", options.modelFile.c_str());
+            return 1;
+        }
+        uint32_t const triangleCount = uint32_t(mesh.indices.size() / 3);
+
+        BVH bvh;
+        Clock::time_point start = Clock::now();
+        bvh.Build(mesh.positions.data(), mesh.indices.data(), triangleCount);
+        double const binaryMilliseconds = MillisecondsSince(start);
+        WideBVH wideBVH;
+        start = Clock::now();
+        wideBVH.Build(bvh);
+        double const wideMilliseconds = MillisecondsSince(start);
+
+        std::printf("widebvh: %s, %u triangles, %u frames, %ux%u\n", options.modelFile.empty() ? "synthetic model" : options.modelFile.c_str(),
+            triangleCount, options.frames, options.screenWidth, options.screenHeight);
+        double const triangles = double(std::max(triangleCount, 1u));
+        size_t const binaryNodeBytes = bvh.GetNodes().size() * sizeof(BVHNode);
+        size_t const wideNodeBytes = size_t(wideBVH.GetNodeCount()) * sizeof(WideBVHNode);
+        std::printf("%8s %10s %10s %14s %14s %12s\n", "tree", "build ms", "nodes", "node B/tri", "total B/tri", "total MB");
+        std::printf("%8s %10.2f %10zu %14.2f %14.2f %12.2f\n", "binary", binaryMilliseconds, bvh.GetNodes().size(), double(binaryNodeBytes) / triangles,
+            double(bvh.GetMemorySize()) / triangles, double(bvh.GetMemorySize()) / (1024.0 * 1024.0));
+        std::printf("%8s %10.2f %10u %14.2f %14.2f %12.2f\n", "wide", binaryMilliseconds + wideMilliseconds, wideBVH.GetNodeCount(),
+            double(wideNodeBytes) / triangles, double(wideBVH.GetMemorySize()) / triangles, double(wideBVH.GetMemorySize()) / (1024.0 * 1024.0));
+
+        //Camera rays of the benchmark frames, traced once through the two level structure
+        std::vector<FrameRays> primaryRays(options.frames);
+        std::vector<FrameRays> aoRays(options.frames);
+        {
+            ThreadPool threadPool;
+            AccelerationStructure scene;
+            scene.Build(mesh, threadPool);
+            AmbientOcclusionTracer tracer(scene);
+            for (uint32_t f = 0; f < options.frames; ++f)
+                GetFrameRays(tracer, GetBenchmarkCamera(options, model, f), f, options, threadPool, primaryRays[f], aoRays[f]);
+        }
+
+        std::vector<Variant> variants = { { "binary", Tree::Binary, SimdWidth::Scalar }, { "wide", Tree::Wide, SimdWidth::Scalar } };
+        if (GetMaxSimdWidth() >= SimdWidth::AVX2)
+        {
+            variants.push_back(Variant{ "binary", Tree::Binary, GetMaxSimdWidth() });
+            variants.push_back(Variant{ "wide", Tree::Wide, SimdWidth::AVX2 });
+        }
+
+        std::printf("%8s %8s %8s %16s %14s %14s %14s %12s\n", "threads", "tree", "simd", "primary Mrays/s", "same closest", "AO Mrays/s",
+            "speedup", "same hits");
+        for (uint32_t threadCount : GetThreadCounts(options))
+        {
+            ThreadPool threadPool(threadCount);
+
+            //Reference: binary tree, one ray at a time
+            std::vector<std::vector<RayHit>> referenceHits(options.frames);
+            std::vector<std::vector<float>> referenceT(options.frames);
+            double referenceMilliseconds = 0.0;
+            for (Variant const& variant : variants)
+            {
+                double primaryMilliseconds = 0.0;
+                double aoMilliseconds = 0.0;
+                uint64_t primaryCount = 0;
+                uint64_t aoCount = 0;
+                uint64_t sameClosest = 0;
+                uint64_t sameHits = 0;
+                bool const reference = &variant == &variants[0];
+                for (uint32_t f = 0; f < options.frames; ++f)
+                {
+                    //Closest hits: the binary tree has no packet version of those, its SIMD variant traces them one by one as well
+                    FrameRays const& primary = primaryRays[f];
+                    std::vector<RayHit> hits(primary.count);
+                    start = Clock::now();
+                    threadPool.ParallelFor((primary.count + RaysPerJob - 1) / RaysPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+                    {
+                        for (uint32_t i = job * RaysPerJob; i < std::min(primary.count, (job + 1) * RaysPerJob); ++i)
+                        {
+                            float3 const origin = { primary.origin[0][i], primary.origin[1][i], primary.origin[2][i] };
+                            float3 const direction = { primary.direction[0][i], primary.direction[1][i], primary.direction[2][i] };
+                            bool const found = variant.tree == Tree::Binary ? bvh.Intersect(origin, direction, 0.f, FLT_MAX, hits[i])
+                                : wideBVH.Intersect(origin, direction, 0.f, FLT_MAX, hits[i], variant.width);
+                            if (!found)
+                                hits[i].triangle = UINT32_MAX;
+                        }
+                    });
+                    primaryMilliseconds += MillisecondsSince(start);
+                    primaryCount += primary.count;
+
+                    FrameRays const& ao = aoRays[f];
+                    std::vector<float> hitT(ao.count);
+                    start = Clock::now();
+                    threadPool.ParallelFor((ao.count + RaysPerJob - 1) / RaysPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+                    {
+                        uint32_t const first = job * RaysPerJob;
+                        RayBatch const batch = ao.GetBatch(first, AORayTMin, AORadius);
+                        uint32_t const count = std::min(RaysPerJob, ao.count - first);
+                        if (variant.tree == Tree::Binary)
+                            IntersectAnyBatch(bvh, batch, count, hitT.data() + first, variant.width);
+                        else
+                            IntersectAnyBatch(wideBVH, batch, count, hitT.data() + first, variant.width);
+                    });
+                    aoMilliseconds += MillisecondsSince(start);
+                    aoCount += ao.count;
+
+                    if (reference)
+                    {
+                        referenceHits[f] = hits;
+                        referenceT[f] = hitT;
+                    }
+                    for (uint32_t i = 0; i < primary.count; ++i)
+                        sameClosest += hits[i].triangle == referenceHits[f][i].triangle ? 1 : 0;
+                    for (uint32_t i = 0; i < ao.count; ++i)
+                        sameHits += (hitT[i] < AORadius) == (referenceT[f][i] < AORadius) ? 1 : 0;
+                }
+                if (reference)
+                    referenceMilliseconds = aoMilliseconds;
+
+                std::printf("%8u %8s %8s %16.2f %13.4f%% %14.2f %13.2fx %11.4f%%\n", threadPool.GetThreadCount(), variant.name, GetSimdWidthName(variant.width),
+                    double(primaryCount) / (primaryMilliseconds * 1000.0), (100.0 * double(sameClosest)) / double(std::max<uint64_t>(primaryCount, 1)),
+                    double(aoCount) / (aoMilliseconds * 1000.0), referenceMilliseconds / aoMilliseconds,
+                    (100.0 * double(sameHits)) / double(std::max<uint64_t>(aoCount, 1)));
+            }
+        }
+        return 0;
+    }
+} //namespace ImplicitPointBench
@@ -0,0 +1,236 @@
+#include "AccelerationStructure.h"
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        BVHBounds const EmptyBounds = { float3{ FLT_MAX, FLT_MAX, FLT_MAX }, float3{ -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+        //Closest hit over the instances, or the first hit found when AnyHit
+        template<bool AnyHit>
+        bool TraverseInstances(AccelerationStructure const& scene, float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit)
+        {
+            std::vector<BVHNode> const& nodes = scene.GetTLASNodes();
+            if (nodes.empty())
+                return false;
+
+            std::vector<BVHInstance> const& instances = scene.GetInstances();
+            std::vector<uint32_t> const& leafInstances = scene.GetTLASInstances();
+            std::vector<uint32_t> const& meshFirstTriangle = scene.GetTriangleMesh().meshFirstTriangle;
+            float3 const inverseDirection = { 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+
+            bool found = false;
+            uint32_t stack[64];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0)
+            {
+                BVHNode const& node = nodes[stack[--stackSize]];
+                if (!IntersectBounds(node, origin, inverseDirection, tMin, tMax))
+                    continue;
+
+                if (node.triangleCount > 0)
+                {
+                    for (uint32_t i = node.leftFirst; i < node.leftFirst + node.triangleCount; ++i)
+                    {
+                        //The object space direction isn't normalized, so t is the same in both spaces
+                        uint32_t const instanceIndex = leafInstances[i];
+                        BVHInstance const& instance = instances[instanceIndex];
+                        float3 const objectOrigin = TransformPoint(instance.worldToObject, origin);
+                        float3 const objectDirection = TransformVector(instance.worldToObject, direction);
+                        BVH const& bvh = scene.GetMeshBVH(instance.mesh);
+                        if (AnyHit)
+                        {
+                            float const t = bvh.IntersectAny(objectOrigin, objectDirection, tMin, tMax);
+                            if (t < tMax)
+                            {
+                                hit.t = t;
+                                hit.instance = instanceIndex;
+                                return true;
+                            }
+                            continue;
+                        }
+
+                        if (!bvh.Intersect(objectOrigin, objectDirection, tMin, tMax, hit))
+                            continue;
+                        hit.triangle += meshFirstTriangle[instance.mesh];
+                        hit.instance = instanceIndex;
+                        found = true;
+                        tMax = hit.t;
+                    }
+                    continue;
+                }
+
+                bool const negative = direction[node.splitAxis] < 0.f;
+                stack[stackSize++] = node.leftFirst + (negative ? 0 : 1);
+                stack[stackSize++] = node.leftFirst + (negative ? 1 : 0);
+            }
+            return found;
+        }
+    }
+
+    void AccelerationStructure::Build(TriangleMesh const& mesh, ThreadPool& threadPool, BVHBuildSettings const& settings)
+    {
+        m_pMesh = &mesh;
+        m_Settings = settings;
+
+        uint32_t const meshCount = mesh.meshFirstTriangle.empty() ? 0 : uint32_t(mesh.meshFirstTriangle.size()) - 1;
+        m_MeshBVHs.clear();
+        m_MeshBVHs.resize(meshCount);
+        m_MeshBuildCosts.assign(meshCount, 0.f);
+
+        //Largest meshes first, so no large mesh starts last and keeps one core busy while the others are done
+        std::vector<uint32_t> order(meshCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+        {
+            return mesh.meshFirstTriangle[a + 1] - mesh.meshFirstTriangle[a] > mesh.meshFirstTriangle[b + 1] - mesh.meshFirstTriangle[b];
+        });
+        threadPool.ParallelFor(meshCount, [&](uint32_t i, uint32_t /*threadIndex*/)
+        {
+            RebuildMesh(order[i]);
+        });
+
+        m_Instances.clear();
+        for (uint32_t i = 0; i < meshCount; ++i)
+            AddInstance(i, Identity());
+        BuildTLAS();
+    }
+
+    void AccelerationStructure::RebuildMesh(uint32_t mesh)
+    {
+        uint32_t const firstTriangle = m_pMesh->meshFirstTriangle[mesh];
+        uint32_t const triangleCount = m_pMesh->meshFirstTriangle[mesh + 1] - firstTriangle;
+        m_MeshBVHs[mesh].Build(m_pMesh->positions.data(), m_pMesh->indices.data() + 3 * size_t(firstTriangle), triangleCount, m_Settings);
+        m_MeshBuildCosts[mesh] = m_MeshBVHs[mesh].GetSAHCost(m_Settings.traversalCost);
+    }
+
+    void AccelerationStructure::RefitMesh(uint32_t mesh)
+    {
+        uint32_t const firstTriangle = m_pMesh->meshFirstTriangle[mesh];
+        m_MeshBVHs[mesh].Refit(m_pMesh->positions.data(), m_pMesh->indices.data() + 3 * size_t(firstTriangle));
+    }
+
+    bool AccelerationStructure::UpdateMesh(uint32_t mesh, float maxCostIncrease)
+    {
+        RefitMesh(mesh);
+        if (!(m_MeshBVHs[mesh].GetSAHCost(m_Settings.traversalCost) > m_MeshBuildCosts[mesh] * maxCostIncrease))
+            return false;
+        RebuildMesh(mesh);
+        return true;
+    }
+
+    uint32_t AccelerationStructure::AddInstance(uint32_t mesh, float4x4 const& objectToWorld)
+    {
+        m_Instances.push_back(BVHInstance{ mesh, objectToWorld, Invert(objectToWorld), EmptyBounds });
+        return uint32_t(m_Instances.size()) - 1;
+    }
+
+    void AccelerationStructure::SetInstanceTransform(uint32_t instance, float4x4 const& objectToWorld)
+    {
+        m_Instances[instance].objectToWorld = objectToWorld;
+        m_Instances[instance].worldToObject = Invert(objectToWorld);
+    }
+
+    void AccelerationStructure::UpdateInstanceBounds(BVHInstance& instance) const
+    {
+        instance.worldBounds = EmptyBounds;
+        BVH const& bvh = m_MeshBVHs[instance.mesh];
+        if (bvh.GetTriangles().empty())
+            return;
+
+        //The 8 corners of the BLAS root bounds
+        BVHNode const& root = bvh.GetNodes()[0];
+        for (uint32_t corner = 0; corner < 8; ++corner)
+        {
+            float3 const objectPoint = {
+                (corner & 1) ? root.boundsMax.x : root.boundsMin.x,
+                (corner & 2) ? root.boundsMax.y : root.boundsMin.y,
+                (corner & 4) ? root.boundsMax.z : root.boundsMin.z };
+            float3 const point = TransformPoint(instance.objectToWorld, objectPoint);
+            BVHBounds& bounds = instance.worldBounds;
+            bounds.min = float3{ min(bounds.min.x, point.x), min(bounds.min.y, point.y), min(bounds.min.z, point.z) };
+            bounds.max = float3{ max(bounds.max.x, point.x), max(bounds.max.y, point.y), max(bounds.max.z, point.z) };
+        }
+    }
+
+    void AccelerationStructure::BuildTLAS()
+    {
+        //Instances of meshes without triangles stay out of the TLAS, their bounds are empty
+        std::vector<BVHBounds> instanceBounds;
+        std::vector<uint32_t> boundsInstances;
+        for (uint32_t i = 0; i < uint32_t(m_Instances.size()); ++i)
+        {
+            UpdateInstanceBounds(m_Instances[i]);
+            if (m_MeshBVHs[m_Instances[i].mesh].GetTriangles().empty())
+                continue;
+            instanceBounds.push_back(m_Instances[i].worldBounds);
+            boundsInstances.push_back(i);
+        }
+        BuildBVHNodes(instanceBounds, m_Settings, m_TLASNodes, m_TLASInstances);
+        for (uint32_t& instance : m_TLASInstances)
+            instance = boundsInstances[instance];
+        m_TLASBuildCost = GetSAHCost(m_TLASNodes, m_Settings.traversalCost);
+    }
+
+    void AccelerationStructure::RefitTLAS()
+    {
+        for (BVHInstance& instance : m_Instances)
+            UpdateInstanceBounds(instance);
+        if (m_TLASInstances.empty())
+            return;
+
+        RefitBVHNodes(m_TLASNodes, [&](uint32_t i)
+        {
+            return m_Instances[m_TLASInstances[i]].worldBounds;
+        });
+    }
+
+    bool AccelerationStructure::UpdateTLAS(float maxCostIncrease)
+    {
+        RefitTLAS();
+        if (!(GetSAHCost(m_TLASNodes, m_Settings.traversalCost) > m_TLASBuildCost * maxCostIncrease))
+            return false;
+        BuildTLAS();
+        return true;
+    }
+
+    bool AccelerationStructure::Intersect(float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit) const
+    {
+        return TraverseInstances<false>(*this, origin, direction, tMin, tMax, hit);
+    }
+
+    float AccelerationStructure::IntersectAny(float3 const& origin, float3 const& direction, float tMin, float tMax) const
+    {
+        RayHit hit;
+        return TraverseInstances<true>(*this, origin, direction, tMin, tMax, hit) ? hit.t : tMax;
+    }
+
+    size_t AccelerationStructure::GetMemorySize() const
+    {
+        size_t size = m_Instances.size() * sizeof(BVHInstance) + m_TLASNodes.size() * sizeof(BVHNode) + m_TLASInstances.size() * sizeof(uint32_t);
+        for (BVH const& bvh : m_MeshBVHs)
+            size += bvh.GetMemorySize();
+        return size;
+    }
+
+    void IntersectAnyBatch(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT, SimdWidth width)
+    {
+        width = min(width, GetMaxSimdWidth());
+        uint32_t const vectorCount = count - (count % uint32_t(width));
+        if (width == SimdWidth::AVX512)
+            IntersectAnyAVX512(scene, rays, vectorCount, hitT);
+        else if (width == SimdWidth::AVX2)
+            IntersectAnyAVX2(scene, rays, vectorCount, hitT);
+
+        for (uint32_t i = (width == SimdWidth::Scalar ? 0 : vectorCount); i < count; ++i)
+        {
+            float3 const origin = { rays.originX[i], rays.originY[i], rays.originZ[i] };
+            float3 const direction = { rays.directionX[i], rays.directionY[i], rays.directionZ[i] };
+            hitT[i] = scene.IntersectAny(origin, direction, rays.tMin, rays.tMax);
+        }
+    }
+} //namespace ImplicitPointCPU
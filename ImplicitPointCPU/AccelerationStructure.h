@@ -0,0 +1,86 @@
+//Two level acceleration structure like the one the demo builds for DXR: a bottom level BVH (BLAS) per mesh of the model and a
+//top level BVH (TLAS) over instances of those meshes, each with its own transform. The BLAS are independent of each other:
+//they are built in parallel, one mesh per job, and rebuilding one mesh only costs that mesh and the small TLAS.
+//Moving geometry is updated by refitting: the trees keep their layout and only their bounds follow the new vertex positions
+//or instance transforms. A refit tree is rebuilt once its SAH cost grew too far past the cost it was built with.
+#pragma once
+#include "BVH.h"
+#include "H3DModel.h"
+#include "ThreadPool.h"
+
+namespace ImplicitPointCPU
+{
+    struct BVHInstance
+    {
+        uint32_t mesh;          //BLAS of the instance
+        float4x4 objectToWorld;
+        float4x4 worldToObject;
+        BVHBounds worldBounds;  //BLAS root bounds transformed to world space
+    };
+
+    //Refit trees whose SAH cost grew past this factor of their build cost are rebuilt by UpdateMesh/UpdateTLAS
+    float const DefaultMaxCostIncrease = 1.5f;
+
+    class AccelerationStructure
+    {
+    public:
+        //mesh has to outlive the structure. Every mesh of it (meshFirstTriangle) gets a BLAS and an instance with an identity transform.
+        void Build(TriangleMesh const& mesh, ThreadPool& threadPool, BVHBuildSettings const& settings = BVHBuildSettings());
+
+        //Builds the BLAS of one mesh again from the current positions of the TriangleMesh, the other BLAS are left untouched.
+        //The TLAS has to be rebuilt afterwards.
+        void RebuildMesh(uint32_t mesh);
+
+        //Bounds of the BLAS of one mesh refit to the current positions of the TriangleMesh, the TLAS has to be refit afterwards
+        void RefitMesh(uint32_t mesh);
+
+        //RefitMesh, followed by RebuildMesh when the refit BLAS costs more than maxCostIncrease times its build cost. True when rebuilt.
+        bool UpdateMesh(uint32_t mesh, float maxCostIncrease = DefaultMaxCostIncrease);
+
+        //Instances take effect with the next BuildTLAS
+        uint32_t AddInstance(uint32_t mesh, float4x4 const& objectToWorld);
+        void SetInstanceTransform(uint32_t instance, float4x4 const& objectToWorld);
+        void BuildTLAS();
+
+        //Instance bounds and TLAS nodes refit to the current transforms and BLAS bounds, for instances that moved. Instances
+        //added since the last BuildTLAS aren't in the tree yet.
+        void RefitTLAS();
+
+        //RefitTLAS, followed by BuildTLAS when the TLAS costs more than maxCostIncrease times its build cost. True when rebuilt.
+        bool UpdateTLAS(float maxCostIncrease = DefaultMaxCostIncrease);
+
+        //Closest hit over all instances, hit.triangle indexes the TriangleMesh and hit.instance the instances
+        bool Intersect(float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit) const;
+
+        //Any hit over all instances, see BVH::IntersectAny
+        float IntersectAny(float3 const& origin, float3 const& direction, float tMin, float tMax) const;
+
+        TriangleMesh const& GetTriangleMesh() const { return *m_pMesh; }
+        uint32_t GetMeshCount() const { return uint32_t(m_MeshBVHs.size()); }
+        BVH const& GetMeshBVH(uint32_t mesh) const { return m_MeshBVHs[mesh]; }
+        std::vector<BVHInstance> const& GetInstances() const { return m_Instances; }
+        std::vector<BVHNode> const& GetTLASNodes() const { return m_TLASNodes; }
+        std::vector<uint32_t> const& GetTLASInstances() const { return m_TLASInstances; } //Leaf order -> instance
+        float GetMeshBuildCost(uint32_t mesh) const { return m_MeshBuildCosts[mesh]; }          //SAH cost at the last RebuildMesh
+        float GetTLASBuildCost() const { return m_TLASBuildCost; }
+        size_t GetMemorySize() const;
+
+    private:
+        TriangleMesh const* m_pMesh = nullptr;
+        BVHBuildSettings m_Settings;
+        std::vector<BVH> m_MeshBVHs;
+        std::vector<float> m_MeshBuildCosts;
+        std::vector<BVHInstance> m_Instances;
+        std::vector<BVHNode> m_TLASNodes;
+        std::vector<uint32_t> m_TLASInstances;
+        float m_TLASBuildCost = 0.f;
+
+        void UpdateInstanceBounds(BVHInstance& instance) const;
+    };
+
+    //IntersectAnyBatch over both levels, the packets stay together through the TLAS and are transformed into every instance they enter
+    void IntersectAnyBatch(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT, SimdWidth width);
+
+    void IntersectAnyAVX2(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT);
+    void IntersectAnyAVX512(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,199 @@
+#include "AmbientOcclusionTracer.h"
+#include "SharedUtilities.h"
+#include <cfloat>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        //Right handed view matrix, camera looks down -z in view space
+        float4x4 CreateView(AOCamera const& camera, float3& forward)
+        {
+            forward = normalize(camera.lookDirection);
+            float3 const right = normalize(cross(forward, camera.up));
+            float3 const up = cross(right, forward);
+            float3 const& position = camera.position;
+
+            float4x4 view = Identity();
+            view.m[0][0] = right.x;    view.m[0][1] = right.y;    view.m[0][2] = right.z;    view.m[0][3] = -dot(right, position);
+            view.m[1][0] = up.x;       view.m[1][1] = up.y;       view.m[1][2] = up.z;       view.m[1][3] = -dot(up, position);
+            view.m[2][0] = -forward.x; view.m[2][1] = -forward.y; view.m[2][2] = -forward.z; view.m[2][3] = dot(forward, position);
+            return view;
+        }
+
+        //Reverse-Z perspective: near plane maps to depth 1, far plane to depth 0
+        float4x4 CreateProjection(AOCamera const& camera, float aspect)
+        {
+            float const cotangent = 1.f / std::tan(camera.verticalFOV * 0.5f);
+            float4x4 projection = {};
+            projection.m[0][0] = cotangent / aspect;
+            projection.m[1][1] = cotangent;
+            projection.m[2][2] = camera.nearPlane / (camera.farPlane - camera.nearPlane);
+            projection.m[2][3] = (camera.farPlane * camera.nearPlane) / (camera.farPlane - camera.nearPlane);
+            projection.m[3][2] = -1.f;
+            return projection;
+        }
+    }
+
+    //--------- RayTracingUtils.hlsli ---------
+    uint32_t InitRand(uint32_t val0, uint32_t val1, uint32_t backoff)
+    {
+        uint32_t v0 = val0, v1 = val1, s0 = 0;
+        for (uint32_t n = 0; n < backoff; n++)
+        {
+            s0 += 0x9e3779b9;
+            v0 += ((v1 << 4) + 0xa341316c) ^ (v1 + s0) ^ ((v1 >> 5) + 0xc8013ea4);
+            v1 += ((v0 << 4) + 0xad90777d) ^ (v0 + s0) ^ ((v0 >> 5) + 0x7e95761e);
+        }
+        return v0;
+    }
+
+    float NextRand(uint32_t& s)
+    {
+        s = (1664525u * s + 1013904223u);
+        return float(s & 0x00FFFFFF) / float(0x01000000);
+    }
+
+    float3 GetPerpendicularVector(float3 const& u)
+    {
+        float3 const a = abs(u);
+        uint32_t const xm = ((a.x - a.y) < 0 && (a.x - a.z) < 0) ? 1 : 0;
+        uint32_t const ym = (a.y - a.z) < 0 ? (1 ^ xm) : 0;
+        uint32_t const zm = 1 ^ (xm | ym);
+        return cross(u, float3{ float(xm), float(ym), float(zm) });
+    }
+
+    float3 GetCosHemisphereSample(uint32_t& randSeed, float3 const& hitNorm)
+    {
+        //Both random numbers are drawn before anything else, in this order, like the float2 constructor of the shader
+        float const randX = NextRand(randSeed);
+        float const randY = NextRand(randSeed);
+
+        float3 const bitangent = GetPerpendicularVector(hitNorm);
+        float3 const tangent = cross(bitangent, hitNorm);
+        float const r = std::sqrt(randX);
+        float const phi = 2.0f * 3.14159265f * randY;
+
+        return tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi)) + hitNorm * std::sqrt(1 - randX);
+    }
+
+    //--------- RayGeneration.hlsl ---------
+    float ShootRayInHemisphere(AccelerationStructure const& scene, float3 const& worldPosition, float3 const& worldDirection)
+    {
+        return saturate(scene.IntersectAny(worldPosition, worldDirection, AORayTMin, AORadius) / AORadius);
+    }
+
+    void AmbientOcclusionTracer::RenderFrame(AOCamera const& camera, uint32_t width, uint32_t height, uint32_t frameCount, SimdWidth simdWidth,
+        ThreadPool& threadPool, FrameData& frame)
+    {
+        TraceGBuffer(camera, width, height, threadPool, frame);
+        TraceAmbientOcclusion(frameCount, simdWidth, threadPool, frame);
+    }
+
+    void AmbientOcclusionTracer::TraceGBuffer(AOCamera const& camera, uint32_t width, uint32_t height, ThreadPool& threadPool, FrameData& frame)
+    {
+        frame.Resize(width, height);
+        m_Normals.assign(size_t(width) * height, float3{ 0.f, 0.f, 0.f });
+
+        float3 forward = {};
+        float4x4 const view = CreateView(camera, forward);
+        float4x4 const viewProjection = mul(CreateProjection(camera, float(width) / float(height)), view);
+        frame.viewProjectionInverse = Invert(viewProjection);
+        frame.viewInverse = Invert(view);
+        frame.viewVector = forward;
+
+        //Rays through the pixel corners, the positions DepthToWorldPosition reconstructs
+        uint2 const screenDimensions = { width, height };
+        TriangleMesh const& mesh = m_Scene.GetTriangleMesh();
+        threadPool.ParallelFor(height, [&](uint32_t y, uint32_t /*threadIndex*/)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                float3 const nearPoint = DepthToWorldPosition(1.f, uint2{ x, y }, screenDimensions, frame.viewProjectionInverse).xyz();
+                float3 const direction = normalize(nearPoint - camera.position);
+
+                RayHit hit;
+                if (!m_Scene.Intersect(camera.position, direction, 0.f, FLT_MAX, hit))
+                    continue;
+
+                float3 const hitPosition = camera.position + direction * hit.t;
+                float4 const clip = mul(viewProjection, float4{ hitPosition.x, hitPosition.y, hitPosition.z, 1.f });
+                float const depth = clip.z / clip.w;
+                if (!(depth > 0.f && depth <= 1.f))
+                    continue;
+
+                uint32_t const index = x + y * width;
+                frame.depth[index] = depth;
+
+                //Interpolated vertex normal, the geometric one facing the camera for meshes without normals. Object space normals
+                //go to world space with the inverse transpose of the instance transform.
+                uint32_t const* const triangle = &mesh.indices[3 * size_t(hit.triangle)];
+                float3 normal = mesh.normals[triangle[0]] * (1.f - hit.u - hit.v) + mesh.normals[triangle[1]] * hit.u + mesh.normals[triangle[2]] * hit.v;
+                bool const geometricNormal = !(dot(normal, normal) > 0.f);
+                if (geometricNormal)
+                    normal = cross(mesh.positions[triangle[1]] - mesh.positions[triangle[0]], mesh.positions[triangle[2]] - mesh.positions[triangle[0]]);
+                float4x4 const& worldToObject = m_Scene.GetInstances()[hit.instance].worldToObject;
+                normal = float3{
+                    worldToObject.m[0][0] * normal.x + worldToObject.m[1][0] * normal.y + worldToObject.m[2][0] * normal.z,
+                    worldToObject.m[0][1] * normal.x + worldToObject.m[1][1] * normal.y + worldToObject.m[2][1] * normal.z,
+                    worldToObject.m[0][2] * normal.x + worldToObject.m[1][2] * normal.y + worldToObject.m[2][2] * normal.z };
+                if (geometricNormal && dot(normal, direction) > 0.f)
+                    normal = -normal;
+                m_Normals[index] = normalize(normal);
+            }
+        });
+
+        m_PrimaryRayCount = uint64_t(width) * height;
+    }
+
+    void AmbientOcclusionTracer::TraceAmbientOcclusion(uint32_t frameCount, SimdWidth simdWidth, ThreadPool& threadPool, FrameData& frame)
+    {
+        uint32_t const width = frame.width;
+        uint2 const screenDimensions = { frame.width, frame.height };
+        m_AORayCount = 0;
+
+        threadPool.ParallelFor(frame.height, [&](uint32_t y, uint32_t /*threadIndex*/)
+        {
+            //The rays of the row as structure of arrays, for the packet traversal
+            std::vector<float> rays(7 * size_t(width));
+            float* const originX = rays.data();
+            float* const originY = originX + width;
+            float* const originZ = originY + width;
+            float* const directionX = originZ + width;
+            float* const directionY = directionX + width;
+            float* const directionZ = directionY + width;
+            float* const hitT = directionZ + width;
+            std::vector<uint32_t> pixels;
+            pixels.reserve(width);
+
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint32_t const index = x + y * width;
+                float const depth = frame.depth[index];
+                frame.ambientOcclusion[index] = 0.f;
+                if (asint(depth) == 0)
+                    continue;
+
+                float3 const worldPosition = DepthToWorldPosition(depth, uint2{ x, y }, screenDimensions, frame.viewProjectionInverse).xyz();
+                uint32_t randSeed = InitRand(index, frameCount, 16);
+                float3 const worldDirection = GetCosHemisphereSample(randSeed, m_Normals[index]);
+                float3 const origin = worldPosition + (worldDirection * 0.01f);
+
+                uint32_t const ray = uint32_t(pixels.size());
+                originX[ray] = origin.x;
+                originY[ray] = origin.y;
+                originZ[ray] = origin.z;
+                directionX[ray] = worldDirection.x;
+                directionY[ray] = worldDirection.y;
+                directionZ[ray] = worldDirection.z;
+                pixels.push_back(index);
+            }
+
+            RayBatch const batch = { originX, originY, originZ, directionX, directionY, directionZ, AORayTMin, AORadius };
+            IntersectAnyBatch(m_Scene, batch, uint32_t(pixels.size()), hitT, simdWidth);
+            for (uint32_t ray = 0; ray < uint32_t(pixels.size()); ++ray)
+                frame.ambientOcclusion[pixels[ray]] = saturate(hitT[ray] / AORadius);
+            m_AORayCount += pixels.size();
+        });
+    }
+} //namespace ImplicitPointCPU
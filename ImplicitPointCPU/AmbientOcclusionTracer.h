@@ -0,0 +1,65 @@
+//CPU version of the ray traced AO of the demo (RayGeneration.hlsl, Hit.hlsl, Miss.hlsl, RayTracingUtils.hlsli): renders
+//the depth buffer of a triangle model with primary rays, then shoots one cosine weighted AO ray per pixel with the same
+//random sequence, origin offset and AO radius as the ray generation shader. Produces the FrameData the engine consumes
+//without a DXR capable GPU.
+#pragma once
+#include "AccelerationStructure.h"
+#include "FrameData.h"
+#include "H3DModel.h"
+#include "ThreadPool.h"
+#include <atomic>
+
+namespace ImplicitPointCPU
+{
+    //--------- RayTracingUtils.hlsli ---------
+    uint32_t InitRand(uint32_t val0, uint32_t val1, uint32_t backoff = 16);
+    float NextRand(uint32_t& s);
+    float3 GetPerpendicularVector(float3 const& u);
+    float3 GetCosHemisphereSample(uint32_t& randSeed, float3 const& hitNorm);
+
+    //--------- RayGeneration.hlsl ---------
+    float const AORayTMin = 0.01f;
+    float const AORadius = 25.f; //TMax of the AO rays
+
+    //Occlusion of one AO ray, the any hit t relative to the AO radius (Hit.hlsl stores RayTCurrent, Miss.hlsl keeps TMax)
+    float ShootRayInHemisphere(AccelerationStructure const& scene, float3 const& worldPosition, float3 const& worldDirection);
+
+    //Camera like the demo's MiniEngine camera: right handed, reverse-Z
+    struct AOCamera
+    {
+        float3 position;
+        float3 lookDirection;
+        float3 up;
+        float verticalFOV = 0.7853981f; //45 degrees
+        float nearPlane = 1.f;
+        float farPlane = 10000.f;
+    };
+
+    class AmbientOcclusionTracer
+    {
+    public:
+        //scene has to outlive the tracer, the normals come from the TriangleMesh it was built from
+        explicit AmbientOcclusionTracer(AccelerationStructure const& scene)
+            : m_Scene(scene)
+        {}
+
+        //Both passes: a frame of width x height as the ray generation shader of frame frameCount would produce it
+        void RenderFrame(AOCamera const& camera, uint32_t width, uint32_t height, uint32_t frameCount, SimdWidth simdWidth, ThreadPool& threadPool, FrameData& frame);
+
+        //Primary rays: camera matrices, depth and the world normal buffer (interpolated vertex normals, like the GBuffer)
+        void TraceGBuffer(AOCamera const& camera, uint32_t width, uint32_t height, ThreadPool& threadPool, FrameData& frame);
+
+        //AO rays of the pixels with depth, a row per job, traced with IntersectAnyBatch
+        void TraceAmbientOcclusion(uint32_t frameCount, SimdWidth simdWidth, ThreadPool& threadPool, FrameData& frame);
+
+        std::vector<float3> const& GetNormalBuffer() const { return m_Normals; }
+        uint64_t GetPrimaryRayCount() const { return m_PrimaryRayCount; } //Of the last TraceGBuffer
+        uint64_t GetAORayCount() const { return m_AORayCount; }           //Of the last TraceAmbientOcclusion
+
+    private:
+        AccelerationStructure const& m_Scene;
+        std::vector<float3> m_Normals;
+        uint64_t m_PrimaryRayCount = 0;
+        std::atomic<uint64_t> m_AORayCount{ 0 };
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,322 @@
+#include "BVH.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        typedef BVHBounds Bounds;
+
+        Bounds const EmptyBounds = { float3{ FLT_MAX, FLT_MAX, FLT_MAX }, float3{ -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+        void Grow(Bounds& bounds, float3 const& point)
+        {
+            bounds.min = float3{ min(bounds.min.x, point.x), min(bounds.min.y, point.y), min(bounds.min.z, point.z) };
+            bounds.max = float3{ max(bounds.max.x, point.x), max(bounds.max.y, point.y), max(bounds.max.z, point.z) };
+        }
+
+        void Grow(Bounds& bounds, Bounds const& other)
+        {
+            Grow(bounds, other.min);
+            Grow(bounds, other.max);
+        }
+
+        float SurfaceArea(float3 const& boundsMin, float3 const& boundsMax)
+        {
+            float3 const extent = boundsMax - boundsMin;
+            if (extent.x < 0.f)
+                return 0.f;
+            return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        struct Bin
+        {
+            Bounds bounds;
+            uint32_t count;
+        };
+
+        struct BuildTask
+        {
+            uint32_t node;
+            uint32_t first;
+            uint32_t count;
+        };
+
+        //Closest hit, or the first hit found when AnyHit
+        template<bool AnyHit>
+        bool Traverse(BVH const& bvh, float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit)
+        {
+            std::vector<BVHNode> const& nodes = bvh.GetNodes();
+            if (nodes.empty())
+                return false;
+
+            std::vector<BVHTriangle> const& triangles = bvh.GetTriangles();
+            float3 const inverseDirection = { 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+
+            bool found = false;
+            uint32_t stack[64];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0)
+            {
+                BVHNode const& node = nodes[stack[--stackSize]];
+                if (!IntersectBounds(node, origin, inverseDirection, tMin, tMax))
+                    continue;
+
+                if (node.triangleCount > 0)
+                {
+                    for (uint32_t i = node.leftFirst; i < node.leftFirst + node.triangleCount; ++i)
+                    {
+                        if (!IntersectTriangle(triangles[i], origin, direction, tMin, tMax, hit))
+                            continue;
+                        hit.triangle = i;
+                        found = true;
+                        if (AnyHit)
+                            return true;
+                        tMax = hit.t;
+                    }
+                    continue;
+                }
+
+                //Far child first on the stack, so the near child is visited first
+                bool const negative = direction[node.splitAxis] < 0.f;
+                stack[stackSize++] = node.leftFirst + (negative ? 0 : 1);
+                stack[stackSize++] = node.leftFirst + (negative ? 1 : 0);
+            }
+            return found;
+        }
+    }
+
+    void BuildBVHNodes(std::vector<BVHBounds> const& primitiveBounds, BVHBuildSettings const& settings, std::vector<BVHNode>& nodes,
+        std::vector<uint32_t>& primitiveIndices)
+    {
+        uint32_t const primitiveCount = uint32_t(primitiveBounds.size());
+        std::vector<float3> centroids(primitiveCount);
+        for (uint32_t i = 0; i < primitiveCount; ++i)
+            centroids[i] = (primitiveBounds[i].min + primitiveBounds[i].max) * 0.5f;
+
+        primitiveIndices.resize(primitiveCount);
+        for (uint32_t i = 0; i < primitiveCount; ++i)
+            primitiveIndices[i] = i;
+
+        //An empty root would be an interior node whose inverted bounds every ray enters
+        nodes.clear();
+        if (primitiveCount == 0)
+            return;
+        nodes.reserve(size_t(2) * max(primitiveCount, 1u));
+        nodes.push_back(BVHNode{ EmptyBounds.min, 0, EmptyBounds.max, 0, 0 });
+
+        uint32_t const binCount = max(settings.binCount, 2u);
+        std::vector<Bin> bins(binCount);
+        std::vector<float> rightAreas(binCount);
+        std::vector<uint32_t> rightCounts(binCount);
+
+        std::vector<BuildTask> tasks;
+        tasks.push_back(BuildTask{ 0, 0, primitiveCount });
+        while (!tasks.empty())
+        {
+            BuildTask const task = tasks.back();
+            tasks.pop_back();
+
+            Bounds bounds = EmptyBounds;
+            Bounds centroidBounds = EmptyBounds;
+            for (uint32_t i = task.first; i < task.first + task.count; ++i)
+            {
+                Grow(bounds, primitiveBounds[primitiveIndices[i]]);
+                Grow(centroidBounds, centroids[primitiveIndices[i]]);
+            }
+            nodes[task.node].boundsMin = bounds.min;
+            nodes[task.node].boundsMax = bounds.max;
+            nodes[task.node].leftFirst = task.first;
+            nodes[task.node].triangleCount = uint16_t(task.count);
+            if (task.count <= 1)
+                continue;
+
+            //Best SAH split over the bins of every axis, the cost is relative to the node area
+            float const nodeArea = SurfaceArea(bounds.min, bounds.max);
+            float bestCost = FLT_MAX;
+            uint32_t bestAxis = 0;
+            uint32_t bestSplit = 0;
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                float const extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+                if (!(extent > 0.f))
+                    continue;
+
+                float const scale = float(binCount) / extent;
+                for (Bin& bin : bins)
+                    bin = Bin{ EmptyBounds, 0 };
+                for (uint32_t i = task.first; i < task.first + task.count; ++i)
+                {
+                    uint32_t const primitive = primitiveIndices[i];
+                    Bin& bin = bins[min(binCount - 1, ToUint((centroids[primitive][axis] - centroidBounds.min[axis]) * scale))];
+                    Grow(bin.bounds, primitiveBounds[primitive]);
+                    ++bin.count;
+                }
+
+                Bounds right = EmptyBounds;
+                uint32_t rightCount = 0;
+                for (uint32_t b = binCount - 1; b > 0; --b)
+                {
+                    Grow(right, bins[b].bounds);
+                    rightCount += bins[b].count;
+                    rightAreas[b] = SurfaceArea(right.min, right.max);
+                    rightCounts[b] = rightCount;
+                }
+
+                Bounds left = EmptyBounds;
+                uint32_t leftCount = 0;
+                for (uint32_t split = 1; split < binCount; ++split)
+                {
+                    Grow(left, bins[split - 1].bounds);
+                    leftCount += bins[split - 1].count;
+                    if (leftCount == 0 || rightCounts[split] == 0)
+                        continue;
+                    float const cost = settings.traversalCost
+                        + (SurfaceArea(left.min, left.max) * float(leftCount) + rightAreas[split] * float(rightCounts[split])) / nodeArea;
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            //Stay a leaf when splitting doesn't pay off, unless the leaf would be too large
+            bool const fitsLeaf = task.count <= settings.maxLeafSize;
+            if (fitsLeaf && bestCost >= float(task.count))
+                continue;
+
+            uint32_t* const first = primitiveIndices.data() + task.first;
+            uint32_t* const last = first + task.count;
+            uint32_t* middle = first;
+            if (bestCost < FLT_MAX)
+            {
+                float const scale = float(binCount) / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+                middle = std::partition(first, last, [&](uint32_t primitive)
+                {
+                    return min(binCount - 1, ToUint((centroids[primitive][bestAxis] - centroidBounds.min[bestAxis]) * scale)) < bestSplit;
+                });
+            }
+            if (middle == first || middle == last)
+            {
+                //Every centroid in the same spot: split the list in half
+                if (fitsLeaf)
+                    continue;
+                middle = first + task.count / 2;
+            }
+
+            uint32_t const leftChild = uint32_t(nodes.size());
+            uint32_t const leftCount = uint32_t(middle - first);
+            nodes.push_back(BVHNode{ EmptyBounds.min, 0, EmptyBounds.max, 0, 0 });
+            nodes.push_back(BVHNode{ EmptyBounds.min, 0, EmptyBounds.max, 0, 0 });
+            nodes[task.node].leftFirst = leftChild;
+            nodes[task.node].triangleCount = 0;
+            nodes[task.node].splitAxis = uint16_t(bestCost < FLT_MAX ? bestAxis : 0);
+            tasks.push_back(BuildTask{ leftChild + 1, task.first + leftCount, task.count - leftCount });
+            tasks.push_back(BuildTask{ leftChild, task.first, leftCount });
+        }
+    }
+
+    float GetSAHCost(std::vector<BVHNode> const& nodes, float traversalCost)
+    {
+        if (nodes.empty())
+            return 0.f;
+
+        float const rootArea = SurfaceArea(nodes[0].boundsMin, nodes[0].boundsMax);
+        if (!(rootArea > 0.f))
+            return float(nodes[0].triangleCount);
+
+        float cost = 0.f;
+        for (BVHNode const& node : nodes)
+        {
+            float const area = SurfaceArea(node.boundsMin, node.boundsMax) / rootArea;
+            cost += area * (node.triangleCount > 0 ? float(node.triangleCount) : traversalCost);
+        }
+        return cost;
+    }
+
+    void BVH::Build(float3 const* positions, uint32_t const* indices, uint32_t triangleCount, BVHBuildSettings const& settings)
+    {
+        std::vector<Bounds> triangleBounds(triangleCount);
+        for (uint32_t i = 0; i < triangleCount; ++i)
+        {
+            Bounds bounds = EmptyBounds;
+            Grow(bounds, positions[indices[3 * i + 0]]);
+            Grow(bounds, positions[indices[3 * i + 1]]);
+            Grow(bounds, positions[indices[3 * i + 2]]);
+            triangleBounds[i] = bounds;
+        }
+        BuildBVHNodes(triangleBounds, settings, m_Nodes, m_TriangleIndices);
+
+        m_Triangles.resize(triangleCount);
+        for (uint32_t i = 0; i < triangleCount; ++i)
+        {
+            uint32_t const triangle = m_TriangleIndices[i];
+            float3 const v0 = positions[indices[3 * triangle + 0]];
+            m_Triangles[i] = BVHTriangle{ v0, positions[indices[3 * triangle + 1]] - v0, positions[indices[3 * triangle + 2]] - v0 };
+        }
+    }
+
+    void BVH::Refit(float3 const* positions, uint32_t const* indices)
+    {
+        if (m_Triangles.empty())
+            return;
+
+        for (size_t i = 0; i < m_Triangles.size(); ++i)
+        {
+            uint32_t const triangle = m_TriangleIndices[i];
+            float3 const v0 = positions[indices[3 * triangle + 0]];
+            m_Triangles[i] = BVHTriangle{ v0, positions[indices[3 * triangle + 1]] - v0, positions[indices[3 * triangle + 2]] - v0 };
+        }
+
+        RefitBVHNodes(m_Nodes, [&](uint32_t i)
+        {
+            BVHTriangle const& triangle = m_Triangles[i];
+            Bounds bounds = { triangle.v0, triangle.v0 };
+            Grow(bounds, triangle.v0 + triangle.edge1);
+            Grow(bounds, triangle.v0 + triangle.edge2);
+            return bounds;
+        });
+    }
+
+    bool BVH::Intersect(float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit) const
+    {
+        if (!Traverse<false>(*this, origin, direction, tMin, tMax, hit))
+            return false;
+        hit.triangle = m_TriangleIndices[hit.triangle];
+        hit.instance = 0;
+        return true;
+    }
+
+    float BVH::IntersectAny(float3 const& origin, float3 const& direction, float tMin, float tMax) const
+    {
+        RayHit hit;
+        return Traverse<true>(*this, origin, direction, tMin, tMax, hit) ? hit.t : tMax;
+    }
+
+    size_t BVH::GetMemorySize() const
+    {
+        return m_Nodes.size() * sizeof(BVHNode) + m_Triangles.size() * sizeof(BVHTriangle) + m_TriangleIndices.size() * sizeof(uint32_t);
+    }
+
+    void IntersectAnyBatch(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT, SimdWidth width)
+    {
+        //Whole packets in the kernel, the tail on the scalar path
+        width = min(width, GetMaxSimdWidth());
+        uint32_t const vectorCount = count - (count % uint32_t(width));
+        if (width == SimdWidth::AVX512)
+            IntersectAnyAVX512(bvh, rays, vectorCount, hitT);
+        else if (width == SimdWidth::AVX2)
+            IntersectAnyAVX2(bvh, rays, vectorCount, hitT);
+
+        for (uint32_t i = (width == SimdWidth::Scalar ? 0 : vectorCount); i < count; ++i)
+        {
+            float3 const origin = { rays.originX[i], rays.originY[i], rays.originZ[i] };
+            float3 const direction = { rays.directionX[i], rays.directionY[i], rays.directionZ[i] };
+            hitT[i] = bvh.IntersectAny(origin, direction, rays.tMin, rays.tMax);
+        }
+    }
+} //namespace ImplicitPointCPU
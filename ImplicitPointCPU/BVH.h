@@ -0,0 +1,183 @@
+//Bounding volume hierarchy over a triangle list, the CPU counterpart of the DXR acceleration structure the demo builds in
+//CreateAccelerationStructures. Built top-down with binned SAH, traced one ray at a time (closest hit for the primary rays)
+//or in packets of 8/16 rays (any hit for the AO rays, see IntersectAnyBatch).
+//Like the demo's RAY_FLAG_CULL_BACK_FACING_TRIANGLES, back faces are never hit: a triangle is front facing when its
+//vertices are clockwise seen from the ray origin, the D3D default for both the rasterizer and DXR.
+#pragma once
+#include "ShaderTypes.h"
+#include "CpuFeatures.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct BVHNode
+    {
+        float3 boundsMin;
+        uint32_t leftFirst;     //Interior: left child, the right child follows it. Leaf: first triangle (primitive).
+        float3 boundsMax;
+        uint16_t triangleCount; //0 for interior nodes
+        uint16_t splitAxis;     //Interior: axis the children were split on, traversal visits the near child first
+    };
+    static_assert(sizeof(BVHNode) == 32, "Two BVH nodes per cache line");
+
+    //Triangle in the form the Moller-Trumbore test reads it
+    struct BVHTriangle
+    {
+        float3 v0;
+        float3 edge1; //v1 - v0
+        float3 edge2; //v2 - v0
+    };
+
+    struct BVHBounds
+    {
+        float3 min;
+        float3 max;
+    };
+
+    struct RayHit
+    {
+        float t;
+        uint32_t triangle; //Index into the triangle list the BVH was built from
+        float u, v;        //Barycentrics of v1 and v2
+        uint32_t instance; //Instance of the AccelerationStructure that was hit, 0 for a single BVH
+    };
+
+    struct BVHBuildSettings
+    {
+        uint32_t binCount = 16;      //SAH bins per axis
+        uint32_t maxLeafSize = 4;    //Larger nodes are always split
+        float traversalCost = 1.f;   //SAH cost of visiting a node, relative to one triangle test
+    };
+
+    //Rays as structure of arrays, every ray shares the [tMin, tMax] interval like the AO rays do
+    struct RayBatch
+    {
+        float const* originX;
+        float const* originY;
+        float const* originZ;
+        float const* directionX;
+        float const* directionY;
+        float const* directionZ;
+        float tMin;
+        float tMax;
+    };
+
+    //Binned SAH build over the bounds of any kind of primitive: the nodes and the primitive order their leaves index. No nodes
+    //at all for no primitives, traversals check for that instead of visiting a root.
+    void BuildBVHNodes(std::vector<BVHBounds> const& primitiveBounds, BVHBuildSettings const& settings, std::vector<BVHNode>& nodes,
+        std::vector<uint32_t>& primitiveIndices);
+
+    //Bottom-up bounds update after the primitives moved, the tree itself stays. leafBounds(i) returns the bounds of the primitive
+    //at leaf position i. Children are always stored after their parent, so one backwards pass over the nodes is enough.
+    template<typename LeafBounds>
+    void RefitBVHNodes(std::vector<BVHNode>& nodes, LeafBounds const& leafBounds)
+    {
+        for (size_t n = nodes.size(); n-- > 0;)
+        {
+            BVHNode& node = nodes[n];
+            BVHBounds bounds;
+            if (node.triangleCount > 0)
+            {
+                bounds = leafBounds(node.leftFirst);
+                for (uint32_t i = node.leftFirst + 1; i < node.leftFirst + node.triangleCount; ++i)
+                {
+                    BVHBounds const other = leafBounds(i);
+                    bounds.min = float3{ min(bounds.min.x, other.min.x), min(bounds.min.y, other.min.y), min(bounds.min.z, other.min.z) };
+                    bounds.max = float3{ max(bounds.max.x, other.max.x), max(bounds.max.y, other.max.y), max(bounds.max.z, other.max.z) };
+                }
+            }
+            else
+            {
+                BVHNode const& left = nodes[node.leftFirst];
+                BVHNode const& right = nodes[node.leftFirst + 1];
+                bounds.min = float3{ min(left.boundsMin.x, right.boundsMin.x), min(left.boundsMin.y, right.boundsMin.y), min(left.boundsMin.z, right.boundsMin.z) };
+                bounds.max = float3{ max(left.boundsMax.x, right.boundsMax.x), max(left.boundsMax.y, right.boundsMax.y), max(left.boundsMax.z, right.boundsMax.z) };
+            }
+            node.boundsMin = bounds.min;
+            node.boundsMax = bounds.max;
+        }
+    }
+
+    //Slab test of the interval [tMin, tMax] of a ray against node bounds
+    inline bool IntersectBounds(BVHNode const& node, float3 const& origin, float3 const& inverseDirection, float tMin, float tMax)
+    {
+        float const x0 = (node.boundsMin.x - origin.x) * inverseDirection.x;
+        float const x1 = (node.boundsMax.x - origin.x) * inverseDirection.x;
+        float const y0 = (node.boundsMin.y - origin.y) * inverseDirection.y;
+        float const y1 = (node.boundsMax.y - origin.y) * inverseDirection.y;
+        float const z0 = (node.boundsMin.z - origin.z) * inverseDirection.z;
+        float const z1 = (node.boundsMax.z - origin.z) * inverseDirection.z;
+        float const tNear = max(max(min(x0, x1), min(y0, y1)), max(min(z0, z1), tMin));
+        float const tFar = min(min(max(x0, x1), max(y0, y1)), min(max(z0, z1), tMax));
+        return tNear <= tFar;
+    }
+
+    //Moller-Trumbore, only front facing (clockwise seen from the origin: negative determinant) triangles hit
+    inline bool IntersectTriangle(BVHTriangle const& triangle, float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit)
+    {
+        float3 const p = cross(direction, triangle.edge2);
+        float const determinant = dot(triangle.edge1, p);
+        if (!(determinant < 0.f))
+            return false;
+
+        float const inverseDeterminant = 1.f / determinant;
+        float3 const s = origin - triangle.v0;
+        float const u = dot(s, p) * inverseDeterminant;
+        if (u < 0.f || u > 1.f)
+            return false;
+        float3 const q = cross(s, triangle.edge1);
+        float const v = dot(direction, q) * inverseDeterminant;
+        if (v < 0.f || (u + v) > 1.f)
+            return false;
+        float const t = dot(triangle.edge2, q) * inverseDeterminant;
+        if (!(t > tMin && t < tMax))
+            return false;
+
+        hit.t = t;
+        hit.u = u;
+        hit.v = v;
+        return true;
+    }
+
+    //Expected cost of a random ray, in triangle tests: node surface areas relative to the root
+    float GetSAHCost(std::vector<BVHNode> const& nodes, float traversalCost = 1.f);
+
+    class BVH
+    {
+    public:
+        //positions are indexed by 3 indices per triangle
+        void Build(float3 const* positions, uint32_t const* indices, uint32_t triangleCount, BVHBuildSettings const& settings = BVHBuildSettings());
+
+        //Same triangles at new positions: the triangles and node bounds are updated, the tree stays as it was built. Far
+        //cheaper than Build, the price is a tree that gets worse (GetSAHCost) the further the triangles move apart.
+        void Refit(float3 const* positions, uint32_t const* indices);
+
+        //Closest front facing hit in (tMin, tMax), false when there is none
+        bool Intersect(float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit) const;
+
+        //Any hit: the t of the first front facing hit found in (tMin, tMax), tMax when there is none. Like
+        //RAY_FLAG_ACCEPT_FIRST_HIT_AND_END_SEARCH that isn't necessarily the closest hit, it depends on the traversal order.
+        float IntersectAny(float3 const& origin, float3 const& direction, float tMin, float tMax) const;
+
+        std::vector<BVHNode> const& GetNodes() const { return m_Nodes; }
+        std::vector<BVHTriangle> const& GetTriangles() const { return m_Triangles; }             //In leaf order
+        std::vector<uint32_t> const& GetTriangleIndices() const { return m_TriangleIndices; }   //Leaf order -> build order
+        size_t GetMemorySize() const;
+
+        float GetSAHCost(float traversalCost = 1.f) const { return ImplicitPointCPU::GetSAHCost(m_Nodes, traversalCost); }
+
+    private:
+        std::vector<BVHNode> m_Nodes;
+        std::vector<BVHTriangle> m_Triangles;
+        std::vector<uint32_t> m_TriangleIndices;
+    };
+
+    //IntersectAny for count rays, hitT[i] receives the result of ray i. width is clamped to what the CPU supports,
+    //SimdWidth::Scalar traces the rays one by one. Packets visit the nodes in the order of their first active ray,
+    //so the found hit can differ from the scalar one, whether there is a hit doesn't.
+    void IntersectAnyBatch(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT, SimdWidth width);
+
+    //Instruction set specific entry points, count must be a multiple of 8 / 16
+    void IntersectAnyAVX2(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT);
+    void IntersectAnyAVX512(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT);
+} //namespace ImplicitPointCPU
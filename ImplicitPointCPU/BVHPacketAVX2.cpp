@@ -0,0 +1,17 @@
+//Compiled with AVX2 enabled (/arch:AVX2, -mavx2), only reached through the runtime dispatch in BVH.cpp and AccelerationStructure.cpp
+#include "AccelerationStructure.h"
+#include "SimdAVX2.h"
+#include "RayPacketKernel.h"
+
+namespace ImplicitPointCPU
+{
+    void IntersectAnyAVX2(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT)
+    {
+        RayPacketKernel<SimdAVX2>::IntersectAny(bvh, rays, count, hitT);
+    }
+
+    void IntersectAnyAVX2(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT)
+    {
+        RayPacketKernel<SimdAVX2>::IntersectAny(scene, rays, count, hitT);
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,18 @@
+//Compiled with AVX-512 enabled (/arch:AVX512, -mavx512f -mavx512dq -mavx512bw -mavx512vl), only reached through the
+//runtime dispatch in BVH.cpp and AccelerationStructure.cpp
+#include "AccelerationStructure.h"
+#include "SimdAVX512.h"
+#include "RayPacketKernel.h"
+
+namespace ImplicitPointCPU
+{
+    void IntersectAnyAVX512(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT)
+    {
+        RayPacketKernel<SimdAVX512>::IntersectAny(bvh, rays, count, hitT);
+    }
+
+    void IntersectAnyAVX512(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT)
+    {
+        RayPacketKernel<SimdAVX512>::IntersectAny(scene, rays, count, hitT);
+    }
+} //namespace ImplicitPointCPU
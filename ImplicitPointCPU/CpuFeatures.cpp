@@ -0,0 +1,107 @@
+#include "CpuFeatures.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        struct CpuidResult
+        {
+            uint32_t eax, ebx, ecx, edx;
+        };
+
+        CpuidResult Cpuid(uint32_t leaf, uint32_t subLeaf)
+        {
+            CpuidResult result = {};
+#if defined(_MSC_VER)
+            int registers[4];
+            __cpuidex(registers, int(leaf), int(subLeaf));
+            result = CpuidResult{ uint32_t(registers[0]), uint32_t(registers[1]), uint32_t(registers[2]), uint32_t(registers[3]) };
+#else
+            __cpuid_count(leaf, subLeaf, result.eax, result.ebx, result.ecx, result.edx);
+#endif
+            return result;
+        }
+
+        //XCR0, the register states the OS saves on a context switch
+        uint64_t GetEnabledStates()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t eax = 0, edx = 0;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (uint64_t(edx) << 32) | eax;
+#endif
+        }
+
+        struct Features
+        {
+            bool avx2 = false;
+            bool avx512 = false;
+
+            Features()
+            {
+                if (Cpuid(0, 0).eax < 7)
+                    return;
+
+                CpuidResult const leaf1 = Cpuid(1, 0);
+                bool const osxsave = (leaf1.ecx & (1u << 27)) != 0;
+                bool const avx = (leaf1.ecx & (1u << 28)) != 0;
+                if (!osxsave || !avx)
+                    return;
+
+                uint64_t const states = GetEnabledStates();
+                bool const ymmEnabled = (states & 0x6) == 0x6;    //SSE + AVX state
+                bool const zmmEnabled = (states & 0xE6) == 0xE6;  //+ opmask and ZMM state
+
+                CpuidResult const leaf7 = Cpuid(7, 0);
+                avx2 = ymmEnabled && (leaf7.ebx & (1u << 5)) != 0;
+                avx512 = avx2 && zmmEnabled
+                    && (leaf7.ebx & (1u << 16)) != 0  //F
+                    && (leaf7.ebx & (1u << 17)) != 0  //DQ
+                    && (leaf7.ebx & (1u << 30)) != 0  //BW
+                    && (leaf7.ebx & (1u << 31)) != 0; //VL
+            }
+        };
+
+        Features const& GetFeatures()
+        {
+            static Features const features;
+            return features;
+        }
+    }
+
+    bool SupportsAVX2()
+    {
+        return GetFeatures().avx2;
+    }
+
+    bool SupportsAVX512()
+    {
+        return GetFeatures().avx512;
+    }
+
+    SimdWidth GetMaxSimdWidth()
+    {
+        if (SupportsAVX512())
+            return SimdWidth::AVX512;
+        if (SupportsAVX2())
+            return SimdWidth::AVX2;
+        return SimdWidth::Scalar;
+    }
+
+    char const* GetSimdWidthName(SimdWidth width)
+    {
+        switch (width)
+        {
+        case SimdWidth::AVX2: return "AVX2";
+        case SimdWidth::AVX512: return "AVX-512";
+        default: return "Scalar";
+        }
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,22 @@
+//Runtime detection of the instruction sets used by the SIMD kernels.
+#pragma once
+#include <cstdint>
+
+namespace ImplicitPointCPU
+{
+    //Lane count of the kernel variants, ordered so a wider variant compares larger
+    enum class SimdWidth : uint32_t
+    {
+        Scalar = 1,
+        AVX2   = 8,
+        AVX512 = 16
+    };
+
+    bool SupportsAVX2();
+    bool SupportsAVX512(); //AVX-512 F + VL + DQ + BW
+
+    //Widest variant supported by both the CPU and the OS
+    SimdWidth GetMaxSimdWidth();
+
+    char const* GetSimdWidthName(SimdWidth width);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,710 @@
+#include "Engine.h"
+#include "SampleGenerationBatch.h"
+#include "FinalVisualizationPass.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        typedef std::chrono::high_resolution_clock Clock;
+
+        //World hash table groups per merge range of AccumulationMode::Deterministic
+        uint32_t const DeterministicMergeGroups = 4096;
+
+        double MillisecondsSince(Clock::time_point const& start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        ResizePolicy GetWorldHashTablePolicy(EngineSettings const& settings)
+        {
+            ResizePolicy policy = settings.worldHashTablePolicy;
+            if (settings.accumulationMode == AccumulationMode::Deterministic)
+                policy.orderedMigration = true;
+            return policy;
+        }
+
+        EngineSettings ResolveSettings(EngineSettings settings)
+        {
+            if (settings.screenWidth == 0 || settings.screenHeight == 0)
+                throw std::invalid_argument("Engine: screenWidth and screenHeight must be larger than 0");
+            if (uint64_t(settings.screenWidth) * settings.screenHeight > 0x7FFFFFFFull)
+                throw std::invalid_argument("Engine: too many pixels for 32 bit pixel indices");
+
+            HashTableConstants& constants = settings.hashTableConstants;
+            if (constants.accumulationHashTableElementCount == 0)
+                constants.accumulationHashTableElementCount = settings.screenWidth * settings.screenHeight;
+            return settings;
+        }
+    }
+
+    Engine::Engine(EngineSettings const& settings)
+        : m_Settings(ResolveSettings(settings))
+        , m_ThreadPool(settings.threadCount)
+        , m_FrameIndex(0)
+        , m_PointSampleBuffer(GetPixelCount(), SampleData{ 0, 0, float3{ 0.f, 0.f, 0.f } })
+        , m_LODBuffer(GetPixelCount(), uint2{ 0, 0 })
+        , m_VisualizationBuffer(GetPixelCount(), 0.f)
+        , m_AccumulationHashTable(m_Settings.hashTableConstants.accumulationHashTableElementCount)
+        , m_WorldHashTable(GetWorldHashTablePolicy(settings), settings.worldHashTableEviction, settings.hashTableConstants.worldHashTableElementCount)
+        , m_AccumulationUpdateCount(0)
+        , m_OctreePrunedEvictedCount(0)
+        , m_OctreePrunedSize(0)
+        , m_OctreeFailedInserts(0)
+        , m_OctreeIncompleteFrame(~0u)
+        , m_OctreeCompleteRevolution(~0u)
+        , m_TemporalReuseHitCount(0)
+        , m_TemporalReuseMissCount(0)
+    {
+        if (m_Settings.tileSize == 0)
+            throw std::invalid_argument("Engine: tileSize must be larger than 0");
+
+        m_SampleBatches.resize(m_ThreadPool.GetThreadCount() * 2);
+        for (SampleBatch& batch : m_SampleBatches)
+        {
+            batch.indices.reserve(m_Settings.tileSize * m_Settings.tileSize);
+            batch.positions.reserve(m_Settings.tileSize * m_Settings.tileSize);
+            batch.levels.reserve(m_Settings.tileSize * m_Settings.tileSize);
+            batch.results.resize(m_Settings.tileSize * m_Settings.tileSize);
+        }
+
+        //Every pixel adds its seed and its previous LOD seed
+        if (m_Settings.tileAggregation)
+        {
+            m_LocalAccumulationMaps.reserve(m_ThreadPool.GetThreadCount());
+            for (uint32_t t = 0; t < m_ThreadPool.GetThreadCount(); ++t)
+                m_LocalAccumulationMaps.emplace_back(m_Settings.tileSize * m_Settings.tileSize * 2);
+        }
+        if (m_Settings.accumulationMode != AccumulationMode::HashTable)
+            m_SortPairBuffers.resize(m_ThreadPool.GetThreadCount());
+        if (m_Settings.neighbourVoxelCacheSize > 0)
+            m_NeighbourVoxelCaches.resize(m_ThreadPool.GetThreadCount(), NeighbourVoxelCache(m_Settings.neighbourVoxelCacheSize));
+        if (m_Settings.octreeCapacity > 0)
+            m_pOctree.reset(new ImplicitPointOctree(m_Settings.octreeCapacity, m_Settings.cellSize, m_Settings.maxLevels));
+        if (m_Settings.temporalReuseDistance > 0.f)
+            m_pReprojectionCache.reset(new ReprojectionCache(m_Settings.screenWidth, m_Settings.screenHeight));
+    }
+
+    template<typename TileFunction>
+    void Engine::DispatchTiles(TileFunction const& tileFunction)
+    {
+        uint32_t const tileSize = m_Settings.tileSize;
+        uint32_t const screenWidth = m_Settings.screenWidth;
+        uint32_t const screenHeight = m_Settings.screenHeight;
+        uint32_t const tilesX = (screenWidth + tileSize - 1) / tileSize;
+        uint32_t const tilesY = (screenHeight + tileSize - 1) / tileSize;
+
+        m_ThreadPool.ParallelFor(tilesX * tilesY, [&](uint32_t tile, uint32_t threadIndex)
+        {
+            uint2 const start = { (tile % tilesX) * tileSize, (tile / tilesX) * tileSize };
+            uint2 const end = { min(start.x + tileSize, screenWidth), min(start.y + tileSize, screenHeight) };
+            tileFunction(start, end, threadIndex);
+        });
+    }
+
+    template<typename PixelFunction>
+    void Engine::DispatchPixels(PixelFunction const& pixelFunction)
+    {
+        DispatchTiles([&](uint2 start, uint2 end, uint32_t threadIndex)
+        {
+            for (uint32_t y = start.y; y < end.y; ++y)
+                for (uint32_t x = start.x; x < end.x; ++x)
+                    pixelFunction(uint2{ x, y }, x + (y * m_Settings.screenWidth), threadIndex);
+        });
+    }
+
+    template<typename SlotFunction>
+    void Engine::DispatchSlots(uint32_t slotCount, SlotFunction const& slotFunction)
+    {
+        uint32_t const slotsPerJob = 4096;
+        m_ThreadPool.ParallelFor((slotCount + slotsPerJob - 1) / slotsPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+        {
+            uint32_t const end = min((job + 1) * slotsPerJob, slotCount);
+            for (uint32_t slotID = job * slotsPerJob; slotID < end; ++slotID)
+                slotFunction(slotID);
+        });
+    }
+
+    void Engine::ValidateFrame(FrameData const& frame) const
+    {
+        if (frame.width != m_Settings.screenWidth || frame.height != m_Settings.screenHeight)
+            throw std::invalid_argument("Engine: frame dimensions do not match the screen dimensions of the pipeline");
+    }
+
+    void Engine::RenderFrame(FrameData const& frame)
+    {
+        ValidateFrame(frame);
+        Clock::time_point const start = Clock::now();
+
+        m_Timings = PassTimings();
+        SampleGenerationPass(frame);
+        if (!m_Settings.stopAccumulating)
+        {
+            AccumulationPass(frame);
+            WorldHashTablePass();
+            MaintenancePass();
+        }
+        if (m_Settings.visualizeFinalPass)
+            FinalVisualizationPass(frame);
+        if (!m_Settings.stopAccumulating)
+            ClearBuffersPass();
+
+        ++m_FrameIndex;
+        m_Timings.total = MillisecondsSince(start);
+    }
+
+    void Engine::SampleGenerationPass(FrameData const& frame)
+    {
+        ValidateFrame(frame);
+        Clock::time_point const start = Clock::now();
+
+        uint2 const screenDimensions = { m_Settings.screenWidth, m_Settings.screenHeight };
+        TextureView const depthBuffer = frame.GetDepthView();
+        TextureView const blurredAOBuffer = frame.GetBlurredAmbientOcclusionView();
+        float3 const cameraPosition = GetTranslation(frame.viewInverse);
+        ReprojectionCache* const pReprojectionCache = m_pReprojectionCache.get();
+        m_TemporalReuseHitCount.store(0, std::memory_order_relaxed);
+        m_TemporalReuseMissCount.store(0, std::memory_order_relaxed);
+
+        bool const useMinMaxPyramid = m_Settings.lodMode == LODMode::MinMaxLOD && m_Settings.minMaxPyramid;
+        if (useMinMaxPyramid)
+            m_MinMaxPyramid.Build(depthBuffer, blurredAOBuffer, 4, 3 + m_Settings.maxLevels, m_ThreadPool);
+
+        DispatchTiles([&](uint2 tileStart, uint2 tileEnd, uint32_t threadIndex)
+        {
+            SampleBatch& batch = m_SampleBatches[threadIndex * 2];
+            SampleBatch& prevLodBatch = m_SampleBatches[threadIndex * 2 + 1];
+            batch.Clear();
+            prevLodBatch.Clear();
+            uint64_t reuseCount = 0;
+
+            for (uint32_t y = tileStart.y; y < tileEnd.y; ++y)
+            {
+                for (uint32_t x = tileStart.x; x < tileEnd.x; ++x)
+                {
+                    uint2 const index2D = { x, y };
+                    uint32_t const index = x + (y * m_Settings.screenWidth);
+
+                    //Sample from depth and get world position
+                    float const depth = frame.depth[index];
+                    if (asint(depth) == 0)
+                    {
+                        m_PointSampleBuffer[index] = SampleData{ 0, 0, float3{ 0.f, 0.f, 0.f } };
+                        continue;
+                    }
+                    float3 const worldPosition = DepthToWorldPosition(depth, index2D, screenDimensions, frame.viewProjectionInverse).xyz();
+
+                    //Determine LOD based on mode
+                    uint32_t lodLevel = 0;
+                    uint32_t prevLodLevel = 0;
+                    if (m_Settings.lodMode == LODMode::FixedLOD)
+                    {
+                        lodLevel = clamp(m_Settings.level, 0u, m_Settings.maxLevels);
+                        prevLodLevel = lodLevel;
+                    }
+                    else if (m_Settings.lodMode == LODMode::DistanceLOD)
+                    {
+                        float percentageLOD = 0.f; //Not used here!
+                        SimpleDistanceLOD(m_Settings.maxLevels, frame.viewVector, worldPosition, cameraPosition, lodLevel, prevLodLevel, percentageLOD);
+                    }
+                    else if (m_Settings.lodMode == LODMode::MinMaxLOD)
+                    {
+                        if (useMinMaxPyramid)
+                            PyramidMinMaxLOD(index2D, m_Settings.maxLevels, m_MinMaxPyramid, lodLevel, prevLodLevel);
+                        else
+                            ScreenMinMaxLOD(index2D, screenDimensions, m_Settings.maxLevels, depthBuffer, blurredAOBuffer, lodLevel, prevLodLevel);
+                    }
+                    m_LODBuffer[index] = uint2{ lodLevel, prevLodLevel };
+
+                    //Closest samples of last frame, when this world position was visible then and barely moved
+                    ReprojectedSample const* pReprojected = nullptr;
+                    if (pReprojectionCache != nullptr)
+                    {
+                        float const reuseDistance = m_Settings.temporalReuseDistance * float(m_Settings.cellSize) / float(1u << max(lodLevel, prevLodLevel));
+                        pReprojected = pReprojectionCache->Find(worldPosition, m_LODBuffer[index], reuseDistance);
+                    }
+
+                    //Pixels outside of the sample pattern keep their LOD for the final pass, but don't accumulate this frame.
+                    //They carry a reprojected entry over, so the pixels of the pattern can find it next frame.
+                    if (!IsSamplePixel(index2D, m_Settings.samplePattern, m_FrameIndex))
+                    {
+                        if (pReprojected != nullptr)
+                            pReprojectionCache->Store(index, *pReprojected);
+                        m_PointSampleBuffer[index] = SampleData{ 0, 0, float3{ 0.f, 0.f, 0.f } };
+                        continue;
+                    }
+                    if (pReprojected != nullptr)
+                    {
+                        pReprojectionCache->Store(index, *pReprojected);
+                        m_PointSampleBuffer[index] = SampleData{ pReprojected->seed, pReprojected->prevSeed, pReprojected->sample };
+                        ++reuseCount;
+                        continue;
+                    }
+
+                    //Queue the closest sample searches, the previous LOD only when it differs to prevent double addition
+                    batch.indices.push_back(index);
+                    batch.positions.push_back(worldPosition);
+                    batch.levels.push_back(lodLevel);
+                    if (prevLodLevel != lodLevel)
+                    {
+                        prevLodBatch.indices.push_back(index);
+                        prevLodBatch.positions.push_back(worldPosition);
+                        prevLodBatch.levels.push_back(prevLodLevel);
+                    }
+                }
+            }
+
+            //Generate closest sample and seed based on LODs
+            uint32_t const count = uint32_t(batch.indices.size());
+            GetGeneratedSampleBatch(batch.positions.data(), batch.levels.data(), count, m_Settings.cellSize,
+                m_Settings.voxelConnectivity, m_Settings.maxLevels, batch.results.data(), m_Settings.simdWidth);
+            for (uint32_t i = 0; i < count; ++i)
+                m_PointSampleBuffer[batch.indices[i]] = SampleData{ batch.results[i].seed, 0, batch.results[i].sample };
+
+            uint32_t const prevLodCount = uint32_t(prevLodBatch.indices.size());
+            GetGeneratedSampleBatch(prevLodBatch.positions.data(), prevLodBatch.levels.data(), prevLodCount, m_Settings.cellSize,
+                m_Settings.voxelConnectivity, m_Settings.maxLevels, prevLodBatch.results.data(), m_Settings.simdWidth);
+            for (uint32_t i = 0; i < prevLodCount; ++i)
+                m_PointSampleBuffer[prevLodBatch.indices[i]].prevSeed = prevLodBatch.results[i].seed;
+
+            if (pReprojectionCache != nullptr)
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    uint32_t const index = batch.indices[i];
+                    SampleData const& data = m_PointSampleBuffer[index];
+                    pReprojectionCache->Store(index, ReprojectedSample{ batch.positions[i], m_LODBuffer[index], data.seed, data.prevSeed, data.sample, 0 });
+                }
+                m_TemporalReuseHitCount.fetch_add(reuseCount, std::memory_order_relaxed);
+                m_TemporalReuseMissCount.fetch_add(count, std::memory_order_relaxed);
+            }
+
+            //Every generated point is accumulated into the world hash table, so the octree knows every voxel with cached points
+            if (m_pOctree && !m_Settings.stopAccumulating)
+            {
+                for (uint32_t i = 0; i < count; ++i)
+                    m_pOctree->Insert(batch.results[i].sample, batch.results[i].seed, batch.levels[i]);
+                for (uint32_t i = 0; i < prevLodCount; ++i)
+                    m_pOctree->Insert(prevLodBatch.results[i].sample, prevLodBatch.results[i].seed, prevLodBatch.levels[i]);
+            }
+        });
+
+        if (pReprojectionCache != nullptr)
+            pReprojectionCache->EndFrame(Invert(frame.viewProjectionInverse));
+        m_Timings.sampleGeneration = MillisecondsSince(start);
+    }
+
+    void Engine::AccumulationPass(FrameData const& frame)
+    {
+        ValidateFrame(frame);
+        Clock::time_point const start = Clock::now();
+        if (m_Settings.accumulationMode != AccumulationMode::HashTable)
+        {
+            SortAccumulationPass(frame);
+            m_Timings.accumulation = MillisecondsSince(start);
+            return;
+        }
+
+        HashTableConstants const& constants = m_Settings.hashTableConstants;
+        m_AccumulationUpdateCount.store(0, std::memory_order_relaxed);
+        DispatchTiles([&](uint2 tileStart, uint2 tileEnd, uint32_t threadIndex)
+        {
+            LocalAccumulationMap* const pLocalMap = m_Settings.tileAggregation ? &m_LocalAccumulationMaps[threadIndex] : nullptr;
+            uint64_t updateCount = 0;
+
+            for (uint32_t y = tileStart.y; y < tileEnd.y; ++y)
+            {
+                for (uint32_t x = tileStart.x; x < tileEnd.x; ++x)
+                {
+                    uint32_t const index = x + (y * m_Settings.screenWidth);
+                    if (index >= constants.accumulationHashTableElementCount)
+                        continue;
+
+                    float const aoValue = frame.ambientOcclusion[index];
+                    uint32_t const aoFixedRepresentation = ToFixedPoint(aoValue, constants.accumulationHashTableValueFractionalBits);
+                    SampleData const& data = m_PointSampleBuffer[index];
+                    if (data.seed == 0)
+                        continue;
+
+                    bool const addPrevSeed = data.prevSeed != 0 && data.prevSeed != data.seed;
+                    if (pLocalMap != nullptr)
+                    {
+                        pLocalMap->Add(data.seed, aoFixedRepresentation);
+                        if (addPrevSeed)
+                            pLocalMap->Add(data.prevSeed, aoFixedRepresentation);
+                        continue;
+                    }
+
+                    m_AccumulationHashTable.Increment(data.seed, aoFixedRepresentation);
+                    if (addPrevSeed)
+                        m_AccumulationHashTable.Increment(data.prevSeed, aoFixedRepresentation);
+                    updateCount += addPrevSeed ? 2 : 1;
+                }
+            }
+
+            //One increment per unique seed of the tile
+            if (pLocalMap != nullptr)
+            {
+                pLocalMap->ForEach([&](KeyData const& data)
+                {
+                    m_AccumulationHashTable.Increment(data.key, data.value, data.count);
+                });
+                updateCount = pLocalMap->GetSize();
+                pLocalMap->Clear();
+            }
+            m_AccumulationUpdateCount.fetch_add(updateCount, std::memory_order_relaxed);
+        });
+
+        m_Timings.accumulation = MillisecondsSince(start);
+    }
+
+    KeyData MergeAccumulatedData(KeyData const& accumulatedData, KeyData const& cachedData, HashTableConstants const& constants)
+    {
+        //Perform constant rescale to prevent overflow
+        float const constantOverflowMultiplier = 0.9f;
+        float const scaledAccumulatedCount = float(accumulatedData.count) * constantOverflowMultiplier;
+        float const cachedCount = FromFixedPoint(cachedData.count, constants.worldHashTableCountFractionalBits);
+
+        float const totalCount = scaledAccumulatedCount + cachedCount;
+        float const cachedValueTerm = (cachedCount / totalCount) * FromFixedPoint(cachedData.value, constants.worldHashTableValueFractionalBits);
+        float const accumulationValueTerm = (scaledAccumulatedCount / totalCount)
+            * (FromFixedPoint(accumulatedData.value, constants.accumulationHashTableValueFractionalBits) / float(accumulatedData.count));
+
+        uint32_t const valueToStore = ToFixedPoint(cachedValueTerm + accumulationValueTerm, constants.worldHashTableValueFractionalBits);
+        uint32_t const countToStore = ToFixedPoint(totalCount, constants.worldHashTableCountFractionalBits);
+        return KeyData{ accumulatedData.key, valueToStore, countToStore };
+    }
+
+    void Engine::WorldHashTablePass()
+    {
+        Clock::time_point const start = Clock::now();
+        if (m_Settings.accumulationMode != AccumulationMode::HashTable)
+        {
+            SortedWorldHashTablePass();
+            m_Timings.worldHashTable = MillisecondsSince(start);
+            return;
+        }
+
+        HashTableConstants const& constants = m_Settings.hashTableConstants;
+        DispatchSlots(m_AccumulationHashTable.GetCapacity(), [&](uint32_t slotID)
+        {
+            KeyData const accumulatedData = m_AccumulationHashTable.LookupBySlotID(slotID);
+            if (accumulatedData.key == 0) //No data accumulated, exit
+                return;
+
+            uint32_t const se = accumulatedData.key; //Because no additional hashing in hashtable, the key is the seed value used
+            KeyData const mergedData = MergeAccumulatedData(accumulatedData, m_WorldHashTable.Lookup(se), constants);
+            m_WorldHashTable.Insert(se, mergedData.value, mergedData.count);
+        });
+
+        m_Timings.worldHashTable = MillisecondsSince(start);
+    }
+
+    //Not a pass of the GPU version: grows or shrinks the world hash table and evicts cold entries, a bounded amount of work per frame
+    void Engine::MaintenancePass()
+    {
+        Clock::time_point const start = Clock::now();
+        m_WorldHashTable.Maintain(m_ThreadPool);
+        if (m_pOctree)
+            MaintainOctree();
+        m_Timings.maintenance = MillisecondsSince(start);
+    }
+
+    void Engine::MaintainOctree()
+    {
+        //The evicted points keep their nodes until the octree is rebuilt from the cached ones. Waits until it grew by an eighth
+        //of its capacity since the last prune, so a working set that fills half of it doesn't rebuild it every frame.
+        uint32_t const size = m_pOctree->GetSize();
+        uint32_t const capacity = m_pOctree->GetCapacity();
+        if (m_WorldHashTable.GetEvictedCount() != m_OctreePrunedEvictedCount && size > capacity / 2 && size - m_OctreePrunedSize > capacity / 8)
+        {
+            m_pOctree->Prune([this](uint32_t seed) { return m_WorldHashTable.Lookup(seed).key != 0; });
+            m_OctreePrunedEvictedCount = m_WorldHashTable.GetEvictedCount();
+            m_OctreePrunedSize = m_pOctree->GetSize();
+        }
+
+        if (m_pOctree->IsComplete())
+            return;
+
+        //A cached point without a node (failed insert, loaded snapshot) is inserted when it is written again, or evicted
+        //maxAge frames after its last write. Without eviction the sweep never wraps and the octree stays incomplete.
+        uint32_t const frame = m_WorldHashTable.GetFrame();
+        if (m_OctreeIncompleteFrame == ~0u || m_pOctree->GetFailedInsertCount() != m_OctreeFailedInserts)
+        {
+            m_OctreeFailedInserts = m_pOctree->GetFailedInsertCount();
+            m_OctreeIncompleteFrame = frame;
+            m_OctreeCompleteRevolution = ~0u;
+        }
+        if (m_OctreeCompleteRevolution == ~0u && frame - m_OctreeIncompleteFrame > m_Settings.worldHashTableEviction.maxAge)
+            m_OctreeCompleteRevolution = m_WorldHashTable.GetSweepRevolutionCount() + 2;
+        if (m_OctreeCompleteRevolution != ~0u && m_WorldHashTable.GetSweepRevolutionCount() >= m_OctreeCompleteRevolution)
+        {
+            m_pOctree->MarkComplete();
+            m_OctreeIncompleteFrame = ~0u;
+        }
+    }
+
+    void Engine::FinalVisualizationPass(FrameData const& frame)
+    {
+        ValidateFrame(frame);
+        Clock::time_point const start = Clock::now();
+
+        uint2 const screenDimensions = { m_Settings.screenWidth, m_Settings.screenHeight };
+        float3 const cameraPosition = GetTranslation(frame.viewInverse);
+        HashTableConstants const& constants = m_Settings.hashTableConstants;
+
+        for (NeighbourVoxelCache& cache : m_NeighbourVoxelCaches)
+            cache.BeginFrame();
+        ImplicitPointOctree const* const pOctree = (m_pOctree && m_pOctree->IsComplete()) ? m_pOctree.get() : nullptr;
+
+        DispatchPixels([&](uint2 index2D, uint32_t index, uint32_t threadIndex)
+        {
+            //Calculate world position of pixel
+            float const depth = frame.depth[index];
+            if (asint(depth) == 0)
+            {
+                m_VisualizationBuffer[index] = 0.f;
+                return;
+            }
+            float3 const pixelWorldPosition = DepthToWorldPosition(depth, index2D, screenDimensions, frame.viewProjectionInverse).xyz();
+
+            //Get LODs - not constant to support DistanceLOD mode
+            uint2 lods = m_LODBuffer[index];
+            NeighbourVoxelCache* const pCache = m_NeighbourVoxelCaches.empty() ? nullptr : &m_NeighbourVoxelCaches[threadIndex];
+
+            //Shepard interpolation - 3D Lookup & linear interpolation between LODs (if necessary)
+            float aoValue = 0.f;
+            if (m_Settings.lodMode == LODMode::FixedLOD)
+            {
+                aoValue = WorldSpaceShepardInterpolationSingleLevel(m_Settings.cellSize, lods.x, pixelWorldPosition, m_Settings.maxLevels,
+                    m_Settings.voxelConnectivity, m_WorldHashTable, constants, pCache, pOctree);
+            }
+            else if (m_Settings.lodMode == LODMode::DistanceLOD)
+            {
+                float percentageLOD = 0.f;
+                SimpleDistanceLOD(m_Settings.maxLevels, frame.viewVector, pixelWorldPosition, cameraPosition, lods.x, lods.y, percentageLOD);
+
+                aoValue = WorldSpaceShepardInterpolationSingleLevel(m_Settings.cellSize, lods.x, pixelWorldPosition, m_Settings.maxLevels,
+                    m_Settings.voxelConnectivity, m_WorldHashTable, constants, pCache, pOctree);
+                float const aoPrevLODValue = WorldSpaceShepardInterpolationSingleLevel(m_Settings.cellSize, lods.y, pixelWorldPosition, m_Settings.maxLevels,
+                    m_Settings.voxelConnectivity, m_WorldHashTable, constants, pCache, pOctree);
+                aoValue = (aoValue * (1.f - percentageLOD)) + (aoPrevLODValue * percentageLOD);
+            }
+            else if (m_Settings.lodMode == LODMode::MinMaxLOD)
+            {
+                aoValue = WorldSpaceShepardInterpolationMultipleLevels(m_Settings.cellSize, lods, pixelWorldPosition, m_Settings.maxLevels,
+                    m_WorldHashTable, constants, pCache, pOctree, m_Settings.reconstructionBudget);
+            }
+
+            m_VisualizationBuffer[index] = aoValue;
+        });
+
+        m_Timings.finalVisualization = MillisecondsSince(start);
+    }
+
+    void Engine::ClearBuffersPass()
+    {
+        Clock::time_point const start = Clock::now();
+
+        if (m_Settings.accumulationMode == AccumulationMode::HashTable)
+        {
+            DispatchSlots(m_AccumulationHashTable.GetCapacity(), [&](uint32_t slotID)
+            {
+                m_AccumulationHashTable.ClearSlot(slotID);
+            });
+        }
+        DispatchPixels([&](uint2 /*index2D*/, uint32_t index, uint32_t /*threadIndex*/)
+        {
+            m_LODBuffer[index] = uint2{ 0, 0 };
+        });
+
+        m_Timings.clearBuffers = MillisecondsSince(start);
+    }
+
+    //AccumulationPass without atomics: every thread appends the (seed, AO) pairs of its tiles, the pairs are sorted by seed
+    //and every run of equal seeds is summed. Integer sums in seed order, so the runs don't depend on the thread count.
+    void Engine::SortAccumulationPass(FrameData const& frame)
+    {
+        HashTableConstants const& constants = m_Settings.hashTableConstants;
+        for (std::vector<uint64_t>& pairs : m_SortPairBuffers)
+            pairs.clear();
+
+        DispatchTiles([&](uint2 tileStart, uint2 tileEnd, uint32_t threadIndex)
+        {
+            std::vector<uint64_t>& pairs = m_SortPairBuffers[threadIndex];
+            for (uint32_t y = tileStart.y; y < tileEnd.y; ++y)
+            {
+                for (uint32_t x = tileStart.x; x < tileEnd.x; ++x)
+                {
+                    uint32_t const index = x + (y * m_Settings.screenWidth);
+                    if (index >= constants.accumulationHashTableElementCount)
+                        continue;
+
+                    float const aoValue = frame.ambientOcclusion[index];
+                    uint64_t const aoFixedRepresentation = ToFixedPoint(aoValue, constants.accumulationHashTableValueFractionalBits);
+                    SampleData const& data = m_PointSampleBuffer[index];
+                    if (data.seed == 0)
+                        continue;
+
+                    pairs.push_back((uint64_t(data.seed) << 32) | aoFixedRepresentation);
+                    if (data.prevSeed != 0 && data.prevSeed != data.seed)
+                        pairs.push_back((uint64_t(data.prevSeed) << 32) | aoFixedRepresentation);
+                }
+            }
+        });
+
+        std::vector<uint32_t> pairOffsets(m_SortPairBuffers.size() + 1, 0);
+        for (size_t t = 0; t < m_SortPairBuffers.size(); ++t)
+            pairOffsets[t + 1] = pairOffsets[t] + uint32_t(m_SortPairBuffers[t].size());
+        uint32_t const pairCount = pairOffsets.back();
+        m_SortElements.resize(pairCount);
+        m_SortScratch.resize(pairCount);
+        m_ThreadPool.ParallelFor(uint32_t(m_SortPairBuffers.size()), [&](uint32_t t, uint32_t /*threadIndex*/)
+        {
+            std::copy(m_SortPairBuffers[t].begin(), m_SortPairBuffers[t].end(), m_SortElements.begin() + pairOffsets[t]);
+        });
+
+        m_RadixSorter.Sort(m_SortElements.data(), m_SortScratch.data(), pairCount, 32, m_ThreadPool);
+
+        //Segmented reduction: a block owns the runs that start in it, even when they continue into the next block
+        uint32_t const elementsPerBlock = 65536;
+        uint32_t const blockCount = (pairCount + elementsPerBlock - 1) / elementsPerBlock;
+        m_RunBlockOffsets.assign(blockCount + 1, 0);
+        auto const isRunStart = [&](uint32_t i)
+        {
+            return i == 0 || (m_SortElements[i] >> 32) != (m_SortElements[i - 1] >> 32);
+        };
+        m_ThreadPool.ParallelFor(blockCount, [&](uint32_t block, uint32_t /*threadIndex*/)
+        {
+            uint32_t runCount = 0;
+            uint32_t const end = min((block + 1) * elementsPerBlock, pairCount);
+            for (uint32_t i = block * elementsPerBlock; i < end; ++i)
+                runCount += isRunStart(i) ? 1 : 0;
+            m_RunBlockOffsets[block + 1] = runCount;
+        });
+        for (uint32_t block = 0; block < blockCount; ++block)
+            m_RunBlockOffsets[block + 1] += m_RunBlockOffsets[block];
+
+        m_AccumulatedRuns.resize(m_RunBlockOffsets[blockCount]);
+        m_ThreadPool.ParallelFor(blockCount, [&](uint32_t block, uint32_t /*threadIndex*/)
+        {
+            uint32_t run = m_RunBlockOffsets[block];
+            uint32_t const end = min((block + 1) * elementsPerBlock, pairCount);
+            for (uint32_t i = block * elementsPerBlock; i < end; ++i)
+            {
+                if (!isRunStart(i))
+                    continue;
+
+                uint32_t const seed = uint32_t(m_SortElements[i] >> 32);
+                KeyData data = { seed, 0, 0 };
+                for (uint32_t j = i; j < pairCount && uint32_t(m_SortElements[j] >> 32) == seed; ++j)
+                {
+                    data.value += uint32_t(m_SortElements[j]);
+                    ++data.count;
+                }
+                m_AccumulatedRuns[run++] = data;
+            }
+        });
+
+        m_AccumulationUpdateCount.store(m_AccumulatedRuns.size(), std::memory_order_relaxed);
+    }
+
+    //WorldHashTablePass over the runs of SortAccumulationPass, sorted again by their home group in the world hash table,
+    //so the merge walks the table front to back instead of jumping around.
+    //Deterministic: the table is cut in ranges of DeterministicMergeGroups groups. A key only claims slots in its own range
+    //and the first MaxProbeGroups groups of the next one, so the even ranges are merged in parallel, each on one thread in
+    //run order, then the odd ones. Every probe sequence then sees its claims in the same order on any amount of threads.
+    void Engine::SortedWorldHashTablePass()
+    {
+        HashTableConstants const& constants = m_Settings.hashTableConstants;
+        uint32_t const runCount = uint32_t(m_AccumulatedRuns.size());
+        WorldHashTable::Table const& table = m_WorldHashTable.GetTable();
+        uint32_t const groupCount = table.GetCapacity() / WorldHashTable::Table::SlotsPerGroup;
+        uint32_t groupBits = 1;
+        while (groupBits < 32 && ((groupCount - 1) >> groupBits) != 0)
+            ++groupBits;
+
+        m_SortElements.resize(runCount);
+        m_SortScratch.resize(runCount);
+        DispatchSlots(runCount, [&](uint32_t run)
+        {
+            m_SortElements[run] = (uint64_t(table.GetHomeGroup(m_AccumulatedRuns[run].key)) << 32) | run;
+        });
+        m_RadixSorter.Sort(m_SortElements.data(), m_SortScratch.data(), runCount, groupBits, m_ThreadPool);
+
+        auto const mergeRun = [&](uint32_t i)
+        {
+            KeyData const& accumulatedData = m_AccumulatedRuns[uint32_t(m_SortElements[i])];
+            KeyData const mergedData = MergeAccumulatedData(accumulatedData, m_WorldHashTable.Lookup(accumulatedData.key), constants);
+            m_WorldHashTable.Insert(mergedData.key, mergedData.value, mergedData.count);
+        };
+        if (m_Settings.accumulationMode != AccumulationMode::Deterministic)
+        {
+            DispatchSlots(runCount, mergeRun);
+            return;
+        }
+
+        //The last range wraps around into the first one, an even amount of ranges keeps them in different halves.
+        //Small tables are merged in one range.
+        static_assert(DeterministicMergeGroups >= WorldHashTable::Table::MaxProbeGroupCount, "A merge range must be longer than a probe sequence");
+        uint32_t const rangeCount = (groupCount % (DeterministicMergeGroups * 2) == 0) ? groupCount / DeterministicMergeGroups : 1;
+        uint32_t const rangeGroups = groupCount / rangeCount;
+        std::vector<uint32_t> rangeStarts(rangeCount + 1, runCount);
+        for (uint32_t range = 0; range < rangeCount; ++range)
+        {
+            uint64_t const firstElement = uint64_t(range * rangeGroups) << 32;
+            rangeStarts[range] = uint32_t(std::lower_bound(m_SortElements.begin(), m_SortElements.end(), firstElement) - m_SortElements.begin());
+        }
+
+        for (uint32_t half = 0; half < 2; ++half)
+        {
+            m_ThreadPool.ParallelFor((rangeCount + 1 - half) / 2, [&](uint32_t job, uint32_t /*threadIndex*/)
+            {
+                uint32_t const range = job * 2 + half;
+                for (uint32_t i = rangeStarts[range]; i < rangeStarts[range + 1]; ++i)
+                    mergeRun(i);
+            });
+        }
+    }
+
+    std::future<bool> Engine::SaveWorldHashTableAsync(std::string const& filename)
+    {
+        m_WorldHashTable.FinishMigration(m_ThreadPool);
+        return SaveSnapshotAsync(filename, m_WorldHashTable, GetSnapshotSettings());
+    }
+
+    bool Engine::LoadWorldHashTable(std::string const& filename)
+    {
+        //The mapped entries were generated by another run, the octree doesn't know their voxels
+        if (m_pOctree)
+        {
+            m_pOctree->MarkIncomplete();
+            m_OctreeIncompleteFrame = ~0u;
+        }
+        return WarmStartFromSnapshot(filename.c_str(), m_WorldHashTable, GetSnapshotSettings());
+    }
+
+    uint64_t Engine::GetNeighbourVoxelCacheHitCount() const
+    {
+        uint64_t hits = 0;
+        for (NeighbourVoxelCache const& cache : m_NeighbourVoxelCaches)
+            hits += cache.GetHitCount();
+        return hits;
+    }
+
+    uint64_t Engine::GetNeighbourVoxelCacheMissCount() const
+    {
+        uint64_t misses = 0;
+        for (NeighbourVoxelCache const& cache : m_NeighbourVoxelCaches)
+            misses += cache.GetMissCount();
+        return misses;
+    }
+
+    SnapshotSettings Engine::GetSnapshotSettings() const
+    {
+        return SnapshotSettings{ m_Settings.hashTableConstants, m_Settings.cellSize, m_Settings.maxLevels };
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,206 @@
+//Headless CPU version of the implicit point pipeline of ImplicitPointDemo: sample generation, accumulation, world hash table merge,
+//final visualization and clear passes, run over all cores on a captured (or synthetic) frame.
+//Every pass mirrors its compute/pixel shader, so the world hash table matches what the GPU path would build for the same input.
+#pragma once
+#include "ShaderTypes.h"
+#include "HashTable.h"
+#include "ResizableHashTable.h"
+#include "LocalAccumulationMap.h"
+#include "NeighbourVoxelCache.h"
+#include "ReprojectionCache.h"
+#include "FinalVisualizationPass.h"
+#include "RadixSort.h"
+#include "HashTableSnapshot.h"
+#include "LODFunctions.h"
+#include "MinMaxPyramid.h"
+#include "FrameData.h"
+#include "ThreadPool.h"
+#include "CpuFeatures.h"
+#include "SampleGenerationFunctions.h"
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct SampleData
+    {
+        uint32_t seed;     //4 bytes
+        uint32_t prevSeed; //4 bytes
+        float3 sample;     //12 bytes
+    };
+
+    //How the samples of a frame are summed per seed and merged into the world hash table
+    enum class AccumulationMode : uint32_t
+    {
+        HashTable = 0,  //Atomic increments into the accumulation hash table, like the GPU version
+        Sort = 1,       //(seed, AO) pairs radix sorted by seed and reduced per run, merged in world hash table slot order
+        Deterministic = 2 //Sort, merged and migrated in an order that doesn't depend on the thread count or scheduling:
+                          //the world hash table ends up bit-identical, slot layout included
+    };
+
+    struct EngineSettings
+    {
+        uint32_t screenWidth = 1920; //Resolution of the frames, every per pixel buffer is sized from it
+        uint32_t screenHeight = 1080;
+        uint32_t voxelConnectivity = 26; //Either: 0, 6, 18 or 26
+        uint32_t maxLevels = 10;
+        uint32_t level = 10; //[0, maxLevels]
+        uint32_t cellSize = 2560;
+        LODMode lodMode = LODMode::FixedLOD;
+        //MinMaxLOD from a min/max pyramid over the blurred AO built once per frame instead of reading the kernel ring by ring.
+        //A few lookups per pixel at any kernel size, but the levels can differ from the shader's, see PyramidMinMaxLOD.
+        bool minMaxPyramid = false;
+        SamplePattern samplePattern = SamplePattern::Full; //Pixels that generate and accumulate a sample, rotated by RenderFrame
+        //Pixels whose world position moved less than this fraction of the cell size on their finest level since last frame keep
+        //last frame's closest samples (found by reprojection) instead of searching again, 0 = search every frame
+        float temporalReuseDistance = 0.f;
+        HashTableConstants hashTableConstants =
+        {
+            8388608,    //worldHashTableElementCount
+            0,          //accumulationHashTableElementCount, 0 = one slot per pixel (screenWidth * screenHeight) like the demo
+            31,         //worldHashTableValueFractionalBits
+            11,         //worldHashTableCountFractionalBits
+            11          //accumulationHashTableValueFractionalBits
+        };
+        ResizePolicy worldHashTablePolicy; //The world hash table grows up to worldHashTableElementCount slots
+        EvictionPolicy worldHashTableEviction;
+        uint32_t threadCount = 0; //0 = hardware concurrency
+        uint32_t tileSize = 64;   //Pixels are handed out to the threads in tileSize x tileSize tiles
+        AccumulationMode accumulationMode = AccumulationMode::HashTable;
+        bool tileAggregation = true; //Sum the samples of a tile per seed before the shared accumulation table
+        uint32_t neighbourVoxelCacheSize = 4096; //Neighbour voxels per thread the final pass reuses between pixels, 0 = gather every voxel per pixel
+        ReconstructionBudget reconstructionBudget; //Early-out of the MinMaxLOD reconstruction, gathers every level by default
+        uint32_t octreeCapacity = 0; //Nodes of the octree over the generated points that lets the reconstruction skip empty voxels, 0 = no octree
+        SimdWidth simdWidth = GetMaxSimdWidth(); //Sample generation kernel, clamped to what the CPU supports
+        bool stopAccumulating = false;
+        bool visualizeFinalPass = true;
+    };
+
+    //Wall clock time of the passes of the last RenderFrame, in milliseconds
+    struct PassTimings
+    {
+        double sampleGeneration = 0.0;
+        double accumulation = 0.0;
+        double worldHashTable = 0.0;
+        double maintenance = 0.0;
+        double finalVisualization = 0.0;
+        double clearBuffers = 0.0;
+        double total = 0.0;
+    };
+
+    //WorldHashTablePass for one key: blends the samples accumulated this frame into the cached entry (empty when the key
+    //was not cached yet), returns the key with the value and count to store in the world hash table
+    KeyData MergeAccumulatedData(KeyData const& accumulatedData, KeyData const& cachedData, HashTableConstants const& constants);
+
+    class Engine
+    {
+    public:
+        explicit Engine(EngineSettings const& settings);
+
+        Engine(Engine const&) = delete;
+        Engine& operator=(Engine const&) = delete;
+
+        //Runs the passes in the same order as ImplicitPointDemo::RenderScene
+        void RenderFrame(FrameData const& frame);
+
+        void SampleGenerationPass(FrameData const& frame);
+        void AccumulationPass(FrameData const& frame);
+        void WorldHashTablePass();
+        void MaintenancePass();
+        void FinalVisualizationPass(FrameData const& frame);
+        void ClearBuffersPass();
+
+        //World hash table snapshots (.iph), see HashTableSnapshot.h. Both are meant to be called between frames.
+        //Saving finishes a running migration, then only copies the table before the file is written in the background.
+        std::future<bool> SaveWorldHashTableAsync(std::string const& filename);
+        //Warm start of an empty world hash table, the mapped entries are used in place until they are migrated
+        bool LoadWorldHashTable(std::string const& filename);
+        SnapshotSettings GetSnapshotSettings() const;
+
+        //The settings the engine runs with, the accumulation hash table element count resolved
+        EngineSettings const& GetSettings() const { return m_Settings; }
+        uint32_t GetPixelCount() const { return m_Settings.screenWidth * m_Settings.screenHeight; }
+        PassTimings const& GetTimings() const { return m_Timings; }
+        //Frames rendered by RenderFrame, selects the pixels of EngineSettings::samplePattern the sample generation pass uses
+        uint32_t GetFrameIndex() const { return m_FrameIndex; }
+        uint32_t GetThreadCount() const { return m_ThreadPool.GetThreadCount(); }
+
+        std::vector<SampleData> const& GetPointSampleBuffer() const { return m_PointSampleBuffer; }
+        std::vector<uint2> const& GetLODBuffer() const { return m_LODBuffer; }
+        std::vector<float> const& GetVisualizationBuffer() const { return m_VisualizationBuffer; }
+        HashTable const& GetAccumulationHashTable() const { return m_AccumulationHashTable; }
+        WorldHashTable const& GetWorldHashTable() const { return m_WorldHashTable; }
+        //Increments into the shared accumulation table by the last AccumulationPass, runs (unique seeds) in sort mode
+        uint64_t GetAccumulationUpdateCount() const { return m_AccumulationUpdateCount.load(std::memory_order_relaxed); }
+        //Neighbour voxels the last FinalVisualizationPass gathered from the caches (hits) and looked up in the world hash table
+        //(misses, 8 lookups each), both 0 without EngineSettings::neighbourVoxelCacheSize
+        uint64_t GetNeighbourVoxelCacheHitCount() const;
+        uint64_t GetNeighbourVoxelCacheMissCount() const;
+        //Pixels of the sample pattern the last SampleGenerationPass took from last frame (hits) and searched (misses), both 0
+        //without EngineSettings::temporalReuseDistance
+        uint64_t GetTemporalReuseHitCount() const { return m_TemporalReuseHitCount.load(std::memory_order_relaxed); }
+        uint64_t GetTemporalReuseMissCount() const { return m_TemporalReuseMissCount.load(std::memory_order_relaxed); }
+        //Octree over the implicit points of the world hash table, nullptr without EngineSettings::octreeCapacity
+        ImplicitPointOctree const* GetOctree() const { return m_pOctree.get(); }
+
+    private:
+        EngineSettings m_Settings;
+        ThreadPool m_ThreadPool;
+        PassTimings m_Timings;
+        uint32_t m_FrameIndex;
+
+        std::vector<SampleData> m_PointSampleBuffer;
+        std::vector<uint2> m_LODBuffer;
+        std::vector<float> m_VisualizationBuffer;
+        HashTable m_AccumulationHashTable; //Temporary 2D hash table, cleared every frame
+        WorldHashTable m_WorldHashTable;   //Permanent 3D hash table, resized incrementally
+
+        //Per thread list of the pixels of a tile that need a generated sample on a certain LOD
+        struct SampleBatch
+        {
+            std::vector<uint32_t> indices;
+            std::vector<float3> positions;
+            std::vector<uint32_t> levels;
+            std::vector<ClosestPointSample> results;
+
+            void Clear() { indices.clear(); positions.clear(); levels.clear(); }
+        };
+        std::vector<SampleBatch> m_SampleBatches; //Two per thread: current and previous LOD
+        std::vector<LocalAccumulationMap> m_LocalAccumulationMaps; //One per thread, see EngineSettings::tileAggregation
+        std::atomic<uint64_t> m_AccumulationUpdateCount;
+        std::vector<NeighbourVoxelCache> m_NeighbourVoxelCaches; //One per thread, see EngineSettings::neighbourVoxelCacheSize
+        std::unique_ptr<ImplicitPointOctree> m_pOctree; //Filled by the sample generation pass, pruned by the maintenance pass
+        uint64_t m_OctreePrunedEvictedCount; //World hash table evictions at the last prune
+        uint32_t m_OctreePrunedSize;         //Octree nodes after the last prune
+        uint64_t m_OctreeFailedInserts;      //Failed inserts of the octree when it last became incomplete
+        uint32_t m_OctreeIncompleteFrame;    //World hash table frame the octree last became incomplete in, ~0u while it is complete
+        uint32_t m_OctreeCompleteRevolution; //Sweep revolution the octree is complete again at, ~0u until maxAge frames passed
+        std::unique_ptr<ReprojectionCache> m_pReprojectionCache; //See EngineSettings::temporalReuseDistance
+        MinMaxPyramid m_MinMaxPyramid; //See EngineSettings::minMaxPyramid
+        std::atomic<uint64_t> m_TemporalReuseHitCount;
+        std::atomic<uint64_t> m_TemporalReuseMissCount;
+
+        //Prunes the evicted points from the octree and marks it complete once the points without a node are evicted
+        void MaintainOctree();
+
+        //AccumulationMode::Sort and Deterministic, the accumulation hash table is not used
+        RadixSorter m_RadixSorter;
+        std::vector<std::vector<uint64_t>> m_SortPairBuffers; //Per thread (seed << 32 | AO) pairs of the frame
+        std::vector<uint64_t> m_SortElements;
+        std::vector<uint64_t> m_SortScratch;
+        std::vector<uint32_t> m_RunBlockOffsets;
+        std::vector<KeyData> m_AccumulatedRuns; //Unique seeds of the frame in ascending order, AO sum and sample count
+
+        template<typename TileFunction>
+        void DispatchTiles(TileFunction const& tileFunction);
+        template<typename PixelFunction>
+        void DispatchPixels(PixelFunction const& pixelFunction);
+        template<typename SlotFunction>
+        void DispatchSlots(uint32_t slotCount, SlotFunction const& slotFunction);
+        void ValidateFrame(FrameData const& frame) const;
+        void SortAccumulationPass(FrameData const& frame);
+        void SortedWorldHashTablePass();
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,195 @@
+#include "FinalVisualizationPass.h"
+#include "SampleGenerationFunctions.h"
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        //Adds the weighted cached values of the implicit points in pointMask (all 8 without an octree) of a single neighbour voxel
+        inline void AccumulateNeighbourSamples(NeighbourVoxel const& neighbour, uint32_t pointMask, uint32_t level, float cellSizeBasedOnLevel,
+            float searchRadius, float3 const& pixelWorldPosition, WorldHashTable const& worldHashTable, HashTableConstants const& constants,
+            float& valueSum, float& weightSum)
+        {
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                if ((pointMask & (1u << i)) == 0)
+                    continue;
+
+                uint32_t const seed = neighbour.seed + i;
+                float3 const sample = neighbour.position + (GenerateSampleInVoxelQuadrant(neighbour.seed, level, i) * cellSizeBasedOnLevel);
+
+                //Interpolation - Due to going over all points per subvoxel, duplicates are not possible
+                KeyData const cachedData = worldHashTable.Lookup(seed);
+                if (cachedData.key != 0)
+                {
+                    float const sampleCount = FromFixedPoint(cachedData.count, constants.worldHashTableCountFractionalBits);
+                    float const dist = distance(pixelWorldPosition, sample);
+                    float const weight = clamp(searchRadius - dist, 0.f, searchRadius) * sampleCount;
+
+                    valueSum += FromFixedPoint(cachedData.value, constants.worldHashTableValueFractionalBits) * weight;
+                    weightSum += weight;
+                }
+            }
+        }
+
+        //NeighbourVoxelCache miss: the same samples and lookups as AccumulateNeighbourSamples, an uncached seed gets a count of 0
+        inline void FillNeighbourVoxel(NeighbourVoxel const& neighbour, uint32_t pointMask, uint32_t level, float cellSizeBasedOnLevel,
+            WorldHashTable const& worldHashTable, HashTableConstants const& constants, CachedNeighbourVoxel& voxel)
+        {
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                if ((pointMask & (1u << i)) == 0)
+                {
+                    voxel.samples[i] = neighbour.position;
+                    voxel.values[i] = 0.f;
+                    voxel.sampleCounts[i] = 0.f;
+                    continue;
+                }
+
+                voxel.samples[i] = neighbour.position + (GenerateSampleInVoxelQuadrant(neighbour.seed, level, i) * cellSizeBasedOnLevel);
+
+                KeyData const cachedData = worldHashTable.Lookup(neighbour.seed + i);
+                bool const cached = cachedData.key != 0;
+                voxel.values[i] = cached ? FromFixedPoint(cachedData.value, constants.worldHashTableValueFractionalBits) : 0.f;
+                voxel.sampleCounts[i] = cached ? FromFixedPoint(cachedData.count, constants.worldHashTableCountFractionalBits) : 0.f;
+            }
+        }
+
+        //A count of 0 adds a weight of +0, which leaves both sums as AccumulateNeighbourSamples would
+        inline void AccumulateCachedNeighbourSamples(CachedNeighbourVoxel const& voxel, float searchRadius, float3 const& pixelWorldPosition,
+            float& valueSum, float& weightSum)
+        {
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                float const dist = distance(pixelWorldPosition, voxel.samples[i]);
+                float const weight = clamp(searchRadius - dist, 0.f, searchRadius) * voxel.sampleCounts[i];
+
+                valueSum += voxel.values[i] * weight;
+                weightSum += weight;
+            }
+        }
+
+        //Seed and generated points of the voxel at neighbourPosition. With an octree, a voxel without points (mask 0) can't have
+        //cached points either, and the seed doesn't have to be hashed.
+        inline uint32_t GetNeighbourPoints(float3 const& neighbourPosition, uint32_t level, float deltaOnLevel, uint32_t discreteCellSize,
+            uint32_t maxLevels, ImplicitPointOctree const* pOctree, uint32_t& seed)
+        {
+            if (pOctree == nullptr || !pOctree->Covers(level))
+            {
+                seed = GetNeighbourVoxelSeed(neighbourPosition, deltaOnLevel, discreteCellSize, maxLevels);
+                return 0xFFu;
+            }
+
+            OctreeNode const* const pNode = pOctree->Find(neighbourPosition, level);
+            uint32_t const pointMask = pNode != nullptr ? pNode->GetPointMask() : 0u;
+            seed = pointMask != 0 ? pNode->seed.load(std::memory_order_relaxed) : 0u;
+            return pointMask;
+        }
+
+        inline void AccumulateNeighbour(float3 const& discretePosition, uint32_t v, uint32_t level, float cellSizeBasedOnLevel, float deltaOnLevel,
+            uint32_t discreteCellSize, uint32_t maxLevels, float searchRadius, float3 const& pixelWorldPosition, WorldHashTable const& worldHashTable,
+            HashTableConstants const& constants, NeighbourVoxelCache* pCache, ImplicitPointOctree const* pOctree, float& valueSum, float& weightSum)
+        {
+            float3 const neighbourPosition = GetNeighbourPosition(discretePosition, v, cellSizeBasedOnLevel);
+            if (pCache == nullptr)
+            {
+                NeighbourVoxel neighbour = { neighbourPosition, 0 };
+                uint32_t const pointMask = GetNeighbourPoints(neighbourPosition, level, deltaOnLevel, discreteCellSize, maxLevels, pOctree, neighbour.seed);
+                if (pointMask != 0)
+                {
+                    AccumulateNeighbourSamples(neighbour, pointMask, level, cellSizeBasedOnLevel, searchRadius, pixelWorldPosition, worldHashTable, constants,
+                        valueSum, weightSum);
+                }
+                return;
+            }
+
+            CachedNeighbourVoxel const& voxel = pCache->Get(neighbourPosition, level, [&](CachedNeighbourVoxel& entry)
+            {
+                NeighbourVoxel neighbour = { neighbourPosition, 0 };
+                uint32_t const pointMask = GetNeighbourPoints(neighbourPosition, level, deltaOnLevel, discreteCellSize, maxLevels, pOctree, neighbour.seed);
+                FillNeighbourVoxel(neighbour, pointMask, level, cellSizeBasedOnLevel, worldHashTable, constants, entry);
+            });
+            AccumulateCachedNeighbourSamples(voxel, searchRadius, pixelWorldPosition, valueSum, weightSum);
+        }
+    }
+
+    float SingleSample(uint32_t seed, WorldHashTable const& worldHashTable, HashTableConstants const& constants)
+    {
+        if (seed == 0)
+            return 0.f;
+
+        KeyData const cachedData = worldHashTable.Lookup(seed);
+        return FromFixedPoint(cachedData.value, constants.worldHashTableValueFractionalBits);
+    }
+
+    float WorldSpaceShepardInterpolationSingleLevel(uint32_t discreteCellSize, uint32_t level, float3 const& pixelWorldPosition, uint32_t maxLevels,
+        uint32_t voxelConnectivity, WorldHashTable const& worldHashTable, HashTableConstants const& constants, NeighbourVoxelCache* pCache,
+        ImplicitPointOctree const* pOctree)
+    {
+        //Shepard Interpolation Variables
+        float const searchRadius = float(discreteCellSize) / float(IntPow2(level));
+        float valueSum = 0.f;
+        float weightSum = 0.f;
+
+        //Discretize position based on discrete cell size and current level
+        float const deltaOnLevel = 1.f / float(IntPow2(level));
+        float const cellSizeBasedOnLevel = float(discreteCellSize) * deltaOnLevel;
+        float3 const discretePosition = Discretize(pixelWorldPosition, cellSizeBasedOnLevel);
+
+        //For that discrete position, interate over all the neighbouring voxels(based on the size of cell size)
+        for (uint32_t v = 0; v < (voxelConnectivity + 1); ++v)
+        {
+            AccumulateNeighbour(discretePosition, v, level, cellSizeBasedOnLevel, deltaOnLevel, discreteCellSize, maxLevels, searchRadius, pixelWorldPosition,
+                worldHashTable, constants, pCache, pOctree, valueSum, weightSum);
+        }
+
+        if (weightSum > 0.f)
+            valueSum /= weightSum;
+
+        return valueSum;
+    }
+
+    float WorldSpaceShepardInterpolationMultipleLevels(uint32_t discreteCellSize, uint2 lhLOD, float3 const& pixelWorldPosition, uint32_t maxLevels,
+        WorldHashTable const& worldHashTable, HashTableConstants const& constants, NeighbourVoxelCache* pCache, ImplicitPointOctree const* pOctree,
+        ReconstructionBudget const& budget)
+    {
+        //Shepard Interpolation Variables
+        uint32_t const voxelConnectivity = 27;
+        float const searchRadius = float(discreteCellSize) / float(IntPow2(lhLOD.y)); //Most coarse level for interpolation
+        float valueSum = 0.f;
+        float weightSum = 0.f;
+
+        //Weights are (searchRadius - dist) * count
+        float const minWeightSum = budget.minWeight * searchRadius;
+        //Rounded up, a budget below 8 points still gathers the center voxel
+        uint32_t const maxVoxels = budget.maxPointsPerPixel == 0 ? ~0u : (budget.maxPointsPerPixel + 7) / 8;
+        uint32_t voxelCount = 0;
+
+        //The budget only stops a pixel that has found a weighted point, without one it would render black and keeps gathering unbudgeted
+        for (uint32_t l = lhLOD.y; l <= lhLOD.x; ++l)
+        {
+            if (weightSum > 0.f && (voxelCount >= maxVoxels || (minWeightSum > 0.f && weightSum >= minWeightSum)))
+                break;
+
+            //Discretize position based on discrete cell size and current level
+            float const deltaOnLevel = 1.f / float(IntPow2(l));
+            float const cellSizeBasedOnLevel = float(discreteCellSize) * deltaOnLevel;
+            float3 const discretePosition = Discretize(pixelWorldPosition, cellSizeBasedOnLevel);
+
+            //For that discrete position, interate over all the neighbouring voxels(based on the size of cell size)
+            //The offsets are ordered center, faces, edges, corners: a budget running out mid level drops the farthest voxels
+            for (uint32_t v = 0; v < voxelConnectivity; ++v, ++voxelCount)
+            {
+                if (voxelCount >= maxVoxels && weightSum > 0.f)
+                    break;
+                AccumulateNeighbour(discretePosition, v, l, cellSizeBasedOnLevel, deltaOnLevel, discreteCellSize, maxLevels, searchRadius, pixelWorldPosition,
+                    worldHashTable, constants, pCache, pOctree, valueSum, weightSum);
+            }
+        }
+
+        if (weightSum > 0.f)
+            valueSum /= weightSum;
+
+        return valueSum;
+    }
+} //namespace ImplicitPointCPU
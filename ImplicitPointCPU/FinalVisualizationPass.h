@@ -0,0 +1,32 @@
+//CPU port of the reconstruction functions in Shaders/FinalVisualizationPass.hlsl
+#pragma once
+#include "ShaderTypes.h"
+#include "ResizableHashTable.h"
+#include "NeighbourVoxelCache.h"
+#include "ImplicitPointOctree.h"
+
+namespace ImplicitPointCPU
+{
+    //Bounded work of WorldSpaceShepardInterpolationMultipleLevels, the default gathers every level
+    struct ReconstructionBudget
+    {
+        float minWeight = 0.f;          //Stop after the level where the summed weight, in samples at distance 0, reaches this. 0 = off
+        uint32_t maxPointsPerPixel = 0; //Implicit points gathered at most, 8 per neighbour voxel rounded up. Exceeded until a weighted point is found. 0 = unbounded
+    };
+
+    //Visualize the pixel using only the value of the cached shading information, for that pixel, in the discrete structure (no filtering)
+    float SingleSample(uint32_t seed, WorldHashTable const& worldHashTable, HashTableConstants const& constants);
+
+    //Visualize the pixel by interpolating in world space using a modified Shepard interpolation. Single level as it doesn't guarantee data
+    //for previous levels. With a cache, the neighbour voxels are gathered from it, the result is bit-identical. With a complete octree,
+    //only the points that were generated are looked up, which drops the seeds that only collide with a cached key.
+    float WorldSpaceShepardInterpolationSingleLevel(uint32_t discreteCellSize, uint32_t level, float3 const& pixelWorldPosition, uint32_t maxLevels,
+        uint32_t voxelConnectivity, WorldHashTable const& worldHashTable, HashTableConstants const& constants, NeighbourVoxelCache* pCache = nullptr,
+        ImplicitPointOctree const* pOctree = nullptr);
+
+    //Visualize the pixel by interpolating in world space using a modified Shepard interpolation. Multiple levels as it acquires data from previous levels.
+    //lhLOD.x is the finest and lhLOD.y the coarsest level. The levels are gathered coarse to fine, the budget stops early.
+    float WorldSpaceShepardInterpolationMultipleLevels(uint32_t discreteCellSize, uint2 lhLOD, float3 const& pixelWorldPosition, uint32_t maxLevels,
+        WorldHashTable const& worldHashTable, HashTableConstants const& constants, NeighbourVoxelCache* pCache = nullptr,
+        ImplicitPointOctree const* pOctree = nullptr, ReconstructionBudget const& budget = ReconstructionBudget());
+} //namespace ImplicitPointCPU
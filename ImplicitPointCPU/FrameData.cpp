@@ -0,0 +1,103 @@
+#include "FrameData.h"
+#include <cstdio>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        uint32_t const FrameFileMagic = 0x46435049; //"IPCF"
+        uint32_t const FrameFileVersion = 1;
+
+        struct FrameFileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t hasBlurredAmbientOcclusion;
+            float4x4 viewProjectionInverse;
+            float4x4 viewInverse;
+            float3 viewVector;
+        };
+    }
+
+    void FrameData::Resize(uint32_t newWidth, uint32_t newHeight)
+    {
+        width = newWidth;
+        height = newHeight;
+        depth.assign(size_t(width) * height, 0.f);
+        ambientOcclusion.assign(size_t(width) * height, 0.f);
+        blurredAmbientOcclusion.clear();
+    }
+
+    bool LoadFrame(char const* filename, FrameData& frame)
+    {
+        FILE* file = std::fopen(filename, "rb");
+        if (file == nullptr)
+            return false;
+
+        bool ok = false;
+        FrameFileHeader header = {};
+        size_t pixelCount = 0;
+
+        if (1 != std::fread(&header, sizeof(FrameFileHeader), 1, file)) goto frame_load_fail;
+        if (header.magic != FrameFileMagic || header.version != FrameFileVersion) goto frame_load_fail;
+
+        frame.Resize(header.width, header.height);
+        frame.viewProjectionInverse = header.viewProjectionInverse;
+        frame.viewInverse = header.viewInverse;
+        frame.viewVector = header.viewVector;
+        pixelCount = size_t(header.width) * header.height;
+
+        if (pixelCount != std::fread(frame.depth.data(), sizeof(float), pixelCount, file)) goto frame_load_fail;
+        if (pixelCount != std::fread(frame.ambientOcclusion.data(), sizeof(float), pixelCount, file)) goto frame_load_fail;
+        if (header.hasBlurredAmbientOcclusion != 0)
+        {
+            frame.blurredAmbientOcclusion.resize(pixelCount);
+            if (pixelCount != std::fread(frame.blurredAmbientOcclusion.data(), sizeof(float), pixelCount, file)) goto frame_load_fail;
+        }
+
+        ok = true;
+
+    frame_load_fail:
+
+        if (EOF == std::fclose(file))
+            ok = false;
+
+        return ok;
+    }
+
+    bool SaveFrame(char const* filename, FrameData const& frame)
+    {
+        FILE* file = std::fopen(filename, "wb");
+        if (file == nullptr)
+            return false;
+
+        bool ok = false;
+        size_t const pixelCount = size_t(frame.width) * frame.height;
+        FrameFileHeader header = {};
+        header.magic = FrameFileMagic;
+        header.version = FrameFileVersion;
+        header.width = frame.width;
+        header.height = frame.height;
+        header.hasBlurredAmbientOcclusion = frame.blurredAmbientOcclusion.empty() ? 0 : 1;
+        header.viewProjectionInverse = frame.viewProjectionInverse;
+        header.viewInverse = frame.viewInverse;
+        header.viewVector = frame.viewVector;
+
+        if (1 != std::fwrite(&header, sizeof(FrameFileHeader), 1, file)) goto frame_save_fail;
+        if (pixelCount != std::fwrite(frame.depth.data(), sizeof(float), pixelCount, file)) goto frame_save_fail;
+        if (pixelCount != std::fwrite(frame.ambientOcclusion.data(), sizeof(float), pixelCount, file)) goto frame_save_fail;
+        if (header.hasBlurredAmbientOcclusion != 0)
+            if (pixelCount != std::fwrite(frame.blurredAmbientOcclusion.data(), sizeof(float), pixelCount, file)) goto frame_save_fail;
+
+        ok = true;
+
+    frame_save_fail:
+
+        if (EOF == std::fclose(file))
+            ok = false;
+
+        return ok;
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,48 @@
+//Input of the CPU engine: the depth and ambient occlusion buffers of a single frame, plus the camera used to render them.
+#pragma once
+#include "ShaderTypes.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    //Read-only view on a single channel texture. Out of bounds loads return 0, like D3D12 does.
+    struct TextureView
+    {
+        float const* pData;
+        uint32_t width;
+        uint32_t height;
+
+        float Load(int32_t x, int32_t y) const
+        {
+            if (x < 0 || y < 0 || uint32_t(x) >= width || uint32_t(y) >= height)
+                return 0.f;
+            return pData[uint32_t(x) + uint32_t(y) * width];
+        }
+    };
+
+    struct FrameData
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        float4x4 viewProjectionInverse = {};
+        float4x4 viewInverse = {};
+        float3 viewVector = {};
+
+        std::vector<float> depth;                   //Reversed-Z depth, 0 = nothing rendered
+        std::vector<float> ambientOcclusion;        //Raw (ray traced) AO, input of the accumulation
+        std::vector<float> blurredAmbientOcclusion; //Blurred AO used by MinMaxLOD, falls back to ambientOcclusion when empty
+
+        TextureView GetDepthView() const { return TextureView{ depth.data(), width, height }; }
+        TextureView GetAmbientOcclusionView() const { return TextureView{ ambientOcclusion.data(), width, height }; }
+        TextureView GetBlurredAmbientOcclusionView() const
+        {
+            return blurredAmbientOcclusion.empty() ? GetAmbientOcclusionView() : TextureView{ blurredAmbientOcclusion.data(), width, height };
+        }
+
+        void Resize(uint32_t newWidth, uint32_t newHeight);
+    };
+
+    //Raw binary frame file (.ipf): header, matrices, then the depth/AO/blurred AO planes as 32 bit floats
+    bool LoadFrame(char const* filename, FrameData& frame);
+    bool SaveFrame(char const* filename, FrameData const& frame);
+} //namespace ImplicitPointCPU
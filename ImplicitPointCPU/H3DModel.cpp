@@ -0,0 +1,166 @@
+#include "H3DModel.h"
+#include <cstdio>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        bool ReadBytes(FILE* file, void* pData, size_t size)
+        {
+            return size == 0 || 1 == std::fread(pData, size, 1, file);
+        }
+
+        bool WriteBytes(FILE* file, void const* pData, size_t size)
+        {
+            return size == 0 || 1 == std::fwrite(pData, size, 1, file);
+        }
+    }
+
+    uint32_t H3DModelView::GetTriangleCount() const
+    {
+        uint32_t count = 0;
+        for (H3DMesh const& mesh : meshes)
+            count += mesh.indexCount / 3;
+        return count;
+    }
+
+    bool IsValidH3D(H3DModelView const& view)
+    {
+        for (H3DMesh const& mesh : view.meshes)
+        {
+            //The tracers read positions as 3 floats, like the acceleration structure build of the demo does
+            H3DAttribDesc const& position = mesh.attrib[H3DAttribPosition];
+            if (position.components != 3 || position.format != H3DAttribFormatFloat)
+                return false;
+            if (uint64_t(position.offset) + sizeof(float3) > mesh.vertexStride)
+                return false;
+            if ((mesh.attribsEnabled & (1u << H3DAttribNormal)) != 0 && uint64_t(mesh.attrib[H3DAttribNormal].offset) + sizeof(float3) > mesh.vertexStride)
+                return false;
+
+            if (uint64_t(mesh.vertexDataByteOffset) + uint64_t(mesh.vertexCount) * mesh.vertexStride > view.vertexData.size)
+                return false;
+            if (uint64_t(mesh.indexDataByteOffset) + uint64_t(mesh.indexCount) * sizeof(uint16_t) > min(view.indexData.size, view.indexDataDepth.size))
+                return false;
+            if (uint64_t(mesh.vertexDataByteOffsetDepth) + uint64_t(mesh.vertexCountDepth) * mesh.vertexStrideDepth > view.vertexDataDepth.size)
+                return false;
+        }
+        return true;
+    }
+
+    uint32_t H3DModel::GetTriangleCount() const
+    {
+        return GetView().GetTriangleCount();
+    }
+
+    H3DModelView H3DModel::GetView() const
+    {
+        H3DModelView view;
+        view.header = &header;
+        view.meshes = H3DSpan<H3DMesh>{ meshes.data(), meshes.size() };
+        view.materials = H3DSpan<H3DMaterial>{ materials.data(), materials.size() };
+        view.vertexData = H3DSpan<uint8_t>{ vertexData.data(), vertexData.size() };
+        view.indexData = H3DSpan<uint8_t>{ indexData.data(), indexData.size() };
+        view.vertexDataDepth = H3DSpan<uint8_t>{ vertexDataDepth.data(), vertexDataDepth.size() };
+        view.indexDataDepth = H3DSpan<uint8_t>{ indexDataDepth.data(), indexDataDepth.size() };
+        return view;
+    }
+
+    bool LoadH3D(char const* filename, H3DModel& model)
+    {
+        FILE* file = std::fopen(filename, "rb");
+        if (file == nullptr)
+            return false;
+
+        bool ok = false;
+
+        if (!ReadBytes(file, &model.header, sizeof(H3DHeader))) goto h3d_load_fail;
+
+        model.meshes.resize(model.header.meshCount);
+        model.materials.resize(model.header.materialCount);
+        if (!ReadBytes(file, model.meshes.data(), sizeof(H3DMesh) * model.meshes.size())) goto h3d_load_fail;
+        if (!ReadBytes(file, model.materials.data(), sizeof(H3DMaterial) * model.materials.size())) goto h3d_load_fail;
+
+        model.vertexData.resize(model.header.vertexDataByteSize);
+        model.indexData.resize(model.header.indexDataByteSize);
+        model.vertexDataDepth.resize(model.header.vertexDataByteSizeDepth);
+        model.indexDataDepth.resize(model.header.indexDataByteSize);
+        if (!ReadBytes(file, model.vertexData.data(), model.vertexData.size())) goto h3d_load_fail;
+        if (!ReadBytes(file, model.indexData.data(), model.indexData.size())) goto h3d_load_fail;
+        if (!ReadBytes(file, model.vertexDataDepth.data(), model.vertexDataDepth.size())) goto h3d_load_fail;
+        if (!ReadBytes(file, model.indexDataDepth.data(), model.indexDataDepth.size())) goto h3d_load_fail;
+
+        if (!IsValidH3D(model.GetView())) goto h3d_load_fail;
+
+        ok = true;
+
+    h3d_load_fail:
+
+        if (EOF == std::fclose(file))
+            ok = false;
+
+        return ok;
+    }
+
+    bool SaveH3D(char const* filename, H3DModel const& model)
+    {
+        FILE* file = std::fopen(filename, "wb");
+        if (file == nullptr)
+            return false;
+
+        bool ok = false;
+
+        if (!WriteBytes(file, &model.header, sizeof(H3DHeader))) goto h3d_save_fail;
+        if (!WriteBytes(file, model.meshes.data(), sizeof(H3DMesh) * model.meshes.size())) goto h3d_save_fail;
+        if (!WriteBytes(file, model.materials.data(), sizeof(H3DMaterial) * model.materials.size())) goto h3d_save_fail;
+        if (!WriteBytes(file, model.vertexData.data(), model.vertexData.size())) goto h3d_save_fail;
+        if (!WriteBytes(file, model.indexData.data(), model.indexData.size())) goto h3d_save_fail;
+        if (!WriteBytes(file, model.vertexDataDepth.data(), model.vertexDataDepth.size())) goto h3d_save_fail;
+        if (!WriteBytes(file, model.indexDataDepth.data(), model.indexDataDepth.size())) goto h3d_save_fail;
+
+        ok = true;
+
+    h3d_save_fail:
+
+        if (EOF == std::fclose(file))
+            ok = false;
+
+        return ok;
+    }
+
+    bool GetTriangleMesh(H3DModelView const& model, TriangleMesh& triangleMesh)
+    {
+        triangleMesh.positions.clear();
+        triangleMesh.normals.clear();
+        triangleMesh.indices.clear();
+        triangleMesh.meshFirstTriangle.clear();
+
+        for (H3DMesh const& mesh : model.meshes)
+        {
+            uint32_t const firstVertex = uint32_t(triangleMesh.positions.size());
+            triangleMesh.meshFirstTriangle.push_back(uint32_t(triangleMesh.indices.size() / 3));
+            bool const hasNormals = (mesh.attribsEnabled & (1u << H3DAttribNormal)) != 0;
+            for (uint32_t v = 0; v < mesh.vertexCount; ++v)
+            {
+                triangleMesh.positions.push_back(model.GetVertexFloat3(mesh, H3DAttribPosition, v));
+                triangleMesh.normals.push_back(hasNormals ? model.GetVertexFloat3(mesh, H3DAttribNormal, v) : float3{ 0.f, 0.f, 0.f });
+            }
+            for (uint32_t i = 0; i < (mesh.indexCount / 3) * 3; ++i)
+            {
+                uint16_t const index = model.GetIndex(mesh, i);
+                if (index >= mesh.vertexCount)
+                {
+                    triangleMesh = TriangleMesh();
+                    return false;
+                }
+                triangleMesh.indices.push_back(firstVertex + index);
+            }
+        }
+        triangleMesh.meshFirstTriangle.push_back(uint32_t(triangleMesh.indices.size() / 3));
+        return true;
+    }
+
+    bool GetTriangleMesh(H3DModel const& model, TriangleMesh& triangleMesh)
+    {
+        return GetTriangleMesh(model.GetView(), triangleMesh);
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,209 @@
+//CPU side reader/writer of the H3D model format of ImplicitPointDemo (Model::LoadH3D / Model::SaveH3D), without the
+//MiniEngine dependencies. The tables have the exact layout of the Model structs: Math::Vector3 is a 16 byte aligned SIMD
+//vector, so every bounding box and color takes 16 bytes per vector and the structs are padded to 16 bytes.
+#pragma once
+#include "ShaderTypes.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct alignas(16) H3DVector3
+    {
+        float x, y, z, w;
+    };
+
+    struct H3DBoundingBox
+    {
+        H3DVector3 min;
+        H3DVector3 max;
+    };
+
+    struct H3DHeader
+    {
+        uint32_t meshCount;
+        uint32_t materialCount;
+        uint32_t vertexDataByteSize;
+        uint32_t indexDataByteSize;
+        uint32_t vertexDataByteSizeDepth;
+        H3DBoundingBox boundingBox;
+    };
+
+    //Model::attrib_format_*
+    enum H3DAttribFormat : uint16_t
+    {
+        H3DAttribFormatNone = 0,
+        H3DAttribFormatUByte,
+        H3DAttribFormatByte,
+        H3DAttribFormatUShort,
+        H3DAttribFormatShort,
+        H3DAttribFormatFloat
+    };
+
+    //Model::attrib_*, the attributes the demo's vertex layout uses
+    enum H3DAttrib : uint32_t
+    {
+        H3DAttribPosition = 0,
+        H3DAttribTexcoord0 = 1,
+        H3DAttribNormal = 2,
+        H3DAttribTangent = 3,
+        H3DAttribBitangent = 4,
+        H3DMaxAttribs = 16
+    };
+
+    struct H3DAttribDesc
+    {
+        uint16_t offset;     //Byte offset from the start of the vertex
+        uint16_t normalized;
+        uint16_t components;
+        uint16_t format;     //H3DAttribFormat
+    };
+
+    struct H3DMesh
+    {
+        H3DBoundingBox boundingBox;
+
+        uint32_t materialIndex;
+
+        uint32_t attribsEnabled;
+        uint32_t attribsEnabledDepth;
+        uint32_t vertexStride;
+        uint32_t vertexStrideDepth;
+        H3DAttribDesc attrib[H3DMaxAttribs];
+        H3DAttribDesc attribDepth[H3DMaxAttribs];
+
+        uint32_t vertexDataByteOffset;
+        uint32_t vertexCount;
+        uint32_t indexDataByteOffset; //16 bit indices, relative to the first vertex of the mesh
+        uint32_t indexCount;
+
+        uint32_t vertexDataByteOffsetDepth;
+        uint32_t vertexCountDepth;
+    };
+
+    struct H3DMaterial
+    {
+        H3DVector3 diffuse;
+        H3DVector3 specular;
+        H3DVector3 ambient;
+        H3DVector3 emissive;
+        H3DVector3 transparent;
+        float opacity;
+        float shininess;
+        float specularStrength;
+
+        char texDiffusePath[128];
+        char texSpecularPath[128];
+        char texEmissivePath[128];
+        char texNormalPath[128];
+        char texLightmapPath[128];
+        char texReflectionPath[128];
+
+        char name[128];
+    };
+
+    static_assert(sizeof(H3DHeader) == 64, "H3DHeader must match the layout of Model::Header");
+    static_assert(sizeof(H3DMesh) == 336, "H3DMesh must match the layout of Model::Mesh");
+    static_assert(sizeof(H3DMaterial) == 992, "H3DMaterial must match the layout of Model::Material");
+
+    //Read-only range of elements stored elsewhere: in the vectors of an H3DModel or in a mapped file
+    template<typename T>
+    struct H3DSpan
+    {
+        T const* data = nullptr;
+        size_t size = 0;
+
+        T const* begin() const { return data; }
+        T const* end() const { return data + size; }
+        T const& operator[](size_t i) const { return data[i]; }
+    };
+
+    //The tables and streams of a model wherever they are stored: H3DModel::GetView or MappedH3DModel::GetView. BVH builders
+    //and bakers read the geometry through this without copying it.
+    struct H3DModelView
+    {
+        H3DHeader const* header = nullptr;
+        H3DSpan<H3DMesh> meshes;
+        H3DSpan<H3DMaterial> materials;
+        H3DSpan<uint8_t> vertexData;
+        H3DSpan<uint8_t> indexData;
+        H3DSpan<uint8_t> vertexDataDepth;
+        H3DSpan<uint8_t> indexDataDepth; //Same size and mesh offsets as indexData
+
+        //Float3 attribute (position, normal, ...) of vertex vertexIndex of mesh
+        float3 GetVertexFloat3(H3DMesh const& mesh, uint32_t attrib, uint32_t vertexIndex) const
+        {
+            float3 value;
+            std::memcpy(&value, vertexData.data + mesh.vertexDataByteOffset + size_t(vertexIndex) * mesh.vertexStride + mesh.attrib[attrib].offset, sizeof(value));
+            return value;
+        }
+
+        uint16_t GetIndex(H3DMesh const& mesh, uint32_t index) const
+        {
+            uint16_t value;
+            std::memcpy(&value, indexData.data + mesh.indexDataByteOffset + size_t(index) * sizeof(uint16_t), sizeof(value));
+            return value;
+        }
+
+        //The vertices (mesh.vertexStride apart) and 16 bit indices of one mesh, full and depth-only
+        H3DSpan<uint8_t> GetVertexData(H3DMesh const& mesh) const
+        {
+            return H3DSpan<uint8_t>{ vertexData.data + mesh.vertexDataByteOffset, size_t(mesh.vertexCount) * mesh.vertexStride };
+        }
+
+        H3DSpan<uint8_t> GetIndexData(H3DMesh const& mesh) const
+        {
+            return H3DSpan<uint8_t>{ indexData.data + mesh.indexDataByteOffset, size_t(mesh.indexCount) * sizeof(uint16_t) };
+        }
+
+        H3DSpan<uint8_t> GetVertexDataDepth(H3DMesh const& mesh) const
+        {
+            return H3DSpan<uint8_t>{ vertexDataDepth.data + mesh.vertexDataByteOffsetDepth, size_t(mesh.vertexCountDepth) * mesh.vertexStrideDepth };
+        }
+
+        H3DSpan<uint8_t> GetIndexDataDepth(H3DMesh const& mesh) const
+        {
+            return H3DSpan<uint8_t>{ indexDataDepth.data + mesh.indexDataByteOffset, size_t(mesh.indexCount) * sizeof(uint16_t) };
+        }
+
+        uint32_t GetTriangleCount() const;
+    };
+
+    //Checks the mesh table against the streams: the position attribute is 3 floats, the position and normal attributes lie
+    //inside the vertex stride, and the vertices and indices of every mesh lie inside their streams. Only the tables are
+    //read, so opening stays cheap: GetTriangleMesh checks the index values against the vertex counts.
+    bool IsValidH3D(H3DModelView const& view);
+
+    struct H3DModel
+    {
+        H3DHeader header = {};
+        std::vector<H3DMesh> meshes;
+        std::vector<H3DMaterial> materials;
+        std::vector<uint8_t> vertexData;
+        std::vector<uint8_t> indexData;
+        std::vector<uint8_t> vertexDataDepth;
+        std::vector<uint8_t> indexDataDepth;
+
+        uint32_t GetTriangleCount() const;
+
+        //Spans over the vectors, valid until they are resized
+        H3DModelView GetView() const;
+    };
+
+    //Same reads and writes as Model::LoadH3D / Model::SaveH3D, false on a short or missing file or tables IsValidH3D rejects
+    bool LoadH3D(char const* filename, H3DModel& model);
+    bool SaveH3D(char const* filename, H3DModel const& model);
+
+    //Every mesh appended into one indexed triangle list: positions, vertex normals and 32 bit indices into them
+    struct TriangleMesh
+    {
+        std::vector<float3> positions;
+        std::vector<float3> normals;
+        std::vector<uint32_t> indices;
+        std::vector<uint32_t> meshFirstTriangle; //First triangle of every mesh, plus the total triangle count
+    };
+
+    //False, with an empty triangleMesh, when an index points past the vertices of its mesh: the only check of the index
+    //values, which IsValidH3D leaves to this pass over all of them
+    bool GetTriangleMesh(H3DModelView const& model, TriangleMesh& triangleMesh);
+    bool GetTriangleMesh(H3DModel const& model, TriangleMesh& triangleMesh);
+} //namespace ImplicitPointCPU
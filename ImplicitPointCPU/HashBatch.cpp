@@ -0,0 +1,64 @@
+#include "HashBatch.h"
+#include "SampleGenerationFunctions.h"
+
+namespace ImplicitPointCPU
+{
+    template<typename Hash>
+    void HashSeedBatch(uint32_t const* x, uint32_t const* y, uint32_t const* z, uint32_t count, uint32_t* seeds, SimdWidth width)
+    {
+        //Whole vectors in the kernel, the tail on the scalar path
+        width = min(width, GetMaxSimdWidth());
+        uint32_t const vectorCount = count - (count % uint32_t(width));
+        if (width == SimdWidth::AVX512)
+            HashSeedBatchAVX512<Hash>(x, y, z, vectorCount, seeds);
+        else if (width == SimdWidth::AVX2)
+            HashSeedBatchAVX2<Hash>(x, y, z, vectorCount, seeds);
+
+        for (uint32_t i = (width == SimdWidth::Scalar ? 0 : vectorCount); i < count; ++i)
+            seeds[i] = Hash::Hash(uint3{ x[i], y[i], z[i] });
+    }
+
+    template void HashSeedBatch<PcgNestedHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*, SimdWidth);
+    template void HashSeedBatch<WangNestedHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*, SimdWidth);
+    template void HashSeedBatch<WangLinearHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*, SimdWidth);
+    template void HashSeedBatch<XxHash32Hash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*, SimdWidth);
+    template void HashSeedBatch<XorShiftLinearHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*, SimdWidth);
+
+    void Hash3Batch(uint32_t const* n, uint32_t count, float* x, float* y, float* z, SimdWidth width)
+    {
+        width = min(width, GetMaxSimdWidth());
+        uint32_t const vectorCount = count - (count % uint32_t(width));
+        if (width == SimdWidth::AVX512)
+            Hash3BatchAVX512(n, vectorCount, x, y, z);
+        else if (width == SimdWidth::AVX2)
+            Hash3BatchAVX2(n, vectorCount, x, y, z);
+
+        for (uint32_t i = (width == SimdWidth::Scalar ? 0 : vectorCount); i < count; ++i)
+        {
+            float3 const hash = hash3(n[i]);
+            x[i] = hash.x;
+            y[i] = hash.y;
+            z[i] = hash.z;
+        }
+    }
+
+    void GenerateVoxelSamplesBatch(uint32_t const* seeds, float3 const* positions, uint32_t count, float cellSize, float3* samples, SimdWidth width)
+    {
+        //An odd last voxel goes to the AVX2 kernel, every AVX-512 CPU has AVX2
+        width = min(width, GetMaxSimdWidth());
+        uint32_t const pairCount = width == SimdWidth::AVX512 ? count & ~1u : 0u;
+        if (pairCount != 0)
+            GenerateVoxelSamplesAVX512(seeds, positions, pairCount, cellSize, samples);
+        if (width != SimdWidth::Scalar)
+        {
+            GenerateVoxelSamplesAVX2(seeds + pairCount, positions + pairCount, count - pairCount, cellSize, samples + 8 * pairCount);
+            return;
+        }
+
+        for (uint32_t v = 0; v < count; ++v)
+        {
+            for (uint32_t i = 0; i < 8; ++i)
+                samples[8 * v + i] = positions[v] + (GenerateSampleInVoxelQuadrant(seeds[v], 0, i) * cellSize);
+        }
+    }
+} //namespace ImplicitPointCPU
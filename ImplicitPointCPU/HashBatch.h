@@ -0,0 +1,33 @@
+//Batched seed hashes: 8 (AVX2) or 16 (AVX-512) fixed point positions per step into the SIMD lanes of a seed hash policy,
+//bit-exact with the scalar policies in HashFunctions.h. The same for hash3 and the 8 implicit points of a voxel.
+#pragma once
+#include "HashFunctions.h"
+#include "CpuFeatures.h"
+#include "ShaderTypes.h"
+
+namespace ImplicitPointCPU
+{
+    //Hashes count fixed point positions, structure of arrays, with the seed hash policy Hash (one of the policies next to
+    //SeedHash). width is clamped to what the CPU supports, SimdWidth::Scalar runs the scalar reference.
+    template<typename Hash>
+    void HashSeedBatch(uint32_t const* x, uint32_t const* y, uint32_t const* z, uint32_t count, uint32_t* seeds, SimdWidth width);
+
+    //Instruction set specific entry points, count must be a multiple of 8 / 16
+    template<typename Hash>
+    void HashSeedBatchAVX2(uint32_t const* x, uint32_t const* y, uint32_t const* z, uint32_t count, uint32_t* seeds);
+    template<typename Hash>
+    void HashSeedBatchAVX512(uint32_t const* x, uint32_t const* y, uint32_t const* z, uint32_t count, uint32_t* seeds);
+
+    //hash3 of count values, structure of arrays
+    void Hash3Batch(uint32_t const* n, uint32_t count, float* x, float* y, float* z, SimdWidth width);
+    void Hash3BatchAVX2(uint32_t const* n, uint32_t count, float* x, float* y, float* z);
+    void Hash3BatchAVX512(uint32_t const* n, uint32_t count, float* x, float* y, float* z);
+
+    //The implicit points of count voxels: samples[8 * v + i] = positions[v] + GenerateSampleInVoxelQuadrant(seeds[v], level, i) * cellSize,
+    //the quadrants of a voxel are the lanes of a vector. Bit-exact with the scalar expression, which is the reference for
+    //SimdWidth::Scalar, as the SIMD translation units are compiled without FMA contraction (NoFloatContraction.h).
+    void GenerateVoxelSamplesBatch(uint32_t const* seeds, float3 const* positions, uint32_t count, float cellSize, float3* samples, SimdWidth width);
+    //One voxel per vector / two voxels per vector, count must be even for AVX-512
+    void GenerateVoxelSamplesAVX2(uint32_t const* seeds, float3 const* positions, uint32_t count, float cellSize, float3* samples);
+    void GenerateVoxelSamplesAVX512(uint32_t const* seeds, float3 const* positions, uint32_t count, float cellSize, float3* samples);
+} //namespace ImplicitPointCPU
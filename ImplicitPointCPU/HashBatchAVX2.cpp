@@ -0,0 +1,53 @@
+//Compiled with AVX2 enabled (/arch:AVX2, -mavx2), only reached through the runtime dispatch in HashBatch.cpp
+#include "NoFloatContraction.h"
+#include "HashBatch.h"
+#include "SimdAVX2.h"
+#include "HashFunctionsSimd.h"
+
+namespace ImplicitPointCPU
+{
+    template<typename Hash>
+    void HashSeedBatchAVX2(uint32_t const* x, uint32_t const* y, uint32_t const* z, uint32_t count, uint32_t* seeds)
+    {
+        typedef SimdAVX2 S;
+        for (uint32_t i = 0; i < count; i += S::Width)
+            S::Store(seeds + i, SeedHashLanes<S, Hash>::Hash(S::Load(x + i), S::Load(y + i), S::Load(z + i)));
+    }
+
+    template void HashSeedBatchAVX2<PcgNestedHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX2<WangNestedHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX2<WangLinearHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX2<XxHash32Hash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX2<XorShiftLinearHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+
+    void Hash3BatchAVX2(uint32_t const* n, uint32_t count, float* x, float* y, float* z)
+    {
+        typedef SimdAVX2 S;
+        for (uint32_t i = 0; i < count; i += S::Width)
+        {
+            S::Float hashX, hashY, hashZ;
+            HashLanes<S>::Hash3(S::Load(n + i), hashX, hashY, hashZ);
+            S::Store(x + i, hashX);
+            S::Store(y + i, hashY);
+            S::Store(z + i, hashZ);
+        }
+    }
+
+    void GenerateVoxelSamplesAVX2(uint32_t const* seeds, float3 const* positions, uint32_t count, float cellSize, float3* samples)
+    {
+        typedef SimdAVX2 S;
+        S::Int const quadrants = S::LaneIndices();
+        float x[S::Width], y[S::Width], z[S::Width];
+        for (uint32_t v = 0; v < count; ++v)
+        {
+            S::Float sampleX, sampleY, sampleZ;
+            HashLanes<S>::SampleInVoxelQuadrant(S::Set1(seeds[v]), quadrants, S::Set1(positions[v].x), S::Set1(positions[v].y),
+                S::Set1(positions[v].z), S::Set1(cellSize), sampleX, sampleY, sampleZ);
+            S::Store(x, sampleX);
+            S::Store(y, sampleY);
+            S::Store(z, sampleZ);
+            for (uint32_t i = 0; i < S::Width; ++i)
+                samples[8 * v + i] = float3{ x[i], y[i], z[i] };
+        }
+    }
+} //namespace ImplicitPointCPU
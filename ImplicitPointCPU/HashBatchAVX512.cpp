@@ -0,0 +1,59 @@
+//Compiled with AVX-512 enabled (/arch:AVX512, -mavx512f -mavx512dq -mavx512bw -mavx512vl), only reached through the
+//runtime dispatch in HashBatch.cpp
+#include "NoFloatContraction.h"
+#include "HashBatch.h"
+#include "SimdAVX512.h"
+#include "HashFunctionsSimd.h"
+
+namespace ImplicitPointCPU
+{
+    template<typename Hash>
+    void HashSeedBatchAVX512(uint32_t const* x, uint32_t const* y, uint32_t const* z, uint32_t count, uint32_t* seeds)
+    {
+        typedef SimdAVX512 S;
+        for (uint32_t i = 0; i < count; i += S::Width)
+            S::Store(seeds + i, SeedHashLanes<S, Hash>::Hash(S::Load(x + i), S::Load(y + i), S::Load(z + i)));
+    }
+
+    template void HashSeedBatchAVX512<PcgNestedHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX512<WangNestedHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX512<WangLinearHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX512<XxHash32Hash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+    template void HashSeedBatchAVX512<XorShiftLinearHash>(uint32_t const*, uint32_t const*, uint32_t const*, uint32_t, uint32_t*);
+
+    void Hash3BatchAVX512(uint32_t const* n, uint32_t count, float* x, float* y, float* z)
+    {
+        typedef SimdAVX512 S;
+        for (uint32_t i = 0; i < count; i += S::Width)
+        {
+            S::Float hashX, hashY, hashZ;
+            HashLanes<S>::Hash3(S::Load(n + i), hashX, hashY, hashZ);
+            S::Store(x + i, hashX);
+            S::Store(y + i, hashY);
+            S::Store(z + i, hashZ);
+        }
+    }
+
+    void GenerateVoxelSamplesAVX512(uint32_t const* seeds, float3 const* positions, uint32_t count, float cellSize, float3* samples)
+    {
+        //Lanes 0-7 are the quadrants of the first voxel of the pair, lanes 8-15 the ones of the second
+        typedef SimdAVX512 S;
+        S::Int const quadrants = S::And(S::LaneIndices(), S::Set1(7u));
+        S::Mask const second = S::Equal(S::And(S::LaneIndices(), S::Set1(8u)), S::Set1(8u));
+        float x[S::Width], y[S::Width], z[S::Width];
+        for (uint32_t v = 0; v < count; v += 2)
+        {
+            float3 const& first = positions[v];
+            float3 const& next = positions[v + 1];
+            S::Float sampleX, sampleY, sampleZ;
+            HashLanes<S>::SampleInVoxelQuadrant(S::Select(second, S::Set1(seeds[v + 1]), S::Set1(seeds[v])), quadrants,
+                S::Select(second, S::Set1(next.x), S::Set1(first.x)), S::Select(second, S::Set1(next.y), S::Set1(first.y)),
+                S::Select(second, S::Set1(next.z), S::Set1(first.z)), S::Set1(cellSize), sampleX, sampleY, sampleZ);
+            S::Store(x, sampleX);
+            S::Store(y, sampleY);
+            S::Store(z, sampleZ);
+            for (uint32_t i = 0; i < S::Width; ++i)
+                samples[8 * v + i] = float3{ x[i], y[i], z[i] };
+        }
+    }
+} //namespace ImplicitPointCPU
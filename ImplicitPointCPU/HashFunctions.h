@@ -0,0 +1,138 @@
+//CPU port of Shaders/HashFunctions.hlsli - results are bit-exact with the HLSL versions
+#pragma once
+#include "ShaderTypes.h"
+
+namespace ImplicitPointCPU
+{
+    //--------- SEED HASH FUNCTIONS ---------
+    //Source: https://gist.github.com/fboldog/a76648e1580b88ca9957f60b20edf49c
+    inline uint32_t wang_hash(uint32_t seed)
+    {
+        seed = (seed ^ 61) ^ (seed >> 16);
+        seed *= 9;
+        seed = seed ^ (seed >> 4);
+        seed *= 0x27d4eb2d;
+        seed = seed ^ (seed >> 15);
+        return seed;
+    }
+
+    //Based on http://jcgt.org/published/0009/03/02/
+    //Source: https://www.shadertoy.com/view/XlGcRh
+    inline uint32_t linearCombine(uint3 const& p)
+    {
+        return 19 * p.x + 47 * p.y + 101 * p.z + 131;
+    }
+
+    inline uint32_t xxhash32(uint3 const& p)
+    {
+        uint32_t const PRIME32_2 = 2246822519u, PRIME32_3 = 3266489917u;
+        uint32_t const PRIME32_4 = 668265263u, PRIME32_5 = 374761393u;
+        uint32_t h32 = p.z + PRIME32_5 + p.x * PRIME32_3;
+        h32 = PRIME32_4 * ((h32 << 17) | (h32 >> (32 - 17)));
+        h32 += p.y * PRIME32_3;
+        h32 = PRIME32_4 * ((h32 << 17) | (h32 >> (32 - 17)));
+        h32 = PRIME32_2 * (h32 ^ (h32 >> 15));
+        h32 = PRIME32_3 * (h32 ^ (h32 >> 13));
+        return h32 ^ (h32 >> 16);
+    }
+
+    inline uint32_t wang_hash_linear(uint3 const& p)
+    {
+        return wang_hash(linearCombine(p));
+    }
+
+    inline uint32_t wang_hash_nested(uint3 const& p)
+    {
+        return wang_hash(p.x + wang_hash(p.y + wang_hash(p.z)));
+    }
+
+    inline uint32_t pcg(uint32_t v)
+    {
+        uint32_t const state = v * 747796405u + 2891336453u;
+        uint32_t const word = ((state >> ((state >> 28) + 4)) ^ state) * 277803737u;
+        return (word >> 22) ^ word;
+    }
+
+    inline uint32_t pcg_nested(uint3 const& p)
+    {
+        return pcg(p.x + pcg(p.y + pcg(p.z)));
+    }
+
+    inline uint32_t xorshift32(uint32_t v)
+    {
+        v ^= v << 13;
+        v ^= v >> 17;
+        v ^= v << 5;
+        return v;
+    }
+
+    inline uint32_t xorshift32_linear(uint3 const& p)
+    {
+        return xorshift32(linearCombine(p));
+    }
+
+    //--------- SEED HASH POLICIES ---------
+    //Hash of the fixed point position that seeds the implicit points (GetSeed, GetSeedWithSignedBits). Picked per build: define
+    //IMPLICITPOINT_SEED_HASH as one of the policies for the whole project, pcg_nested like the shader when it is not defined.
+    //Other policies give other implicit points than the GPU demo. SIMD versions: SeedHashLanes in HashFunctionsSimd.h.
+    //LayoutID identifies the policy in world hash table snapshots, every key depends on it. pcg_nested is 0, the value of
+    //the field in snapshots written before it was stored.
+    struct PcgNestedHash
+    {
+        static uint32_t const LayoutID = 0;
+        static char const* GetName() { return "pcg_nested"; }
+        static uint32_t Hash(uint3 const& p) { return pcg_nested(p); }
+    };
+
+    struct WangNestedHash
+    {
+        static uint32_t const LayoutID = 1;
+        static char const* GetName() { return "wang_hash_nested"; }
+        static uint32_t Hash(uint3 const& p) { return wang_hash_nested(p); }
+    };
+
+    struct WangLinearHash
+    {
+        static uint32_t const LayoutID = 2;
+        static char const* GetName() { return "wang_hash_linear"; }
+        static uint32_t Hash(uint3 const& p) { return wang_hash_linear(p); }
+    };
+
+    struct XxHash32Hash
+    {
+        static uint32_t const LayoutID = 3;
+        static char const* GetName() { return "xxhash32"; }
+        static uint32_t Hash(uint3 const& p) { return xxhash32(p); }
+    };
+
+    struct XorShiftLinearHash
+    {
+        static uint32_t const LayoutID = 4;
+        static char const* GetName() { return "xorshift32_linear"; }
+        static uint32_t Hash(uint3 const& p) { return xorshift32_linear(p); }
+    };
+
+#if defined(IMPLICITPOINT_SEED_HASH)
+    typedef IMPLICITPOINT_SEED_HASH SeedHash;
+#else
+    typedef PcgNestedHash SeedHash;
+#endif
+
+    //--------- RANDOM SAMPLE FUNCTIONS ---------
+    //https://www.shadertoy.com/view/llGSzw
+    inline float3 hash3(uint32_t n)
+    {
+        //integer hash copied from Hugo Elias
+        n = (n << 13) ^ n;
+        n = n * (n * n * 15731u + 789221u) + 1376312589u;
+        uint3 const k = { n * n, n * (n * 16807u), n * (n * 48271u) };
+        uint3 const v = { k.x & 0x7fffffffu, k.y & 0x7fffffffu, k.z & 0x7fffffffu };
+        return ToFloat3(v) / float(0x7fffffff);
+    }
+
+    //Return random float [0,1] range
+    inline float randomNormalizedFloat(uint32_t seed)
+    {
+        return xorshift32(seed) * 2.3283064365387e-10f;
+    }
+} //namespace ImplicitPointCPU
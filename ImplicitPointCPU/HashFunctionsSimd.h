@@ -0,0 +1,144 @@
+//Lane-parallel versions of HashFunctions.h, written once against the SimdAVX2/SimdAVX512 interface, bit-exact with the
+//scalar ports. Only include this from the instruction set specific translation units.
+#pragma once
+#include "HashFunctions.h"
+
+namespace ImplicitPointCPU
+{
+    template<typename S>
+    struct HashLanes
+    {
+        typedef typename S::Int Int;
+        typedef typename S::Float Float;
+
+        static Int WangHash(Int seed)
+        {
+            seed = S::Xor(S::Xor(seed, S::Set1(61u)), S::template ShiftRight<16>(seed));
+            seed = S::Mul(seed, S::Set1(9u));
+            seed = S::Xor(seed, S::template ShiftRight<4>(seed));
+            seed = S::Mul(seed, S::Set1(0x27d4eb2du));
+            return S::Xor(seed, S::template ShiftRight<15>(seed));
+        }
+
+        static Int LinearCombine(Int x, Int y, Int z)
+        {
+            return S::Add(S::Add(S::Add(S::Mul(x, S::Set1(19u)), S::Mul(y, S::Set1(47u))), S::Mul(z, S::Set1(101u))), S::Set1(131u));
+        }
+
+        static Int RotateLeft17(Int h)
+        {
+            return S::Or(S::template ShiftLeft<17>(h), S::template ShiftRight<32 - 17>(h));
+        }
+
+        static Int XxHash32(Int x, Int y, Int z)
+        {
+            Int const prime2 = S::Set1(2246822519u), prime3 = S::Set1(3266489917u);
+            Int const prime4 = S::Set1(668265263u), prime5 = S::Set1(374761393u);
+            Int h32 = S::Add(S::Add(z, prime5), S::Mul(x, prime3));
+            h32 = S::Mul(prime4, RotateLeft17(h32));
+            h32 = S::Add(h32, S::Mul(y, prime3));
+            h32 = S::Mul(prime4, RotateLeft17(h32));
+            h32 = S::Mul(prime2, S::Xor(h32, S::template ShiftRight<15>(h32)));
+            h32 = S::Mul(prime3, S::Xor(h32, S::template ShiftRight<13>(h32)));
+            return S::Xor(h32, S::template ShiftRight<16>(h32));
+        }
+
+        static Int WangHashLinear(Int x, Int y, Int z)
+        {
+            return WangHash(LinearCombine(x, y, z));
+        }
+
+        static Int WangHashNested(Int x, Int y, Int z)
+        {
+            return WangHash(S::Add(x, WangHash(S::Add(y, WangHash(z)))));
+        }
+
+        static Int Pcg(Int v)
+        {
+            Int const state = S::Add(S::Mul(v, S::Set1(747796405u)), S::Set1(2891336453u));
+            Int const shift = S::Add(S::template ShiftRight<28>(state), S::Set1(4u));
+            Int const word = S::Mul(S::Xor(S::ShiftRightVariable(state, shift), state), S::Set1(277803737u));
+            return S::Xor(S::template ShiftRight<22>(word), word);
+        }
+
+        static Int PcgNested(Int x, Int y, Int z)
+        {
+            return Pcg(S::Add(x, Pcg(S::Add(y, Pcg(z)))));
+        }
+
+        static Int XorShift32(Int v)
+        {
+            v = S::Xor(v, S::template ShiftLeft<13>(v));
+            v = S::Xor(v, S::template ShiftRight<17>(v));
+            v = S::Xor(v, S::template ShiftLeft<5>(v));
+            return v;
+        }
+
+        static Int XorShift32Linear(Int x, Int y, Int z)
+        {
+            return XorShift32(LinearCombine(x, y, z));
+        }
+
+        //float(0x7fffffff) rounds to 2^31, so the division is a multiplication by 2^-31 with the same result
+        static void Hash3(Int n, Float& x, Float& y, Float& z)
+        {
+            n = S::Xor(S::template ShiftLeft<13>(n), n);
+            n = S::Add(S::Mul(n, S::Add(S::Mul(S::Mul(n, n), S::Set1(15731u)), S::Set1(789221u))), S::Set1(1376312589u));
+            Int const mask = S::Set1(0x7fffffffu);
+            Float const inverseScale = S::Set1(1.f / float(0x7fffffff));
+            x = S::Mul(S::IntToFloat(S::And(S::Mul(n, n), mask)), inverseScale);
+            y = S::Mul(S::IntToFloat(S::And(S::Mul(n, S::Mul(n, S::Set1(16807u))), mask)), inverseScale);
+            z = S::Mul(S::IntToFloat(S::And(S::Mul(n, S::Mul(n, S::Set1(48271u))), mask)), inverseScale);
+        }
+
+        //GenerateSampleInVoxelQuadrant(seed, level, quadrant) * cellSize + voxelPosition, one quadrant per lane
+        static void SampleInVoxelQuadrant(Int seed, Int quadrant, Float voxelX, Float voxelY, Float voxelZ, Float cellSize,
+            Float& x, Float& y, Float& z)
+        {
+            Float hashX, hashY, hashZ;
+            Hash3(S::Add(seed, quadrant), hashX, hashY, hashZ);
+            //The hash is in [0, 1], halving it by multiplication is exact as well
+            Float const cellDelta = S::Set1(0.5f);
+            Float const offsetX = S::IntToFloat(S::template ShiftRight<1>(S::And(quadrant, S::Set1(2u))));
+            Float const offsetY = S::IntToFloat(S::And(quadrant, S::Set1(1u)));
+            Float const offsetZ = S::IntToFloat(S::template ShiftRight<2>(S::And(quadrant, S::Set1(4u))));
+            x = S::Add(voxelX, S::Mul(S::Add(S::Mul(offsetX, cellDelta), S::Mul(hashX, cellDelta)), cellSize));
+            y = S::Add(voxelY, S::Mul(S::Add(S::Mul(offsetY, cellDelta), S::Mul(hashY, cellDelta)), cellSize));
+            z = S::Add(voxelZ, S::Mul(S::Add(S::Mul(offsetZ, cellDelta), S::Mul(hashZ, cellDelta)), cellSize));
+        }
+    };
+
+    //Seed hash policy (see SeedHash) on lanes of fixed point positions
+    template<typename S, typename Hash>
+    struct SeedHashLanes;
+
+    template<typename S>
+    struct SeedHashLanes<S, PcgNestedHash>
+    {
+        static typename S::Int Hash(typename S::Int x, typename S::Int y, typename S::Int z) { return HashLanes<S>::PcgNested(x, y, z); }
+    };
+
+    template<typename S>
+    struct SeedHashLanes<S, WangNestedHash>
+    {
+        static typename S::Int Hash(typename S::Int x, typename S::Int y, typename S::Int z) { return HashLanes<S>::WangHashNested(x, y, z); }
+    };
+
+    template<typename S>
+    struct SeedHashLanes<S, WangLinearHash>
+    {
+        static typename S::Int Hash(typename S::Int x, typename S::Int y, typename S::Int z) { return HashLanes<S>::WangHashLinear(x, y, z); }
+    };
+
+    template<typename S>
+    struct SeedHashLanes<S, XxHash32Hash>
+    {
+        static typename S::Int Hash(typename S::Int x, typename S::Int y, typename S::Int z) { return HashLanes<S>::XxHash32(x, y, z); }
+    };
+
+    template<typename S>
+    struct SeedHashLanes<S, XorShiftLinearHash>
+    {
+        static typename S::Int Hash(typename S::Int x, typename S::Int y, typename S::Int z) { return HashLanes<S>::XorShift32Linear(x, y, z); }
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,466 @@
+//CPU version of Shaders/HashTable.hlsli - open addressing, keys are claimed with a compare exchange, values accumulated atomically.
+//Inspired by: https://nosferalatu.com/SimpleGPUHashTable.html
+//Unlike the shader, slots are probed per cache line (group) and the probe length is bounded, so a full table fails fast
+//instead of walking CompareAttempts slots.
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct KeyData
+    {
+        uint32_t key;
+        uint32_t value;
+        uint32_t count;
+    };
+
+    //Same layout as the HashTableConstants cbuffer of the demo without the screen dimensions at its end, which are
+    //EngineSettings::screenWidth and screenHeight. Stored in the snapshot header (HashTableSnapshot.cpp).
+    struct HashTableConstants
+    {
+        uint32_t worldHashTableElementCount;
+        uint32_t accumulationHashTableElementCount;
+        uint32_t worldHashTableValueFractionalBits;
+        uint32_t worldHashTableCountFractionalBits;
+        uint32_t accumulationHashTableValueFractionalBits;
+    };
+
+    struct HashTableStatistics
+    {
+        uint32_t capacity = 0;
+        uint32_t occupied = 0;
+        float loadFactor = 0.f;
+        float averageProbeLength = 0.f;             //In groups, 0 = found in the home group
+        uint32_t maxProbeLength = 0;
+        uint64_t failedInserts = 0;                 //Inserts/increments dropped because the probe bound was reached
+        std::vector<uint32_t> probeLengthHistogram; //Occupied slots per probe length
+    };
+
+    //KeyData slot: key, value and count in the order of KeyData plus the frame the key was last written in,
+    //so 4 slots fill a cache line exactly
+    struct KeyDataSlot
+    {
+        static uint32_t const SlotsPerGroup = 4;
+        static uint32_t const LayoutID = 1; //Stored in snapshots, change when the layout changes
+        static bool const TracksLastTouched = true;
+
+        std::atomic<uint32_t> key;
+        std::atomic<uint32_t> value;
+        std::atomic<uint32_t> count;
+        std::atomic<uint32_t> lastTouched;
+
+        KeyData Load() const
+        {
+            return KeyData{ key.load(std::memory_order_relaxed), value.load(std::memory_order_relaxed), count.load(std::memory_order_relaxed) };
+        }
+
+        void Store(uint32_t newValue, uint32_t newCount)
+        {
+            value.store(newValue, std::memory_order_relaxed);
+            count.store(newCount, std::memory_order_relaxed);
+        }
+
+        //HashTableIncrement: add the value, count one more sample (or addedCount pre-summed ones)
+        void Accumulate(uint32_t addedValue, uint32_t addedCount = 1)
+        {
+            value.fetch_add(addedValue, std::memory_order_relaxed);
+            count.fetch_add(addedCount, std::memory_order_relaxed);
+        }
+
+        //Only written when it changes, most keys are touched many times per frame
+        void Touch(uint32_t frame)
+        {
+            if (lastTouched.load(std::memory_order_relaxed) != frame)
+                lastTouched.store(frame, std::memory_order_relaxed);
+        }
+
+        uint32_t GetLastTouched() const
+        {
+            return lastTouched.load(std::memory_order_relaxed);
+        }
+
+        void Clear()
+        {
+            key.store(0, std::memory_order_relaxed);
+            value.store(0, std::memory_order_relaxed);
+            count.store(0, std::memory_order_relaxed);
+            lastTouched.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    //Compact world table slot: the key plus value and count packed in one word, 8 slots per cache line. Both are stored as
+    //small floats of their fixed point word (exponent + mantissa, so the count is log encoded): the value keeps a relative
+    //precision of 2^-14, the count 2^-10. Load hands out the decoded fixed point words, so callers see the same KeyData as
+    //with KeyDataSlot. There is no room for the frame, tables of this slot don't age (see ResizableHashTable::Sweep) and
+    //the slot can't be incremented, only stored.
+    struct CompactKeyDataSlot
+    {
+        static uint32_t const SlotsPerGroup = 8;
+        static uint32_t const LayoutID = 2;
+        static bool const TracksLastTouched = false;
+
+        static uint32_t const ValueMantissaBits = 13;
+        static uint32_t const ValueBits = 18;           //5 bit exponent
+        static uint32_t const CountMantissaBits = 9;    //Remaining 14 bits: 5 bit exponent
+
+        std::atomic<uint32_t> key;
+        std::atomic<uint32_t> packed; //count << ValueBits | value
+
+        //Exponent 0 stores small words exactly, above that the mantissa has an implicit leading one. Rounds to nearest.
+        static uint32_t Encode(uint32_t word, uint32_t mantissaBits)
+        {
+            if (word < (1u << mantissaBits))
+                return word;
+
+            uint64_t rounded = word;
+            uint32_t shift = HighestSetBit(rounded) - mantissaBits;
+            if (shift > 0)
+            {
+                rounded += uint64_t(1) << (shift - 1);
+                shift = HighestSetBit(rounded) - mantissaBits;
+            }
+            uint32_t const mantissa = uint32_t(rounded >> shift) & ((1u << mantissaBits) - 1);
+            return ((shift + 1) << mantissaBits) | mantissa;
+        }
+
+        static uint32_t Decode(uint32_t code, uint32_t mantissaBits)
+        {
+            uint32_t const exponent = code >> mantissaBits;
+            uint32_t const mantissa = code & ((1u << mantissaBits) - 1);
+            if (exponent == 0)
+                return mantissa;
+            uint64_t const word = uint64_t((1u << mantissaBits) | mantissa) << (exponent - 1);
+            return word > 0xFFFFFFFFu ? 0xFFFFFFFFu : uint32_t(word);
+        }
+
+        static uint32_t Pack(uint32_t value, uint32_t count)
+        {
+            return (Encode(count, CountMantissaBits) << ValueBits) | Encode(value, ValueMantissaBits);
+        }
+
+        KeyData Load() const
+        {
+            uint32_t const word = packed.load(std::memory_order_relaxed);
+            return KeyData{ key.load(std::memory_order_relaxed), Decode(word & ((1u << ValueBits) - 1), ValueMantissaBits),
+                Decode(word >> ValueBits, CountMantissaBits) };
+        }
+
+        //Value and count change together, a reader never sees half an update
+        void Store(uint32_t newValue, uint32_t newCount)
+        {
+            packed.store(Pack(newValue, newCount), std::memory_order_relaxed);
+        }
+
+        void Touch(uint32_t /*frame*/) {}
+        uint32_t GetLastTouched() const { return 0; }
+
+        void Clear()
+        {
+            key.store(0, std::memory_order_relaxed);
+            packed.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        static uint32_t HighestSetBit(uint64_t word)
+        {
+            uint32_t bit = 0;
+            for (uint32_t step = 32; step > 0; step /= 2)
+            {
+                if (word >> step)
+                {
+                    word >>= step;
+                    bit += step;
+                }
+            }
+            return bit;
+        }
+    };
+
+    //Home group of a key, the group its probe sequence starts at. key % groupCount, like the shader: keys that are random in
+    //all bits spread evenly, neighbouring keys land in unrelated groups.
+    struct ModuloHomeGroup
+    {
+        static uint32_t const LayoutID = 0; //Stored in snapshots, 0 in the ones written before there was a choice
+
+        static uint32_t Get(uint32_t key, uint32_t groupCount) { return key % groupCount; }
+    };
+
+    //Keeps the order of the keys: the table is cut in as many ranges as there are values of the top bits, keys that share
+    //their top bits land in neighbouring groups whatever the capacity is. Meant for spatial seeds (see
+    //GetSpatialSeedWithSignedBits), which put a hash of the bucket they are in in the top bits.
+    struct RangeHomeGroup
+    {
+        static uint32_t const LayoutID = 1;
+
+        static uint32_t Get(uint32_t key, uint32_t groupCount) { return uint32_t((uint64_t(key) * groupCount) >> 32); }
+    };
+
+    //Lock-free insert/increment/lookup for any number of threads. Key 0 marks an empty slot, like on the GPU.
+    //A Slot that is all zero bytes must be an empty slot.
+    //The home group of a key comes from HomeGroup. A group is filled front to back, so a lookup can stop at the first empty slot.
+    template<typename Slot, uint32_t MaxProbeGroups = 64, typename HomeGroup = ModuloHomeGroup>
+    class ConcurrentHashTable
+    {
+    public:
+        typedef Slot SlotType;
+        typedef HomeGroup HomeGroupType;
+        static uint32_t const SlotsPerGroup = Slot::SlotsPerGroup;
+        static uint32_t const MaxProbeGroupCount = MaxProbeGroups;
+        static uint32_t const CacheLineSize = 64;
+
+        //Capacity is rounded up to a multiple of SlotsPerGroup
+        explicit ConcurrentHashTable(uint32_t capacity)
+            : m_GroupCount((capacity + SlotsPerGroup - 1) / SlotsPerGroup)
+            , m_Size(0)
+            , m_FailedInserts(0)
+        {
+            if (m_GroupCount == 0)
+                m_GroupCount = 1;
+
+            //Groups start on a cache line boundary, C++14 new does not guarantee that for over-aligned types.
+            //calloc hands out zeroed (empty) slots, for large tables the OS zeroes the pages on first touch,
+            //so creating a table costs no time up front.
+            m_pStorage.reset(static_cast<uint8_t*>(std::calloc(sizeof(Group) * m_GroupCount + CacheLineSize, 1)));
+            if (!m_pStorage)
+                throw std::bad_alloc();
+            uintptr_t const address = reinterpret_cast<uintptr_t>(m_pStorage.get());
+            m_pGroups = reinterpret_cast<Group*>((address + CacheLineSize - 1) & ~uintptr_t(CacheLineSize - 1));
+            for (uint32_t g = 0; g < m_GroupCount; ++g)
+                new (&m_pGroups[g]) Group;
+        }
+
+        //View on slots in memory owned by somebody else, laid out like GetSlotData of a table with the same Slot type,
+        //for example a mapped snapshot. Nothing is copied or freed, pSlotData must be cache line aligned.
+        ConcurrentHashTable(void* pSlotData, uint32_t capacity, uint32_t size)
+            : m_pGroups(static_cast<Group*>(pSlotData))
+            , m_GroupCount(capacity / SlotsPerGroup)
+            , m_Size(size)
+            , m_FailedInserts(0)
+        {
+            if (capacity == 0 || capacity % SlotsPerGroup != 0 || reinterpret_cast<uintptr_t>(pSlotData) % CacheLineSize != 0)
+                throw std::invalid_argument("ConcurrentHashTable: external slot data must be cache line aligned whole groups");
+        }
+
+        ConcurrentHashTable(ConcurrentHashTable const&) = delete;
+        ConcurrentHashTable& operator=(ConcurrentHashTable const&) = delete;
+
+        uint32_t GetCapacity() const { return m_GroupCount * SlotsPerGroup; }
+        uint32_t GetSize() const { return m_Size.load(std::memory_order_relaxed); }
+        //GetCapacity() slots, raw bytes are only meaningful while no other thread writes
+        void const* GetSlotData() const { return m_pGroups; }
+
+        //Frame stamped on every slot that is written, see EraseSlot and ResizableHashTable for the aging
+        void SetFrame(uint32_t frame) { m_Frame = frame; }
+        uint32_t GetFrame() const { return m_Frame; }
+        uint64_t GetFailedInsertCount() const { return m_FailedInserts.load(std::memory_order_relaxed); }
+        //Group the probe sequence of key starts at
+        uint32_t GetHomeGroup(uint32_t key) const { return HomeGroup::Get(key, m_GroupCount); }
+
+        //HashTableInsert: key = hashed 3D point for example. Returns false when the probe bound was reached.
+        bool Insert(uint32_t key, uint32_t value, uint32_t count)
+        {
+            bool claimed = false;
+            Slot* const pSlot = FindOrClaim(key, claimed);
+            if (pSlot == nullptr)
+                return false;
+            pSlot->Store(value, count);
+            pSlot->Touch(m_Frame);
+            return true;
+        }
+
+        //Only stores value and count when the key was not in the table yet, used to migrate entries between tables
+        bool InsertIfAbsent(uint32_t key, uint32_t value, uint32_t count, uint32_t lastTouched)
+        {
+            bool claimed = false;
+            Slot* const pSlot = FindOrClaim(key, claimed);
+            if (pSlot == nullptr || !claimed)
+                return false;
+            pSlot->Store(value, count);
+            pSlot->Touch(lastTouched);
+            return true;
+        }
+
+        //HashTableIncrement, count > 1 adds that many samples that were summed up front in value.
+        //Returns false when the probe bound was reached.
+        bool Increment(uint32_t key, uint32_t value, uint32_t count = 1)
+        {
+            bool claimed = false;
+            Slot* const pSlot = FindOrClaim(key, claimed);
+            if (pSlot == nullptr)
+                return false;
+            pSlot->Accumulate(value, count);
+            pSlot->Touch(m_Frame);
+            return true;
+        }
+
+        KeyData Lookup(uint32_t key) const
+        {
+            uint32_t group = GetHomeGroup(key);
+            uint32_t const probeGroups = GetProbeGroupCount();
+            for (uint32_t p = 0; p < probeGroups; ++p)
+            {
+                Slot const* const slots = m_pGroups[group].slots;
+                for (uint32_t s = 0; s < SlotsPerGroup; ++s)
+                {
+                    uint32_t const slotKey = slots[s].key.load(std::memory_order_relaxed);
+                    if (slotKey == key)
+                        return slots[s].Load();
+                    if (slotKey == 0)
+                        return KeyData{ 0, 0, 0 };
+                }
+                group = NextGroup(group);
+            }
+            return KeyData{ 0, 0, 0 };
+        }
+
+        KeyData LookupBySlotID(uint32_t slotID) const
+        {
+            if (slotID < GetCapacity())
+                return GetSlot(slotID).Load();
+            return KeyData{ 0, 0, 0 };
+        }
+
+        uint32_t GetLastTouchedBySlotID(uint32_t slotID) const
+        {
+            return slotID < GetCapacity() ? GetSlot(slotID).GetLastTouched() : 0;
+        }
+
+        //Not safe to run concurrently with Insert/Increment, like the ClearBuffersPass
+        void ClearSlot(uint32_t slotID)
+        {
+            Slot& slot = GetSlot(slotID);
+            if (slot.key.load(std::memory_order_relaxed) != 0)
+                m_Size.fetch_sub(1, std::memory_order_relaxed);
+            slot.Clear();
+        }
+
+        //Removes the key in slotID with backward shift deletion: the entries after the hole that are allowed to live there
+        //move back, so probe sequences stay unbroken without tombstones. Slots are probed as one linear sequence that
+        //starts at the first slot of the home group, that is the order FindOrClaim fills them in.
+        //Returns the slot that is empty afterwards. Not safe to run concurrently with any other access.
+        uint32_t EraseSlot(uint32_t slotID)
+        {
+            uint32_t const capacity = GetCapacity();
+            if (slotID >= capacity || GetSlot(slotID).key.load(std::memory_order_relaxed) == 0)
+                return slotID;
+
+            uint32_t hole = slotID;
+            uint32_t next = slotID;
+            for (uint32_t step = 1; step < capacity; ++step)
+            {
+                next = (next + 1 == capacity) ? 0 : next + 1;
+                Slot& candidate = GetSlot(next);
+                uint32_t const key = candidate.key.load(std::memory_order_relaxed);
+                if (key == 0)
+                    break;
+
+                //The candidate can fill the hole when the hole lies between its home slot and its current slot
+                uint32_t const homeSlot = GetHomeGroup(key) * SlotsPerGroup;
+                uint32_t const distanceFromHome = (next + capacity - homeSlot) % capacity;
+                uint32_t const distanceFromHole = (next + capacity - hole) % capacity;
+                if (distanceFromHome < distanceFromHole)
+                    continue;
+
+                Slot& target = GetSlot(hole);
+                KeyData const data = candidate.Load();
+                target.key.store(key, std::memory_order_relaxed);
+                target.Store(data.value, data.count);
+                target.Touch(candidate.GetLastTouched());
+                hole = next;
+            }
+
+            GetSlot(hole).Clear();
+            m_Size.fetch_sub(1, std::memory_order_relaxed);
+            return hole;
+        }
+
+        //Scans the whole table, don't call while other threads are writing if exact numbers are needed
+        HashTableStatistics ComputeStatistics() const
+        {
+            HashTableStatistics statistics;
+            statistics.capacity = GetCapacity();
+            statistics.failedInserts = GetFailedInsertCount();
+            statistics.probeLengthHistogram.assign(MaxProbeGroups, 0);
+
+            uint64_t probeLengthSum = 0;
+            for (uint32_t g = 0; g < m_GroupCount; ++g)
+            {
+                for (uint32_t s = 0; s < SlotsPerGroup; ++s)
+                {
+                    uint32_t const key = m_pGroups[g].slots[s].key.load(std::memory_order_relaxed);
+                    if (key == 0)
+                        continue;
+                    uint32_t const homeGroup = GetHomeGroup(key);
+                    uint32_t const probeLength = (g >= homeGroup) ? (g - homeGroup) : (g + m_GroupCount - homeGroup);
+                    ++statistics.occupied;
+                    ++statistics.probeLengthHistogram[probeLength < MaxProbeGroups ? probeLength : MaxProbeGroups - 1];
+                    probeLengthSum += probeLength;
+                    statistics.maxProbeLength = probeLength > statistics.maxProbeLength ? probeLength : statistics.maxProbeLength;
+                }
+            }
+
+            statistics.loadFactor = float(statistics.occupied) / float(statistics.capacity);
+            statistics.averageProbeLength = statistics.occupied > 0 ? float(double(probeLengthSum) / statistics.occupied) : 0.f;
+            return statistics;
+        }
+
+    private:
+        struct Group
+        {
+            Slot slots[SlotsPerGroup];
+        };
+        static_assert(sizeof(Group) == CacheLineSize, "A probe group must fill exactly one cache line");
+
+        struct FreeDeleter
+        {
+            void operator()(uint8_t* pStorage) const { std::free(pStorage); }
+        };
+
+        std::unique_ptr<uint8_t, FreeDeleter> m_pStorage;
+        Group* m_pGroups = nullptr;
+        uint32_t m_GroupCount;
+        std::atomic<uint32_t> m_Size;
+        uint32_t m_Frame = 0;
+        std::atomic<uint64_t> m_FailedInserts;
+
+        uint32_t GetProbeGroupCount() const { return m_GroupCount < MaxProbeGroups ? m_GroupCount : MaxProbeGroups; }
+        uint32_t NextGroup(uint32_t group) const { return (group + 1 == m_GroupCount) ? 0 : group + 1; }
+        Slot& GetSlot(uint32_t slotID) const { return m_pGroups[slotID / SlotsPerGroup].slots[slotID % SlotsPerGroup]; }
+
+        //Slot that holds key, claiming the first empty slot of the probe sequence if the key is not in the table yet
+        Slot* FindOrClaim(uint32_t key, bool& claimed)
+        {
+            uint32_t group = GetHomeGroup(key);
+            uint32_t const probeGroups = GetProbeGroupCount();
+            for (uint32_t p = 0; p < probeGroups; ++p)
+            {
+                Slot* const slots = m_pGroups[group].slots;
+                for (uint32_t s = 0; s < SlotsPerGroup; ++s)
+                {
+                    //Plain load first, only slots that look empty are worth a compare exchange
+                    uint32_t previousValue = slots[s].key.load(std::memory_order_relaxed);
+                    if (previousValue == 0 && slots[s].key.compare_exchange_strong(previousValue, key, std::memory_order_relaxed))
+                    {
+                        m_Size.fetch_add(1, std::memory_order_relaxed);
+                        claimed = true;
+                        return &slots[s];
+                    }
+                    if (previousValue == key)
+                        return &slots[s];
+                }
+                group = NextGroup(group);
+            }
+
+            m_FailedInserts.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    };
+
+    typedef ConcurrentHashTable<KeyDataSlot> HashTable;
+} //namespace ImplicitPointCPU
@@ -0,0 +1,240 @@
+#include "HashTableSnapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        uint32_t const SnapshotFileMagic = 0x53485049; //"IPHS"
+        uint32_t const SnapshotFileVersion = 1;
+
+        typedef WorldHashTable::Table SnapshotTable;
+        typedef SnapshotTable::SlotType SnapshotSlot;
+        typedef SnapshotTable::HomeGroupType SnapshotHomeGroup;
+
+        //Padded to a cache line, so the slots behind it stay aligned in the mapping
+        struct SnapshotFileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t slotLayout;    //Slot::LayoutID
+            uint32_t slotSize;
+            uint32_t capacity;      //Slots in the file
+            uint32_t size;          //Occupied slots
+            uint32_t frame;         //Frame the slots were stamped up to
+            HashTableConstants hashTableConstants;
+            uint32_t cellSize;
+            uint32_t maxLevels;
+            uint32_t homeGroupLayout; //HomeGroup::LayoutID, the seeds of the keys depend on it as well
+            uint32_t seedHashLayout;  //SeedHash::LayoutID
+        };
+        static_assert(sizeof(SnapshotFileHeader) == SnapshotTable::CacheLineSize, "The snapshot header must fill exactly one cache line");
+
+        bool WriteSnapshotFile(char const* filename, std::vector<uint8_t> const& data)
+        {
+            FILE* file = std::fopen(filename, "wb");
+            if (file == nullptr)
+                return false;
+
+            bool ok = false;
+
+            if (data.size() != std::fwrite(data.data(), 1, data.size(), file)) goto snapshot_save_fail;
+
+            ok = true;
+
+        snapshot_save_fail:
+
+            if (EOF == std::fclose(file))
+                ok = false;
+
+            return ok;
+        }
+
+        //Header and slots in one buffer, empty when the table is migrating and has no single slot array to copy
+        std::vector<uint8_t> CreateSnapshotData(WorldHashTable const& table, SnapshotSettings const& settings)
+        {
+            std::vector<uint8_t> data;
+            if (table.IsMigrating())
+                return data;
+
+            SnapshotTable const& slots = table.GetTable();
+            size_t const slotBytes = size_t(slots.GetCapacity()) * sizeof(SnapshotSlot);
+            SnapshotFileHeader header = {};
+            header.magic = SnapshotFileMagic;
+            header.version = SnapshotFileVersion;
+            header.slotLayout = SnapshotSlot::LayoutID;
+            header.homeGroupLayout = SnapshotHomeGroup::LayoutID;
+            header.slotSize = sizeof(SnapshotSlot);
+            header.capacity = slots.GetCapacity();
+            header.size = slots.GetSize();
+            header.frame = table.GetFrame();
+            header.hashTableConstants = settings.hashTableConstants;
+            header.cellSize = settings.cellSize;
+            header.maxLevels = settings.maxLevels;
+            header.seedHashLayout = settings.seedHashLayout;
+
+            data.resize(sizeof(SnapshotFileHeader) + slotBytes);
+            std::memcpy(data.data(), &header, sizeof(SnapshotFileHeader));
+            std::memcpy(data.data() + sizeof(SnapshotFileHeader), slots.GetSlotData(), slotBytes);
+            return data;
+        }
+
+        //key << 32 | slotID of every occupied slot, ascending by key
+        std::vector<uint64_t> GetSortedKeys(SnapshotTable const& table)
+        {
+            std::vector<uint64_t> keys;
+            keys.reserve(table.GetSize());
+            for (uint32_t slotID = 0; slotID < table.GetCapacity(); ++slotID)
+            {
+                uint32_t const key = table.LookupBySlotID(slotID).key;
+                if (key != 0)
+                    keys.push_back((uint64_t(key) << 32) | slotID);
+            }
+            std::sort(keys.begin(), keys.end());
+            return keys;
+        }
+    }
+
+    std::future<bool> SaveSnapshotAsync(std::string const& filename, WorldHashTable const& table, SnapshotSettings const& settings)
+    {
+        std::shared_ptr<std::vector<uint8_t>> pData = std::make_shared<std::vector<uint8_t>>(CreateSnapshotData(table, settings));
+        if (pData->empty())
+        {
+            std::promise<bool> failed;
+            failed.set_value(false);
+            return failed.get_future();
+        }
+
+        return std::async(std::launch::async, [filename, pData]()
+        {
+            return WriteSnapshotFile(filename.c_str(), *pData);
+        });
+    }
+
+    bool SaveSnapshot(char const* filename, WorldHashTable const& table, SnapshotSettings const& settings)
+    {
+        std::vector<uint8_t> const data = CreateSnapshotData(table, settings);
+        return !data.empty() && WriteSnapshotFile(filename, data);
+    }
+
+    bool HashTableSnapshot::Open(char const* filename)
+    {
+        m_pTable.reset();
+        if (!m_File.Open(filename))
+            return false;
+
+        SnapshotFileHeader header = {};
+        if (m_File.GetSize() < sizeof(SnapshotFileHeader))
+        {
+            m_File.Close();
+            return false;
+        }
+        std::memcpy(&header, m_File.GetData(), sizeof(SnapshotFileHeader));
+
+        bool const valid = header.magic == SnapshotFileMagic && header.version == SnapshotFileVersion
+            && header.slotLayout == SnapshotSlot::LayoutID && header.slotSize == sizeof(SnapshotSlot) && header.homeGroupLayout == SnapshotHomeGroup::LayoutID
+            && header.seedHashLayout == SeedHash::LayoutID
+            && header.capacity != 0 && header.capacity % SnapshotTable::SlotsPerGroup == 0 && header.size <= header.capacity
+            && m_File.GetSize() == sizeof(SnapshotFileHeader) + uint64_t(header.capacity) * header.slotSize;
+        if (!valid)
+        {
+            m_File.Close();
+            return false;
+        }
+
+        m_Settings.hashTableConstants = header.hashTableConstants;
+        m_Settings.cellSize = header.cellSize;
+        m_Settings.maxLevels = header.maxLevels;
+        m_Settings.seedHashLayout = header.seedHashLayout;
+        m_Frame = header.frame;
+        m_pTable.reset(new SnapshotTable(static_cast<uint8_t*>(m_File.GetData()) + sizeof(SnapshotFileHeader), header.capacity, header.size));
+        return true;
+    }
+
+    //The element counts only size the tables, they don't change keys or values
+    bool HashTableSnapshot::IsCompatible(SnapshotSettings const& settings) const
+    {
+        HashTableConstants const& a = m_Settings.hashTableConstants;
+        HashTableConstants const& b = settings.hashTableConstants;
+        return m_Settings.cellSize == settings.cellSize && m_Settings.maxLevels == settings.maxLevels && m_Settings.seedHashLayout == settings.seedHashLayout
+            && a.worldHashTableValueFractionalBits == b.worldHashTableValueFractionalBits
+            && a.worldHashTableCountFractionalBits == b.worldHashTableCountFractionalBits
+            && a.accumulationHashTableValueFractionalBits == b.accumulationHashTableValueFractionalBits;
+    }
+
+    std::unique_ptr<WorldHashTable::Table> HashTableSnapshot::CreateTableView() const
+    {
+        if (!m_pTable)
+            return nullptr;
+        return std::unique_ptr<SnapshotTable>(new SnapshotTable(const_cast<void*>(m_pTable->GetSlotData()), m_pTable->GetCapacity(), m_pTable->GetSize()));
+    }
+
+    SnapshotComparison CompareSnapshots(HashTableSnapshot const& a, HashTableSnapshot const& b)
+    {
+        SnapshotTable const& tableA = a.GetTable();
+        SnapshotTable const& tableB = b.GetTable();
+        SnapshotComparison comparison;
+
+        std::vector<uint64_t> const keysA = GetSortedKeys(tableA);
+        std::vector<uint64_t> const keysB = GetSortedKeys(tableB);
+        size_t indexA = 0;
+        size_t indexB = 0;
+        while (indexA < keysA.size() || indexB < keysB.size())
+        {
+            uint64_t const keyA = indexA < keysA.size() ? (keysA[indexA] >> 32) : UINT64_MAX;
+            uint64_t const keyB = indexB < keysB.size() ? (keysB[indexB] >> 32) : UINT64_MAX;
+            uint32_t const key = uint32_t(std::min(keyA, keyB));
+
+            KeyData dataA = {};
+            KeyData dataB = {};
+            uint32_t lastTouchedA = 0;
+            uint32_t lastTouchedB = 0;
+            if (keyA == key)
+            {
+                uint32_t const slotID = uint32_t(keysA[indexA++]);
+                dataA = tableA.LookupBySlotID(slotID);
+                lastTouchedA = tableA.GetLastTouchedBySlotID(slotID);
+            }
+            if (keyB == key)
+            {
+                uint32_t const slotID = uint32_t(keysB[indexB++]);
+                dataB = tableB.LookupBySlotID(slotID);
+                lastTouchedB = tableB.GetLastTouchedBySlotID(slotID);
+            }
+
+            if (dataA.key == dataB.key && dataA.value == dataB.value && dataA.count == dataB.count && lastTouchedA == lastTouchedB)
+                continue;
+            if (comparison.differingKeyCount++ == 0)
+            {
+                comparison.firstDifferingKey = key;
+                comparison.firstA = dataA;
+                comparison.firstB = dataB;
+                comparison.firstLastTouchedA = lastTouchedA;
+                comparison.firstLastTouchedB = lastTouchedB;
+            }
+        }
+
+        SnapshotSettings const& settingsA = a.GetSettings();
+        SnapshotSettings const& settingsB = b.GetSettings();
+        comparison.sameEntries = comparison.differingKeyCount == 0;
+        comparison.identical = comparison.sameEntries && a.GetFrame() == b.GetFrame()
+            && std::memcmp(&settingsA, &settingsB, sizeof(SnapshotSettings)) == 0
+            && tableA.GetCapacity() == tableB.GetCapacity()
+            && std::memcmp(tableA.GetSlotData(), tableB.GetSlotData(), size_t(tableA.GetCapacity()) * sizeof(SnapshotSlot)) == 0;
+        return comparison;
+    }
+
+    bool WarmStartFromSnapshot(char const* filename, WorldHashTable& table, SnapshotSettings const& settings)
+    {
+        std::shared_ptr<HashTableSnapshot> pSnapshot = std::make_shared<HashTableSnapshot>();
+        if (!pSnapshot->Open(filename) || !pSnapshot->IsCompatible(settings))
+            return false;
+
+        std::unique_ptr<WorldHashTable::Table> pView = pSnapshot->CreateTableView();
+        uint32_t const frame = pSnapshot->GetFrame();
+        return table.WarmStart(std::move(pView), frame, std::move(pSnapshot));
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,72 @@
+//Versioned binary snapshot of the world hash table (.iph): a 64 byte header with the settings the seeds and fixed point
+//values were generated with, followed by the slots exactly as they are laid out in memory. Loading maps the file and
+//uses the slots in place, so a baked cache can be looked up before a single byte of it was copied.
+#pragma once
+#include "ResizableHashTable.h"
+#include "HashFunctions.h"
+#include "MappedFile.h"
+#include <future>
+#include <memory>
+#include <string>
+
+namespace ImplicitPointCPU
+{
+    //Everything the keys and values of the table depend on, a snapshot is only usable with the same settings
+    struct SnapshotSettings
+    {
+        HashTableConstants hashTableConstants;
+        uint32_t cellSize;
+        uint32_t maxLevels;
+        uint32_t seedHashLayout = SeedHash::LayoutID; //Seed hash policy the keys were made with
+    };
+
+    //Copies the slots of the table, so the caller can keep rendering while the file is written on a background thread.
+    //Call between frames. A running migration has to be finished first (FinishMigration), the result is false otherwise.
+    std::future<bool> SaveSnapshotAsync(std::string const& filename, WorldHashTable const& table, SnapshotSettings const& settings);
+    bool SaveSnapshot(char const* filename, WorldHashTable const& table, SnapshotSettings const& settings);
+
+    class HashTableSnapshot
+    {
+    public:
+        //Maps the file and validates the header against the slot layouts and seed hash policy of this build, none of the
+        //slots are read
+        bool Open(char const* filename);
+
+        SnapshotSettings const& GetSettings() const { return m_Settings; }
+        bool IsCompatible(SnapshotSettings const& settings) const;
+        uint32_t GetFrame() const { return m_Frame; }
+        uint64_t GetFileSize() const { return m_File.GetSize(); }
+
+        //Zero-copy lookups straight on the mapped slots, only valid after a successful Open
+        WorldHashTable::Table const& GetTable() const { return *m_pTable; }
+        //Another view on the mapped slots, for WorldHashTable::WarmStart
+        std::unique_ptr<WorldHashTable::Table> CreateTableView() const;
+
+    private:
+        MappedFile m_File;
+        SnapshotSettings m_Settings = {};
+        uint32_t m_Frame = 0;
+        std::unique_ptr<WorldHashTable::Table> m_pTable;
+    };
+
+    //Result of CompareSnapshots. Entries are matched by key, so tables with the same entries in another slot layout have
+    //the same entries without being identical.
+    struct SnapshotComparison
+    {
+        bool identical = false;             //Same frame, settings and slot bytes
+        bool sameEntries = false;           //Same keys with the same value, count and last touched frame
+        uint64_t differingKeyCount = 0;     //Keys missing in one of the snapshots or with other data
+        uint32_t firstDifferingKey = 0;     //Lowest differing key, only valid when differingKeyCount > 0
+        KeyData firstA = {};                //Its entry in a and b, key 0 when the snapshot doesn't have it
+        KeyData firstB = {};
+        uint32_t firstLastTouchedA = 0;
+        uint32_t firstLastTouchedB = 0;
+    };
+
+    //Both snapshots have to be open
+    SnapshotComparison CompareSnapshots(HashTableSnapshot const& a, HashTableSnapshot const& b);
+
+    //Maps the snapshot and hands it to the (empty) table as warm start. False when the file is missing or invalid, was
+    //saved with other settings, or the table already holds entries.
+    bool WarmStartFromSnapshot(char const* filename, WorldHashTable& table, SnapshotSettings const& settings);
+} //namespace ImplicitPointCPU
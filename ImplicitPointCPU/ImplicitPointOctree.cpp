@@ -0,0 +1,230 @@
+#include "ImplicitPointOctree.h"
+#include <stdexcept>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        //Spreads the lower 21 bits of value to every third bit
+        uint64_t SpreadBits(uint64_t value)
+        {
+            value &= 0x1FFFFFull;
+            value = (value | (value << 32)) & 0x1F00000000FFFFull;
+            value = (value | (value << 16)) & 0x1F0000FF0000FFull;
+            value = (value | (value << 8)) & 0x100F00F00F00F00Full;
+            value = (value | (value << 4)) & 0x10C30C30C30C30C3ull;
+            value = (value | (value << 2)) & 0x1249249249249249ull;
+            return value;
+        }
+    }
+
+    ImplicitPointOctree::ImplicitPointOctree(uint32_t capacity, uint32_t discreteCellSize, uint32_t maxLevels)
+        : m_DiscreteCellSize(discreteCellSize)
+        , m_MaxLevels(maxLevels)
+        , m_Size(0)
+        , m_FailedInserts(0)
+    {
+        if (maxLevels > MaxLevel)
+            throw std::invalid_argument("ImplicitPointOctree: maxLevels doesn't fit the locational code");
+
+        uint32_t capacityBits = 10;
+        while ((1u << capacityBits) < capacity && capacityBits < 31)
+            ++capacityBits;
+        m_Mask = (1u << capacityBits) - 1;
+        m_Shift = 64 - capacityBits;
+        m_pNodes.reset(new OctreeNode[size_t(m_Mask) + 1]);
+        Clear();
+    }
+
+    void ImplicitPointOctree::Clear()
+    {
+        for (uint32_t i = 0; i <= m_Mask; ++i)
+        {
+            m_pNodes[i].key.store(0, std::memory_order_relaxed);
+            m_pNodes[i].seed.store(0, std::memory_order_relaxed);
+            m_pNodes[i].masks.store(0, std::memory_order_relaxed);
+        }
+        m_Size.store(0, std::memory_order_relaxed);
+        m_FailedInserts.store(0, std::memory_order_relaxed);
+        m_CompletedFailedInserts = 0;
+        m_Incomplete = false;
+    }
+
+    void ImplicitPointOctree::Rebuild(std::vector<PrunedVoxel> const& voxels)
+    {
+        uint64_t const failedInserts = GetFailedInsertCount();
+        uint64_t const completedFailedInserts = m_CompletedFailedInserts;
+        bool const incomplete = m_Incomplete;
+        Clear();
+
+        for (PrunedVoxel const& voxel : voxels)
+        {
+            //The leading 1 bit of the key is bit 3 * (RootCoordinateBits + level)
+            uint32_t level = 0;
+            while ((voxel.key >> (3 * (RootCoordinateBits + level + 1))) != 0)
+                ++level;
+
+            OctreeNode* const pNode = FindOrClaimNode(voxel.key);
+            if (pNode == nullptr)
+            {
+                m_FailedInserts.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            pNode->seed.store(voxel.seed, std::memory_order_relaxed);
+            pNode->masks.fetch_or(voxel.pointMask, std::memory_order_release);
+            LinkParents(voxel.key, level);
+        }
+
+        //The points of the nodes that didn't fit are lost like the ones of a failed insert
+        m_FailedInserts.fetch_add(failedInserts, std::memory_order_relaxed);
+        m_CompletedFailedInserts = completedFailedInserts;
+        m_Incomplete = incomplete;
+    }
+
+    uint64_t ImplicitPointOctree::GetKey(int3 const& coordinates, uint32_t level) const
+    {
+        //Centered on the origin, so the coordinates of a level are the ones of the level above * 2 + the octant
+        uint32_t const bits = RootCoordinateBits + level;
+        int64_t const bias = int64_t(1) << (bits - 1);
+        int64_t const x = int64_t(coordinates.x) + bias;
+        int64_t const y = int64_t(coordinates.y) + bias;
+        int64_t const z = int64_t(coordinates.z) + bias;
+        int64_t const limit = int64_t(1) << bits;
+        if (x < 0 || y < 0 || z < 0 || x >= limit || y >= limit || z >= limit)
+            return 0;
+
+        return (uint64_t(1) << (3 * bits)) | SpreadBits(uint64_t(x)) | (SpreadBits(uint64_t(y)) << 1) | (SpreadBits(uint64_t(z)) << 2);
+    }
+
+    OctreeNode* ImplicitPointOctree::FindNode(uint64_t key) const
+    {
+        uint32_t index = uint32_t((key * 0x9E3779B97F4A7C15ull) >> m_Shift);
+        for (uint32_t probe = 0; probe < MaxProbeLength; ++probe)
+        {
+            OctreeNode& node = m_pNodes[index];
+            uint64_t const nodeKey = node.key.load(std::memory_order_acquire);
+            if (nodeKey == key)
+                return &node;
+            if (nodeKey == 0)
+                return nullptr;
+            index = (index + 1) & m_Mask;
+        }
+        return nullptr;
+    }
+
+    OctreeNode* ImplicitPointOctree::FindOrClaimNode(uint64_t key)
+    {
+        uint32_t index = uint32_t((key * 0x9E3779B97F4A7C15ull) >> m_Shift);
+        for (uint32_t probe = 0; probe < MaxProbeLength; ++probe)
+        {
+            OctreeNode& node = m_pNodes[index];
+            uint64_t nodeKey = node.key.load(std::memory_order_acquire);
+            if (nodeKey == 0 && node.key.compare_exchange_strong(nodeKey, key, std::memory_order_acq_rel))
+            {
+                m_Size.fetch_add(1, std::memory_order_relaxed);
+                return &node;
+            }
+            if (nodeKey == key)
+                return &node;
+            index = (index + 1) & m_Mask;
+        }
+        return nullptr;
+    }
+
+    bool ImplicitPointOctree::Insert(float3 const& sample, uint32_t seed, uint32_t level)
+    {
+        if (level > m_MaxLevels)
+            return false;
+
+        //Same voxel and seed as the reconstruction finds for this point
+        float const deltaOnLevel = 1.f / float(IntPow2(level));
+        float const cellSizeBasedOnLevel = float(m_DiscreteCellSize) * deltaOnLevel;
+        float3 const discretePosition = Discretize(sample, cellSizeBasedOnLevel);
+        uint64_t key = GetKey(ToInt3(discretePosition / cellSizeBasedOnLevel), level);
+        OctreeNode* pNode = key != 0 ? FindNode(key) : nullptr;
+        uint32_t masks = pNode != nullptr ? pNode->masks.load(std::memory_order_acquire) : 0u;
+        uint32_t quadrant = (masks & 0xFFu) != 0 ? seed - pNode->seed.load(std::memory_order_relaxed) : ~0u;
+        if (quadrant >= 8)
+        {
+            //First point of the voxel, or a sample on a voxel face that was discretized into the voxel next to the one that
+            //generated it: the seed tells which voxel it is
+            uint32_t voxelSeed = 0;
+            for (uint32_t v = 0; v < 27 && quadrant >= 8; ++v)
+            {
+                float3 const candidate = GetNeighbourPosition(discretePosition, v, cellSizeBasedOnLevel);
+                voxelSeed = GetNeighbourVoxelSeed(candidate, deltaOnLevel, m_DiscreteCellSize, m_MaxLevels);
+                quadrant = seed - voxelSeed;
+                if (quadrant < 8 && v != 0)
+                    key = GetKey(ToInt3(candidate / cellSizeBasedOnLevel), level);
+            }
+
+            pNode = (quadrant < 8 && key != 0) ? FindOrClaimNode(key) : nullptr;
+            if (pNode == nullptr)
+            {
+                m_FailedInserts.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            //Every inserter of the voxel stores the same seed
+            pNode->seed.store(voxelSeed, std::memory_order_relaxed);
+            masks = pNode->masks.load(std::memory_order_acquire);
+        }
+        if ((masks & (1u << quadrant)) != 0)
+            return true;
+        pNode->masks.fetch_or(1u << quadrant, std::memory_order_release);
+        return LinkParents(key, level);
+    }
+
+    bool ImplicitPointOctree::LinkParents(uint64_t key, uint32_t level)
+    {
+        //Link the parents up to the first one that already had this child, whoever set that bit links the rest
+        uint64_t childKey = key;
+        for (uint32_t l = level; l > 0; --l)
+        {
+            uint64_t const parentKey = childKey >> 3;
+            uint32_t const childBit = 0x100u << uint32_t(childKey & 7u);
+            OctreeNode* const pParent = FindOrClaimNode(parentKey);
+            if (pParent == nullptr)
+            {
+                m_FailedInserts.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if ((pParent->masks.fetch_or(childBit, std::memory_order_acq_rel) & childBit) != 0)
+                break;
+            childKey = parentKey;
+        }
+        return true;
+    }
+
+    OctreeNode const* ImplicitPointOctree::Find(float3 const& discretePosition, uint32_t level) const
+    {
+        if (level > m_MaxLevels)
+            return nullptr;
+
+        float const cellSizeBasedOnLevel = float(m_DiscreteCellSize) * (1.f / float(IntPow2(level)));
+        uint64_t const key = GetKey(ToInt3(discretePosition / cellSizeBasedOnLevel), level);
+        return key != 0 ? FindNode(key) : nullptr;
+    }
+
+    uint32_t ImplicitPointOctree::FindFinestLevel(float3 const& position, uint32_t maxLevel) const
+    {
+        uint64_t key = GetKey(GetVoxelCoordinates(position, 0), 0);
+        OctreeNode const* pNode = key != 0 ? FindNode(key) : nullptr;
+        uint32_t finestLevel = ~0u;
+        for (uint32_t level = 0; pNode != nullptr; ++level)
+        {
+            if (pNode->GetPointMask() != 0)
+                finestLevel = level;
+            if (level >= maxLevel || level >= m_MaxLevels)
+                break;
+
+            //The child mask answers for the voxels nothing was generated in without probing
+            uint64_t const childKey = GetKey(GetVoxelCoordinates(position, level + 1), level + 1);
+            if ((childKey >> 3) != key || (pNode->GetChildMask() & (1u << uint32_t(childKey & 7u))) == 0)
+                break;
+            key = childKey;
+            pNode = FindNode(key);
+        }
+        return finestLevel;
+    }
+} //namespace ImplicitPointCPU
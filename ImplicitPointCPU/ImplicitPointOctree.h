@@ -0,0 +1,187 @@
+//Hashed sparse octree over the implicit points the engine generated: one node per voxel, on every level, that holds a
+//generated point or has a descendant that does. Nodes are keyed by their locational code, the Morton code of the voxel
+//coordinates behind a leading 1 bit that encodes the level: the parent of a node is key >> 3, its children key << 3 | octant.
+//The nodes live in an open addressing table, so finding the node of a voxel is one hash, walking down the levels one probe
+//per level. Reconstruction uses it to skip the neighbour voxels nothing was generated in, instead of hashing their seeds and
+//probing the world hash table for all 8 points. Insert is safe from any number of threads, the queries must not run
+//concurrently with it (they are used in a later pass).
+#pragma once
+#include "ShaderTypes.h"
+#include "SampleGenerationFunctions.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct OctreeNode
+    {
+        std::atomic<uint64_t> key;   //Locational code, 0 = empty slot
+        std::atomic<uint32_t> seed;  //Seed of the implicit points of the voxel, valid when the point mask is not 0
+        std::atomic<uint32_t> masks; //Bits 0-7: quadrant points generated, bits 8-15: children present per octant
+
+        uint32_t GetPointMask() const { return masks.load(std::memory_order_acquire) & 0xFFu; }
+        uint32_t GetChildMask() const { return (masks.load(std::memory_order_acquire) >> 8) & 0xFFu; }
+    };
+
+    class ImplicitPointOctree
+    {
+    public:
+        static uint32_t const RootCoordinateBits = 10; //Level 0 voxels per axis, centered on the origin
+        static uint32_t const MaxLevel = 11;           //3 * (RootCoordinateBits + MaxLevel) + 1 bits fit a key
+        static uint32_t const MaxProbeLength = 128;
+
+        //capacity is rounded up to a power of two, maxLevels must be at most MaxLevel
+        ImplicitPointOctree(uint32_t capacity, uint32_t discreteCellSize, uint32_t maxLevels);
+
+        ImplicitPointOctree(ImplicitPointOctree const&) = delete;
+        ImplicitPointOctree& operator=(ImplicitPointOctree const&) = delete;
+
+        //Records the implicit point seed that was generated at sample on level, together with the parents of its voxel.
+        //False when level is above maxLevels (not covered, see Covers), the point is outside of the octree bounds, doesn't belong
+        //to the voxel at sample or its neighbours or the table is full.
+        bool Insert(float3 const& sample, uint32_t seed, uint32_t level);
+        void Clear();
+
+        //Rebuilds the octree from the generated points keep(seed) is true for, the voxels that lost all of their points free
+        //their nodes. It stays as complete as it was. Must not run concurrently with Insert or the queries.
+        template<typename KeepFunction>
+        void Prune(KeepFunction const& keep)
+        {
+            std::vector<PrunedVoxel> voxels;
+            for (uint32_t i = 0; i <= m_Mask; ++i)
+            {
+                OctreeNode const& node = m_pNodes[i];
+                uint32_t const seed = node.seed.load(std::memory_order_relaxed);
+                uint32_t pointMask = node.GetPointMask();
+                for (uint32_t quadrant = 0; quadrant < 8; ++quadrant)
+                {
+                    if ((pointMask & (1u << quadrant)) != 0 && !keep(seed + quadrant))
+                        pointMask &= ~(1u << quadrant);
+                }
+                if (pointMask != 0)
+                    voxels.push_back(PrunedVoxel{ node.key.load(std::memory_order_relaxed), seed, pointMask });
+            }
+            Rebuild(voxels);
+        }
+
+        //Node of the voxel at discretePosition (see Discretize and GetNeighbourPosition) on level, nullptr when nothing was generated in it
+        OctreeNode const* Find(float3 const& discretePosition, uint32_t level) const;
+
+        //Finest level, up to maxLevel, whose voxel containing position holds generated points, ~0u when there is none.
+        //Walks down from level 0 and stops at the first voxel without a node.
+        uint32_t FindFinestLevel(float3 const& position, uint32_t maxLevel) const;
+
+        //Calls function(seed, sample, level) for every generated point within radius of position on the levels [minLevel, maxLevel].
+        //Only visits the nodes whose voxel overlaps the bounds of the sphere.
+        template<typename PointFunction>
+        void ForEachPointInRadius(float3 const& position, float radius, uint32_t minLevel, uint32_t maxLevel, PointFunction const& function) const
+        {
+            int3 const lower = GetVoxelCoordinates(position - radius, 0);
+            int3 const upper = GetVoxelCoordinates(position + radius, 0);
+            for (int32_t z = lower.z; z <= upper.z; ++z)
+            {
+                for (int32_t y = lower.y; y <= upper.y; ++y)
+                {
+                    for (int32_t x = lower.x; x <= upper.x; ++x)
+                    {
+                        uint64_t const key = GetKey(int3{ x, y, z }, 0);
+                        OctreeNode const* const pNode = key != 0 ? FindNode(key) : nullptr;
+                        if (pNode != nullptr)
+                            VisitInRadius(*pNode, key, int3{ x, y, z }, 0, position, radius, minLevel, maxLevel, function);
+                    }
+                }
+            }
+        }
+
+        //Only the levels up to maxLevels have nodes, the points generated on other levels are unknown to the octree
+        bool Covers(uint32_t level) const { return level <= m_MaxLevels; }
+        uint32_t GetCapacity() const { return m_Mask + 1; }
+        uint32_t GetSize() const { return m_Size.load(std::memory_order_relaxed); }
+        uint64_t GetFailedInsertCount() const { return m_FailedInserts.load(std::memory_order_relaxed); }
+
+        //False after a failed insert or MarkIncomplete: points in the world hash table may have no node, so the octree can't
+        //be used to skip voxels. Clear makes it complete again, so does MarkComplete once the points without a node are gone.
+        bool IsComplete() const { return GetFailedInsertCount() == m_CompletedFailedInserts && !m_Incomplete; }
+        void MarkIncomplete() { m_Incomplete = true; }
+        void MarkComplete() { m_CompletedFailedInserts = GetFailedInsertCount(); m_Incomplete = false; }
+
+    private:
+        std::unique_ptr<OctreeNode[]> m_pNodes;
+        uint32_t m_Mask = 0;
+        uint32_t m_Shift = 0;
+        uint32_t m_DiscreteCellSize = 0;
+        uint32_t m_MaxLevels = 0;
+        std::atomic<uint32_t> m_Size;
+        std::atomic<uint64_t> m_FailedInserts;
+        uint64_t m_CompletedFailedInserts = 0; //Failed inserts before the last MarkComplete
+        bool m_Incomplete = false;
+
+        struct PrunedVoxel
+        {
+            uint64_t key;
+            uint32_t seed;
+            uint32_t pointMask;
+        };
+
+        float GetCellSize(uint32_t level) const { return float(m_DiscreteCellSize) / float(IntPow2(level)); }
+        //Integer coordinates of the voxel containing position, the same voxel Discretize maps it to
+        int3 GetVoxelCoordinates(float3 const& position, uint32_t level) const
+        {
+            float const cellSize = GetCellSize(level);
+            return ToInt3(Discretize(position, cellSize) / cellSize);
+        }
+        //Locational code of the voxel, 0 when it is outside of the octree bounds
+        uint64_t GetKey(int3 const& coordinates, uint32_t level) const;
+        OctreeNode* FindNode(uint64_t key) const;
+        OctreeNode* FindOrClaimNode(uint64_t key);
+        //Sets the child bits of the parents of the node at key on level, up to the first one that already had it
+        bool LinkParents(uint64_t key, uint32_t level);
+        void Rebuild(std::vector<PrunedVoxel> const& voxels);
+
+        template<typename PointFunction>
+        void VisitInRadius(OctreeNode const& node, uint64_t key, int3 const& coordinates, uint32_t level, float3 const& position, float radius,
+            uint32_t minLevel, uint32_t maxLevel, PointFunction const& function) const
+        {
+            float const cellSize = GetCellSize(level);
+            uint32_t const pointMask = node.GetPointMask();
+            if (level >= minLevel && pointMask != 0)
+            {
+                uint32_t const seed = node.seed.load(std::memory_order_relaxed);
+                float3 const voxelPosition = ToFloat3(coordinates) * cellSize;
+                for (uint32_t i = 0; i < 8; ++i)
+                {
+                    if ((pointMask & (1u << i)) == 0)
+                        continue;
+                    float3 const sample = voxelPosition + (GenerateSampleInVoxelQuadrant(seed, level, i) * cellSize);
+                    if (distance(position, sample) <= radius)
+                        function(seed + i, sample, level);
+                }
+            }
+            if (level >= maxLevel)
+                return;
+
+            uint32_t const childMask = node.GetChildMask();
+            float const childCellSize = cellSize * 0.5f;
+            for (uint32_t octant = 0; octant < 8; ++octant)
+            {
+                if ((childMask & (1u << octant)) == 0)
+                    continue;
+
+                //Skip the children whose voxel is farther than radius from position
+                int3 const childCoordinates = { coordinates.x * 2 + int32_t(octant & 1u), coordinates.y * 2 + int32_t((octant >> 1) & 1u),
+                    coordinates.z * 2 + int32_t(octant >> 2) };
+                float3 const childMin = ToFloat3(childCoordinates) * childCellSize;
+                float3 const closest = { clamp(position.x, childMin.x, childMin.x + childCellSize), clamp(position.y, childMin.y, childMin.y + childCellSize),
+                    clamp(position.z, childMin.z, childMin.z + childCellSize) };
+                if (distance(position, closest) > radius)
+                    continue;
+
+                uint64_t const childKey = (key << 3) | octant;
+                OctreeNode const* const pChild = FindNode(childKey);
+                if (pChild != nullptr)
+                    VisitInRadius(*pChild, childKey, childCoordinates, level + 1, position, radius, minLevel, maxLevel, function);
+            }
+        }
+    };
+} //namespace ImplicitPointCPU
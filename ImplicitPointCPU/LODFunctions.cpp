@@ -0,0 +1,111 @@
+#include "LODFunctions.h"
+#include <cmath>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        //Reads one kernel texel and updates the min-max. Returns false where the shader "continue"s,
+        //which also skips the mirrored texel of that iteration (kept to stay identical to the shader).
+        inline bool AccumulateMinMax(uint2 index2D, int32_t xx, int32_t yy, uint32_t screenWidth, uint32_t amountElements,
+            TextureView const& depthBuffer, TextureView const& aoBuffer, float2& lhLOD)
+        {
+            //Get wanted index based on kernel
+            int32_t const sampleX = int32_t(index2D.x) + xx;
+            int32_t const sampleY = int32_t(index2D.y) + yy;
+            uint32_t const sampleIndex = uint32_t(sampleX) + (uint32_t(sampleY) * screenWidth);
+
+            //Range check
+            if (sampleIndex >= amountElements)
+                return false;
+
+            //See if valid pixel
+            float const depth = depthBuffer.Load(sampleX, sampleY);
+            if (asint(depth) == 0)
+                return false;
+
+            //Read AO, and determine min-max
+            float const ao = aoBuffer.Load(sampleX, sampleY);
+            lhLOD.x = min(lhLOD.x, ao);
+            lhLOD.y = max(lhLOD.y, ao);
+            return true;
+        }
+    }
+
+    void SimpleDistanceLOD(uint32_t maxAmountLevels, float3 const& view, float3 const& worldPos, float3 const& cameraPos,
+        uint32_t& lod, uint32_t& prevLod, float& percentageBetweenLOD)
+    {
+        uint32_t const numLOD = maxAmountLevels + 1;
+        float const lodTransitionInterval = 300.f;
+        float const z = max(dot(view, worldPos - cameraPos), 0.f);
+        float const invLod = max(float(numLOD) - (z / lodTransitionInterval), 0.f);
+        float const currentLOD = clamp(invLod, 0.f, float(numLOD));
+
+        uint32_t const l = ToUint(std::ceil(currentLOD));
+        if (l == numLOD) //Over maxAmountLevels
+        {
+            lod = maxAmountLevels;
+            prevLod = maxAmountLevels;
+            percentageBetweenLOD = 1.f;
+        }
+        else //Between 0 and maxAmountLevels + 1
+        {
+            lod = l;
+            prevLod = l - 1;
+            percentageBetweenLOD = float(ToUint(currentLOD) + 1) - currentLOD; //Frac difference, linear norm "dist" to next LOD
+        }
+    }
+
+    void ScreenMinMaxLOD(uint2 index2D, uint2 screenDimensions, uint32_t maxAmountLevels,
+        TextureView const& depthBuffer, TextureView const& aoBuffer, uint32_t& lod, uint32_t& prevLod)
+    {
+        //Start LOD and parameters
+        uint32_t l = maxAmountLevels;
+        int32_t kernelSize = 3;
+        uint32_t const amountElements = screenDimensions.x * screenDimensions.y;
+
+        //Start with base kernel
+        float2 lhLOD = { 1.f, 0.f }; //current minmax
+        for (int32_t yy = -kernelSize; yy <= kernelSize; ++yy)
+            for (int32_t xx = -kernelSize; xx <= kernelSize; ++xx)
+                AccumulateMinMax(index2D, xx, yy, screenDimensions.x, amountElements, depthBuffer, aoBuffer, lhLOD);
+        ++kernelSize;
+
+        //Iterate until a wanted LOD is found - only checking new pixels at edges
+        while (l > 0)
+        {
+            //Top & Bottom row
+            for (int32_t xx = -kernelSize; xx <= kernelSize; ++xx)
+            {
+                if (!AccumulateMinMax(index2D, xx, -kernelSize, screenDimensions.x, amountElements, depthBuffer, aoBuffer, lhLOD))
+                    continue;
+                AccumulateMinMax(index2D, xx, +kernelSize, screenDimensions.x, amountElements, depthBuffer, aoBuffer, lhLOD);
+            }
+
+            //Sides
+            for (int32_t yy = -(kernelSize - 1); yy <= (kernelSize - 1); ++yy)
+            {
+                if (!AccumulateMinMax(index2D, -kernelSize, yy, screenDimensions.x, amountElements, depthBuffer, aoBuffer, lhLOD))
+                    continue;
+                AccumulateMinMax(index2D, +kernelSize, yy, screenDimensions.x, amountElements, depthBuffer, aoBuffer, lhLOD);
+            }
+
+            //Check difference between minmax, if > threshold, lod found
+            float const diff = std::fabs(lhLOD.y - lhLOD.x);
+            float const threshold = 0.00005f;
+            if (diff > threshold)
+            {
+                lod = l;
+                prevLod = l - 1;
+                return;
+            }
+
+            //Go to next LOD and increase kernal size
+            --l;
+            ++kernelSize;
+        }
+
+        lod = 0;
+        prevLod = 0;
+    }
+} //namespace ImplicitPointCPU
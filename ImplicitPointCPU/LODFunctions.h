@@ -0,0 +1,22 @@
+//CPU port of Shaders/LODFunctions.hlsli
+#pragma once
+#include "ShaderTypes.h"
+#include "FrameData.h"
+
+namespace ImplicitPointCPU
+{
+    enum class LODMode : uint32_t
+    {
+        FixedLOD    = 0,
+        DistanceLOD = 1,
+        MinMaxLOD   = 2
+    };
+
+    //Fixed distance based LOD
+    void SimpleDistanceLOD(uint32_t maxAmountLevels, float3 const& view, float3 const& worldPos, float3 const& cameraPos,
+        uint32_t& lod, uint32_t& prevLod, float& percentageBetweenLOD);
+
+    //Screen MinMax Based LOD
+    void ScreenMinMaxLOD(uint2 index2D, uint2 screenDimensions, uint32_t maxAmountLevels,
+        TextureView const& depthBuffer, TextureView const& aoBuffer, uint32_t& lod, uint32_t& prevLod);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,65 @@
+//Private map of one thread that sums the samples of a tile per seed before they go to the shared accumulation table.
+//Neighbouring pixels mostly hit the same few seeds, so a tile collapses into a handful of entries and the shared table
+//only sees one increment per unique seed instead of two per pixel. Sums are integers, the result is the same either way.
+#pragma once
+#include "HashTable.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    class LocalAccumulationMap
+    {
+    public:
+        //maxKeys = the most unique keys added between two Clear calls, the map is sized to stay at most half full
+        explicit LocalAccumulationMap(uint32_t maxKeys)
+        {
+            uint32_t capacity = 16;
+            while (capacity < maxKeys * 2)
+                capacity *= 2;
+            m_Entries.assign(capacity, KeyData{ 0, 0, 0 });
+            m_Mask = capacity - 1;
+            m_Used.reserve(maxKeys);
+        }
+
+        //Linear probing on the key, seeds are hashes already. key must not be 0.
+        void Add(uint32_t key, uint32_t value)
+        {
+            uint32_t index = key & m_Mask;
+            while (m_Entries[index].key != key)
+            {
+                if (m_Entries[index].key == 0)
+                {
+                    m_Entries[index].key = key;
+                    m_Used.push_back(index);
+                    break;
+                }
+                index = (index + 1) & m_Mask;
+            }
+            m_Entries[index].value += value;
+            ++m_Entries[index].count;
+        }
+
+        //Calls function(KeyData) once per unique key, in the order the keys were first added
+        template<typename EntryFunction>
+        void ForEach(EntryFunction const& function) const
+        {
+            for (uint32_t index : m_Used)
+                function(m_Entries[index]);
+        }
+
+        uint32_t GetSize() const { return uint32_t(m_Used.size()); }
+
+        //Only touches the used entries, so clearing costs as much as the tile added
+        void Clear()
+        {
+            for (uint32_t index : m_Used)
+                m_Entries[index] = KeyData{ 0, 0, 0 };
+            m_Used.clear();
+        }
+
+    private:
+        std::vector<KeyData> m_Entries;
+        std::vector<uint32_t> m_Used;
+        uint32_t m_Mask = 0;
+    };
+} //namespace ImplicitPointCPU
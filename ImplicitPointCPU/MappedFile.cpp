@@ -0,0 +1,106 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ImplicitPointCPU
+{
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+#if defined(_WIN32)
+    bool MappedFile::Open(char const* filename)
+    {
+        Close();
+
+        HANDLE const hFile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+            return false;
+        m_hFile = hFile;
+
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+        {
+            Close();
+            return false;
+        }
+
+        m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (m_hMapping == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        m_pData = MapViewOfFile(m_hMapping, FILE_MAP_COPY, 0, 0, 0);
+        if (m_pData == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        m_Size = uint64_t(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_pData != nullptr)
+            UnmapViewOfFile(m_pData);
+        if (m_hMapping != nullptr)
+            CloseHandle(m_hMapping);
+        if (m_hFile != nullptr)
+            CloseHandle(m_hFile);
+
+        m_pData = nullptr;
+        m_hMapping = nullptr;
+        m_hFile = nullptr;
+        m_Size = 0;
+    }
+#else
+    bool MappedFile::Open(char const* filename)
+    {
+        Close();
+
+        int const file = open(filename, O_RDONLY);
+        if (file < 0)
+            return false;
+
+        struct stat status = {};
+        if (fstat(file, &status) != 0 || status.st_size <= 0)
+        {
+            close(file);
+            return false;
+        }
+
+        //The mapping keeps the file referenced, the descriptor is not needed anymore
+        void* const pData = mmap(nullptr, size_t(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        close(file);
+        if (pData == MAP_FAILED)
+            return false;
+
+        m_pData = pData;
+        m_Size = uint64_t(status.st_size);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_pData != nullptr)
+            munmap(m_pData, size_t(m_Size));
+
+        m_pData = nullptr;
+        m_Size = 0;
+    }
+#endif
+} //namespace ImplicitPointCPU
@@ -0,0 +1,31 @@
+//Read-only file mapped into memory (mmap / MapViewOfFile). The mapping is copy-on-write, so the data can be handed to
+//types that expect mutable memory without ever changing the file.
+#pragma once
+#include <cstdint>
+
+namespace ImplicitPointCPU
+{
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        bool Open(char const* filename);
+        void Close();
+
+        void* GetData() const { return m_pData; }
+        uint64_t GetSize() const { return m_Size; }
+
+    private:
+        void* m_pData = nullptr;
+        uint64_t m_Size = 0;
+#if defined(_WIN32)
+        void* m_hFile = nullptr;
+        void* m_hMapping = nullptr;
+#endif
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,56 @@
+#include "MappedH3DModel.h"
+
+namespace ImplicitPointCPU
+{
+    //The mapping starts page aligned and the tables are multiples of 16 bytes, so the structs are read in place aligned
+    static_assert(sizeof(H3DHeader) % alignof(H3DMesh) == 0, "The mesh table must stay aligned in the mapping");
+    static_assert(sizeof(H3DMesh) % alignof(H3DMaterial) == 0, "The material table must stay aligned in the mapping");
+
+    bool MappedH3DModel::Open(char const* filename)
+    {
+        Close();
+        if (!m_File.Open(filename))
+            return false;
+
+        uint8_t const* const pData = static_cast<uint8_t const*>(m_File.GetData());
+        H3DModelView view;
+        bool valid = m_File.GetSize() >= sizeof(H3DHeader);
+        if (valid)
+        {
+            //Same order as LoadH3D reads them, the depth-only indices have the size of the full ones
+            H3DHeader const& header = *reinterpret_cast<H3DHeader const*>(pData);
+            uint64_t const meshesOffset = sizeof(H3DHeader);
+            uint64_t const materialsOffset = meshesOffset + uint64_t(header.meshCount) * sizeof(H3DMesh);
+            uint64_t const vertexDataOffset = materialsOffset + uint64_t(header.materialCount) * sizeof(H3DMaterial);
+            uint64_t const indexDataOffset = vertexDataOffset + header.vertexDataByteSize;
+            uint64_t const vertexDataDepthOffset = indexDataOffset + header.indexDataByteSize;
+            uint64_t const indexDataDepthOffset = vertexDataDepthOffset + header.vertexDataByteSizeDepth;
+            valid = indexDataDepthOffset + header.indexDataByteSize <= m_File.GetSize();
+            if (valid)
+            {
+                view.header = &header;
+                view.meshes = H3DSpan<H3DMesh>{ reinterpret_cast<H3DMesh const*>(pData + meshesOffset), header.meshCount };
+                view.materials = H3DSpan<H3DMaterial>{ reinterpret_cast<H3DMaterial const*>(pData + materialsOffset), header.materialCount };
+                view.vertexData = H3DSpan<uint8_t>{ pData + vertexDataOffset, header.vertexDataByteSize };
+                view.indexData = H3DSpan<uint8_t>{ pData + indexDataOffset, header.indexDataByteSize };
+                view.vertexDataDepth = H3DSpan<uint8_t>{ pData + vertexDataDepthOffset, header.vertexDataByteSizeDepth };
+                view.indexDataDepth = H3DSpan<uint8_t>{ pData + indexDataDepthOffset, header.indexDataByteSize };
+                valid = IsValidH3D(view);
+            }
+        }
+        if (!valid)
+        {
+            m_File.Close();
+            return false;
+        }
+
+        m_View = view;
+        return true;
+    }
+
+    void MappedH3DModel::Close()
+    {
+        m_View = H3DModelView();
+        m_File.Close();
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,26 @@
+//H3D model read in place from a memory mapped file: Open validates the header, mesh and material tables where they lie in
+//the mapping and the view points into it, nothing is copied. The vertex and index streams are read from disk page by page
+//as their consumers first touch them, so a large scene opens in the time it takes to check its tables.
+#pragma once
+#include "H3DModel.h"
+#include "MappedFile.h"
+
+namespace ImplicitPointCPU
+{
+    class MappedH3DModel
+    {
+    public:
+        //False on a missing or short file or tables IsValidH3D rejects. Bytes after the streams are ignored, like LoadH3D does.
+        bool Open(char const* filename);
+        void Close();
+
+        //Spans into the mapping, only valid after a successful Open and until Close. The index values are not checked yet,
+        //build triangle lists from them with GetTriangleMesh.
+        H3DModelView const& GetView() const { return m_View; }
+        uint64_t GetFileSize() const { return m_File.GetSize(); }
+
+    private:
+        MappedFile m_File;
+        H3DModelView m_View;
+    };
+} //namespace ImplicitPointCPU
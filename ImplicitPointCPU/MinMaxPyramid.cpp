@@ -0,0 +1,103 @@
+#include "MinMaxPyramid.h"
+#include <cmath>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        float2 const EmptyMinMax = { 1.f, 0.f }; //Start value of the shader's min-max, no texel changes it
+
+        uint32_t GetLevel(uint32_t side)
+        {
+            uint32_t level = 0;
+            while ((2u << level) <= side)
+                ++level;
+            return level;
+        }
+    }
+
+    void MinMaxPyramid::Build(TextureView const& depthBuffer, TextureView const& aoBuffer, uint32_t minRadius, uint32_t maxRadius, ThreadPool& threadPool)
+    {
+        m_Padding = maxRadius;
+        m_Width = depthBuffer.width + 2 * m_Padding;
+        m_Height = depthBuffer.height + 2 * m_Padding;
+        m_MinLevel = GetLevel(2 * minRadius + 1);
+        uint32_t const maxLevel = GetLevel(2 * maxRadius + 1);
+        size_t const size = size_t(m_Width) * m_Height;
+
+        m_Levels.resize(maxLevel - m_MinLevel + 1);
+        for (std::vector<float2>& level : m_Levels)
+            level.resize(size);
+        m_Scratch[0].resize(size);
+        m_Scratch[1].resize(size);
+
+        //Level 0: the texels themselves
+        std::vector<float2>& texels = m_MinLevel == 0 ? m_Levels[0] : m_Scratch[0];
+        threadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t /*threadIndex*/)
+        {
+            int32_t const screenY = int32_t(y) - int32_t(m_Padding);
+            for (uint32_t x = 0; x < m_Width; ++x)
+            {
+                int32_t const screenX = int32_t(x) - int32_t(m_Padding);
+                float2 minMax = EmptyMinMax;
+                if (asint(depthBuffer.Load(screenX, screenY)) != 0)
+                {
+                    float const ao = aoBuffer.Load(screenX, screenY);
+                    minMax = float2{ min(minMax.x, ao), max(minMax.y, ao) };
+                }
+                texels[x + y * m_Width] = minMax;
+            }
+        });
+
+        //Level k: the 4 blocks of level k - 1 in its square, blocks past the padded screen are empty
+        for (uint32_t level = 1; level <= maxLevel; ++level)
+        {
+            std::vector<float2> const& source = (level - 1) >= m_MinLevel ? m_Levels[level - 1 - m_MinLevel] : m_Scratch[(level - 1) & 1];
+            std::vector<float2>& target = level >= m_MinLevel ? m_Levels[level - m_MinLevel] : m_Scratch[level & 1];
+            uint32_t const half = 1u << (level - 1);
+            threadPool.ParallelFor(m_Height, [&](uint32_t y, uint32_t /*threadIndex*/)
+            {
+                bool const hasBottom = (y + half) < m_Height;
+                for (uint32_t x = 0; x < m_Width; ++x)
+                {
+                    bool const hasRight = (x + half) < m_Width;
+                    float2 const a = source[x + y * m_Width];
+                    float2 const b = hasRight ? source[(x + half) + y * m_Width] : EmptyMinMax;
+                    float2 const c = hasBottom ? source[x + (y + half) * m_Width] : EmptyMinMax;
+                    float2 const d = (hasRight && hasBottom) ? source[(x + half) + (y + half) * m_Width] : EmptyMinMax;
+                    target[x + y * m_Width] = float2{ min(min(a.x, b.x), min(c.x, d.x)), max(max(a.y, b.y), max(c.y, d.y)) };
+                }
+            });
+        }
+    }
+
+    size_t MinMaxPyramid::GetMemorySize() const
+    {
+        size_t size = 0;
+        for (std::vector<float2> const& level : m_Levels)
+            size += level.size() * sizeof(float2);
+        return size;
+    }
+
+    void PyramidMinMaxLOD(uint2 index2D, uint32_t maxAmountLevels, MinMaxPyramid const& pyramid, uint32_t& lod, uint32_t& prevLod)
+    {
+        //Kernel size 4 decides level maxAmountLevels, every next size one level less, down to level 1 at 3 + maxAmountLevels.
+        //The min/max only widen with the kernel size: find the first one whose difference is above the threshold.
+        float const threshold = 0.00005f;
+        uint32_t first = 4;
+        uint32_t last = 4 + maxAmountLevels; //One past the largest kernel size = level 0
+        while (first < last)
+        {
+            uint32_t const kernelSize = first + (last - first) / 2;
+            float2 const lhLOD = pyramid.GetMinMax(index2D, kernelSize);
+            if (std::fabs(lhLOD.y - lhLOD.x) > threshold)
+                last = kernelSize;
+            else
+                first = kernelSize + 1;
+        }
+
+        uint32_t const l = maxAmountLevels - (first - 4);
+        lod = l;
+        prevLod = l > 0 ? l - 1 : 0;
+    }
+} //namespace ImplicitPointCPU
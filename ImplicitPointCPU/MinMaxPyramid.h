@@ -0,0 +1,58 @@
+//Min/max of the AO over square screen windows in O(1): level k holds the min/max of the 2^k x 2^k texels starting at every
+//texel (a 2D sparse table), so any square is covered by 4 overlapping blocks of one level. Built once per frame from the
+//(blurred) AO buffer, it lets ScreenMinMaxLOD pick a level with a few lookups instead of reading the kernel ring by ring.
+//Texels without depth and outside of the screen are ignored, like the shader does.
+#pragma once
+#include "ShaderTypes.h"
+#include "FrameData.h"
+#include "ThreadPool.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    class MinMaxPyramid
+    {
+    public:
+        //Windows of up to (2 * maxRadius + 1)^2 texels can be queried, those of at least (2 * minRadius + 1)^2 texels are
+        //kept: only the levels in between are stored
+        void Build(TextureView const& depthBuffer, TextureView const& aoBuffer, uint32_t minRadius, uint32_t maxRadius, ThreadPool& threadPool);
+
+        //Min (x) and max (y) AO of the valid texels in the window of radius around center, { 1, 0 } without any.
+        //radius in [minRadius, maxRadius] of the last Build.
+        float2 GetMinMax(uint2 center, uint32_t radius) const
+        {
+            uint32_t const side = 2 * radius + 1;
+            uint32_t level = 0;
+            while ((2u << level) <= side)
+                ++level;
+            std::vector<float2> const& blocks = m_Levels[level - m_MinLevel];
+
+            //Padded coordinates of the corner blocks, the window starts at center - radius
+            uint32_t const x0 = center.x + m_Padding - radius;
+            uint32_t const y0 = center.y + m_Padding - radius;
+            uint32_t const x1 = x0 + side - (1u << level);
+            uint32_t const y1 = y0 + side - (1u << level);
+            float2 const a = blocks[x0 + y0 * m_Width];
+            float2 const b = blocks[x1 + y0 * m_Width];
+            float2 const c = blocks[x0 + y1 * m_Width];
+            float2 const d = blocks[x1 + y1 * m_Width];
+            return float2{ min(min(a.x, b.x), min(c.x, d.x)), max(max(a.y, b.y), max(c.y, d.y)) };
+        }
+
+        //Bytes of the stored levels
+        size_t GetMemorySize() const;
+
+    private:
+        uint32_t m_Width = 0;   //Screen width + 2 * m_Padding
+        uint32_t m_Height = 0;
+        uint32_t m_Padding = 0; //Windows may reach maxRadius texels past the screen
+        uint32_t m_MinLevel = 0;
+        std::vector<std::vector<float2>> m_Levels; //m_MinLevel and up
+        std::vector<float2> m_Scratch[2];
+    };
+
+    //ScreenMinMaxLOD on the pyramid of the frame, built with minRadius 4 and maxRadius 3 + maxAmountLevels.
+    //The level is the one of the first kernel size whose min/max differ, found by a binary search over the kernel sizes.
+    //Unlike the shader, a texel without depth doesn't skip the texel on the opposite side of its ring.
+    void PyramidMinMaxLOD(uint2 index2D, uint32_t maxAmountLevels, MinMaxPyramid const& pyramid, uint32_t& lod, uint32_t& prevLod);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,87 @@
+//Private table of one thread with the neighbour voxels the final visualization pass gathered this frame: the 8 implicit
+//points of a voxel with the world hash table value and sample count of their seeds. Neighbouring pixels share almost all
+//of their 27 neighbours, so most pixels gather from here instead of hashing the seeds and points and probing the world
+//hash table again. Direct mapped, a miss overwrites the slot. Entries are tagged with the frame, so the table doesn't
+//have to be cleared when the world hash table changes. Values are the same floats the pixel would compute itself.
+#pragma once
+#include "ShaderTypes.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct CachedNeighbourVoxel
+    {
+        float3 samples[8];      //Absolute position of the implicit point per quadrant
+        float values[8];        //World hash table value of the point
+        float sampleCounts[8];  //World hash table sample count of the point, 0 when the seed is not cached
+        uint3 positionBits;     //Tag: neighbour position, level and frame
+        uint32_t level;
+        uint32_t frame;
+    };
+
+    class NeighbourVoxelCache
+    {
+    public:
+        //entryCount is rounded up to a power of two
+        explicit NeighbourVoxelCache(uint32_t entryCount)
+        {
+            uint32_t capacity = 1;
+            while (capacity < entryCount)
+            {
+                capacity *= 2;
+                --m_Shift;
+            }
+            m_Entries.resize(capacity);
+            for (CachedNeighbourVoxel& entry : m_Entries)
+                entry.frame = 0;
+        }
+
+        //Invalidates every entry, call once per frame before the first Get
+        void BeginFrame()
+        {
+            m_Hits = 0;
+            m_Misses = 0;
+            if (++m_Frame != 0)
+                return;
+
+            for (CachedNeighbourVoxel& entry : m_Entries)
+                entry.frame = 0;
+            m_Frame = 1;
+        }
+
+        //Entry of the voxel at neighbourPosition (see GetNeighbourPosition) on level, fill(CachedNeighbourVoxel&) computes the
+        //samples, values and counts on a miss. The reference is valid until the next Get.
+        template<typename FillFunction>
+        CachedNeighbourVoxel const& Get(float3 const& neighbourPosition, uint32_t level, FillFunction const& fill)
+        {
+            //The positions are multiples of the cell size, the low mantissa bits are mostly 0: the index is taken from the top bits
+            uint3 const bits = asuint(neighbourPosition);
+            uint32_t const hash = (bits.x * 73856093u) ^ (bits.y * 19349663u) ^ (bits.z * 83492791u) ^ level;
+            CachedNeighbourVoxel& entry = m_Entries[m_Shift == 32 ? 0 : (hash * 2654435761u) >> m_Shift];
+            if (entry.frame == m_Frame && entry.level == level && entry.positionBits.x == bits.x && entry.positionBits.y == bits.y
+                && entry.positionBits.z == bits.z)
+            {
+                ++m_Hits;
+                return entry;
+            }
+
+            ++m_Misses;
+            fill(entry);
+            entry.positionBits = bits;
+            entry.level = level;
+            entry.frame = m_Frame;
+            return entry;
+        }
+
+        //Gathers since the last BeginFrame
+        uint64_t GetHitCount() const { return m_Hits; }
+        uint64_t GetMissCount() const { return m_Misses; }
+
+    private:
+        std::vector<CachedNeighbourVoxel> m_Entries;
+        uint32_t m_Shift = 32;
+        uint32_t m_Frame = 0;
+        uint64_t m_Hits = 0;
+        uint64_t m_Misses = 0;
+    };
+} //namespace ImplicitPointCPU
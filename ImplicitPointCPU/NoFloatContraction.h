@@ -0,0 +1,12 @@
+//Include first in the translation units whose SIMD kernels are bit-exact with a scalar port. With FMA enabled (-mfma, AVX-512)
+//GCC fuses a multiply and the add that consumes it by default (-ffp-contract=fast), also across the Simd wrappers, which
+//rounds once where the scalar port rounds twice. Every function defined after this include keeps them apart.
+#pragma once
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
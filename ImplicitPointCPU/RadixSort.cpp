@@ -0,0 +1,65 @@
+#include "RadixSort.h"
+#include "ShaderTypes.h"
+#include <cstring>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        //Large enough that the per block histograms are cheap compared to the scatter
+        uint32_t const ElementsPerBlock = 65536;
+    }
+
+    //Every pass: count the digits per block, turn the counts into the offsets where every block scatters a digit to
+    //(digit major, block minor, so the pass is stable), then scatter. Blocks are independent, only the prefix is serial.
+    void RadixSorter::Sort(uint64_t* pElements, uint64_t* pScratch, uint32_t count, uint32_t keyBits, ThreadPool& threadPool)
+    {
+        if (count < 2 || keyBits == 0)
+            return;
+
+        uint32_t const blockCount = (count + ElementsPerBlock - 1) / ElementsPerBlock;
+        m_Histograms.resize(size_t(blockCount) * BucketCount);
+
+        uint64_t* pSource = pElements;
+        uint64_t* pDestination = pScratch;
+        for (uint32_t shift = 32; shift < 32 + keyBits; shift += DigitBits)
+        {
+            threadPool.ParallelFor(blockCount, [&](uint32_t block, uint32_t /*threadIndex*/)
+            {
+                uint32_t* const histogram = &m_Histograms[size_t(block) * BucketCount];
+                std::memset(histogram, 0, BucketCount * sizeof(uint32_t));
+                uint32_t const end = min((block + 1) * ElementsPerBlock, count);
+                for (uint32_t i = block * ElementsPerBlock; i < end; ++i)
+                    ++histogram[(pSource[i] >> shift) & (BucketCount - 1)];
+            });
+
+            uint32_t offset = 0;
+            for (uint32_t digit = 0; digit < BucketCount; ++digit)
+            {
+                for (uint32_t block = 0; block < blockCount; ++block)
+                {
+                    uint32_t& bucket = m_Histograms[size_t(block) * BucketCount + digit];
+                    uint32_t const digitCount = bucket;
+                    bucket = offset;
+                    offset += digitCount;
+                }
+            }
+
+            threadPool.ParallelFor(blockCount, [&](uint32_t block, uint32_t /*threadIndex*/)
+            {
+                uint32_t* const offsets = &m_Histograms[size_t(block) * BucketCount];
+                uint32_t const end = min((block + 1) * ElementsPerBlock, count);
+                for (uint32_t i = block * ElementsPerBlock; i < end; ++i)
+                    pDestination[offsets[(pSource[i] >> shift) & (BucketCount - 1)]++] = pSource[i];
+            });
+
+            uint64_t* const pSorted = pDestination;
+            pDestination = pSource;
+            pSource = pSorted;
+        }
+
+        //Odd amount of passes, the result ended up in the scratch buffer
+        if (pSource != pElements)
+            std::memcpy(pElements, pSource, size_t(count) * sizeof(uint64_t));
+    }
+} //namespace ImplicitPointCPU
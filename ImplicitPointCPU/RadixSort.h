@@ -0,0 +1,23 @@
+//Multithreaded LSD radix sort of 64 bit key/value elements, the CPU counterpart of Core/BitonicSort: the key is in the
+//upper 32 bits, the value (an AO sum, an index, ...) in the lower 32 bits and is carried along.
+#pragma once
+#include "ThreadPool.h"
+#include <cstdint>
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    class RadixSorter
+    {
+    public:
+        static uint32_t const DigitBits = 8;
+        static uint32_t const BucketCount = 1u << DigitBits;
+
+        //Sorts count elements ascending by their key, keyBits in [1, 32] and every key below 2^keyBits. Stable, so elements
+        //with equal keys keep their order. The result is in pElements, pScratch must hold count elements as well.
+        void Sort(uint64_t* pElements, uint64_t* pScratch, uint32_t count, uint32_t keyBits, ThreadPool& threadPool);
+
+    private:
+        std::vector<uint32_t> m_Histograms; //BucketCount per block, turned into scatter offsets in place
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,223 @@
+//Packet version of BVH::IntersectAny and AccelerationStructure::IntersectAny, written once against the SimdAVX2/SimdAVX512
+//interface: the rays of a packet are the lanes of a vector and walk the tree together. A node is skipped when none of the
+//active rays hits its bounds, a ray leaves the packet as soon as it found a hit, and the packet ends when no ray is left.
+//Only include this from the instruction set specific translation units (BVHPacketAVX2.cpp, ...).
+#pragma once
+#include "AccelerationStructure.h"
+
+namespace ImplicitPointCPU
+{
+    template<typename S>
+    struct RayPacketKernel
+    {
+        typedef typename S::Float Float;
+        typedef typename S::Mask Mask;
+
+        static Mask IntersectBounds(BVHNode const& node, Float const origin[3], Float const inverseDirection[3], Float tMin, Float tMax)
+        {
+            Float tNear = tMin;
+            Float tFar = tMax;
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                Float const t0 = S::Mul(S::Sub(S::Set1(node.boundsMin[axis]), origin[axis]), inverseDirection[axis]);
+                Float const t1 = S::Mul(S::Sub(S::Set1(node.boundsMax[axis]), origin[axis]), inverseDirection[axis]);
+                tNear = S::Max(tNear, S::Min(t0, t1));
+                tFar = S::Min(tFar, S::Max(t0, t1));
+            }
+            return S::LessEqual(tNear, tFar);
+        }
+
+        //Same test as the scalar Moller-Trumbore, front faces only
+        static Mask IntersectTriangle(BVHTriangle const& triangle, Float const origin[3], Float const direction[3], Float tMin, Float tMax, Float& t)
+        {
+            Float const e1[3] = { S::Set1(triangle.edge1.x), S::Set1(triangle.edge1.y), S::Set1(triangle.edge1.z) };
+            Float const e2[3] = { S::Set1(triangle.edge2.x), S::Set1(triangle.edge2.y), S::Set1(triangle.edge2.z) };
+
+            Float p[3];
+            Cross(direction, e2, p);
+            Float const determinant = Dot(e1, p);
+            Mask hit = S::Less(determinant, S::Set1(0.f));
+            if (!S::Any(hit))
+                return hit;
+
+            Float const inverseDeterminant = S::Div(S::Set1(1.f), determinant);
+            Float const s[3] = { S::Sub(origin[0], S::Set1(triangle.v0.x)), S::Sub(origin[1], S::Set1(triangle.v0.y)), S::Sub(origin[2], S::Set1(triangle.v0.z)) };
+            Float const u = S::Mul(Dot(s, p), inverseDeterminant);
+            Float q[3];
+            Cross(s, e1, q);
+            Float const v = S::Mul(Dot(direction, q), inverseDeterminant);
+            t = S::Mul(Dot(e2, q), inverseDeterminant);
+
+            Float const zero = S::Set1(0.f);
+            Float const one = S::Set1(1.f);
+            hit = S::MaskAnd(hit, S::MaskAnd(S::GreaterEqual(u, zero), S::LessEqual(u, one)));
+            hit = S::MaskAnd(hit, S::MaskAnd(S::GreaterEqual(v, zero), S::LessEqual(S::Add(u, v), one)));
+            return S::MaskAnd(hit, S::MaskAnd(S::Greater(t, tMin), S::Less(t, tMax)));
+        }
+
+        //One packet of rays in the space of the tree it traverses
+        struct Packet
+        {
+            Float origin[3];
+            Float direction[3];
+            Float inverseDirection[3];
+            float directionLanes[3][S::Width]; //For the scalar near child decision
+        };
+
+        static void InitPacket(Float const origin[3], Float const direction[3], Packet& packet)
+        {
+            Float const one = S::Set1(1.f);
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                packet.origin[axis] = origin[axis];
+                packet.direction[axis] = direction[axis];
+                packet.inverseDirection[axis] = S::Div(one, direction[axis]);
+                S::Store(packet.directionLanes[axis], direction[axis]);
+            }
+        }
+
+        //Near child first for the first active ray of the packet: pushes the far child, then the near one
+        static void PushChildren(BVHNode const& node, Packet const& packet, Mask active, uint32_t* stack, uint32_t& stackSize)
+        {
+            uint32_t const activeBits = S::Bits(active);
+            uint32_t lane = 0;
+            while ((activeBits & (1u << lane)) == 0)
+                ++lane;
+            bool const negative = packet.directionLanes[node.splitAxis][lane] < 0.f;
+            stack[stackSize++] = node.leftFirst + (negative ? 0 : 1);
+            stack[stackSize++] = node.leftFirst + (negative ? 1 : 0);
+        }
+
+        //Any hit traversal of one tree: the active rays that hit something get their t and leave active
+        static void TraverseAny(BVH const& bvh, Packet const& packet, Float tMin, Float tMax, Mask& active, Float& t)
+        {
+            if (bvh.GetNodes().empty())
+                return;
+
+            BVHNode const* const nodes = bvh.GetNodes().data();
+            BVHTriangle const* const triangles = bvh.GetTriangles().data();
+
+            uint32_t stack[64];
+            uint32_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0)
+            {
+                BVHNode const& node = nodes[stack[--stackSize]];
+                Mask const hitBounds = S::MaskAnd(active, IntersectBounds(node, packet.origin, packet.inverseDirection, tMin, tMax));
+                if (!S::Any(hitBounds))
+                    continue;
+
+                if (node.triangleCount > 0)
+                {
+                    for (uint32_t i = node.leftFirst; i < node.leftFirst + node.triangleCount; ++i)
+                    {
+                        Float triangleT = tMax;
+                        Mask const hit = S::MaskAnd(hitBounds, IntersectTriangle(triangles[i], packet.origin, packet.direction, tMin, tMax, triangleT));
+                        t = S::Select(hit, triangleT, t);
+                        active = S::MaskAndNot(active, hit);
+                    }
+                    if (!S::Any(active))
+                        return;
+                    continue;
+                }
+
+                PushChildren(node, packet, active, stack, stackSize);
+            }
+        }
+
+        static void IntersectAny(BVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT)
+        {
+            Float const tMin = S::Set1(rays.tMin);
+            Float const tMax = S::Set1(rays.tMax);
+
+            for (uint32_t first = 0; first < count; first += S::Width)
+            {
+                Float const origin[3] = { S::Load(rays.originX + first), S::Load(rays.originY + first), S::Load(rays.originZ + first) };
+                Float const direction[3] = { S::Load(rays.directionX + first), S::Load(rays.directionY + first), S::Load(rays.directionZ + first) };
+                Packet packet;
+                InitPacket(origin, direction, packet);
+
+                Float t = tMax;
+                Mask active = S::LessEqual(tMin, tMax);
+                TraverseAny(bvh, packet, tMin, tMax, active, t);
+                S::Store(hitT + first, t);
+            }
+        }
+
+        //Two levels: the world space packet walks the TLAS, every instance it enters gets the packet in object space
+        static void IntersectAny(AccelerationStructure const& scene, RayBatch const& rays, uint32_t count, float* hitT)
+        {
+            std::vector<BVHNode> const& nodes = scene.GetTLASNodes();
+            std::vector<BVHInstance> const& instances = scene.GetInstances();
+            std::vector<uint32_t> const& leafInstances = scene.GetTLASInstances();
+            Float const tMin = S::Set1(rays.tMin);
+            Float const tMax = S::Set1(rays.tMax);
+
+            for (uint32_t first = 0; first < count; first += S::Width)
+            {
+                Float const origin[3] = { S::Load(rays.originX + first), S::Load(rays.originY + first), S::Load(rays.originZ + first) };
+                Float const direction[3] = { S::Load(rays.directionX + first), S::Load(rays.directionY + first), S::Load(rays.directionZ + first) };
+                Packet packet;
+                InitPacket(origin, direction, packet);
+
+                Float t = tMax;
+                Mask active = S::LessEqual(tMin, tMax);
+                uint32_t stack[64];
+                uint32_t stackSize = 0;
+                if (!nodes.empty())
+                    stack[stackSize++] = 0;
+                while (stackSize > 0)
+                {
+                    BVHNode const& node = nodes[stack[--stackSize]];
+                    Mask const hitBounds = S::MaskAnd(active, IntersectBounds(node, packet.origin, packet.inverseDirection, tMin, tMax));
+                    if (!S::Any(hitBounds))
+                        continue;
+
+                    if (node.triangleCount > 0)
+                    {
+                        for (uint32_t i = node.leftFirst; i < node.leftFirst + node.triangleCount && S::Any(active); ++i)
+                        {
+                            BVHInstance const& instance = instances[leafInstances[i]];
+                            Float objectOrigin[3];
+                            Float objectDirection[3];
+                            Transform(instance.worldToObject, origin, 1.f, objectOrigin);
+                            Transform(instance.worldToObject, direction, 0.f, objectDirection);
+                            Packet objectPacket;
+                            InitPacket(objectOrigin, objectDirection, objectPacket);
+                            TraverseAny(scene.GetMeshBVH(instance.mesh), objectPacket, tMin, tMax, active, t);
+                        }
+                        if (!S::Any(active))
+                            break;
+                        continue;
+                    }
+
+                    PushChildren(node, packet, active, stack, stackSize);
+                }
+                S::Store(hitT + first, t);
+            }
+        }
+
+    private:
+        static Float Dot(Float const a[3], Float const b[3])
+        {
+            return S::Add(S::Add(S::Mul(a[0], b[0]), S::Mul(a[1], b[1])), S::Mul(a[2], b[2]));
+        }
+
+        static void Cross(Float const a[3], Float const b[3], Float result[3])
+        {
+            result[0] = S::Sub(S::Mul(a[1], b[2]), S::Mul(a[2], b[1]));
+            result[1] = S::Sub(S::Mul(a[2], b[0]), S::Mul(a[0], b[2]));
+            result[2] = S::Sub(S::Mul(a[0], b[1]), S::Mul(a[1], b[0]));
+        }
+
+        //mul(M, float4(v, w)).xyz for w 1 (points) or 0 (directions)
+        static void Transform(float4x4 const& m, Float const v[3], float w, Float result[3])
+        {
+            for (uint32_t row = 0; row < 3; ++row)
+            {
+                Float const sum = S::Add(S::Mul(S::Set1(m.m[row][0]), v[0]), S::Add(S::Mul(S::Set1(m.m[row][1]), v[1]), S::Mul(S::Set1(m.m[row][2]), v[2])));
+                result[row] = w != 0.f ? S::Add(sum, S::Set1(m.m[row][3] * w)) : sum;
+            }
+        }
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,83 @@
+//Closest samples the pixels found last frame, looked up again by reprojecting the world position of a pixel into the screen
+//of the last frame. A pixel whose world position moved less than the reuse distance keeps last frame's seeds and sample
+//instead of searching the neighbour voxels again. Double buffered: the pixels of a frame read the entries of the last frame
+//while other pixels write theirs. Entries are tagged with the frame, so pixels that stored nothing don't need to be cleared.
+#pragma once
+#include "ShaderTypes.h"
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    struct ReprojectedSample
+    {
+        float3 worldPosition; //Position the closest samples were searched for
+        uint2 lods;           //Level and previous level the seeds are on
+        uint32_t seed;
+        uint32_t prevSeed;    //0 when both levels are the same
+        float3 sample;
+        uint32_t frame;
+    };
+
+    class ReprojectionCache
+    {
+    public:
+        ReprojectionCache(uint32_t width, uint32_t height)
+            : m_Width(width)
+            , m_Height(height)
+            , m_PrevViewProjection()
+        {
+            for (std::vector<ReprojectedSample>& entries : m_Entries)
+                entries.resize(size_t(width) * height, ReprojectedSample{ float3{ 0.f, 0.f, 0.f }, uint2{ 0, 0 }, 0, 0, float3{ 0.f, 0.f, 0.f }, 0 });
+        }
+
+        //Entry of last frame at the pixel worldPosition was visible at, nullptr when that pixel is off screen, stored nothing,
+        //has other levels or searched further than maxDistance away from worldPosition
+        ReprojectedSample const* Find(float3 const& worldPosition, uint2 lods, float maxDistance) const
+        {
+            //Inverse of DepthToWorldPosition, rounded to the nearest pixel
+            float4 const clip = mul(m_PrevViewProjection, float4{ worldPosition.x, worldPosition.y, worldPosition.z, 1.f });
+            if (!(clip.w > 0.f))
+                return nullptr;
+            float const x = std::floor(((clip.x / clip.w) * 0.5f + 0.5f) * float(m_Width) + 0.5f);
+            float const y = std::floor((0.5f - (clip.y / clip.w) * 0.5f) * float(m_Height) + 0.5f);
+            if (!(x >= 0.f && x < float(m_Width) && y >= 0.f && y < float(m_Height)))
+                return nullptr;
+
+            ReprojectedSample const& entry = m_Entries[m_Current ^ 1][uint32_t(x) + uint32_t(y) * m_Width];
+            if (entry.frame != m_Frame - 1 || entry.lods.x != lods.x || entry.lods.y != lods.y)
+                return nullptr;
+            float3 const offset = entry.worldPosition - worldPosition;
+            return dot(offset, offset) < maxDistance * maxDistance ? &entry : nullptr;
+        }
+
+        //Keeps the closest samples of pixel index for the next frame
+        void Store(uint32_t index, ReprojectedSample const& entry)
+        {
+            ReprojectedSample& stored = m_Entries[m_Current][index];
+            stored = entry;
+            stored.frame = m_Frame;
+        }
+
+        //Call once the pixels of a frame are stored, viewProjection is the camera of that frame
+        void EndFrame(float4x4 const& viewProjection)
+        {
+            m_PrevViewProjection = viewProjection;
+            m_Current ^= 1;
+            if (++m_Frame != 0)
+                return;
+
+            for (std::vector<ReprojectedSample>& entries : m_Entries)
+                for (ReprojectedSample& entry : entries)
+                    entry.frame = 0;
+            m_Frame = 2;
+        }
+
+    private:
+        uint32_t m_Width;
+        uint32_t m_Height;
+        std::vector<ReprojectedSample> m_Entries[2];
+        uint32_t m_Current = 0;
+        uint32_t m_Frame = 2; //Entries start at frame 0, which is never the last frame
+        float4x4 m_PrevViewProjection;
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,307 @@
+//World cache store that grows and shrinks with the amount of live implicit points, without a stop-the-world rehash.
+//A resize allocates the new table and every Maintain call moves a bounded amount of slots of the old table into it.
+//Until the old table is drained, lookups check the new table first and the old one second, inserts always go to the new
+//table. Insert/Lookup are safe from any number of threads, Maintain must not run concurrently with them (it is a pass).
+//Maintain also ages the entries: every slot remembers the frame it was last written in and a clock hand sweeps a bounded
+//amount of slots per frame, evicting the entries that were not touched for maxAge frames. A key touched since the hand
+//last passed gets a second chance, so the working set stays bounded to what was seen recently during long walkthroughs.
+//Slots without TracksLastTouched (CompactKeyDataSlot) are never evicted.
+#pragma once
+#include "HashTable.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+namespace ImplicitPointCPU
+{
+    struct ResizePolicy
+    {
+        uint32_t initialCapacity = 1048576;        //Also the minimum capacity when shrinking
+        uint32_t minInsertHeadroom = 1048576;      //New keys a frame may add before the first Maintain call, a full table
+                                                   //drops inserts and makes every lookup that misses walk the probe bound
+        float maxLoadFactor = 0.5f;                //Grow when the expected size of the next frame is above
+        float minLoadFactor = 0.125f;              //Shrink /2 when below
+        uint32_t migrationSlotsPerStep = 524288;   //Slots of the old table moved per Maintain call
+        bool orderedMigration = false;             //Migrate on one thread in slot order, so the layout of the new table
+                                                   //doesn't depend on the thread count
+    };
+
+    struct EvictionPolicy
+    {
+        uint32_t maxAge = 3600;                    //Frames without a write before an entry is evicted, 0 = never evict
+        uint32_t sweepSlotsPerStep = 262144;       //Minimum slots the clock hand passes per Maintain call, at least a full
+                                                   //revolution per maxAge frames so no entry overstays twice its age
+    };
+
+    template<typename Slot, uint32_t MaxProbeGroups = 64, typename HomeGroup = ModuloHomeGroup>
+    class ResizableHashTable
+    {
+    public:
+        typedef ConcurrentHashTable<Slot, MaxProbeGroups, HomeGroup> Table;
+
+        //maximumCapacity bounds the memory like the fixed size table of the GPU version does
+        ResizableHashTable(ResizePolicy const& policy, EvictionPolicy const& eviction, uint32_t maximumCapacity)
+            : m_Policy(policy)
+            , m_Eviction(eviction)
+            , m_MaximumCapacity(std::max(maximumCapacity, policy.initialCapacity))
+            , m_InsertHeadroom(policy.minInsertHeadroom)
+        {
+            uint64_t capacity = std::min(policy.initialCapacity, m_MaximumCapacity);
+            while (capacity < m_MaximumCapacity && !Fits(0, uint32_t(capacity)))
+                capacity *= 2;
+            m_pCurrent.reset(new Table(uint32_t(std::min(capacity, uint64_t(m_MaximumCapacity)))));
+            m_pCurrent->SetFrame(m_Frame);
+        }
+
+        ResizableHashTable(ResizableHashTable const&) = delete;
+        ResizableHashTable& operator=(ResizableHashTable const&) = delete;
+
+        bool Insert(uint32_t key, uint32_t value, uint32_t count)
+        {
+            return m_pCurrent->Insert(key, value, count);
+        }
+
+        KeyData Lookup(uint32_t key) const
+        {
+            KeyData data = m_pCurrent->Lookup(key);
+            if (data.key == 0 && m_pPrevious && !IsMigrated(key))
+                data = m_pPrevious->Lookup(key);
+            return data;
+        }
+
+        //Capacity of the table inserts go to, the table being drained is not included
+        uint32_t GetCapacity() const { return m_pCurrent->GetCapacity(); }
+        //Entries in the new table plus the ones of the old table that were not migrated yet. Upper bound while migrating:
+        //a key updated after the resize is in both tables until its old slot is migrated.
+        uint32_t GetSize() const { return m_pCurrent->GetSize() + (m_pPrevious ? m_MigrationRemaining : 0); }
+        //Bytes of slot storage, including the old table while it is being drained
+        uint64_t GetMemoryUsage() const
+        {
+            uint64_t const slots = uint64_t(m_pCurrent->GetCapacity()) + (m_pPrevious ? m_pPrevious->GetCapacity() : 0);
+            return slots * sizeof(Slot);
+        }
+        bool IsMigrating() const { return m_pPrevious != nullptr; }
+        //[0, 1] progress of the running migration, 1 when no migration is running
+        float GetMigrationProgress() const
+        {
+            return m_pPrevious ? float(m_MigrationCursor) / float(m_pPrevious->GetCapacity()) : 1.f;
+        }
+        uint32_t GetFrame() const { return m_Frame; }
+        //Table inserts go to, holds every entry when no migration is running
+        Table const& GetTable() const { return *m_pCurrent; }
+        uint32_t GetResizeCount() const { return m_ResizeCount; }
+        uint64_t GetEvictedCount() const { return m_EvictedCount; }
+        uint32_t GetLastEvictedCount() const { return m_LastEvictedCount; }  //Evicted by the last Maintain call
+        //Times the clock hand wrapped around the live table. A resize restarts the hand at slot 0, so once it wrapped twice
+        //after frame F + maxAge, every entry last written up to frame F is evicted.
+        uint32_t GetSweepRevolutionCount() const { return m_SweepRevolutionCount; }
+        float GetOccupancy() const { return float(GetSize()) / float(GetCapacity()); }
+        HashTableStatistics ComputeStatistics() const { return m_pCurrent->ComputeStatistics(); }
+
+        //Advances a running migration by one step, or starts a resize when the load factor left the policy range or
+        //an insert ran into the probe bound. Without a running migration the clock hand sweeps for cold entries.
+        //Call once per frame, after the passes that insert, it also starts the next frame for the aging.
+        //The table has to absorb a whole frame of inserts without growing, so it keeps headroom for twice the largest amount
+        //of slots a frame claimed so far.
+        void Maintain(ThreadPool& threadPool)
+        {
+            uint32_t const currentSize = m_pCurrent->GetSize();
+            if (m_pPrevious)
+            {
+                //Updated keys move to the new table early, so its claims don't say much about the amount of new keys.
+                //Fallback: the new table must never fill up before the old one is drained, finish in one go.
+                uint32_t slots = m_Policy.migrationSlotsPerStep;
+                if (currentSize > uint32_t(m_Policy.maxLoadFactor * m_pCurrent->GetCapacity()))
+                    slots = m_pPrevious->GetCapacity();
+                MigrateSlots(threadPool, slots);
+                m_LastCurrentSize = m_pCurrent->GetSize();
+                m_LastEvictedCount = 0;
+                NextFrame();
+                return;
+            }
+
+            if (currentSize > m_LastCurrentSize)
+                m_InsertHeadroom = std::max(m_InsertHeadroom, (currentSize - m_LastCurrentSize) * 2);
+
+            m_LastEvictedCount = Sweep();
+            m_EvictedCount += m_LastEvictedCount;
+
+            uint32_t const size = m_pCurrent->GetSize();
+            uint32_t const capacity = m_pCurrent->GetCapacity();
+            if ((!Fits(size, capacity) || m_pCurrent->GetFailedInsertCount() > 0) && capacity < m_MaximumCapacity)
+            {
+                uint64_t newCapacity = uint64_t(capacity) * 2;
+                while (newCapacity < m_MaximumCapacity && !Fits(size, uint32_t(newCapacity)))
+                    newCapacity *= 2;
+                BeginResize(uint32_t(std::min(newCapacity, uint64_t(m_MaximumCapacity))));
+            }
+            else if (size + m_InsertHeadroom < uint32_t(m_Policy.minLoadFactor * capacity) && capacity / 2 >= m_Policy.initialCapacity)
+            {
+                BeginResize(capacity / 2);
+            }
+            m_LastCurrentSize = m_pCurrent->GetSize();
+            NextFrame();
+        }
+
+        //Moves all remaining entries of a running migration at once, e.g. before taking a snapshot of GetTable()
+        void FinishMigration(ThreadPool& threadPool)
+        {
+            if (m_pPrevious)
+                MigrateSlots(threadPool, m_pPrevious->GetCapacity());
+        }
+
+        //Warm start from a table that lives in memory owned by pOwner, like a mapped snapshot. Its entries are used in
+        //place right away and migrate into a new live table like during a resize, pOwner is released once they did.
+        //Only possible while the table is empty and not migrating. frame is the frame the entries were stamped up to.
+        bool WarmStart(std::unique_ptr<Table> pTable, uint32_t frame, std::shared_ptr<void const> pOwner)
+        {
+            if (m_pPrevious || m_pCurrent->GetSize() != 0 || !pTable)
+                return false;
+
+            uint32_t const size = pTable->GetSize();
+            uint64_t capacity = m_pCurrent->GetCapacity();
+            while (capacity < m_MaximumCapacity && !Fits(size, uint32_t(capacity)))
+                capacity *= 2;
+
+            m_Frame = std::max(m_Frame, frame + 1);
+            m_pPrevious = std::move(pTable);
+            m_pPreviousOwner = std::move(pOwner);
+            m_pCurrent.reset(new Table(uint32_t(std::min(capacity, uint64_t(m_MaximumCapacity)))));
+            m_pCurrent->SetFrame(m_Frame);
+            m_MigrationCursor = 0;
+            m_MigrationRemaining = size;
+            m_ClockHand = 0;
+            m_LastCurrentSize = 0;
+            return true;
+        }
+
+    private:
+        ResizePolicy m_Policy;
+        EvictionPolicy m_Eviction;
+        uint32_t m_MaximumCapacity;
+        uint32_t m_InsertHeadroom;
+        std::unique_ptr<Table> m_pCurrent;
+        std::unique_ptr<Table> m_pPrevious;   //Table being drained, nullptr when no migration is running
+        std::shared_ptr<void const> m_pPreviousOwner; //Keeps the memory of a warm start table alive
+        uint32_t m_MigrationCursor = 0;       //Slots of m_pPrevious below the cursor are migrated
+        uint32_t m_MigrationRemaining = 0;    //Occupied slots of m_pPrevious at or above the cursor
+        uint32_t m_ResizeCount = 0;
+        uint32_t m_LastCurrentSize = 0;       //Size of m_pCurrent at the end of the previous Maintain call
+        uint32_t m_Frame = 1;                 //Stamped on written slots, 0 is left for slots that were never written
+        uint32_t m_ClockHand = 0;
+        uint32_t m_SweepRevolutionCount = 0;
+        uint64_t m_EvictedCount = 0;
+        uint32_t m_LastEvictedCount = 0;
+
+        //True when every slot the key could occupy in the old table is below the migration cursor
+        bool IsMigrated(uint32_t key) const
+        {
+            uint64_t const homeSlot = uint64_t(m_pPrevious->GetHomeGroup(key)) * Table::SlotsPerGroup;
+            return homeSlot + uint64_t(MaxProbeGroups) * Table::SlotsPerGroup <= m_MigrationCursor;
+        }
+
+        void NextFrame()
+        {
+            ++m_Frame;
+            m_pCurrent->SetFrame(m_Frame);
+        }
+
+        //Clock sweep over m_pCurrent, returns the amount of evicted entries
+        uint32_t Sweep()
+        {
+            if (m_Eviction.maxAge == 0 || !Slot::TracksLastTouched)
+                return 0;
+
+            Table& table = *m_pCurrent;
+            uint32_t const capacity = table.GetCapacity();
+            uint32_t const revolutionSteps = (capacity + m_Eviction.maxAge - 1) / m_Eviction.maxAge;
+            uint32_t const steps = std::min(std::max(m_Eviction.sweepSlotsPerStep, revolutionSteps), capacity);
+            uint32_t evicted = 0;
+            if (m_ClockHand >= capacity)
+                m_ClockHand = 0;
+
+            for (uint32_t step = 0; step < steps; ++step)
+            {
+                if (table.LookupBySlotID(m_ClockHand).key != 0 && m_Frame - table.GetLastTouchedBySlotID(m_ClockHand) > m_Eviction.maxAge)
+                {
+                    //The backward shift can move an entry into the slot under the hand, so look at it again
+                    table.EraseSlot(m_ClockHand);
+                    ++evicted;
+                    continue;
+                }
+                m_ClockHand = (m_ClockHand + 1 == capacity) ? 0 : m_ClockHand + 1;
+                m_SweepRevolutionCount += m_ClockHand == 0 ? 1 : 0;
+            }
+            return evicted;
+        }
+
+        bool Fits(uint32_t size, uint32_t capacity) const
+        {
+            return uint64_t(size) + m_InsertHeadroom <= uint64_t(m_Policy.maxLoadFactor * capacity);
+        }
+
+        void BeginResize(uint32_t capacity)
+        {
+            m_pPrevious = std::move(m_pCurrent);
+            m_pCurrent.reset(new Table(capacity));
+            m_pCurrent->SetFrame(m_Frame);
+            m_MigrationCursor = 0;
+            m_ClockHand = 0;
+            m_MigrationRemaining = m_pPrevious->GetSize();
+            ++m_ResizeCount;
+        }
+
+        void MigrateSlots(ThreadPool& threadPool, uint32_t slotCount)
+        {
+            uint32_t const begin = m_MigrationCursor;
+            uint32_t const end = uint32_t(std::min(uint64_t(begin) + slotCount, uint64_t(m_pPrevious->GetCapacity())));
+            uint32_t const slotsPerJob = m_Policy.orderedMigration ? std::max(end - begin, 1u) : 4096;
+            std::atomic<uint32_t> migrated(0);
+
+            //An entry that was inserted in the new table after the resize is newer than the old one, so it wins
+            threadPool.ParallelFor((end - begin + slotsPerJob - 1) / slotsPerJob, [&](uint32_t job, uint32_t /*threadIndex*/)
+            {
+                uint32_t const jobBegin = begin + job * slotsPerJob;
+                uint32_t const jobEnd = std::min(jobBegin + slotsPerJob, end);
+                uint32_t jobMigrated = 0;
+                for (uint32_t slotID = jobBegin; slotID < jobEnd; ++slotID)
+                {
+                    KeyData const data = m_pPrevious->LookupBySlotID(slotID);
+                    if (data.key == 0)
+                        continue;
+                    m_pCurrent->InsertIfAbsent(data.key, data.value, data.count, m_pPrevious->GetLastTouchedBySlotID(slotID));
+                    ++jobMigrated;
+                }
+                migrated.fetch_add(jobMigrated, std::memory_order_relaxed);
+            });
+
+            m_MigrationCursor = end;
+            m_MigrationRemaining -= std::min(m_MigrationRemaining, migrated.load(std::memory_order_relaxed));
+            if (m_MigrationCursor == m_pPrevious->GetCapacity())
+            {
+                m_pPrevious.reset();
+                m_pPreviousOwner.reset();
+                m_MigrationCursor = 0;
+                m_MigrationRemaining = 0;
+            }
+        }
+    };
+
+    //With IMPLICITPOINT_SPATIAL_SEEDS (project wide, see GetNeighbourVoxelSeed) the seeds start with a hash of the bucket
+    //they are in, the world hash table keeps the points of a bucket in neighbouring groups. The "spatialkeys" benchmark compares
+    //the cache lines and pages the reconstruction touches with both layouts.
+#if defined(IMPLICITPOINT_SPATIAL_SEEDS)
+    typedef RangeHomeGroup WorldHomeGroup;
+#else
+    typedef ModuloHomeGroup WorldHomeGroup;
+#endif
+
+    //Define to store the world hash table in CompactKeyDataSlots: half the memory and bandwidth of KeyDataSlot, at the cost
+    //of quantized values and counts and no eviction. The "compactslot" benchmark measures the error on recorded frames.
+    //#define IMPLICITPOINT_COMPACT_WORLD_HASH_TABLE
+#if defined(IMPLICITPOINT_COMPACT_WORLD_HASH_TABLE)
+    typedef ResizableHashTable<CompactKeyDataSlot, 64, WorldHomeGroup> WorldHashTable;
+#else
+    typedef ResizableHashTable<KeyDataSlot, 64, WorldHomeGroup> WorldHashTable;
+#endif
+} //namespace ImplicitPointCPU
@@ -0,0 +1,58 @@
+#include "SampleGenerationBatch.h"
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        typedef void (*SampleKernel)(float const*, float const*, float const*, uint32_t const*, uint32_t, uint32_t, uint32_t,
+            uint32_t*, float*, float*, float*);
+
+        uint32_t const MaxLanes = 16;
+
+        //Transposes the positions into structure of arrays, pads the tail by repeating the last position
+        void RunKernel(SampleKernel kernel, uint32_t lanes, float3 const* positions, uint32_t const* levels, uint32_t count,
+            uint32_t discreteCellSize, uint32_t voxelConnectivity, uint32_t maxLevels, ClosestPointSample* results)
+        {
+            float x[MaxLanes], y[MaxLanes], z[MaxLanes];
+            uint32_t l[MaxLanes];
+            uint32_t seed[MaxLanes];
+            float sampleX[MaxLanes], sampleY[MaxLanes], sampleZ[MaxLanes];
+
+            for (uint32_t start = 0; start < count; start += lanes)
+            {
+                uint32_t const valid = min(lanes, count - start);
+                for (uint32_t i = 0; i < lanes; ++i)
+                {
+                    uint32_t const source = start + min(i, valid - 1);
+                    x[i] = positions[source].x;
+                    y[i] = positions[source].y;
+                    z[i] = positions[source].z;
+                    l[i] = levels[source];
+                }
+
+                kernel(x, y, z, l, discreteCellSize, voxelConnectivity, maxLevels, seed, sampleX, sampleY, sampleZ);
+
+                for (uint32_t i = 0; i < valid; ++i)
+                {
+                    results[start + i].seed = seed[i];
+                    results[start + i].sample = float3{ sampleX[i], sampleY[i], sampleZ[i] };
+                }
+            }
+        }
+    }
+
+    void GetGeneratedSampleBatch(float3 const* positions, uint32_t const* levels, uint32_t count, uint32_t discreteCellSize,
+        uint32_t voxelConnectivity, uint32_t maxLevels, ClosestPointSample* results, SimdWidth width)
+    {
+        width = min(width, GetMaxSimdWidth());
+        if (width == SimdWidth::AVX512)
+            RunKernel(&GetGeneratedSampleAVX512, 16, positions, levels, count, discreteCellSize, voxelConnectivity, maxLevels, results);
+        else if (width == SimdWidth::AVX2)
+            RunKernel(&GetGeneratedSampleAVX2, 8, positions, levels, count, discreteCellSize, voxelConnectivity, maxLevels, results);
+        else
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                results[i] = GetGeneratedSample(positions[i], discreteCellSize, levels[i], voxelConnectivity, maxLevels);
+        }
+    }
+} //namespace ImplicitPointCPU
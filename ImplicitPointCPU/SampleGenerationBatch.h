@@ -0,0 +1,21 @@
+//Batched GetGeneratedSample: 8 (AVX2) or 16 (AVX-512) positions per call into the SIMD kernel, bit-exact with the scalar port.
+//The kernels are compiled without FMA contraction (NoFloatContraction.h), which the bit-exact results depend on.
+#pragma once
+#include "SampleGenerationFunctions.h"
+#include "CpuFeatures.h"
+
+namespace ImplicitPointCPU
+{
+    //Generates the closest sample for count positions, every position on its own LOD level.
+    //width is clamped to what the CPU supports, SimdWidth::Scalar runs the scalar reference.
+    void GetGeneratedSampleBatch(float3 const* positions, uint32_t const* levels, uint32_t count, uint32_t discreteCellSize,
+        uint32_t voxelConnectivity, uint32_t maxLevels, ClosestPointSample* results, SimdWidth width);
+
+    //Instruction set specific entry points, process exactly 8 / 16 lanes of structure of arrays data
+    void GetGeneratedSampleAVX2(float const* positionX, float const* positionY, float const* positionZ, uint32_t const* levels,
+        uint32_t discreteCellSize, uint32_t voxelConnectivity, uint32_t maxLevels,
+        uint32_t* outSeed, float* outSampleX, float* outSampleY, float* outSampleZ);
+    void GetGeneratedSampleAVX512(float const* positionX, float const* positionY, float const* positionZ, uint32_t const* levels,
+        uint32_t discreteCellSize, uint32_t voxelConnectivity, uint32_t maxLevels,
+        uint32_t* outSeed, float* outSampleX, float* outSampleY, float* outSampleZ);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,16 @@
+//Compiled with AVX2 enabled (/arch:AVX2, -mavx2), only reached through the runtime dispatch in SampleGenerationBatch.cpp
+#include "NoFloatContraction.h"
+#include "SampleGenerationBatch.h"
+#include "SimdAVX2.h"
+#include "SampleGenerationKernel.h"
+
+namespace ImplicitPointCPU
+{
+    void GetGeneratedSampleAVX2(float const* positionX, float const* positionY, float const* positionZ, uint32_t const* levels,
+        uint32_t discreteCellSize, uint32_t voxelConnectivity, uint32_t maxLevels,
+        uint32_t* outSeed, float* outSampleX, float* outSampleY, float* outSampleZ)
+    {
+        SampleGenerationKernel<SimdAVX2>::GetGeneratedSample(positionX, positionY, positionZ, levels, discreteCellSize, voxelConnectivity, maxLevels,
+            outSeed, outSampleX, outSampleY, outSampleZ);
+    }
+} //namespace ImplicitPointCPU
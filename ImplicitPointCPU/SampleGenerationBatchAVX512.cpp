@@ -0,0 +1,17 @@
+//Compiled with AVX-512 enabled (/arch:AVX512, -mavx512f -mavx512dq -mavx512bw -mavx512vl), only reached through the
+//runtime dispatch in SampleGenerationBatch.cpp
+#include "NoFloatContraction.h"
+#include "SampleGenerationBatch.h"
+#include "SimdAVX512.h"
+#include "SampleGenerationKernel.h"
+
+namespace ImplicitPointCPU
+{
+    void GetGeneratedSampleAVX512(float const* positionX, float const* positionY, float const* positionZ, uint32_t const* levels,
+        uint32_t discreteCellSize, uint32_t voxelConnectivity, uint32_t maxLevels,
+        uint32_t* outSeed, float* outSampleX, float* outSampleY, float* outSampleZ)
+    {
+        SampleGenerationKernel<SimdAVX512>::GetGeneratedSample(positionX, positionY, positionZ, levels, discreteCellSize, voxelConnectivity, maxLevels,
+            outSeed, outSampleX, outSampleY, outSampleZ);
+    }
+} //namespace ImplicitPointCPU
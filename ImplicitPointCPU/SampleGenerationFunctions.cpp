@@ -0,0 +1,124 @@
+#include "SampleGenerationFunctions.h"
+#include <cfloat>
+
+namespace ImplicitPointCPU
+{
+    int3 const NeighbourOffsets[27] =
+    {
+        int3{ 0, 0, 0 }, //No Connectivity runs until here, which is 1 element
+
+        int3{ -1, 0, 0 },
+        int3{ 1, 0, 0 },
+        int3{ 0, 1, 0 },
+        int3{ 0, -1, 0 },
+        int3{ 0, 0, -1 },
+        int3{ 0, 0, 1 }, //6 Connectivity runs until here, which is 7 elements
+
+        int3{ -1, 1, 0 },
+        int3{ -1, -1, 0 },
+        int3{ 1, -1, 0 },
+        int3{ 1, 1, 0 },
+
+        int3{ -1, 0, 1 },
+        int3{ 1, 0, 1 },
+        int3{ 0, 1, 1 },
+        int3{ 0, -1, 1 },
+
+        int3{ -1, 0, -1 },
+        int3{ 1, 0, -1 },
+        int3{ 0, 1, -1 },
+        int3{ 0, -1, -1 }, //18 Connectivity runs until here, which is 19 elements
+
+        int3{ -1, 1, 1 },
+        int3{ -1, -1, 1 },
+        int3{ 1, -1, 1 },
+        int3{ 1, 1, 1 },
+        int3{ -1, 1, -1 },
+        int3{ -1, -1, -1 },
+        int3{ 1, -1, -1 },
+        int3{ 1, 1, -1 } //26 Connectivity runs until here, which is 27 elements
+    };
+
+    void GetClosestSampleTriplet(float3 const& pos, float3 const& absSample, uint32_t seed, ClosestPointSample closestSamples[3])
+    {
+        //Calculate the square distance
+        float3 const diff = pos - absSample;
+        float const currentSqrDistance = dot(diff, diff);
+
+        //Find if closer than one of the three cached distances, and if so, which one
+        int32_t foundIndex = -1;
+        float largestFoundDistance = 0.f;
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            float3 const cachedDiff = pos - closestSamples[i].sample;
+            float const cachedSqrDistance = dot(cachedDiff, cachedDiff);
+            if (currentSqrDistance < cachedSqrDistance && largestFoundDistance < cachedSqrDistance)
+            {
+                foundIndex = i;
+                largestFoundDistance = cachedSqrDistance;
+            }
+        }
+
+        //Replace the one with the largest distance with this new closest sample
+        if (foundIndex != -1)
+        {
+            closestSamples[foundIndex].sample = absSample;
+            closestSamples[foundIndex].seed = seed;
+        }
+    }
+
+    uint32_t GetIndexByProbability(float3 const& position, ClosestPointSample const closestSamples[3])
+    {
+        //Create probability values based on "area" (actually just distances)
+        float3 const distances = {
+            dot(position - closestSamples[0].sample, position - closestSamples[0].sample),
+            dot(position - closestSamples[1].sample, position - closestSamples[1].sample),
+            dot(position - closestSamples[2].sample, position - closestSamples[2].sample) };
+        float3 areas = {
+            distances[1] * distances[2],
+            distances[0] * distances[2],
+            distances[0] * distances[1] };
+        float const totalArea = areas.x + areas.y + areas.z;
+        areas = areas / totalArea; //normalize
+
+        //Get random normalized value, seed based on position
+        float const randomValue = randomNormalizedFloat(GetSeed(position, 15));
+
+        //Get index based on probability - saturate(uint(x)) is 1 once x >= 1
+        return (ToUint(randomValue / areas.x) >= 1u ? 1u : 0u) + (ToUint(randomValue / (areas.x + areas.y)) >= 1u ? 1u : 0u);
+    }
+
+    ClosestPointSample GetGeneratedSample(float3 const& position, uint32_t discreteCellSize, uint32_t level, uint32_t voxelConnectivity, uint32_t maxLevels)
+    {
+        //Triplet use
+        ClosestPointSample closestSamples[3];
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            closestSamples[i].sample = float3{ FLT_MAX, FLT_MAX, FLT_MAX };
+            closestSamples[i].seed = 0;
+        }
+
+        //Discretize position based on discrete cell size and current level
+        float const deltaOnLevel = 1.f / float(IntPow2(level));
+        float const cellSizeBasedOnLevel = float(discreteCellSize) * deltaOnLevel;
+        float3 const discretePosition = Discretize(position, cellSizeBasedOnLevel);
+
+        //For that discrete position, interate over all the neighbouring voxels(based on the size of cell size)
+        for (uint32_t v = 0; v < (voxelConnectivity + 1); ++v)
+        {
+            NeighbourVoxel const neighbour = GetNeighbourVoxel(discretePosition, v, cellSizeBasedOnLevel, deltaOnLevel, discreteCellSize, maxLevels);
+
+            //Random point technique, using random implicit points
+            for (uint32_t i = 0; i < 8; ++i)
+            {
+                uint32_t const currentSeed = neighbour.seed + i;
+                float3 const normalizedSample = GenerateSampleInVoxelQuadrant(neighbour.seed, level, i);
+                float3 const absoluteSample = neighbour.position + (normalizedSample * cellSizeBasedOnLevel);
+                GetClosestSampleTriplet(position, absoluteSample, currentSeed, closestSamples);
+            }
+        }
+
+        uint32_t const index = GetIndexByProbability(position, closestSamples);
+        return closestSamples[index];
+    }
+} //namespace ImplicitPointCPU
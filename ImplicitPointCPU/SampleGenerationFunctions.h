@@ -0,0 +1,163 @@
+//CPU port of Shaders/SampleGenerationFunctions.hlsli
+//Only the active technique of GetGeneratedSample is ported (random implicit points + probability based triplet selection).
+#pragma once
+#include "ShaderTypes.h"
+#include "HashFunctions.h"
+#include "SharedUtilities.h"
+
+namespace ImplicitPointCPU
+{
+    //Voxel Connectivity Data: 0 connectivity uses 1 element, 6 uses 7, 18 uses 19 and 26 uses all 27
+    extern int3 const NeighbourOffsets[27];
+
+    //Struct used to cache closest points - not necessarly what you would store in the final buffers
+    struct ClosestPointSample
+    {
+        uint32_t seed;
+        float3 sample;
+    };
+
+    //Implicit voxel next to the discretized position, shared by sample generation and reconstruction
+    struct NeighbourVoxel
+    {
+        float3 position; //Discrete position of the neighbour on the current level
+        uint32_t seed;   //Absolute seed, the implicit points use seed + quadrant
+    };
+
+    //Returns the delta value for the level in normalized range
+    inline float GetCellDelta(uint32_t level)
+    {
+        return 1.f / float(IntPow2(level + 1));
+    }
+
+    //Returns an int3 where each component represents the offset direction
+    //E.g. (1,1,0) == RightBottomFront Voxel Offsets - TopLeft corners are the origin
+    inline int3 OffsetVectorFromQuadrant(uint32_t quadrant)
+    {
+        return int3{
+            int32_t((quadrant & 2) >> 1),   //Left vs Right: xx0x
+            int32_t(quadrant & 1),          //Top vs Bottom: xxx0
+            int32_t((quadrant & 4) >> 2) }; //Front vs Back: x0xx
+    }
+
+    //Generate a sample in the voxel within a certain quadrant.
+    //The sample is a normalized value within the voxel itself.
+    inline float3 GenerateSampleInVoxelQuadrant(uint32_t seed, uint32_t /*level*/, uint32_t quadrant)
+    {
+        //Generate normalized sample, based on seed and offset based on quadrant (progressive required)
+        float3 const sample = hash3(seed + quadrant);
+        float3 const offsets = ToFloat3(OffsetVectorFromQuadrant(quadrant));
+        float const cellDelta = 0.5f;
+        //Return remapped to level
+        return (offsets * cellDelta) + (sample / (1.f / cellDelta));
+    }
+
+    //Get seed value based on discretized position
+    template<typename Hash = SeedHash>
+    inline uint32_t GetSeed(float3 const& discretePos, uint32_t fixedPointFractionalBits)
+    {
+        //Convert float value to fixed point representation for hash functions
+        uint3 const fp = ToFixedPoint(discretePos, fixedPointFractionalBits);
+        return Hash::Hash(fp);
+    }
+
+    //Fixed point representation of the discretized position that GetSeedWithSignedBits hashes
+    inline uint3 ToSignedFixedPoint(float3 const& discretePos, uint32_t fixedPointFractionalBits)
+    {
+        //Putting the signs of all 3 axis in the 3 most significant bits
+        uint32_t const fracScale = 1u << fixedPointFractionalBits;
+
+        float3 const rawFractionalPart = frac(discretePos);
+        float3 const rawIntegerPart = trunc(discretePos);
+
+        uint3 const fp = ToUint3(rawFractionalPart * float(fracScale)); //fractional part
+        uint3 const ai = ToUint3(abs(rawIntegerPart));
+        uint3 const ip = { //shifted integer part
+            (ai.x << fixedPointFractionalBits) & 0x1FFFFFFFu,
+            (ai.y << fixedPointFractionalBits) & 0x1FFFFFFFu,
+            (ai.z << fixedPointFractionalBits) & 0x1FFFFFFFu };
+        uint32_t const xp = uint32_t(clamp(sign(rawIntegerPart.x) * -1, 0, 1)) << 31;
+        uint32_t const yp = uint32_t(clamp(sign(rawIntegerPart.y) * -1, 0, 1)) << 30;
+        uint32_t const zp = uint32_t(clamp(sign(rawIntegerPart.z) * -1, 0, 1)) << 29;
+
+        return uint3{ xp | fp.x | ip.x, yp | fp.y | ip.y, zp | fp.z | ip.z };
+    }
+
+    //Get seed value based on discretized position - storing the signs from every axis in the most significant bits
+    template<typename Hash = SeedHash>
+    inline uint32_t GetSeedWithSignedBits(float3 const& discretePos, uint32_t fixedPointFractionalBits)
+    {
+        return Hash::Hash(ToSignedFixedPoint(discretePos, fixedPointFractionalBits));
+    }
+
+    //Spatial seeds: the top SpatialSeedBucketBits bits hash the bucket the voxel is in, the voxel SpatialSeedBucketLevels levels
+    //up (4x4x4 voxels of the level), the low bits are the ones of GetSeedWithSignedBits. Tables with a RangeHomeGroup keep the
+    //points of a bucket in neighbouring groups, so the 27 neighbours of a pixel touch a few runs of cache lines instead of 216
+    //random ones. The bucket is hashed rather than Morton ordered: a bounded probe sequence can't absorb the dense buckets
+    //when neighbouring buckets share a table range as well.
+    uint32_t const SpatialSeedBucketBits = 16;
+    uint32_t const SpatialSeedBucketLevels = 2;
+
+    //Map to top-left-back vertex, taking into account negative space:
+    //+x = right, +y = up, +z = out of screen
+    inline float3 Discretize(float3 const& position, float cellSize)
+    {
+        float3 discretePosition = ToFloat3(ToInt3(position / cellSize)) * cellSize;
+        uint3 const signBits = asuint(position);
+        discretePosition -= ToFloat3(uint3{ signBits.x >> 31, signBits.y >> 31, signBits.z >> 31 }) * cellSize; //If negative value, map to topleft in negative space!
+        return discretePosition;
+    }
+
+    //Absolute position of neighbour v of the discrete position
+    inline float3 GetNeighbourPosition(float3 const& discretePosition, uint32_t v, float cellSizeBasedOnLevel)
+    {
+        return discretePosition + (ToFloat3(NeighbourOffsets[v]) * cellSizeBasedOnLevel);
+    }
+
+    //Absolute center position of the voxel at neighbourPosition (see GetNeighbourPosition), which seeds its implicit points
+    inline float3 GetNeighbourVoxelCenter(float3 const& neighbourPosition, float deltaOnLevel, uint32_t discreteCellSize)
+    {
+        //Get the top level discrete position of the neighbour position. This is due to the fact that we want to find the quadrant in a normalized
+        //fashion and the fact that the neighbour position might be in the same or another voxel as the position!
+        float3 const neighbourDiscreteTopPosition = Discretize(neighbourPosition, float(discreteCellSize));
+        float3 const normalizedRelativePosition = abs((neighbourDiscreteTopPosition - neighbourPosition) / float(int32_t(discreteCellSize)));
+        float const deltaNextLevel = deltaOnLevel * 0.5f;
+        float3 const centerNormalizedRelativePosition = normalizedRelativePosition + deltaNextLevel;
+        return neighbourDiscreteTopPosition + (centerNormalizedRelativePosition * float(discreteCellSize));
+    }
+
+    //GetSeedWithSignedBits behind the hash of the bucket of the voxel centered at acp on the level of deltaOnLevel
+    inline uint32_t GetSpatialSeedWithSignedBits(float3 const& acp, float deltaOnLevel, uint32_t discreteCellSize, uint32_t fixedPointFractionalBits)
+    {
+        //acp is a voxel center, never on the border of a bucket
+        float const bucketSize = float(discreteCellSize) * deltaOnLevel * float(1u << SpatialSeedBucketLevels);
+        int3 const bucket = ToInt3(Discretize(acp, bucketSize) / bucketSize);
+        uint32_t const bucketHash = pcg(pcg_nested(uint3{ uint32_t(bucket.x), uint32_t(bucket.y), uint32_t(bucket.z) }) + asuint(deltaOnLevel));
+        uint32_t const lowMask = (1u << (32 - SpatialSeedBucketBits)) - 1;
+        return (bucketHash & ~lowMask) | (GetSeedWithSignedBits(acp, fixedPointFractionalBits) & lowMask);
+    }
+
+    //Seed of the implicit points of the voxel at neighbourPosition (see GetNeighbourPosition).
+    //Define IMPLICITPOINT_SPATIAL_SEEDS for the whole project to use spatial seeds, the world hash table layout follows it.
+    inline uint32_t GetNeighbourVoxelSeed(float3 const& neighbourPosition, float deltaOnLevel, uint32_t discreteCellSize, uint32_t maxLevels)
+    {
+        float3 const acp = GetNeighbourVoxelCenter(neighbourPosition, deltaOnLevel, discreteCellSize);
+#if defined(IMPLICITPOINT_SPATIAL_SEEDS)
+        return GetSpatialSeedWithSignedBits(acp, deltaOnLevel, discreteCellSize, maxLevels);
+#else
+        return GetSeedWithSignedBits(acp, maxLevels);
+#endif
+    }
+
+    //Neighbour v of the discrete position, with the seed of its implicit points
+    inline NeighbourVoxel GetNeighbourVoxel(float3 const& discretePosition, uint32_t v, float cellSizeBasedOnLevel, float deltaOnLevel,
+        uint32_t discreteCellSize, uint32_t maxLevels)
+    {
+        float3 const neighbourPosition = GetNeighbourPosition(discretePosition, v, cellSizeBasedOnLevel);
+        return NeighbourVoxel{ neighbourPosition, GetNeighbourVoxelSeed(neighbourPosition, deltaOnLevel, discreteCellSize, maxLevels) };
+    }
+
+    void GetClosestSampleTriplet(float3 const& pos, float3 const& absSample, uint32_t seed, ClosestPointSample closestSamples[3]);
+    uint32_t GetIndexByProbability(float3 const& position, ClosestPointSample const closestSamples[3]);
+    ClosestPointSample GetGeneratedSample(float3 const& position, uint32_t discreteCellSize, uint32_t level, uint32_t voxelConnectivity, uint32_t maxLevels);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,231 @@
+//Lane-parallel version of GetGeneratedSample, written once against the SimdAVX2/SimdAVX512 interface.
+//Every lane follows the exact operation order of the scalar port in SampleGenerationFunctions, so results are bit-exact with it.
+//That holds only without FMA contraction: the translation units include NoFloatContraction.h first.
+//Only include this from the instruction set specific translation units (SampleGenerationBatchAVX2.cpp, ...).
+#pragma once
+#include "SampleGenerationFunctions.h"
+#include "HashFunctionsSimd.h"
+#include <cfloat>
+
+namespace ImplicitPointCPU
+{
+    template<typename S>
+    struct SampleGenerationKernel
+    {
+        typedef typename S::Float Float;
+        typedef typename S::Int Int;
+        typedef typename S::Mask Mask;
+
+        struct Float3
+        {
+            Float x, y, z;
+        };
+
+        //Triplet use, structure of arrays: one register per component per cached sample
+        struct Triplet
+        {
+            Float x[3], y[3], z[3];
+            Float sqrDistance[3]; //Cached, the scalar version recomputes the same value every time
+            Int seed[3];
+        };
+
+        //--------- CONVERSIONS & HASHES ---------
+        //Same as ToUint: negative and NaN map to 0, out of range saturates
+        static Int ToUint(Float value)
+        {
+            Float const twoPow31 = S::Set1(2147483648.f);
+            Int const small = S::TruncateToInt(value);
+            Int const large = S::Xor(S::TruncateToInt(S::Sub(value, twoPow31)), S::Set1(0x80000000u));
+            Int result = S::Select(S::GreaterEqual(value, twoPow31), large, small);
+            result = S::Select(S::GreaterEqual(value, S::Set1(4294967296.f)), S::Set1(0xFFFFFFFFu), result);
+            return S::MaskToInt(S::Greater(value, S::Set1(0.f)), result);
+        }
+
+        static Float3 Hash3(Int n)
+        {
+            Float3 hash;
+            HashLanes<S>::Hash3(n, hash.x, hash.y, hash.z);
+            return hash;
+        }
+
+        //--------- SAMPLE GENERATION FUNCTIONS ---------
+        static Float Discretize(Float position, Float cellSize)
+        {
+            Float const discretePosition = S::Mul(S::IntToFloat(S::TruncateToInt(S::Div(position, cellSize))), cellSize);
+            Float const signBit = S::IntToFloat(S::template ShiftRight<31>(S::AsInt(position)));
+            return S::Sub(discretePosition, S::Mul(signBit, cellSize));
+        }
+
+        static Int SignedBitsComponent(Float value, Float fracScale, uint32_t fixedPointFractionalBits, uint32_t signShift)
+        {
+            Float const rawFractionalPart = S::Sub(value, S::Floor(value));
+            Float const rawIntegerPart = S::Trunc(value);
+            Int const fp = ToUint(S::Mul(rawFractionalPart, fracScale));
+            Int const ip = S::And(S::ShiftLeft(ToUint(S::Abs(rawIntegerPart)), fixedPointFractionalBits), S::Set1(0x1FFFFFFFu));
+            Int const sp = S::MaskToInt(S::Less(rawIntegerPart, S::Set1(0.f)), S::Set1(1u << signShift));
+            return S::Or(S::Or(sp, fp), ip);
+        }
+
+        static Int GetSeedWithSignedBits(Float3 const& discretePos, uint32_t fixedPointFractionalBits)
+        {
+            Float const fracScale = S::Set1(float(1u << fixedPointFractionalBits));
+            return SeedHashLanes<S, SeedHash>::Hash(
+                SignedBitsComponent(discretePos.x, fracScale, fixedPointFractionalBits, 31),
+                SignedBitsComponent(discretePos.y, fracScale, fixedPointFractionalBits, 30),
+                SignedBitsComponent(discretePos.z, fracScale, fixedPointFractionalBits, 29));
+        }
+
+        static Int GetSpatialSeedWithSignedBits(Float3 const& acp, Float deltaOnLevel, Float cellSize, uint32_t fixedPointFractionalBits)
+        {
+            Float const bucketSize = S::Mul(S::Mul(cellSize, deltaOnLevel), S::Set1(float(1u << SpatialSeedBucketLevels)));
+            Int const bucketHash = HashLanes<S>::Pcg(S::Add(HashLanes<S>::PcgNested(
+                S::TruncateToInt(S::Div(Discretize(acp.x, bucketSize), bucketSize)),
+                S::TruncateToInt(S::Div(Discretize(acp.y, bucketSize), bucketSize)),
+                S::TruncateToInt(S::Div(Discretize(acp.z, bucketSize), bucketSize))), S::AsInt(deltaOnLevel)));
+            uint32_t const lowMask = (1u << (32 - SpatialSeedBucketBits)) - 1;
+            return S::Or(S::And(bucketHash, S::Set1(~lowMask)), S::And(GetSeedWithSignedBits(acp, fixedPointFractionalBits), S::Set1(lowMask)));
+        }
+
+        static Float SqrDistance(Float3 const& position, Float x, Float y, Float z)
+        {
+            Float const dx = S::Sub(position.x, x);
+            Float const dy = S::Sub(position.y, y);
+            Float const dz = S::Sub(position.z, z);
+            return S::Add(S::Add(S::Mul(dx, dx), S::Mul(dy, dy)), S::Mul(dz, dz));
+        }
+
+        //Branchless GetClosestSampleTriplet: the last cached sample that is further than the new one and further than
+        //the previously found ones gets replaced
+        static void UpdateTriplet(Float3 const& position, Float3 const& sample, Int seed, Triplet& triplet)
+        {
+            Float const currentSqrDistance = SqrDistance(position, sample.x, sample.y, sample.z);
+
+            Mask found[3];
+            Float largestFoundDistance = S::Set1(0.f);
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                Float const cachedSqrDistance = triplet.sqrDistance[i];
+                found[i] = S::MaskAnd(S::Less(currentSqrDistance, cachedSqrDistance), S::Less(largestFoundDistance, cachedSqrDistance));
+                largestFoundDistance = S::Select(found[i], cachedSqrDistance, largestFoundDistance);
+            }
+
+            Mask const replace[3] = {
+                S::MaskAndNot(S::MaskAndNot(found[0], found[1]), found[2]),
+                S::MaskAndNot(found[1], found[2]),
+                found[2] };
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                triplet.x[i] = S::Select(replace[i], sample.x, triplet.x[i]);
+                triplet.y[i] = S::Select(replace[i], sample.y, triplet.y[i]);
+                triplet.z[i] = S::Select(replace[i], sample.z, triplet.z[i]);
+                triplet.sqrDistance[i] = S::Select(replace[i], currentSqrDistance, triplet.sqrDistance[i]);
+                triplet.seed[i] = S::Select(replace[i], seed, triplet.seed[i]);
+            }
+        }
+
+        //GetIndexByProbability, returns the masks of the lanes that pick index 1 and index 2
+        static void GetIndexByProbability(Float3 const& position, Triplet const& triplet, Mask& pickSecond, Mask& pickThird)
+        {
+            Float const d0 = triplet.sqrDistance[0];
+            Float const d1 = triplet.sqrDistance[1];
+            Float const d2 = triplet.sqrDistance[2];
+            Float areaX = S::Mul(d1, d2);
+            Float areaY = S::Mul(d0, d2);
+            Float const areaZ = S::Mul(d0, d1);
+            Float const totalArea = S::Add(S::Add(areaX, areaY), areaZ);
+            areaX = S::Div(areaX, totalArea);
+            areaY = S::Div(areaY, totalArea);
+
+            //Get random normalized value, seed based on position (GetSeed with 15 fractional bits)
+            Float const fracScale = S::Set1(float(1u << 15));
+            Int const seed = SeedHashLanes<S, SeedHash>::Hash(
+                ToUint(S::Mul(S::Abs(position.x), fracScale)),
+                ToUint(S::Mul(S::Abs(position.y), fracScale)),
+                ToUint(S::Mul(S::Abs(position.z), fracScale)));
+            Float const randomValue = S::Mul(S::UintToFloat(HashLanes<S>::XorShift32(seed)), S::Set1(2.3283064365387e-10f));
+
+            //uint(x) >= 1 is the same as x >= 1 for every input, including NaN and infinity
+            Mask const first = S::GreaterEqual(S::Div(randomValue, areaX), S::Set1(1.f));
+            Mask const second = S::GreaterEqual(S::Div(randomValue, S::Add(areaX, areaY)), S::Set1(1.f));
+            pickThird = S::MaskAnd(first, second);
+            pickSecond = S::MaskAndNot(S::MaskOr(first, second), pickThird);
+        }
+
+        //Width lanes, structure of arrays in and out
+        static void GetGeneratedSample(float const* positionX, float const* positionY, float const* positionZ, uint32_t const* levels,
+            uint32_t discreteCellSize, uint32_t voxelConnectivity, uint32_t maxLevels,
+            uint32_t* outSeed, float* outSampleX, float* outSampleY, float* outSampleZ)
+        {
+            Float3 const position = { S::Load(positionX), S::Load(positionY), S::Load(positionZ) };
+            Int const level = S::Load(levels);
+
+            //Triplet use
+            Triplet triplet;
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                triplet.x[i] = S::Set1(FLT_MAX);
+                triplet.y[i] = S::Set1(FLT_MAX);
+                triplet.z[i] = S::Set1(FLT_MAX);
+                triplet.sqrDistance[i] = SqrDistance(position, triplet.x[i], triplet.y[i], triplet.z[i]);
+                triplet.seed[i] = S::Set1(0u);
+            }
+
+            //Discretize position based on discrete cell size and current level
+            Int const pow2 = S::ShiftLeftVariable(S::Set1(1u), S::And(level, S::Set1(31u)));
+            Float const deltaOnLevel = S::Div(S::Set1(1.f), S::IntToFloat(pow2));
+            Float const cellSize = S::Set1(float(discreteCellSize));
+            Float const cellSizeBasedOnLevel = S::Mul(cellSize, deltaOnLevel);
+            Float3 const discretePosition = {
+                Discretize(position.x, cellSizeBasedOnLevel),
+                Discretize(position.y, cellSizeBasedOnLevel),
+                Discretize(position.z, cellSizeBasedOnLevel) };
+            Float const signedCellSize = S::Set1(float(int32_t(discreteCellSize)));
+            Float const deltaNextLevel = S::Mul(deltaOnLevel, S::Set1(0.5f));
+
+            //For that discrete position, interate over all the neighbouring voxels(based on the size of cell size)
+            for (uint32_t v = 0; v < (voxelConnectivity + 1); ++v)
+            {
+                //Neighbour position and the seed of its implicit points, see GetNeighbourVoxel
+                int3 const offset = NeighbourOffsets[v];
+                Float3 const neighbourPosition = {
+                    S::Add(discretePosition.x, S::Mul(S::Set1(float(offset.x)), cellSizeBasedOnLevel)),
+                    S::Add(discretePosition.y, S::Mul(S::Set1(float(offset.y)), cellSizeBasedOnLevel)),
+                    S::Add(discretePosition.z, S::Mul(S::Set1(float(offset.z)), cellSizeBasedOnLevel)) };
+                Float3 const top = {
+                    Discretize(neighbourPosition.x, cellSize),
+                    Discretize(neighbourPosition.y, cellSize),
+                    Discretize(neighbourPosition.z, cellSize) };
+                Float3 const acp = {
+                    S::Add(top.x, S::Mul(S::Add(S::Abs(S::Div(S::Sub(top.x, neighbourPosition.x), signedCellSize)), deltaNextLevel), cellSize)),
+                    S::Add(top.y, S::Mul(S::Add(S::Abs(S::Div(S::Sub(top.y, neighbourPosition.y), signedCellSize)), deltaNextLevel), cellSize)),
+                    S::Add(top.z, S::Mul(S::Add(S::Abs(S::Div(S::Sub(top.z, neighbourPosition.z), signedCellSize)), deltaNextLevel), cellSize)) };
+#if defined(IMPLICITPOINT_SPATIAL_SEEDS)
+                Int const neighbourSeed = GetSpatialSeedWithSignedBits(acp, deltaOnLevel, cellSize, maxLevels);
+#else
+                Int const neighbourSeed = GetSeedWithSignedBits(acp, maxLevels);
+#endif
+
+                //Random point technique, using random implicit points
+                for (uint32_t i = 0; i < 8; ++i)
+                {
+                    Int const currentSeed = S::Add(neighbourSeed, S::Set1(i));
+                    Float3 const hash = Hash3(currentSeed);
+                    int3 const quadrant = OffsetVectorFromQuadrant(i);
+                    Float const cellDelta = S::Set1(0.5f);
+                    Float3 const absoluteSample = {
+                        S::Add(neighbourPosition.x, S::Mul(S::Add(S::Mul(S::Set1(float(quadrant.x)), cellDelta), S::Mul(hash.x, cellDelta)), cellSizeBasedOnLevel)),
+                        S::Add(neighbourPosition.y, S::Mul(S::Add(S::Mul(S::Set1(float(quadrant.y)), cellDelta), S::Mul(hash.y, cellDelta)), cellSizeBasedOnLevel)),
+                        S::Add(neighbourPosition.z, S::Mul(S::Add(S::Mul(S::Set1(float(quadrant.z)), cellDelta), S::Mul(hash.z, cellDelta)), cellSizeBasedOnLevel)) };
+                    UpdateTriplet(position, absoluteSample, currentSeed, triplet);
+                }
+            }
+
+            Mask pickSecond, pickThird;
+            GetIndexByProbability(position, triplet, pickSecond, pickThird);
+            S::Store(outSeed, S::Select(pickThird, triplet.seed[2], S::Select(pickSecond, triplet.seed[1], triplet.seed[0])));
+            S::Store(outSampleX, S::Select(pickThird, triplet.x[2], S::Select(pickSecond, triplet.x[1], triplet.x[0])));
+            S::Store(outSampleY, S::Select(pickThird, triplet.y[2], S::Select(pickSecond, triplet.y[1], triplet.y[0])));
+            S::Store(outSampleZ, S::Select(pickThird, triplet.z[2], S::Select(pickSecond, triplet.z[1], triplet.z[0])));
+        }
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,66 @@
+#include "ShaderTypes.h"
+#include <utility>
+
+namespace ImplicitPointCPU
+{
+    float4x4 mul(float4x4 const& a, float4x4 const& b)
+    {
+        float4x4 result = {};
+        for (uint32_t r = 0; r < 4; ++r)
+            for (uint32_t c = 0; c < 4; ++c)
+                for (uint32_t k = 0; k < 4; ++k)
+                    result.m[r][c] += a.m[r][k] * b.m[k][c];
+        return result;
+    }
+
+    float4x4 Identity()
+    {
+        float4x4 result = {};
+        for (uint32_t i = 0; i < 4; ++i)
+            result.m[i][i] = 1.f;
+        return result;
+    }
+
+    //Gauss-Jordan elimination with partial pivoting, in double precision to keep the round trip stable
+    float4x4 Invert(float4x4 const& m)
+    {
+        double a[4][8] = {};
+        for (uint32_t r = 0; r < 4; ++r)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+                a[r][c] = m.m[r][c];
+            a[r][4 + r] = 1.0;
+        }
+
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            uint32_t pivot = c;
+            for (uint32_t r = c + 1; r < 4; ++r)
+                if (std::fabs(a[r][c]) > std::fabs(a[pivot][c]))
+                    pivot = r;
+            if (a[pivot][c] == 0.0)
+                return float4x4{}; //Singular matrix
+            if (pivot != c)
+                for (uint32_t k = 0; k < 8; ++k)
+                    std::swap(a[c][k], a[pivot][k]);
+
+            double const invPivot = 1.0 / a[c][c];
+            for (uint32_t k = 0; k < 8; ++k)
+                a[c][k] *= invPivot;
+            for (uint32_t r = 0; r < 4; ++r)
+            {
+                if (r == c)
+                    continue;
+                double const factor = a[r][c];
+                for (uint32_t k = 0; k < 8; ++k)
+                    a[r][k] -= factor * a[c][k];
+            }
+        }
+
+        float4x4 result;
+        for (uint32_t r = 0; r < 4; ++r)
+            for (uint32_t c = 0; c < 4; ++c)
+                result.m[r][c] = static_cast<float>(a[r][4 + c]);
+        return result;
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,172 @@
+//HLSL-like vector types and intrinsics, used to port the ImplicitPointDemo shaders to the CPU.
+//Conversions and shifts mirror the HLSL semantics the shaders rely on, so ported code can be kept line-by-line identical.
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+namespace ImplicitPointCPU
+{
+    struct float2
+    {
+        float x, y;
+    };
+
+    struct float3
+    {
+        float x, y, z;
+
+        float& operator[](uint32_t i) { return (&x)[i]; }
+        float operator[](uint32_t i) const { return (&x)[i]; }
+    };
+
+    struct float4
+    {
+        float x, y, z, w;
+
+        float3 xyz() const { return float3{ x, y, z }; }
+    };
+
+    struct uint2
+    {
+        uint32_t x, y;
+    };
+
+    struct uint3
+    {
+        uint32_t x, y, z;
+    };
+
+    struct int3
+    {
+        int32_t x, y, z;
+    };
+
+    //Row-major storage: m[row][column], used as mul(M, v) like the shaders do
+    struct float4x4
+    {
+        float m[4][4];
+    };
+
+    //--------- SCALAR CONVERSIONS ---------
+    //float -> int, out of range and NaN map to INT_MIN (x86 "integer indefinite", which the SIMD paths share)
+    inline int32_t ToInt(float value)
+    {
+        return (value >= -2147483648.f && value < 2147483648.f) ? static_cast<int32_t>(value) : INT32_MIN;
+    }
+
+    //float -> uint, negative and NaN map to 0, out of range saturates
+    inline uint32_t ToUint(float value)
+    {
+        if (!(value > 0.f))
+            return 0;
+        if (value >= 4294967296.f)
+            return 0xFFFFFFFFu;
+        return static_cast<uint32_t>(value);
+    }
+
+    //Mirrors HLSL "1 << level": an int literal with the shift amount masked to 5 bits
+    inline int32_t IntPow2(uint32_t level)
+    {
+        return static_cast<int32_t>(1u << (level & 31u));
+    }
+
+    inline uint32_t asuint(float value)
+    {
+        uint32_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    inline int32_t asint(float value)
+    {
+        int32_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    inline float asfloat(uint32_t value)
+    {
+        float result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    }
+
+    //--------- SCALAR INTRINSICS ---------
+    inline float frac(float value) { return value - std::floor(value); }
+    inline float saturate(float value) { return value < 0.f ? 0.f : (value > 1.f ? 1.f : value); }
+    inline int32_t sign(float value) { return (value > 0.f) - (value < 0.f); }
+    template<typename T> inline T clamp(T value, T low, T high) { return value < low ? low : (value > high ? high : value); }
+    template<typename T> inline T min(T a, T b) { return a < b ? a : b; }
+    template<typename T> inline T max(T a, T b) { return a > b ? a : b; }
+
+    //--------- FLOAT3 OPERATORS ---------
+    inline float3 operator+(float3 const& a, float3 const& b) { return float3{ a.x + b.x, a.y + b.y, a.z + b.z }; }
+    inline float3 operator-(float3 const& a, float3 const& b) { return float3{ a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline float3 operator*(float3 const& a, float3 const& b) { return float3{ a.x * b.x, a.y * b.y, a.z * b.z }; }
+    inline float3 operator/(float3 const& a, float3 const& b) { return float3{ a.x / b.x, a.y / b.y, a.z / b.z }; }
+    inline float3 operator+(float3 const& a, float s) { return float3{ a.x + s, a.y + s, a.z + s }; }
+    inline float3 operator-(float3 const& a, float s) { return float3{ a.x - s, a.y - s, a.z - s }; }
+    inline float3 operator*(float3 const& a, float s) { return float3{ a.x * s, a.y * s, a.z * s }; }
+    inline float3 operator*(float s, float3 const& a) { return float3{ s * a.x, s * a.y, s * a.z }; }
+    inline float3 operator/(float3 const& a, float s) { return float3{ a.x / s, a.y / s, a.z / s }; }
+    inline float3 operator-(float3 const& a) { return float3{ -a.x, -a.y, -a.z }; }
+    inline float3& operator+=(float3& a, float3 const& b) { a = a + b; return a; }
+    inline float3& operator-=(float3& a, float3 const& b) { a = a - b; return a; }
+
+    inline float dot(float3 const& a, float3 const& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline float length(float3 const& a) { return std::sqrt(dot(a, a)); }
+    inline float distance(float3 const& a, float3 const& b) { return length(a - b); }
+    inline float3 abs(float3 const& a) { return float3{ std::fabs(a.x), std::fabs(a.y), std::fabs(a.z) }; }
+    inline float3 frac(float3 const& a) { return float3{ frac(a.x), frac(a.y), frac(a.z) }; }
+    inline float3 trunc(float3 const& a) { return float3{ std::trunc(a.x), std::trunc(a.y), std::trunc(a.z) }; }
+    inline float3 normalize(float3 const& a) { return a / length(a); }
+    inline float3 cross(float3 const& a, float3 const& b)
+    {
+        return float3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    //--------- VECTOR CONVERSIONS ---------
+    inline float3 ToFloat3(int3 const& a) { return float3{ float(a.x), float(a.y), float(a.z) }; }
+    inline float3 ToFloat3(uint3 const& a) { return float3{ float(a.x), float(a.y), float(a.z) }; }
+    inline int3 ToInt3(float3 const& a) { return int3{ ToInt(a.x), ToInt(a.y), ToInt(a.z) }; }
+    inline uint3 ToUint3(float3 const& a) { return uint3{ ToUint(a.x), ToUint(a.y), ToUint(a.z) }; }
+    inline uint3 asuint(float3 const& a) { return uint3{ asuint(a.x), asuint(a.y), asuint(a.z) }; }
+
+    //--------- MATRIX ---------
+    inline float4 mul(float4x4 const& m, float4 const& v)
+    {
+        return float4{
+            m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z + m.m[0][3] * v.w,
+            m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z + m.m[1][3] * v.w,
+            m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z + m.m[2][3] * v.w,
+            m.m[3][0] * v.x + m.m[3][1] * v.y + m.m[3][2] * v.z + m.m[3][3] * v.w };
+    }
+
+    float4x4 mul(float4x4 const& a, float4x4 const& b);
+    float4x4 Invert(float4x4 const& m);
+    float4x4 Identity();
+
+    //Translation column of a (view inverse) matrix, HLSL: M._m03_m13_m23
+    inline float3 GetTranslation(float4x4 const& m)
+    {
+        return float3{ m.m[0][3], m.m[1][3], m.m[2][3] };
+    }
+
+    //mul(M, float4(p, 1)).xyz and mul(M, float4(v, 0)).xyz of an affine M
+    inline float3 TransformPoint(float4x4 const& m, float3 const& p)
+    {
+        return float3{
+            m.m[0][0] * p.x + m.m[0][1] * p.y + m.m[0][2] * p.z + m.m[0][3],
+            m.m[1][0] * p.x + m.m[1][1] * p.y + m.m[1][2] * p.z + m.m[1][3],
+            m.m[2][0] * p.x + m.m[2][1] * p.y + m.m[2][2] * p.z + m.m[2][3] };
+    }
+
+    inline float3 TransformVector(float4x4 const& m, float3 const& v)
+    {
+        return float3{
+            m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z,
+            m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z,
+            m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z };
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,58 @@
+//CPU port of Shaders/SharedUtilities.hlsli
+#pragma once
+#include "ShaderTypes.h"
+
+namespace ImplicitPointCPU
+{
+    //Pixels that generate and accumulate a sample in a frame, the final visualization stays full resolution
+    enum class SamplePattern : uint32_t
+    {
+        Full         = 0, //Every pixel, every frame
+        Quarter      = 1, //One pixel of every 2x2 block, rotating over 4 frames
+        Checkerboard = 2  //Half of the pixels, alternating every frame
+    };
+
+    //Whether the pixel at screenCoord generates and accumulates a sample in frame frameIndex.
+    //Quarter visits the 2x2 block in the order (0,0), (1,1), (1,0), (0,1): every frame is spread over both rows and columns.
+    inline bool IsSamplePixel(uint2 screenCoord, SamplePattern samplePattern, uint32_t frameIndex)
+    {
+        if (samplePattern == SamplePattern::Quarter)
+        {
+            uint32_t const quarterOrder[4] = { 0, 3, 1, 2 };
+            return ((screenCoord.x & 1) | ((screenCoord.y & 1) << 1)) == quarterOrder[frameIndex & 3];
+        }
+        if (samplePattern == SamplePattern::Checkerboard)
+            return ((screenCoord.x + screenCoord.y) & 1) == (frameIndex & 1);
+        return true;
+    }
+
+    //Get world position from depth buffer value
+    inline float4 DepthToWorldPosition(float depth, uint2 screenCoord, uint2 screenDimensions, float4x4 const& viewProjectionInverse)
+    {
+        float2 const normalizedScreenCoord = { float(screenCoord.x) / float(screenDimensions.x), float(screenCoord.y) / float(screenDimensions.y) };
+        float2 const ndcXY = { normalizedScreenCoord.x * 2.f - 1.f, (1.f - normalizedScreenCoord.y) * 2.f - 1.f };
+        float4 const ndc = { ndcXY.x, ndcXY.y, depth, 1.f };
+        float4 const worldPos = mul(viewProjectionInverse, ndc);
+        return float4{ worldPos.x / worldPos.w, worldPos.y / worldPos.w, worldPos.z / worldPos.w, 1.f };
+    }
+
+    //Floating point value to (unsigned) fixed point, based on fractionalBitCount
+    inline uint32_t ToFixedPoint(float value, uint32_t fractionalBitCount)
+    {
+        uint32_t const frac = 1u << fractionalBitCount;
+        return ToUint(std::fabs(value) * float(frac));
+    }
+
+    inline uint3 ToFixedPoint(float3 const& value, uint32_t fractionalBitCount)
+    {
+        uint32_t const frac = 1u << fractionalBitCount;
+        return ToUint3(abs(value) * float(frac));
+    }
+
+    //Fixed point to floating point value, based on fractionalBitCount
+    inline float FromFixedPoint(uint32_t value, uint32_t fractionalBitCount)
+    {
+        uint32_t const frac = 1u << fractionalBitCount;
+        return float(value) / float(frac);
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,81 @@
+//8-wide AVX2 operations used by the templated SIMD kernels. Only include this from translation units compiled for AVX2
+//(/arch:AVX2 or -mavx2) and only call into them after SupportsAVX2() returned true.
+//The kernels rely on every operation rounding exactly like its scalar counterpart, so no fused multiply-add is used.
+#pragma once
+#include <immintrin.h>
+#include <cstdint>
+
+namespace ImplicitPointCPU
+{
+    struct SimdAVX2
+    {
+        static uint32_t const Width = 8;
+        typedef __m256 Float;
+        typedef __m256i Int;
+        typedef __m256 Mask;
+
+        //--------- LOAD/STORE ---------
+        static Float Load(float const* p) { return _mm256_loadu_ps(p); }
+        static Int Load(uint32_t const* p) { return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p)); }
+        static Int LoadUint16(uint16_t const* p) { return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p))); } //Zero extended
+        static void Store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+        static void Store(uint32_t* p, Int v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+        static Float Set1(float v) { return _mm256_set1_ps(v); }
+        static Int Set1(uint32_t v) { return _mm256_set1_epi32(int32_t(v)); }
+        static Int LaneIndices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+
+        //--------- FLOAT ---------
+        static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+        static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+        static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+        static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+        static Float Floor(Float a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+        static Float Trunc(Float a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+        static Float Abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+        static Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+        static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+        static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+
+        //--------- INT (32 bit, unsigned semantics where it matters) ---------
+        static Int Add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+        static Int Sub(Int a, Int b) { return _mm256_sub_epi32(a, b); }
+        static Int Mul(Int a, Int b) { return _mm256_mullo_epi32(a, b); }
+        static Int And(Int a, Int b) { return _mm256_and_si256(a, b); }
+        static Int Or(Int a, Int b) { return _mm256_or_si256(a, b); }
+        static Int Xor(Int a, Int b) { return _mm256_xor_si256(a, b); }
+        template<int N> static Int ShiftLeft(Int a) { return _mm256_slli_epi32(a, N); }
+        template<int N> static Int ShiftRight(Int a) { return _mm256_srli_epi32(a, N); }
+        static Int ShiftLeft(Int a, uint32_t n) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(int32_t(n))); }
+        static Int ShiftRight(Int a, uint32_t n) { return _mm256_srl_epi32(a, _mm_cvtsi32_si128(int32_t(n))); }
+        static Int ShiftLeftVariable(Int a, Int n) { return _mm256_sllv_epi32(a, n); }
+        static Int ShiftRightVariable(Int a, Int n) { return _mm256_srlv_epi32(a, n); }
+
+        //--------- CONVERSIONS ---------
+        static Float IntToFloat(Int a) { return _mm256_cvtepi32_ps(a); }   //Signed
+        static Int TruncateToInt(Float a) { return _mm256_cvttps_epi32(a); } //Signed, out of range and NaN = 0x80000000
+        static Float UintToFloat(Int a)
+        {
+            //Both halves convert exactly, so the single rounding of the add matches a direct uint -> float conversion
+            Float const high = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(a, 16)), _mm256_set1_ps(65536.f));
+            Float const low = _mm256_cvtepi32_ps(_mm256_and_si256(a, _mm256_set1_epi32(0xFFFF)));
+            return _mm256_add_ps(high, low);
+        }
+        static Int AsInt(Float a) { return _mm256_castps_si256(a); }
+        static Float AsFloat(Int a) { return _mm256_castsi256_ps(a); }
+
+        //--------- MASKS ---------
+        static Mask Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static Mask LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        static Mask Greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static Mask GreaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static Mask Equal(Int a, Int b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+        static Mask MaskAnd(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+        static Mask MaskOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+        static Mask MaskAndNot(Mask a, Mask b) { return _mm256_andnot_ps(b, a); } //a & ~b
+        static bool Any(Mask a) { return _mm256_movemask_ps(a) != 0; }
+        static uint32_t Bits(Mask a) { return uint32_t(_mm256_movemask_ps(a)); }
+        static Float Select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); } //m ? a : b
+        static Int Select(Mask m, Int a, Int b) { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), m)); }
+        static Int MaskToInt(Mask m, Int a) { return _mm256_and_si256(_mm256_castps_si256(m), a); } //m ? a : 0
+    };
+} //namespace ImplicitPointCPU
@@ -0,0 +1,74 @@
+//16-wide AVX-512 (F/DQ/BW/VL) operations used by the templated SIMD kernels, same interface as SimdAVX2.
+//Only include this from translation units compiled for AVX-512 and only call into them after SupportsAVX512() returned true.
+#pragma once
+#include <immintrin.h>
+#include <cstdint>
+
+namespace ImplicitPointCPU
+{
+    struct SimdAVX512
+    {
+        static uint32_t const Width = 16;
+        typedef __m512 Float;
+        typedef __m512i Int;
+        typedef __mmask16 Mask;
+
+        //--------- LOAD/STORE ---------
+        static Float Load(float const* p) { return _mm512_loadu_ps(p); }
+        static Int Load(uint32_t const* p) { return _mm512_loadu_si512(p); }
+        static Int LoadUint16(uint16_t const* p) { return _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(p))); } //Zero extended
+        static void Store(float* p, Float v) { _mm512_storeu_ps(p, v); }
+        static void Store(uint32_t* p, Int v) { _mm512_storeu_si512(p, v); }
+        static Float Set1(float v) { return _mm512_set1_ps(v); }
+        static Int Set1(uint32_t v) { return _mm512_set1_epi32(int32_t(v)); }
+        static Int LaneIndices() { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+
+        //--------- FLOAT ---------
+        static Float Add(Float a, Float b) { return _mm512_add_ps(a, b); }
+        static Float Sub(Float a, Float b) { return _mm512_sub_ps(a, b); }
+        static Float Mul(Float a, Float b) { return _mm512_mul_ps(a, b); }
+        static Float Div(Float a, Float b) { return _mm512_div_ps(a, b); }
+        static Float Floor(Float a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+        static Float Trunc(Float a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+        static Float Abs(Float a) { return _mm512_abs_ps(a); }
+        static Float Sqrt(Float a) { return _mm512_sqrt_ps(a); }
+        static Float Min(Float a, Float b) { return _mm512_min_ps(a, b); }
+        static Float Max(Float a, Float b) { return _mm512_max_ps(a, b); }
+
+        //--------- INT (32 bit, unsigned semantics where it matters) ---------
+        static Int Add(Int a, Int b) { return _mm512_add_epi32(a, b); }
+        static Int Sub(Int a, Int b) { return _mm512_sub_epi32(a, b); }
+        static Int Mul(Int a, Int b) { return _mm512_mullo_epi32(a, b); }
+        static Int And(Int a, Int b) { return _mm512_and_si512(a, b); }
+        static Int Or(Int a, Int b) { return _mm512_or_si512(a, b); }
+        static Int Xor(Int a, Int b) { return _mm512_xor_si512(a, b); }
+        template<int N> static Int ShiftLeft(Int a) { return _mm512_slli_epi32(a, N); }
+        template<int N> static Int ShiftRight(Int a) { return _mm512_srli_epi32(a, N); }
+        static Int ShiftLeft(Int a, uint32_t n) { return _mm512_sll_epi32(a, _mm_cvtsi32_si128(int32_t(n))); }
+        static Int ShiftRight(Int a, uint32_t n) { return _mm512_srl_epi32(a, _mm_cvtsi32_si128(int32_t(n))); }
+        static Int ShiftLeftVariable(Int a, Int n) { return _mm512_sllv_epi32(a, n); }
+        static Int ShiftRightVariable(Int a, Int n) { return _mm512_srlv_epi32(a, n); }
+
+        //--------- CONVERSIONS ---------
+        static Float IntToFloat(Int a) { return _mm512_cvtepi32_ps(a); }   //Signed
+        static Int TruncateToInt(Float a) { return _mm512_cvttps_epi32(a); } //Signed, out of range and NaN = 0x80000000
+        static Float UintToFloat(Int a) { return _mm512_cvtepu32_ps(a); }
+        static Int AsInt(Float a) { return _mm512_castps_si512(a); }
+        static Float AsFloat(Int a) { return _mm512_castsi512_ps(a); }
+
+        //--------- MASKS ---------
+        static Mask Less(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+        static Mask LessEqual(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+        static Mask Greater(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+        static Mask GreaterEqual(Float a, Float b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+        static Mask Equal(Int a, Int b) { return _mm512_cmpeq_epi32_mask(a, b); }
+        static Mask MaskAnd(Mask a, Mask b) { return _kand_mask16(a, b); }
+        static Mask MaskOr(Mask a, Mask b) { return _kor_mask16(a, b); }
+        static Mask MaskAndNot(Mask a, Mask b) { return _kandn_mask16(b, a); } //a & ~b
+        static bool Any(Mask a) { return a != 0; }
+        static uint32_t Bits(Mask a) { return uint32_t(a); }
+        static Float Select(Mask m, Float a, Float b) { return _mm512_mask_blend_ps(m, b, a); } //m ? a : b
+        static Int Select(Mask m, Int a, Int b) { return _mm512_mask_blend_epi32(m, b, a); }
+        static Int MaskToInt(Mask m, Int a) { return _mm512_maskz_mov_epi32(m, a); } //m ? a : 0
+    };
+} //namespace ImplicitPointCPU
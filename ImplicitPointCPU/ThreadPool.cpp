@@ -0,0 +1,85 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace ImplicitPointCPU
+{
+    ThreadPool::ThreadPool(uint32_t threadCount)
+        : m_NextJob(0)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_Workers.reserve(threadCount - 1);
+        for (uint32_t i = 1; i < threadCount; ++i)
+            m_Workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Quit = true;
+        }
+        m_WorkCondition.notify_all();
+        for (std::thread& worker : m_Workers)
+            worker.join();
+    }
+
+    void ThreadPool::ParallelFor(uint32_t count, JobFunction const& function)
+    {
+        //Nothing to share, run on the calling thread
+        if (m_Workers.empty() || count <= 1)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                function(i, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_pFunction = &function;
+            m_JobCount = count;
+            m_NextJob.store(0, std::memory_order_relaxed);
+            m_ActiveWorkers = uint32_t(m_Workers.size());
+            ++m_Generation;
+        }
+        m_WorkCondition.notify_all();
+
+        RunJobs(0);
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_DoneCondition.wait(lock, [this]() { return m_ActiveWorkers == 0; });
+        m_pFunction = nullptr;
+    }
+
+    void ThreadPool::WorkerLoop(uint32_t threadIndex)
+    {
+        uint64_t seenGeneration = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_WorkCondition.wait(lock, [&]() { return m_Quit || m_Generation != seenGeneration; });
+                if (m_Quit)
+                    return;
+                seenGeneration = m_Generation;
+            }
+
+            RunJobs(threadIndex);
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (--m_ActiveWorkers == 0)
+                m_DoneCondition.notify_one();
+        }
+    }
+
+    void ThreadPool::RunJobs(uint32_t threadIndex)
+    {
+        uint32_t job = m_NextJob.fetch_add(1, std::memory_order_relaxed);
+        while (job < m_JobCount)
+        {
+            (*m_pFunction)(job, threadIndex);
+            job = m_NextJob.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+} //namespace ImplicitPointCPU
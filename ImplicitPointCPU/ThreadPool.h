@@ -0,0 +1,48 @@
+//Minimal fork-join pool used to spread the per-pixel passes over all cores.
+//The calling thread takes part in the work, so a pool of N threads spawns N - 1 workers.
+#pragma once
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ImplicitPointCPU
+{
+    class ThreadPool
+    {
+    public:
+        typedef std::function<void(uint32_t index, uint32_t threadIndex)> JobFunction;
+
+        explicit ThreadPool(uint32_t threadCount = 0); //0 = hardware concurrency
+        ~ThreadPool();
+
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool& operator=(ThreadPool const&) = delete;
+
+        //Amount of threads running jobs, including the calling thread
+        uint32_t GetThreadCount() const { return uint32_t(m_Workers.size()) + 1; }
+
+        //Runs function for every index in [0, count) and returns once all of them are done.
+        //threadIndex is in [0, GetThreadCount()) and can be used to index per thread scratch data.
+        void ParallelFor(uint32_t count, JobFunction const& function);
+
+    private:
+        std::vector<std::thread> m_Workers;
+        std::mutex m_Mutex;
+        std::condition_variable m_WorkCondition;
+        std::condition_variable m_DoneCondition;
+
+        JobFunction const* m_pFunction = nullptr;
+        uint32_t m_JobCount = 0;
+        std::atomic<uint32_t> m_NextJob;
+        uint32_t m_ActiveWorkers = 0;
+        uint64_t m_Generation = 0;
+        bool m_Quit = false;
+
+        void WorkerLoop(uint32_t threadIndex);
+        void RunJobs(uint32_t threadIndex);
+    };
+} //namespace ImplicitPointCPU
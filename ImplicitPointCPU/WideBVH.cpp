@@ -0,0 +1,237 @@
+#include "WideBVHKernel.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        uint32_t const CacheLineSize = 64;
+
+        struct ScalarChildTest
+        {
+            static uint32_t Intersect(WideBVHNode const& node, WideBVHRay const& ray, float tMin, float tMax, float tNear[WideBVHWidth])
+            {
+                //Per axis t = q * step / direction + (origin - rayOrigin) / direction, for every quantized bound q
+                float scale[3];
+                float offset[3];
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    scale[axis] = GetQuantizationStep(node.exponent[axis]) * ray.inverseDirection[axis];
+                    offset[axis] = (node.origin[axis] - ray.origin[axis]) * ray.inverseDirection[axis];
+                }
+
+                uint32_t mask = 0;
+                for (uint32_t child = 0; child < WideBVHWidth; ++child)
+                {
+                    if ((node.childMask & (1u << child)) == 0)
+                        continue;
+                    float childNear = tMin;
+                    float childFar = tMax;
+                    for (uint32_t axis = 0; axis < 3; ++axis)
+                    {
+                        float const t0 = float(node.childMin[axis][child]) * scale[axis] + offset[axis];
+                        float const t1 = float(node.childMax[axis][child]) * scale[axis] + offset[axis];
+                        childNear = max(childNear, min(t0, t1));
+                        childFar = min(childFar, max(t0, t1));
+                    }
+                    tNear[child] = childNear;
+                    mask |= (childNear <= childFar ? 1u : 0u) << child;
+                }
+                return mask;
+            }
+        };
+
+        float SurfaceArea(BVHNode const& node)
+        {
+            float3 const extent = node.boundsMax - node.boundsMin;
+            return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        //Smallest power of two step that reaches boundsMax in 65535 steps from boundsMin, in float arithmetic
+        int8_t GetQuantizationExponent(float boundsMin, float boundsMax)
+        {
+            int exponent = 0;
+            std::frexp((boundsMax - boundsMin) / 65535.f, &exponent);
+            exponent = clamp(exponent - 1, -126, 127);
+            while (exponent < 127 && boundsMin + 65535.f * GetQuantizationStep(int8_t(exponent)) < boundsMax)
+                ++exponent;
+            return int8_t(exponent);
+        }
+
+        //Rounded outwards: the dequantized interval origin + [low, high] * step contains [boundsMin, boundsMax]
+        void Quantize(float origin, float step, float boundsMin, float boundsMax, uint16_t& low, uint16_t& high)
+        {
+            uint32_t q = min(ToUint(std::floor((boundsMin - origin) / step)), 65535u);
+            while (q > 0 && origin + float(q) * step > boundsMin)
+                --q;
+            low = uint16_t(q);
+
+            q = min(ToUint(std::ceil((boundsMax - origin) / step)), 65535u);
+            while (q < 65535 && origin + float(q) * step < boundsMax)
+                ++q;
+            high = uint16_t(q);
+        }
+    }
+
+    void WideBVH::Build(BVH const& bvh)
+    {
+        std::vector<BVHNode> const& binaryNodes = bvh.GetNodes();
+        std::vector<BVHTriangle> const& binaryTriangles = bvh.GetTriangles();
+        std::vector<uint32_t> const& binaryTriangleIndices = bvh.GetTriangleIndices();
+
+        m_Triangles.clear();
+        m_TriangleIndices.clear();
+        m_Triangles.reserve(binaryTriangles.size());
+        m_TriangleIndices.reserve(binaryTriangles.size());
+
+        std::vector<WideBVHNode> nodes;
+        if (!binaryTriangles.empty())
+            nodes.push_back(WideBVHNode());
+
+        struct BuildTask
+        {
+            uint32_t node;
+            uint32_t binaryNode;
+        };
+        std::vector<BuildTask> tasks;
+        if (!nodes.empty())
+            tasks.push_back(BuildTask{ 0, 0 });
+        while (!tasks.empty())
+        {
+            BuildTask const task = tasks.back();
+            tasks.pop_back();
+
+            //Open the interior child with the largest surface area until there are 8 children or only leaves
+            uint32_t children[WideBVHWidth];
+            uint32_t childCount = 0;
+            BVHNode const& binaryNode = binaryNodes[task.binaryNode];
+            if (binaryNode.triangleCount > 0)
+            {
+                children[childCount++] = task.binaryNode;
+            }
+            else
+            {
+                children[childCount++] = binaryNode.leftFirst;
+                children[childCount++] = binaryNode.leftFirst + 1;
+            }
+            while (childCount < WideBVHWidth)
+            {
+                uint32_t largest = WideBVHWidth;
+                float largestArea = -1.f;
+                for (uint32_t i = 0; i < childCount; ++i)
+                {
+                    BVHNode const& child = binaryNodes[children[i]];
+                    if (child.triangleCount == 0 && SurfaceArea(child) > largestArea)
+                    {
+                        largest = i;
+                        largestArea = SurfaceArea(child);
+                    }
+                }
+                if (largest == WideBVHWidth)
+                    break;
+                uint32_t const left = binaryNodes[children[largest]].leftFirst;
+                children[largest] = left;
+                children[childCount++] = left + 1;
+            }
+
+            WideBVHNode node = {};
+            float3 boundsMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+            float3 boundsMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            for (uint32_t i = 0; i < childCount; ++i)
+            {
+                BVHNode const& child = binaryNodes[children[i]];
+                boundsMin = float3{ min(boundsMin.x, child.boundsMin.x), min(boundsMin.y, child.boundsMin.y), min(boundsMin.z, child.boundsMin.z) };
+                boundsMax = float3{ max(boundsMax.x, child.boundsMax.x), max(boundsMax.y, child.boundsMax.y), max(boundsMax.z, child.boundsMax.z) };
+            }
+            node.origin = boundsMin;
+            float step[3];
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                node.exponent[axis] = GetQuantizationExponent(boundsMin[axis], boundsMax[axis]);
+                step[axis] = GetQuantizationStep(node.exponent[axis]);
+            }
+            node.childMask = uint8_t((1u << childCount) - 1);
+            node.firstChildNode = uint32_t(nodes.size());
+            node.firstTriangle = uint32_t(m_Triangles.size());
+
+            uint32_t interiorCount = 0;
+            for (uint32_t i = 0; i < childCount; ++i)
+            {
+                BVHNode const& child = binaryNodes[children[i]];
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                    Quantize(node.origin[axis], step[axis], child.boundsMin[axis], child.boundsMax[axis], node.childMin[axis][i], node.childMax[axis][i]);
+
+                if (child.triangleCount > 0)
+                {
+                    if (child.triangleCount >= WideBVHInteriorChild)
+                        throw std::invalid_argument("WideBVH: leaves hold at most 127 triangles");
+                    node.childInfo[i] = uint8_t(child.triangleCount);
+                    for (uint32_t t = child.leftFirst; t < child.leftFirst + child.triangleCount; ++t)
+                    {
+                        m_Triangles.push_back(binaryTriangles[t]);
+                        m_TriangleIndices.push_back(binaryTriangleIndices[t]);
+                    }
+                    continue;
+                }
+
+                node.childInfo[i] = uint8_t(WideBVHInteriorChild | interiorCount);
+                tasks.push_back(BuildTask{ node.firstChildNode + interiorCount, children[i] });
+                nodes.push_back(WideBVHNode());
+                ++interiorCount;
+            }
+            nodes[task.node] = node;
+        }
+
+        //Cache line aligned copy, C++14 new does not guarantee that for over-aligned types
+        m_NodeCount = uint32_t(nodes.size());
+        m_NodeStorage.assign(nodes.size() * sizeof(WideBVHNode) + CacheLineSize, 0);
+        if (!nodes.empty())
+            std::memcpy(const_cast<WideBVHNode*>(GetNodes()), nodes.data(), nodes.size() * sizeof(WideBVHNode));
+    }
+
+    WideBVHNode const* WideBVH::GetNodes() const
+    {
+        uintptr_t const address = reinterpret_cast<uintptr_t>(m_NodeStorage.data());
+        return reinterpret_cast<WideBVHNode const*>((address + CacheLineSize - 1) & ~uintptr_t(CacheLineSize - 1));
+    }
+
+    bool WideBVH::Intersect(float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit, SimdWidth width) const
+    {
+        bool const found = min(width, GetMaxSimdWidth()) >= SimdWidth::AVX2
+            ? IntersectAVX2(*this, origin, direction, tMin, tMax, hit)
+            : TraverseWideBVH<false, ScalarChildTest>(*this, origin, direction, tMin, tMax, hit);
+        if (!found)
+            return false;
+        hit.triangle = m_TriangleIndices[hit.triangle];
+        hit.instance = 0;
+        return true;
+    }
+
+    float WideBVH::IntersectAny(float3 const& origin, float3 const& direction, float tMin, float tMax, SimdWidth width) const
+    {
+        if (min(width, GetMaxSimdWidth()) >= SimdWidth::AVX2)
+            return IntersectAnyAVX2(*this, origin, direction, tMin, tMax);
+
+        RayHit hit;
+        return TraverseWideBVH<true, ScalarChildTest>(*this, origin, direction, tMin, tMax, hit) ? hit.t : tMax;
+    }
+
+    size_t WideBVH::GetMemorySize() const
+    {
+        return size_t(m_NodeCount) * sizeof(WideBVHNode) + m_Triangles.size() * sizeof(BVHTriangle) + m_TriangleIndices.size() * sizeof(uint32_t);
+    }
+
+    void IntersectAnyBatch(WideBVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT, SimdWidth width)
+    {
+        width = min(width, GetMaxSimdWidth());
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            float3 const origin = { rays.originX[i], rays.originY[i], rays.originZ[i] };
+            float3 const direction = { rays.directionX[i], rays.directionY[i], rays.directionZ[i] };
+            hitT[i] = bvh.IntersectAny(origin, direction, rays.tMin, rays.tMax, width);
+        }
+    }
+} //namespace ImplicitPointCPU
@@ -0,0 +1,56 @@
+//Compressed 8-wide BVH, collapsed from a binary BVH: a node holds the bounds of up to 8 children as 16-bit offsets from its
+//own minimum, in power of two steps per axis, and is 128 bytes: two cache lines instead of the 7 binary nodes (224 bytes) it
+//replaces at best. A ray tests all children of a node at once, one child per lane of an AVX2 vector, and visits the hit
+//interior children nearest first. The quantized bounds are rounded outwards, so they always contain the exact ones.
+#pragma once
+#include "BVH.h"
+
+namespace ImplicitPointCPU
+{
+    uint32_t const WideBVHWidth = 8;
+    uint8_t const WideBVHInteriorChild = 0x80; //childInfo flag, the low bits are the rank among the interior children
+
+    struct WideBVHNode
+    {
+        float3 origin;            //Minimum of the node bounds, the child bounds are quantized relative to it
+        int8_t exponent[3];       //Quantization step per axis: 2^exponent
+        uint8_t childMask;        //Slots in use
+        uint32_t firstChildNode;  //The interior children, consecutive in slot order
+        uint32_t firstTriangle;   //The triangles of the leaf children, consecutive in slot order
+        uint8_t childInfo[WideBVHWidth];              //Interior: WideBVHInteriorChild | rank, leaf: triangle count
+        uint16_t childMin[3][WideBVHWidth];           //Per axis, rounded down
+        uint16_t childMax[3][WideBVHWidth];           //Per axis, rounded up
+    };
+    static_assert(sizeof(WideBVHNode) == 128, "Two cache lines per wide node");
+
+    class WideBVH
+    {
+    public:
+        //Interior nodes take over the children of their largest interior children until they have 8. The leaves of bvh stay
+        //leaves, they can hold up to 127 triangles (BVHBuildSettings::maxLeafSize).
+        void Build(BVH const& bvh);
+
+        //Closest hit and any hit like BVH::Intersect/IntersectAny, width selects the child test (clamped to the CPU's)
+        bool Intersect(float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit, SimdWidth width = SimdWidth::AVX512) const;
+        float IntersectAny(float3 const& origin, float3 const& direction, float tMin, float tMax, SimdWidth width = SimdWidth::AVX512) const;
+
+        uint32_t GetNodeCount() const { return m_NodeCount; }
+        WideBVHNode const* GetNodes() const; //Cache line aligned
+        std::vector<BVHTriangle> const& GetTriangles() const { return m_Triangles; }             //In leaf order
+        std::vector<uint32_t> const& GetTriangleIndices() const { return m_TriangleIndices; }   //Leaf order -> build order
+        size_t GetMemorySize() const;
+
+    private:
+        std::vector<uint8_t> m_NodeStorage; //Nodes from the first cache line boundary on
+        uint32_t m_NodeCount = 0;
+        std::vector<BVHTriangle> m_Triangles;
+        std::vector<uint32_t> m_TriangleIndices;
+    };
+
+    //WideBVH::IntersectAny for count rays, the SoA counterpart of IntersectAnyBatch(BVH const&, ...)
+    void IntersectAnyBatch(WideBVH const& bvh, RayBatch const& rays, uint32_t count, float* hitT, SimdWidth width);
+
+    //Child test on the 8 lanes of AVX2, also used on AVX-512 CPUs: a node has no more than 8 children to fill wider vectors
+    bool IntersectAVX2(WideBVH const& bvh, float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit);
+    float IntersectAnyAVX2(WideBVH const& bvh, float3 const& origin, float3 const& direction, float tMin, float tMax);
+} //namespace ImplicitPointCPU
@@ -0,0 +1,44 @@
+//Compiled with AVX2 enabled (/arch:AVX2, -mavx2), only reached through the runtime dispatch in WideBVH.cpp
+#include "WideBVHKernel.h"
+#include "SimdAVX2.h"
+
+namespace ImplicitPointCPU
+{
+    namespace
+    {
+        typedef SimdAVX2 S;
+        static_assert(S::Width == WideBVHWidth, "One child per lane");
+
+        //ScalarChildTest of WideBVH.cpp with the 8 children in the lanes
+        struct AVX2ChildTest
+        {
+            static uint32_t Intersect(WideBVHNode const& node, WideBVHRay const& ray, float tMin, float tMax, float tNear[WideBVHWidth])
+            {
+                S::Float childNear = S::Set1(tMin);
+                S::Float childFar = S::Set1(tMax);
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    S::Float const scale = S::Set1(GetQuantizationStep(node.exponent[axis]) * ray.inverseDirection[axis]);
+                    S::Float const offset = S::Set1((node.origin[axis] - ray.origin[axis]) * ray.inverseDirection[axis]);
+                    S::Float const t0 = S::Add(S::Mul(S::IntToFloat(S::LoadUint16(node.childMin[axis])), scale), offset);
+                    S::Float const t1 = S::Add(S::Mul(S::IntToFloat(S::LoadUint16(node.childMax[axis])), scale), offset);
+                    childNear = S::Max(childNear, S::Min(t0, t1));
+                    childFar = S::Min(childFar, S::Max(t0, t1));
+                }
+                S::Store(tNear, childNear);
+                return S::Bits(S::LessEqual(childNear, childFar)) & node.childMask;
+            }
+        };
+    }
+
+    bool IntersectAVX2(WideBVH const& bvh, float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit)
+    {
+        return TraverseWideBVH<false, AVX2ChildTest>(bvh, origin, direction, tMin, tMax, hit);
+    }
+
+    float IntersectAnyAVX2(WideBVH const& bvh, float3 const& origin, float3 const& direction, float tMin, float tMax)
+    {
+        RayHit hit;
+        return TraverseWideBVH<true, AVX2ChildTest>(bvh, origin, direction, tMin, tMax, hit) ? hit.t : tMax;
+    }
+} //namespace ImplicitPointCPU
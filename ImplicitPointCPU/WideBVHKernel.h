@@ -0,0 +1,90 @@
+//Single ray traversal of a WideBVH, written once for any child box test: ChildTest::Intersect returns the mask of the
+//children whose bounds the ray enters in [tMin, tMax] and their entry distances. The scalar test is in WideBVH.cpp, the
+//8 lane one in WideBVHAVX2.cpp. Only include this from those translation units.
+#pragma once
+#include "WideBVH.h"
+
+namespace ImplicitPointCPU
+{
+    struct WideBVHRay
+    {
+        float3 origin;
+        float3 direction;
+        float3 inverseDirection;
+    };
+
+    //2^exponent, for exponents in the normal float range the build keeps to
+    inline float GetQuantizationStep(int8_t exponent)
+    {
+        return asfloat(uint32_t(int32_t(exponent) + 127) << 23);
+    }
+
+    //Closest hit, or the first hit found when AnyHit. hit.triangle is in leaf order.
+    template<bool AnyHit, typename ChildTest>
+    bool TraverseWideBVH(WideBVH const& bvh, float3 const& origin, float3 const& direction, float tMin, float tMax, RayHit& hit)
+    {
+        if (bvh.GetNodeCount() == 0)
+            return false;
+
+        WideBVHNode const* const nodes = bvh.GetNodes();
+        BVHTriangle const* const triangles = bvh.GetTriangles().data();
+        WideBVHRay const ray = { origin, direction, float3{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z } };
+
+        //Every level pushes at most 7 more nodes than it pops, for trees as deep as the binary traversal supports
+        struct StackEntry
+        {
+            uint32_t node;
+            float tNear;
+        };
+        StackEntry stack[(WideBVHWidth - 1) * 64 + 1];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = StackEntry{ 0, tMin };
+
+        bool found = false;
+        while (stackSize > 0)
+        {
+            StackEntry const entry = stack[--stackSize];
+            if (entry.tNear > tMax)
+                continue;
+
+            WideBVHNode const& node = nodes[entry.node];
+            float tNear[WideBVHWidth];
+            uint32_t const hitMask = ChildTest::Intersect(node, ray, tMin, tMax, tNear);
+
+            //Leaf children are tested right away, interior children go on the stack far to near
+            uint32_t const firstPushed = stackSize;
+            uint32_t triangle = node.firstTriangle;
+            for (uint32_t child = 0; child < WideBVHWidth; ++child)
+            {
+                uint8_t const info = node.childInfo[child];
+                bool const hitChild = ((hitMask >> child) & 1) != 0;
+                if ((info & WideBVHInteriorChild) != 0)
+                {
+                    if (!hitChild)
+                        continue;
+                    uint32_t i = stackSize++;
+                    for (; i > firstPushed && stack[i - 1].tNear < tNear[child]; --i)
+                        stack[i] = stack[i - 1];
+                    stack[i] = StackEntry{ node.firstChildNode + (info & ~WideBVHInteriorChild), tNear[child] };
+                    continue;
+                }
+
+                if (hitChild)
+                {
+                    for (uint32_t t = triangle; t < triangle + info; ++t)
+                    {
+                        if (!IntersectTriangle(triangles[t], ray.origin, ray.direction, tMin, tMax, hit))
+                            continue;
+                        hit.triangle = t;
+                        found = true;
+                        if (AnyHit)
+                            return true;
+                        tMax = hit.t;
+                    }
+                }
+                triangle += info;
+            }
+        }
+        return found;
+    }
+} //namespace ImplicitPointCPU
@@ -54,18 +54,26 @@ __declspec(align(16)) struct SharedConstants
 	Matrix4 viewProjectionInverseMat;
 	Matrix4 viewInverseMat;
 	Matrix4 worldMat;
+	Matrix4 prevViewProjectionMat;
 	Vector4 viewVector;
 	uint32_t voxelConnectivity;
 	uint32_t level;
     uint32_t maxLevels;
 	uint32_t cellSize;
     uint32_t localizedLOD;
+    uint32_t screenWidth;
+    uint32_t screenHeight;
+    uint32_t samplePattern;
+    uint32_t sampleFrameIndex;
+    float temporalReuseDistance;
 };
 
 __declspec(align(16)) struct RayTracingConstants
 {
 	Matrix4 viewProjectionInverseMat;
 	uint32_t frameCount;
+    uint32_t samplePattern;
+    uint32_t sampleFrameIndex;
 };
 
 __declspec(align(16)) struct PointSampleData
@@ -91,6 +99,8 @@ __declspec(align(16)) struct HashTableConstants
 	uint32_t worldHashTableValueFractionalBits;
 	uint32_t worldHashTableCountFractionalBits;
 	uint32_t accumulationHashTableValueFractionalBits;
+    uint32_t screenWidth;
+    uint32_t screenHeight;
 };
 
 class ImplicitPointDemo : public GameCore::IGameApp
@@ -129,19 +139,23 @@ private:
     StructuredBuffer m_FullscreenVertexBuffer;
     ByteAddressBuffer m_FullscreenIndexBuffer;
     StructuredBuffer m_SampleGenerationBuffer;
+    StructuredBuffer m_ReprojectionBuffers[2]; //Closest samples per pixel of this and the last frame, see ReprojectionData
+    Matrix4 m_PrevViewProjectionMat = Matrix4(kIdentity);
+    float m_TemporalReuseDistance = 0.f; //Fraction of the cell size a reprojected world position may move to keep its samples
     GraphicsPSO m_SampleGenerationPSO;
 
     //--- FULLSCREEN SAMPLE VISUALIZATION MEMBERS ---
     GraphicsPSO m_SampleVisualizationPSO;
 
     //--- HASHTABLE MEMBERS ---
-    const HashTableConstants m_HashTableConstants =
+    HashTableConstants m_HashTableConstants =
     {
         8388608, //World Hash Table Element Count -> 8388608 * 12 bytes = +- 100Mb pre-allocated video memory
-        2073600, //Accumulation Hash Table Element Count = 1920 * 1080 pixels
+        0,       //Accumulation Hash Table Element Count = amount of pixels, set in Startup
         31,      //World Hash Table - Amount bits Fractional Part "Value"
         11,      //World Hash Table - Amount bits Fractional Part "Count"
-        11       //Accumulation Hash Table - Amount bits Fractional Part "Value"
+        11,      //Accumulation Hash Table - Amount bits Fractional Part "Value"
+        0, 0     //Screen Dimensions = scene color buffer at Startup, every per pixel buffer and dispatch is sized from these
     };
 
     //--- ACCUMULATION MEMBERS ---
@@ -205,6 +219,12 @@ private:
         DistanceLOD = 1,
         MinMaxLOD   = 2
     };
+    enum class SamplePattern : uint32_t //Pixels that trace AO, generate and accumulate a sample in a frame
+    {
+        Full         = 0,
+        Quarter      = 1,
+        Checkerboard = 2
+    };
     bool m_SSAOEnabled = true;
     bool m_VisualizeSamples = false;
     bool m_StopAccumulating = false;
@@ -212,6 +232,8 @@ private:
     bool m_VisualizeRayTracing = false;
     bool m_TechniqueEnabled = true;
     LODMode m_LODMode = LODMode::FixedLOD;
+    SamplePattern m_SamplePattern = SamplePattern::Full;
+    uint32_t m_SampleFrameIndex = 0; //Rotates the pixels of the sample pattern, once per frame
 
     //--- PRIVATE FUNCTIONS ---
     void InitializeRayTracing();
@@ -289,8 +311,8 @@ void ImplicitPointDemo::Startup( void )
     //--- SETUP ROOT SIGNATURE ---
     m_RootSignature.Reset(3, 0);
     m_RootSignature[0].InitAsConstantBuffer(0, D3D12_SHADER_VISIBILITY_ALL);
-    m_RootSignature[1].InitAsDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 5, D3D12_SHADER_VISIBILITY_PIXEL); //Depth + Normal Buffer + Tangent + Bitangent + AO Buffer
-    m_RootSignature[2].InitAsDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 3, 2); //PointSampleBuffer + LODBuffer
+    m_RootSignature[1].InitAsDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 0, 6, D3D12_SHADER_VISIBILITY_PIXEL); //Depth + Normal Buffer + Tangent + Bitangent + AO Buffer + Previous Reprojection Buffer
+    m_RootSignature[2].InitAsDescriptorRange(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 3, 3); //PointSampleBuffer + LODBuffer + Reprojection Buffer
     m_RootSignature.Finalize(L"ImplicitPointDemo_RasterizationRootSignature", D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
     //--- SETUP MESH DRAWING PIPELINE STATE OBJECT ---
@@ -316,6 +338,9 @@ void ImplicitPointDemo::Startup( void )
     //--- SETUP GBUFFER FILL PSO ---
     uint32_t const widthBuffer = g_SceneColorBuffer.GetWidth();
     uint32_t const heightBuffer = g_SceneColorBuffer.GetHeight();
+    m_HashTableConstants.screenWidth = widthBuffer;
+    m_HashTableConstants.screenHeight = heightBuffer;
+    m_HashTableConstants.accumulationHashTableElementCount = widthBuffer * heightBuffer;
     m_WorldNormalBuffer.Create(L"World Normal Buffer", widthBuffer, heightBuffer, 1, DXGI_FORMAT_R32G32B32A32_FLOAT);
     m_WorldTangentBuffer.Create(L"World Tangent Buffer", widthBuffer, heightBuffer, 1, DXGI_FORMAT_R32G32B32A32_FLOAT);
     m_WorldBitangentBuffer.Create(L"World Bitangent Buffer", widthBuffer, heightBuffer, 1, DXGI_FORMAT_R32G32B32A32_FLOAT);
@@ -362,6 +387,9 @@ void ImplicitPointDemo::Startup( void )
     uint32_t const sampleNumElements = m_DepthBuffer.GetWidth() * m_DepthBuffer.GetHeight();
     m_SampleGenerationBuffer.Create(L"SampleBuffer", sampleNumElements, sampleElementSize);
     m_LODBuffer.Create(L"LOD Buffer", sampleNumElements, sizeof(uint32_t) * 2); //Stores uint2
+    uint32_t const reprojectionElementSize = 44; //sizeof(ReprojectionData)
+    m_ReprojectionBuffers[0].Create(L"Reprojection Buffer 0", sampleNumElements, reprojectionElementSize);
+    m_ReprojectionBuffers[1].Create(L"Reprojection Buffer 1", sampleNumElements, reprojectionElementSize);
 
     //--- SETUP POINT VISUALIZATION ---
 	D3D12_INPUT_ELEMENT_DESC const vertexPointVisualizationLayout[] =
@@ -548,6 +576,14 @@ void ImplicitPointDemo::Update( float deltaT )
     //Enable/Disable Entire Technique
     if (GameInput::IsFirstReleased(GameInput::kKey_p))
         m_TechniqueEnabled = !m_TechniqueEnabled;
+
+    //Enable/Disable Temporal Reuse of the closest samples
+    if (GameInput::IsFirstReleased(GameInput::kKey_o))
+        m_TemporalReuseDistance = m_TemporalReuseDistance > 0.f ? 0.f : 0.25f;
+
+    //Cycle Sample Pattern: Full, Quarter, Checkerboard
+    if (GameInput::IsFirstReleased(GameInput::kKey_i))
+        m_SamplePattern = static_cast<SamplePattern>((static_cast<uint32_t>(m_SamplePattern) + 1) % 3);
 }
 
 void ImplicitPointDemo::RenderScene( void )
@@ -571,6 +607,7 @@ void ImplicitPointDemo::RenderScene( void )
             AOGaussianBlurPass(gfxContext);
         SetDefaultRenderingPipeline(gfxContext); //Reset to default due to RT context!
 		SampleGenerationPass(gfxContext);
+        m_PrevViewProjectionMat = m_MainCamera.GetViewProjMatrix();
 		if (m_VisualizeSamples)
 			SampleVisualizationPass(gfxContext);
         if (!m_StopAccumulating)
@@ -583,6 +620,7 @@ void ImplicitPointDemo::RenderScene( void )
 
         if (!m_StopAccumulating)
             ClearBuffersPass(gfxContext);
+        ++m_SampleFrameIndex;
     }
 
     //--- END ---
@@ -908,6 +946,12 @@ void ImplicitPointDemo::SetDefaultRenderingPipeline(GraphicsContext& gfxContext)
 	constants.cellSize = m_CellSize;
     constants.localizedLOD = static_cast<uint32_t>(m_LODMode);
     constants.maxLevels = m_MaxLevels;
+    constants.screenWidth = m_HashTableConstants.screenWidth;
+    constants.screenHeight = m_HashTableConstants.screenHeight;
+    constants.samplePattern = static_cast<uint32_t>(m_SamplePattern);
+    constants.sampleFrameIndex = m_SampleFrameIndex;
+    constants.prevViewProjectionMat = m_PrevViewProjectionMat;
+    constants.temporalReuseDistance = m_TemporalReuseDistance;
 	gfxContext.SetDynamicConstantBufferView(0, sizeof(SharedConstants), &constants);
 }
 
@@ -996,6 +1040,9 @@ void ImplicitPointDemo::RayTracingPass(GraphicsContext& gfxContext)
 	RayTracingConstants rtConstants = {};
 	rtConstants.viewProjectionInverseMat = Invert(m_MainCamera.GetViewProjMatrix());
     rtConstants.frameCount = m_FrameCount;
+    //MinMaxLOD blurs the AO of every pixel, so the other pixels can only skip their rays without it
+    rtConstants.samplePattern = static_cast<uint32_t>(m_LODMode == LODMode::MinMaxLOD ? SamplePattern::Full : m_SamplePattern);
+    rtConstants.sampleFrameIndex = m_SampleFrameIndex;
     gfxContext.WriteBuffer(m_DynamicConstantBuffer, 0, &rtConstants, sizeof(RayTracingConstants));
     gfxContext.TransitionResource(m_DynamicConstantBuffer, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
     pCommandList->SetComputeRootConstantBufferView(3, m_DynamicConstantBuffer->GetGPUVirtualAddress()); //Constant Buffer
@@ -1056,13 +1103,20 @@ void ImplicitPointDemo::SampleGenerationPass(GraphicsContext& gfxContext)
 	gfxContext.TransitionResource(m_LODBuffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
 	gfxContext.TransitionResource(m_BlurredAOBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
+    //Written this frame, read next frame
+    StructuredBuffer& reprojectionBuffer = m_ReprojectionBuffers[m_SampleFrameIndex & 1];
+    StructuredBuffer& prevReprojectionBuffer = m_ReprojectionBuffers[(m_SampleFrameIndex + 1) & 1];
+    gfxContext.TransitionResource(reprojectionBuffer, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    gfxContext.TransitionResource(prevReprojectionBuffer, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
 	gfxContext.SetPipelineState(m_SampleGenerationPSO);
 
-	D3D12_CPU_DESCRIPTOR_HANDLE const srvHandles[5] = 
-        { m_DepthBuffer.GetDepthSRV(), m_WorldNormalBuffer.GetSRV(), m_WorldTangentBuffer.GetSRV(), m_WorldBitangentBuffer.GetSRV(), m_BlurredAOBuffer.GetSRV() };
-    D3D12_CPU_DESCRIPTOR_HANDLE const uavHandles[2] = { m_SampleGenerationBuffer.GetUAV(), m_LODBuffer.GetUAV() };
-	gfxContext.SetDynamicDescriptors(1, 0, 5, srvHandles);
-    gfxContext.SetDynamicDescriptors(2, 0, 2, uavHandles);
+	D3D12_CPU_DESCRIPTOR_HANDLE const srvHandles[6] = 
+        { m_DepthBuffer.GetDepthSRV(), m_WorldNormalBuffer.GetSRV(), m_WorldTangentBuffer.GetSRV(), m_WorldBitangentBuffer.GetSRV(), m_BlurredAOBuffer.GetSRV(),
+          prevReprojectionBuffer.GetSRV() };
+    D3D12_CPU_DESCRIPTOR_HANDLE const uavHandles[3] = { m_SampleGenerationBuffer.GetUAV(), m_LODBuffer.GetUAV(), reprojectionBuffer.GetUAV() };
+	gfxContext.SetDynamicDescriptors(1, 0, 6, srvHandles);
+    gfxContext.SetDynamicDescriptors(2, 0, 3, uavHandles);
 
 	gfxContext.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	gfxContext.SetIndexBuffer(m_FullscreenIndexBuffer.IndexBufferView());
@@ -1096,7 +1150,7 @@ void ImplicitPointDemo::AccumulationPass(GraphicsContext& gfxContext)
 	computeContext.SetDynamicDescriptor(1, 0, m_AccumulationHashTable.GetUAV());
 	computeContext.SetDynamicConstantBufferView(2, sizeof(HashTableConstants), &m_HashTableConstants);
 
-	computeContext.Dispatch2D(1920, 1080);
+	computeContext.Dispatch2D(m_HashTableConstants.screenWidth, m_HashTableConstants.screenHeight);
 }
 
 void ImplicitPointDemo::WorldHashTablePass(GraphicsContext& gfxContext)
@@ -1117,7 +1171,7 @@ void ImplicitPointDemo::WorldHashTablePass(GraphicsContext& gfxContext)
     computeContext.SetDynamicDescriptor(1, 0, m_WorldHashTable.GetUAV());
     computeContext.SetDynamicConstantBufferView(2, sizeof(HashTableConstants), &m_HashTableConstants);
 
-    computeContext.Dispatch2D(1920, 1080);
+    computeContext.Dispatch2D(m_HashTableConstants.screenWidth, m_HashTableConstants.screenHeight);
 }
 
 void ImplicitPointDemo::FinalVisualizationPass(GraphicsContext& gfxContext)
@@ -1166,7 +1220,7 @@ void ImplicitPointDemo::FinalVisualizationPass(GraphicsContext& gfxContext)
     demoConstants.voxelConnectivity = m_VoxelConnectivity;
     computeContext.SetDynamicConstantBufferView(5, sizeof(DemoConstants), &demoConstants);
 
-    computeContext.Dispatch2D(1920, 1080);
+    computeContext.Dispatch2D(m_HashTableConstants.screenWidth, m_HashTableConstants.screenHeight);
     computeContext.Flush(true); //Make sure all previous data is saved in V-RAM, and wait for completion!
 
     //Copy to RenderTarget...
@@ -1195,5 +1249,5 @@ void ImplicitPointDemo::ClearBuffersPass(GraphicsContext& gfxContext)
 	computeContext.SetDynamicDescriptors(0, 0, 2, uavHandles);
 	computeContext.SetDynamicConstantBufferView(1, sizeof(HashTableConstants), &m_HashTableConstants);
 
-    computeContext.Dispatch2D(1920, 1080);
+    computeContext.Dispatch2D(m_HashTableConstants.screenWidth, m_HashTableConstants.screenHeight);
 }
\ No newline at end of file
@@ -21,16 +21,17 @@ cbuffer HashTableConstants                          : register(b0)
     uint WorldHashTableValueFractionalBits;
     uint WorldHashTableCountFractionalBits;
     uint AccumulationHashTableValueFractionalBits;
+    uint2 ScreenDimensions;
 }
 
 [numthreads(8, 8, 1)]
 void main(uint3 DTid : SV_DispatchThreadID)
 {
-    const uint2 screenDimensions = uint2(1920, 1080);
+    const uint2 screenDimensions = ScreenDimensions;
     
-    //Input Data
+    //Input Data - the dispatch is rounded up to whole thread groups, threads right of the screen would add the next row again
     const uint index = uint(DTid.x + (DTid.y * screenDimensions.x));
-    if (index >= AccumulationHashTableElementCount)
+    if (DTid.x >= screenDimensions.x || index >= AccumulationHashTableElementCount)
         return;
     
     const float aoValue = AOBuffer[DTid.xy].r;
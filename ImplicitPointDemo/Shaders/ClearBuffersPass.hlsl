@@ -9,16 +9,18 @@ cbuffer HashTableConstants                      : register(b0)
     uint WorldHashTableValueFractionalBits;
     uint WorldHashTableCountFractionalBits;
     uint AccumulationHashTableValueFractionalBits;
+    uint2 ScreenDimensions;
 }
 
 [numthreads(8, 8, 1)]
 void main( uint3 DTid : SV_DispatchThreadID )
 {
-    const uint2 screenDimensions = uint2(1920, 1080);
+    const uint2 screenDimensions = ScreenDimensions;
     const uint amountElements = screenDimensions.x * screenDimensions.y;
     
+    //The dispatch is rounded up to whole thread groups, threads right of the screen would clear the next row
     const uint index = uint(DTid.x + (DTid.y * screenDimensions.x));
-    if (index < amountElements)
+    if (DTid.x < screenDimensions.x && index < amountElements)
     {
         AccumulationBuffer[index].key = 0;
         AccumulationBuffer[index].value = 0;
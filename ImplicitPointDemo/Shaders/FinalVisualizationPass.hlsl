@@ -22,6 +22,7 @@ cbuffer HashTableConstants                          : register(b0)
     uint WorldHashTableValueFractionalBits;
     uint WorldHashTableCountFractionalBits;
     uint AccumulationHashTableValueFractionalBits;
+    uint2 ScreenDimensions;
 }
 cbuffer CameraData                                  : register(b1)
 {
@@ -33,7 +34,6 @@ cbuffer Modes                                       : register(b2)
 {
     uint MaxLevels;
     uint LODMode;
-    bool QuarterSPP;
 }
 cbuffer DemoConstants                               : register(b3)
 {
@@ -177,7 +177,9 @@ float WorldSpaceShepardInterpolationMultipleLevels(in uint discreteCellSize, in
 void main(uint3 DTid : SV_DispatchThreadID)
 {
     //Indexing
-    const uint2 screenDimensions = uint2(1920, 1080);
+    const uint2 screenDimensions = ScreenDimensions;
+    if (DTid.x >= screenDimensions.x || DTid.y >= screenDimensions.y)
+        return;
     const uint index = uint(DTid.x + (DTid.y * screenDimensions.x));
     
     //Calculate world position of pixel
@@ -30,12 +30,12 @@ float ShootRayInHemisphere(in float3 worldPosition, in float3 worldDirection)
 [shader("raygeneration")]
 void RayGen()
 {
-    const uint2 screenDimensions = uint2(1920, 1080);
+    const uint2 screenDimensions = DispatchRaysDimensions().xy;
       
-    //Test if necessary to cast (using depth buffer)
+    //Test if necessary to cast (using depth buffer and the pixels that accumulate a sample this frame)
     const float depth = DepthBuffer[DispatchRaysIndex().xy];
     const int iDepth = asint(depth);
-    if (iDepth == 0)
+    if (iDepth == 0 || !IsSamplePixel(DispatchRaysIndex().xy, SamplePattern, SampleFrameIndex))
     {
         OutputBuffer[DispatchRaysIndex().xy] = float4(0.f, 0.f, 0.f, 1.f);
         return;
@@ -11,7 +11,8 @@ cbuffer RayTracingCB                          : register(b0)
 {
     float4x4 ViewProjectionInverseMatrix;
     uint FrameCount;
-    bool QuarterSPP;
+    uint SamplePattern; //Only the pixels that accumulate a sample this frame need AO, Full when the AO is blurred for MinMaxLOD
+    uint SampleFrameIndex;
 }
 
 struct RayPayload
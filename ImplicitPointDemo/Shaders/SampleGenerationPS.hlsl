@@ -2,13 +2,31 @@
 #include "SampleGenerationFunctions.hlsli"
 #include "LODFunctions.hlsli"
 
+//Entry of the last frame at the pixel worldPosition was visible at, when it has the same LODs and was searched less than
+//maxDistance away. Inverse of DepthToWorldPosition, rounded to the nearest pixel.
+bool FindReprojectedSample(in float3 worldPosition, in uint2 lods, in float maxDistance, in uint2 screenDimensions, out ReprojectionData reprojected)
+{
+    reprojected = (ReprojectionData) 0;
+    const float4 clip = mul(PrevViewProjectionMatrix, float4(worldPosition, 1.f));
+    if (SampleFrameIndex == 0 || clip.w <= 0.f)
+        return false;
+    const float2 ndc = clip.xy / clip.w;
+    const float2 screenPosition = floor(float2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f) * float2(screenDimensions) + 0.5f);
+    if (any(screenPosition < 0.f) || any(screenPosition >= float2(screenDimensions)))
+        return false;
+    
+    reprojected = PrevReprojectionBuffer[uint(screenPosition.x) + (uint(screenPosition.y) * screenDimensions.x)];
+    const float3 offset = reprojected.worldPosition - worldPosition;
+    return reprojected.frame == SampleFrameIndex && all(reprojected.lods == lods) && dot(offset, offset) < (maxDistance * maxDistance);
+}
+
 void main(SampleGenerationOutput vsOutput)
 {
     //For testing different techniques
     const bool useJittering = false;
     
     //Indexing
-    const uint2 screenDimensions = uint2(1920, 1080);
+    const uint2 screenDimensions = ScreenDimensions;
     const uint index = uint(vsOutput.position.x) + (uint(vsOutput.position.y) * screenDimensions.x);
     const uint2 index2D = uint2(index % screenDimensions.x, index / screenDimensions.x);
     
@@ -62,6 +80,37 @@ void main(SampleGenerationOutput vsOutput)
     //Store LODs (determined based on different method)
     LODBuffer[index] = uint2(lodLevel, prevLodLevel);
     
+    //Closest samples of last frame, when this world position was visible then and barely moved
+    ReprojectionData reprojected = (ReprojectionData) 0;
+    bool reuse = false;
+    if (TemporalReuseDistance > 0.f)
+    {
+        const float reuseDistance = TemporalReuseDistance * float(CellSize) / float(1 << max(lodLevel, prevLodLevel));
+        reuse = FindReprojectedSample(worldPosition, uint2(lodLevel, prevLodLevel), reuseDistance, screenDimensions, reprojected);
+        if (reuse)
+        {
+            reprojected.frame = SampleFrameIndex + 1;
+            ReprojectionBuffer[index] = reprojected;
+        }
+    }
+    
+    //Pixels outside of the sample pattern keep their LOD for the final pass, but don't accumulate this frame.
+    //They carry a reprojected entry over, so the pixels of the pattern can find it next frame.
+    if (!IsSamplePixel(index2D, SamplePattern, SampleFrameIndex))
+    {
+        PointSampleBuffer[index].seed = 0;
+        PointSampleBuffer[index].prevSeed = 0;
+        PointSampleBuffer[index].sample = float3(0.f, 0.f, 0.f);
+        return;
+    }
+    if (reuse)
+    {
+        PointSampleBuffer[index].seed = reprojected.seed;
+        PointSampleBuffer[index].prevSeed = reprojected.prevSeed;
+        PointSampleBuffer[index].sample = reprojected.sample;
+        return;
+    }
+    
     //Generate closest sample and seed based on LODs
     const ClosestPointSample closestSample = GetGeneratedSample(worldPosition.xyz, CellSize, lodLevel, VoxelConnectivity, MaxLevels);
     ClosestPointSample closestSamplePrevLOD = (ClosestPointSample) 0;
@@ -72,4 +121,16 @@ void main(SampleGenerationOutput vsOutput)
     PointSampleBuffer[index].seed = closestSample.seed;
     PointSampleBuffer[index].prevSeed = closestSamplePrevLOD.seed;
     PointSampleBuffer[index].sample = closestSample.sample;
+    
+    if (TemporalReuseDistance > 0.f)
+    {
+        ReprojectionData searched;
+        searched.worldPosition = worldPosition;
+        searched.lods = uint2(lodLevel, prevLodLevel);
+        searched.seed = closestSample.seed;
+        searched.prevSeed = closestSamplePrevLOD.seed;
+        searched.sample = closestSample.sample;
+        searched.frame = SampleFrameIndex + 1;
+        ReprojectionBuffer[index] = searched;
+    }
 }
\ No newline at end of file
@@ -8,12 +8,17 @@ cbuffer SharedConstants : register(b0)
     float4x4 ViewProjectionInverseMatrix;
     float4x4 ViewInverseMatrix;
     float4x4 WorldMatrix;
+    float4x4 PrevViewProjectionMatrix; //Camera of the last frame that generated samples, see ReprojectionData
     float4 ViewVector;
     uint VoxelConnectivity;
     uint Level;
     uint MaxLevels;
     uint CellSize;
     uint LODMode;
+    uint2 ScreenDimensions;
+    uint SamplePattern; //0 = Full, 1 = Quarter, 2 = Checkerboard, see IsSamplePixel
+    uint SampleFrameIndex;
+    float TemporalReuseDistance; //Fraction of the cell size on the finest level, 0 = search every frame
 }
 
 Texture2D<float>  DepthBuffer       : register(t0);
@@ -31,6 +36,19 @@ struct SampleData
 RWStructuredBuffer<SampleData>  PointSampleBuffer   : register(u3);
 RWStructuredBuffer<uint2>       LODBuffer           : register(u4);
 
+//Closest samples a pixel found, looked up next frame by reprojecting the world position. Ping-ponged every frame.
+struct ReprojectionData
+{
+    float3 worldPosition; //12 bytes - position the closest samples were searched for
+    uint2 lods;           //8 bytes
+    uint seed;            //4 bytes
+    uint prevSeed;        //4 bytes
+    float3 sample;        //12 bytes
+    uint frame;           //4 bytes - SampleFrameIndex + 1 of the frame that stored it
+};
+StructuredBuffer<ReprojectionData>   PrevReprojectionBuffer : register(t5);
+RWStructuredBuffer<ReprojectionData> ReprojectionBuffer     : register(u5);
+
 //---- STRUCTS ----
 struct MeshVertexInput
 {
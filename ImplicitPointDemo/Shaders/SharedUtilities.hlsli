@@ -36,4 +36,18 @@ inline float3 FromFixedPoint(in uint3 value, in uint fractionalBitCount)
     uint frac = 1 << fractionalBitCount;
     return float3(value) / frac;
 }
+
+//Whether the pixel at screenCoord generates and accumulates a sample in frame frameIndex (0 = Full, 1 = Quarter, 2 = Checkerboard).
+//Quarter visits the 2x2 block in the order (0,0), (1,1), (1,0), (0,1): every frame is spread over both rows and columns.
+inline bool IsSamplePixel(in uint2 screenCoord, in uint samplePattern, in uint frameIndex)
+{
+    if (samplePattern == 1)
+    {
+        const uint quarterOrder[4] = { 0, 3, 1, 2 };
+        return ((screenCoord.x & 1) | ((screenCoord.y & 1) << 1)) == quarterOrder[frameIndex & 3];
+    }
+    if (samplePattern == 2)
+        return ((screenCoord.x + screenCoord.y) & 1) == (frameIndex & 1);
+    return true;
+}
 #endif
\ No newline at end of file